@@ -0,0 +1,81 @@
+/*
+  CETALIB "board" Library Example: "board_button_events.ino"
+
+  This example reads the USER pushbutton events from the "board" event queue:
+    - click:          toggle the USER LED
+    - double click:   blink the USER LED at 5 Hz
+    - long press:     turn the USER LED off
+
+  The pushbutton is read from an interrupt and debounced in the background,
+  so the events are not lost even though the main loop below is slow (it
+  blocks for 250 mS on each pass).
+
+  Hardware Configurations Supported:
+
+  CETA IoT Robot (Schematic #14-00069A/B), based on RPI-Pico-WH
+  (Select "Board = Raspberry Pi Pico W")
+
+  Sparkfun XRP Robot Platform (#KIT-27644), based on the RPI RP2350B MCU
+  (Select "Board = SparkFun XRP Controller")
+
+  Sparkfun XRP (Beta) Robot Platform (#KIT-22230), based on the RPI Pico W
+  (Select "Board = SparkFun XRP Controller (Beta)")
+
+  created 19 Oct 2026
+  by dBm Signal Dynamics Inc.
+
+*/
+
+#include <stdio.h>    // needed for "sprintf()" function
+#include <cetalib.h>
+
+const struct CETALIB_INTERFACE *myRobot = &CETALIB;
+
+const char *eventNames[] = {"press", "release", "long press", "double click"};
+bool ignoreNextRelease = false;   // the release ending a long press or double click is not a click
+
+// Define a serial terminal output buffer for messages
+char serialOutBuffer[64];
+
+void setup() {
+  Serial.begin(115200);
+  delay(2000);
+  myRobot->board->initialize();
+  Serial.println("Waiting for the USER pushbutton...");
+  myRobot->board->wait_for_button();    // sleeps until the first press
+  Serial.println("Started");
+}
+
+void loop() {
+  myRobot->board->tasks();
+
+  BUTTON_EVENT event;
+  while (myRobot->board->get_button_event(&event))
+  {
+    sprintf(serialOutBuffer, "%8lu mS: %s", event.time, eventNames[event.type]);
+    Serial.println(serialOutBuffer);
+    switch (event.type)
+    {
+      case BUTTON_EVENT_RELEASE:
+        if (!ignoreNextRelease)
+        {
+          myRobot->board->led_toggle();
+        }
+        ignoreNextRelease = false;
+        break;
+      case BUTTON_EVENT_DOUBLE_CLICK:
+        myRobot->board->led_blink(5);
+        ignoreNextRelease = true;
+        break;
+      case BUTTON_EVENT_LONG_PRESS:
+        myRobot->board->led_off();
+        ignoreNextRelease = true;
+        break;
+      default:
+        break;
+    }
+  }
+
+  // Simulate a slow main loop
+  delay(250);
+}
@@ -0,0 +1,93 @@
+/*
+  CETALIB "board" Library Example: "board_led_status_codes.ino"
+
+  This example shows status codes on the USER LED with "led_play()". Each code
+  is a small table of colors and durations, played by a hardware timer, so the
+  LED timing stays regular even while the main loop is busy.
+
+  Press the USER pushbutton to step through the status codes. While the "busy"
+  code is shown, the loop blocks for 3 seconds without calling tasks() (as the
+  IMU calibration does), and the LED keeps flashing regularly.
+
+  On the XRP the USER LED is an RGB NeoPixel, so each code has its own color.
+  On the CETA and XRP (Beta) robots the USER LED is a single color LED, so only
+  the flash timing differs.
+
+  Hardware Configurations Supported:
+
+  CETA IoT Robot (Schematic #14-00069A/B), based on RPI-Pico-WH
+  (Select "Board = Raspberry Pi Pico W")
+
+  Sparkfun XRP Robot Platform (#KIT-27644), based on the RPI RP2350B MCU
+  (Select "Board = SparkFun XRP Controller")
+
+  Sparkfun XRP (Beta) Robot Platform (#KIT-22230), based on the RPI Pico W
+  (Select "Board = SparkFun XRP Controller (Beta)")
+
+  created 19 Oct 2026
+  by dBm Signal Dynamics Inc.
+
+*/
+
+#include <cetalib.h>
+
+const struct CETALIB_INTERFACE *myRobot = &CETALIB;
+
+// Status code tables: {color (0xRRGGBB), duration (mS)}
+const LED_STEP readyCode[] = {{0x000A00, 100}, {0, 1900}};                       // green heartbeat
+const LED_STEP busyCode[] = {{0x0A0A00, 50}, {0, 50}};                            // fast yellow flicker
+const LED_STEP warningCode[] = {{0x0A0500, 300}, {0, 200}, {0x0A0500, 300}, {0, 1200}}; // 2 slow orange flashes
+const LED_STEP errorCode[] = {{0x0A0000, 150}, {0, 150}, {0x0A0000, 150}, {0, 150},
+                              {0x0A0000, 150}, {0, 1000}};                        // 3 red flashes
+const LED_STEP connectedCode[] = {{0x00000A, 500}, {0x000A00, 500}};              // blue/green alternating
+
+int statusCode = 0;
+
+void setup() {
+  Serial.begin(115200);
+  delay(2000);
+  myRobot->board->initialize();
+  showStatus();
+}
+
+void loop() {
+  myRobot->board->tasks();
+
+  if (myRobot->board->is_button_pressed())
+  {
+    statusCode = (statusCode + 1) % 5;
+    showStatus();
+    if (statusCode == 1)
+    {
+      // Simulate a long blocking operation: the LED keeps its timing
+      delay(3000);
+    }
+  }
+}
+
+void showStatus(void)
+{
+  switch (statusCode)
+  {
+    case 0:
+      Serial.println("Status: ready");
+      myRobot->board->led_play(readyCode, 2);
+      break;
+    case 1:
+      Serial.println("Status: busy (loop blocked for 3 seconds)");
+      myRobot->board->led_play(busyCode, 2);
+      break;
+    case 2:
+      Serial.println("Status: warning");
+      myRobot->board->led_play(warningCode, 4);
+      break;
+    case 3:
+      Serial.println("Status: error");
+      myRobot->board->led_play(errorCode, 6);
+      break;
+    case 4:
+      Serial.println("Status: connected");
+      myRobot->board->led_play(connectedCode, 2);
+      break;
+  }
+}
@@ -0,0 +1,102 @@
+/*
+  CETALIB "boot" Library Example: "boot_fast_start.ino"
+
+  This example starts all modules with the "boot" orchestrator, so the slow
+  initializations overlap instead of running one after the other:
+
+    - the OLED splash screen is displayed without waiting
+    - the WiFi association and MQTT broker connection continue in the
+      background (mqttc "begin()"), while the robot is already usable
+    - the motors are ready (and accept drive commands) as soon as their
+      step completes
+
+  Each step records its start and completion time. The startup timeline is
+  displayed on the serial terminal when all "required" steps are complete
+  (the robot is ready), and again when the background steps are complete.
+
+  Calibration procedures still run during initialization if a module has no
+  calibration data: run the calibration examples first to measure a normal
+  boot.
+
+  Hardware Configurations Supported:
+
+  CETA IoT Robot (Schematic #14-00069A/B), based on RPI-Pico-WH
+  (Select "Board = Raspberry Pi Pico W")
+
+  Sparkfun XRP Robot Platform (#KIT-27644), based on the RPI RP2350B MCU
+  (Select "Board = SparkFun XRP Controller")
+
+  Sparkfun XRP (Beta) Robot Platform (#KIT-22230), based on the RPI Pico W
+  (Select "Board = SparkFun XRP Controller (Beta)")
+
+  created 19 Oct 2026
+  by dBm Signal Dynamics Inc.
+
+*/
+
+#include <cetalib.h>
+
+const struct CETALIB_INTERFACE *myRobot = &CETALIB;
+
+// WiFi Parameters
+const char ssid[] = "MY_SSID";        // EDIT
+const char pass[] = "MY_PASSPHRASE";  // EDIT
+
+// MQTT Broker URL, Username, Password
+const char MQTTbroker[] = "broker.emqx.io";
+int MQTTport = 1883;    // EDIT: 1883 for open connection, or 8883 for secure connection
+const char MQTTusername[] = "";
+const char MQTTpassword[] = "";
+
+// No subscribe topics
+const char *subscribeTopicIDs[] = {""};
+int num_subscribeTopicIDs = 0;
+
+bool readyReported = false;
+bool timelineReported = false;
+
+// Initialization steps: start() returns false if the initialization failed,
+// poll() returns true when a background initialization is complete
+bool startBoard(void) { myRobot->board->initialize(); return true; }
+bool startOled(void) { return myRobot->oled->initialize(); }
+bool startReflectance(void) { myRobot->reflectance->initialize(); return true; }
+bool startDrive(void) { myRobot->diffDrive->initialize(false, false); return true; }
+bool startNetwork(void)
+{
+  return myRobot->mqttc->begin(ssid, pass, MQTTbroker, MQTTport, MQTTusername, MQTTpassword, subscribeTopicIDs, num_subscribeTopicIDs);
+}
+bool pollNetwork(void) { return myRobot->mqttc->is_connected(); }
+
+void setup() {
+  Serial.begin(115200);
+
+  // Define the steps: name, start function, poll function, required for "ready"
+  myRobot->boot->add_step("board", startBoard, NULL, true);
+  myRobot->boot->add_step("network", startNetwork, pollNetwork, false);
+  myRobot->boot->add_step("oled", startOled, NULL, false);
+  myRobot->boot->add_step("reflectance", startReflectance, NULL, true);
+  myRobot->boot->add_step("drive", startDrive, NULL, true);
+
+  // Start all steps, without waiting for the background ones
+  myRobot->boot->run();
+}
+
+void loop() {
+  // Run the background tasks (board tasks() also polls the boot steps)
+  myRobot->mqttc->tasks();
+  myRobot->board->tasks();
+
+  if (myRobot->boot->is_ready() && !readyReported)
+  {
+    readyReported = true;
+    myRobot->boot->print_timeline();
+    myRobot->board->led_pattern(1);
+  }
+
+  // Display the complete timeline once the network is connected
+  if (myRobot->mqttc->is_connected() && !timelineReported)
+  {
+    timelineReported = true;
+    myRobot->boot->print_timeline();
+  }
+}
@@ -0,0 +1,126 @@
+/*
+  CETALIB Calibration Example: "calibration_joystick.ino"
+
+  This example runs the "reflectance" and "servoarm" calibration routines
+  from the joystick, at any time, while the robot keeps running. The
+  routines do not block: the reflectance and servoarm tasks() advance them,
+  and the new calibration is used and saved (with a single flash write) only
+  when a routine completes. Until then, and if it is cancelled, the previous
+  calibration is used.
+
+  Joystick buttons:
+    X:              reflectance auto calibration: place the robot in front
+                    of a line, facing it. The robot drives over the line and
+                    back, and sets the trip thresholds from the readings.
+    Y:              servoarm calibration (HOME, LIFT then DROP positions)
+    DPAD N/S:       move the arm up/down 1 degree (servoarm calibration)
+    A:              accept/continue (same as the USER switch)
+    B:              cancel the running calibration
+    Left Stick Y, Right Stick X: drive the robot (arcade), except during the
+                    reflectance auto calibration
+
+  Hardware Configuration:
+
+  Windows/MacOS PC with Logitech F310 Gamepad connected in "D" mode.
+  Follow the provided instructions for running the gamepad python script on your PC.
+
+  CETA IoT Robot (Schematic #14-00069A/B), based on RPI-Pico-WH
+  (Select Board: "Raspberry Pi Pico W")
+
+  Sparkfun XRP Robot Platform (#KIT-27644), based on the RPI RP2350B MCU
+  (Select Board: "SparkFun XRP Controller")
+
+  Sparkfun XRP (Beta) Robot Platform (#KIT-22230), based on the RPI Pico W
+  (Select "Board = SparkFun XRP Controller (Beta)")
+
+  created 19 Oct 2026
+  by dBm Signal Dynamics Inc.
+
+*/
+
+#include <cetalib.h>
+
+// define & initialize a pointer to the CETALIB functions
+const struct CETALIB_INTERFACE *myRobot = &CETALIB;
+
+// define motor effort parameters
+float leftDriveEffort, rightDriveEffort;
+
+// reflectance auto calibration drive effort (slow, so the sensors see the line)
+const float sweepEffort = 0.25f;
+
+// define USER LED blink patterns for joystick initialization status
+int ledPatternSuccess = 1;    // 1 blink per second on successful init
+int ledPatternFailure = 5;    // 5 blinks per second on failed init
+
+// the setup function runs once when you press reset or power the board
+void setup() {
+  Serial.begin(115200);
+  delay(5000);
+  myRobot->board->initialize();
+  myRobot->diffDrive->initialize(false, false); // adjust parameters for forward motion in your robot
+  myRobot->reflectance->initialize();
+  myRobot->servoarm->initialize();
+  if(!myRobot->joystick->initialize())
+  {
+    Serial.println("Joystick Initialization failed. Stopping.");
+    myRobot->board->led_pattern(ledPatternFailure);
+    while(1)
+    {
+      // blink the USER LED to indicate joystick error
+      myRobot->board->tasks();
+    }
+  }
+  myRobot->board->led_pattern(ledPatternSuccess);
+}
+
+// the loop function runs over and over again forever
+void loop() {
+  myRobot->board->tasks();
+  myRobot->reflectance->tasks();    // runs the reflectance routine
+  myRobot->servoarm->tasks();       // runs the servoarm routine
+  myRobot->joystick->tasks();
+  if(myRobot->joystick->is_active())
+  {
+    uint16_t pressed = myRobot->joystick->get_buttons_pressed();
+    bool calibrating = myRobot->reflectance->is_calibrating() || myRobot->servoarm->is_calibrating();
+
+    if ((pressed & JOYSTICK_BUTTON_X) && !calibrating)
+    {
+      myRobot->diffDrive->stop();
+      if (myRobot->reflectance->start_auto_calibration(sweepEffort))
+      {
+        Serial.println("Reflectance auto calibration started");
+      }
+    }
+    if ((pressed & JOYSTICK_BUTTON_Y) && !calibrating)
+    {
+      myRobot->servoarm->start_calibration();
+    }
+    if (pressed & JOYSTICK_BUTTON_DPAD_N)
+    {
+      myRobot->servoarm->calibration_adjust(1);
+    }
+    if (pressed & JOYSTICK_BUTTON_DPAD_S)
+    {
+      myRobot->servoarm->calibration_adjust(-1);
+    }
+    if (pressed & JOYSTICK_BUTTON_A)
+    {
+      myRobot->reflectance->calibration_next();
+      myRobot->servoarm->calibration_next();
+    }
+    if (pressed & JOYSTICK_BUTTON_B)
+    {
+      myRobot->reflectance->cancel_calibration();
+      myRobot->servoarm->cancel_calibration();
+    }
+
+    // the reflectance auto calibration drives the motors itself
+    if (!myRobot->reflectance->is_calibrating())
+    {
+      myRobot->joystick->get_drive_efforts(&leftDriveEffort, &rightDriveEffort);
+      myRobot->diffDrive->set_efforts(leftDriveEffort, rightDriveEffort);
+    }
+  }
+}
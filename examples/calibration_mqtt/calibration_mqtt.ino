@@ -0,0 +1,210 @@
+/*
+  CETALIB Calibration Example: "calibration_mqtt.ino"
+
+  This example runs the calibration routines remotely, over MQTT, at any
+  time. The routines do not block: the robot keeps publishing its line
+  sensor status every second while a routine runs. The new calibration is
+  used and saved (with a single flash write) only when a routine completes.
+  Until then, and if it is cancelled, the previous calibration is used.
+
+  Send one of these commands to the "CETAIoTRobot/in/calibration" topic:
+    REFLECTANCE_AUTO: place the robot in front of a line, facing it. The
+                      robot drives over the line and back, and sets the trip
+                      thresholds from the readings.
+    REFLECTANCE:      USER switch routine (background, then line readings)
+    SERVOARM:         set the HOME, LIFT and DROP arm positions
+    IMU:              gyro offset and gain (CETA IoT Robot only)
+    UP, DOWN:         move the arm 1 degree (servoarm routine)
+    NEXT:             accept/continue (same as pressing the USER switch)
+    CANCEL:           stop the running routine
+
+  The robot publishes "RUNNING" when a routine starts, then "DONE" (new
+  calibration saved) or "NOT SAVED" (cancelled or failed, see the serial
+  terminal) to the "CETAIoTRobot/out/calibration" topic, and the line
+  status (0-7) to "CETAIoTRobot/out/lineStatus" every second.
+
+  Use any MQTT Client app to interact with this demo, for example:
+    - MQTTX (https://mqttx.app/)
+    - IoT MQTT Panel App (download from Google Play or Apple App Store)
+
+  Hardware Configurations Supported:
+
+  CETA IoT Robot (Schematic #14-00069A/B), based on RPI-Pico-WH
+  (Select "Board = Raspberry Pi Pico W")
+
+  Sparkfun XRP Robot Platform (#KIT-27644), based on the RPI RP2350B MCU
+  (Select "Board = SparkFun XRP Controller")
+
+  Sparkfun XRP (Beta) Robot Platform (#KIT-22230), based on the RPI Pico W
+  (Select "Board = SparkFun XRP Controller (Beta)")
+
+  created 19 Oct 2026
+  by dBm Signal Dynamics Inc.
+
+*/
+
+#include <stdio.h>    // needed for "sprintf()" function
+#include <string.h>   // needed for "strcpy()" function
+#include <cetalib.h>
+
+const struct CETALIB_INTERFACE *myRobot = &CETALIB;
+
+// WiFi Parameters
+const char ssid[] = "MY_SSID";        // EDIT
+const char pass[] = "MY_PASSPHRASE";  // EDIT
+
+// MQTT Broker URL, Username, Password
+const char MQTTbroker[] = "broker.emqx.io";
+int MQTTport = 1883;    // EDIT: 1883 for open connection, or 8883 for secure connection
+const char MQTTusername[] = "";
+const char MQTTpassword[] = "";
+
+// MQTT publish topics and payload buffer
+const char calibrationStatusTopic[] = "CETAIoTRobot/out/calibration";
+const char lineStatusTopic[] = "CETAIoTRobot/out/lineStatus";
+char pubPayload[32];
+
+// MQTT subscribe topics
+const char calibrationTopic[] = "CETAIoTRobot/in/calibration";
+const char *subscribeTopicIDs[] = {calibrationTopic};
+int num_subscribeTopicIDs = sizeof(subscribeTopicIDs)/sizeof(subscribeTopicIDs[0]);
+
+// A payload buffer to store the received subscription messages
+char subPayload[256];
+
+// reflectance auto calibration drive effort (slow, so the sensors see the line)
+const float sweepEffort = 0.25f;
+
+unsigned long lineStatusPrevTime;
+const long lineStatusInterval = 1000; // (publish interval in mS)
+bool wasCalibrating = false;
+unsigned long startCommits;           // calibration store commits when the routine started
+
+// Number of calibration store commits (a routine commits its record when it completes)
+unsigned long calstoreCommits(void)
+{
+  CALSTORE_STATS *stats = myRobot->calstore->get_stats();
+  return stats->commits + stats->commitsSkipped;
+}
+
+bool isCalibrating(void)
+{
+  bool calibrating = myRobot->reflectance->is_calibrating() || myRobot->servoarm->is_calibrating();
+  #if defined(ARDUINO_RASPBERRY_PI_PICO_W)
+  calibrating = calibrating || myRobot->imu->is_calibrating();
+  #endif
+  return calibrating;
+}
+
+void processCommand(const char *command)
+{
+  bool started = false;
+  if (0 == strcmp(command, "REFLECTANCE_AUTO"))
+  {
+    started = !isCalibrating() && myRobot->reflectance->start_auto_calibration(sweepEffort);
+  }
+  else if (0 == strcmp(command, "REFLECTANCE"))
+  {
+    started = !isCalibrating() && myRobot->reflectance->start_calibration();
+  }
+  else if (0 == strcmp(command, "SERVOARM"))
+  {
+    started = !isCalibrating() && myRobot->servoarm->start_calibration();
+  }
+  #if defined(ARDUINO_RASPBERRY_PI_PICO_W)
+  else if (0 == strcmp(command, "IMU"))
+  {
+    started = !isCalibrating() && myRobot->imu->start_calibration();
+  }
+  #endif
+  else if (0 == strcmp(command, "UP"))
+  {
+    myRobot->servoarm->calibration_adjust(1);
+  }
+  else if (0 == strcmp(command, "DOWN"))
+  {
+    myRobot->servoarm->calibration_adjust(-1);
+  }
+  else if (0 == strcmp(command, "NEXT"))
+  {
+    myRobot->reflectance->calibration_next();
+    myRobot->servoarm->calibration_next();
+    #if defined(ARDUINO_RASPBERRY_PI_PICO_W)
+    myRobot->imu->calibration_next();
+    #endif
+  }
+  else if (0 == strcmp(command, "CANCEL"))
+  {
+    myRobot->reflectance->cancel_calibration();
+    myRobot->servoarm->cancel_calibration();
+    #if defined(ARDUINO_RASPBERRY_PI_PICO_W)
+    myRobot->imu->cancel_calibration();
+    #endif
+  }
+  if (started)
+  {
+    startCommits = calstoreCommits();
+    strcpy(pubPayload, "RUNNING");
+    myRobot->mqttc->send_message(calibrationStatusTopic, pubPayload);
+  }
+}
+
+void setup() {
+  Serial.begin(115200);
+  delay(2000);
+  myRobot->board->initialize();
+  myRobot->diffDrive->initialize(false, false); // adjust parameters for forward motion in your robot
+  myRobot->reflectance->initialize();
+  myRobot->servoarm->initialize();
+  #if defined(ARDUINO_RASPBERRY_PI_PICO_W)
+  if (!myRobot->imu->initialize())
+  {
+    Serial.println("Failed to initialize IMU!");
+  }
+  #endif
+  // Attempt to connect to AP and Broker
+  if (!myRobot->mqttc->connect(ssid, pass, MQTTbroker, MQTTport, MQTTusername, MQTTpassword, subscribeTopicIDs, num_subscribeTopicIDs))
+  {
+    Serial.println("Failed to initialize MQTT Client!. Stopping.");
+    myRobot->board->led_blink(10);
+    while (1)
+    {
+      myRobot->board->tasks();
+    }
+  }
+}
+
+void loop() {
+  // Run the background tasks and the calibration routines
+  myRobot->mqttc->tasks();
+  myRobot->board->tasks();
+  myRobot->reflectance->tasks();    // runs the reflectance routine
+  myRobot->servoarm->tasks();       // runs the servoarm routine
+  #if defined(ARDUINO_RASPBERRY_PI_PICO_W)
+  myRobot->imu->tasks();    // runs the imu routine
+  #endif
+
+  // Poll/Process a calibration command
+  if (myRobot->mqttc->is_message_available(calibrationTopic))
+  {
+    strcpy(subPayload, myRobot->mqttc->receive_message());
+    processCommand(subPayload);
+  }
+
+  // Report the end of a routine
+  bool calibrating = isCalibrating();
+  if (wasCalibrating && !calibrating)
+  {
+    strcpy(pubPayload, (calstoreCommits() != startCommits) ? "DONE" : "NOT SAVED");
+    myRobot->mqttc->send_message(calibrationStatusTopic, pubPayload);
+  }
+  wasCalibrating = calibrating;
+
+  // Publish the line status every second, also while calibrating
+  if ((millis() - lineStatusPrevTime) >= lineStatusInterval)
+  {
+    lineStatusPrevTime = millis();
+    sprintf(pubPayload, "%d", myRobot->reflectance->get_line_status());
+    myRobot->mqttc->send_message(lineStatusTopic, pubPayload);
+  }
+}
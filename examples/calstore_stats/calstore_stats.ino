@@ -0,0 +1,81 @@
+/*
+  CETALIB "calstore" Library Example: "calstore_stats.ino"
+
+  This example shows how the calibration data of all modules is loaded from
+  flash and saved back to flash.
+
+  The "calstore" module reads the calibration records once, the first time a
+  module is initialized, and keeps them in RAM. A flash write (a 4 KB flash
+  sector erase/program, with interrupts disabled) only happens when a module
+  saves new calibration values, and all changes are saved with a single write.
+
+  After the modules are initialized, the number of flash reads and writes
+  during boot, and the duration of each flash write are displayed on the
+  serial terminal. Hold the USER pushbutton during reset to clear the
+  reflectance calibration and run the calibration procedure again: the clear
+  and the new calibration values are saved with a single flash write.
+
+  Hardware Configurations Supported:
+
+  CETA IoT Robot (Schematic #14-00069A/B), based on RPI-Pico-WH
+  (Select "Board = Raspberry Pi Pico W")
+
+  Sparkfun XRP Robot Platform (#KIT-27644), based on the RPI RP2350B MCU
+  (Select "Board = SparkFun XRP Controller")
+
+  Sparkfun XRP (Beta) Robot Platform (#KIT-22230), based on the RPI Pico W
+  (Select "Board = SparkFun XRP Controller (Beta)")
+
+  created 19 Oct 2026
+  by dBm Signal Dynamics Inc.
+
+*/
+
+#include <stdio.h>    // needed for "sprintf()" function
+#include <cetalib.h>
+
+const struct CETALIB_INTERFACE *myRobot = &CETALIB;
+
+// Define a serial terminal output buffer for messages
+char serialOutBuffer[256];
+
+void setup() {
+  Serial.begin(115200);
+  delay(2000);
+  myRobot->board->initialize();
+  if(0 == myRobot->board->get_button_level())
+  {
+    while(0 == myRobot->board->get_button_level());
+    myRobot->reflectance->clear_calibration();
+  }
+
+  unsigned long startTime = millis();
+  myRobot->reflectance->initialize();
+  myRobot->servoarm->initialize();
+  #if defined(ARDUINO_RASPBERRY_PI_PICO_W)
+  myRobot->diffDrive->initialize(false, false);
+  if (!myRobot->imu->initialize())
+  {
+    Serial.println("Failed to initialize IMU!");
+  }
+  #endif
+  sprintf(serialOutBuffer, "Modules initialized in %lu mS", millis() - startTime);
+  Serial.println(serialOutBuffer);
+  reportStats();
+}
+
+void loop() {
+  // Run the background tasks (also saves deferred calibration changes)
+  myRobot->board->tasks();
+}
+
+void reportStats(void)
+{
+  CALSTORE_STATS *stats = myRobot->calstore->get_stats();
+  sprintf(serialOutBuffer, "Flash reads: %lu  Flash writes: %lu (skipped: %lu)  Last write: %lu uS  Max write: %lu uS",
+          stats->loads, stats->commits, stats->commitsSkipped, stats->lastCommitTime, stats->maxCommitTime);
+  Serial.println(serialOutBuffer);
+  sprintf(serialOutBuffer, "Lifetime flash writes: %lu  CRC errors: %lu  Records adopted from previous version: %lu",
+          stats->lifetimeCommits, stats->crcErrors, stats->migrated);
+  Serial.println(serialOutBuffer);
+}
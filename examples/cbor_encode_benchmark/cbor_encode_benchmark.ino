@@ -0,0 +1,105 @@
+/*
+  CETALIB "cbor" Library Example: "cbor_encode_benchmark.ino"
+
+  This example compares the cost of serializing an IMU telemetry record as a
+  JSON string (using sprintf(), as in "mqttc_pub_sub_imu.ino") against the
+  compact binary CBOR encoding provided by the "cbor" module.
+
+  For each format the sketch reports the average encode time per record (in uS)
+  and the number of payload bytes that would be sent to the broker. The encoded
+  CBOR record is then decoded again to confirm the round trip.
+
+  No network connection is required. Press the USER switch to repeat the test.
+
+  Hardware Configuration:
+
+  CETA IoT Robot (Schematic #14-00069A/B), based on RPI-Pico-WH
+  (Select Board: "Raspberry Pi Pico W")
+  
+  Sparkfun XRP Robot Platform (#KIT-27644), based on the RPI RP2350B MCU
+  (Select Board: "SparkFun XRP Controller")
+
+  Sparkfun XRP (Beta) Robot Platform (#KIT-22230), based on the RPI Pico W
+  (Select "Board = SparkFun XRP Controller (Beta)")
+
+  created 19 Oct 2026
+  by dBm Signal Dynamics Inc.
+
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <cetalib.h>
+
+// define & initialize a pointer to the CETALIB functions
+const struct CETALIB_INTERFACE *myRobot = &CETALIB;
+
+// number of records encoded per measurement
+const int numIterations = 1000;
+
+// JSON and CBOR output buffers
+char jsonBuffer[256];
+uint8_t cborBuffer[32];
+
+void runBenchmark(void)
+{
+  struct CBOR_IMU_RECORD imuRecord;
+  CBOR_RECORD decoded;
+  unsigned long startTime, jsonTime, cborTime;
+  int jsonLength = 0;
+  int cborLength = 0;
+
+  // JSON: sprintf() float formatting, as used by the mqttc examples
+  startTime = micros();
+  for(int i = 0; i < numIterations; i++)
+  {
+    sprintf(jsonBuffer, "{\"imuData\": {\"temperature\": %3.1f, \"heading\": %4.1f}}", 24.5f + (i & 7), 123.4f + i);
+    jsonLength = strlen(jsonBuffer);
+  }
+  jsonTime = micros() - startTime;
+
+  // CBOR: fixed-layout integer record, written straight into cborBuffer
+  startTime = micros();
+  for(int i = 0; i < numIterations; i++)
+  {
+    imuRecord.timestamp = millis();
+    imuRecord.temperature = 24.5f + (i & 7);
+    imuRecord.heading = 123.4f + i;
+    cborLength = myRobot->cbor->encode_imu(cborBuffer, sizeof(cborBuffer), &imuRecord);
+  }
+  cborTime = micros() - startTime;
+
+  Serial.printf("JSON: %6.2f uS/record, %d bytes: %s\r\n", (float)jsonTime / numIterations, jsonLength, jsonBuffer);
+  Serial.printf("CBOR: %6.2f uS/record, %d bytes: ", (float)cborTime / numIterations, cborLength);
+  for(int i = 0; i < cborLength; i++)
+  {
+    Serial.printf("%02x", cborBuffer[i]);
+  }
+  Serial.println();
+
+  // confirm the record decodes back to the original values
+  if(CBOR_RECORD_IMU == myRobot->cbor->decode(cborBuffer, cborLength, &decoded))
+  {
+    Serial.printf("Decoded: timestamp %lu, temperature %.2f, heading %.2f\r\n\r\n",
+                  (unsigned long)decoded.data.imu.timestamp, decoded.data.imu.temperature, decoded.data.imu.heading);
+  }
+  else
+  {
+    Serial.println("Decode failed!\r\n");
+  }
+}
+
+void setup() {
+  Serial.begin(115200);
+  while(!Serial);
+  myRobot->board->initialize();
+  runBenchmark();
+}
+
+void loop() {
+  myRobot->board->tasks();
+  if(myRobot->board->is_button_pressed())
+  {
+    runBenchmark();
+  }
+}
@@ -0,0 +1,160 @@
+/*
+  CETALIB "datalog" Library Example: "datalog_control_rate.ino"
+
+  This example records a simple line follower at its 100 Hz control rate to a
+  log file in flash, for analysis on a PC.
+
+  Each sample holds the left/right motor efforts, the reflectance sensor
+  values, the rangefinder distance and the encoder counts (XRP robots) or
+  the heading (CETA robot). Samples are buffered in RAM and written to flash
+  by board "tasks()", so recording takes a few microseconds per sample.
+
+  Press the USER pushbutton to start following the line and recording. Press
+  it again to stop: the log file is then sent to the serial terminal as hex
+  text. Capture it and convert it to CSV with the decoder utility:
+
+    python cetalib-datalog-decode.py --serial <PORT>
+
+  (see utilities/datalog/README.md). Close the serial monitor of the Arduino
+  IDE first, so the decoder can open the serial port.
+
+  A flash file system must be selected in the Arduino IDE before uploading:
+  "Tools > Flash Size", e.g. "2MB (Sketch: 1MB, FS: 1MB)".
+
+  Hardware Configurations Supported:
+
+  CETA IoT Robot (Schematic #14-00069A/B), based on RPI-Pico-WH
+  (Select "Board = Raspberry Pi Pico W")
+
+  Sparkfun XRP Robot Platform (#KIT-27644), based on the RPI RP2350B MCU
+  (Select "Board = SparkFun XRP Controller")
+
+  Sparkfun XRP (Beta) Robot Platform (#KIT-22230), based on the RPI Pico W
+  (Select "Board = SparkFun XRP Controller (Beta)")
+
+  created 19 Oct 2026
+  by dBm Signal Dynamics Inc.
+
+*/
+
+#include <stdio.h>    // needed for "sprintf()" function
+#include <cetalib.h>
+
+const struct CETALIB_INTERFACE *myRobot = &CETALIB;
+
+const char logFileName[] = "/datalog.bin";
+
+// Line follower parameters
+const float baseEffort = 0.3;
+const float steeringGain = 0.4;
+float leftEffort, rightEffort;
+bool running = false;
+
+// Define control loop interval variables
+unsigned long controlCurrentTime, controlPrevTime;
+const long controlInterval = 10;      // (control interval in mS)
+
+// The rangefinder is slower, measure it every 5th control interval
+int controlCount = 0;
+int distanceChannel;
+
+// Define a serial terminal output buffer for messages
+char serialOutBuffer[256];
+
+// Channel sources: return the value to record at each sample
+float getLeftEffort(void) { return leftEffort; }
+float getRightEffort(void) { return rightEffort; }
+#if defined(ARDUINO_SPARKFUN_XRP_CONTROLLER) || defined(ARDUINO_SPARKFUN_XRP_CONTROLLER_BETA)
+float getLeftCounts(void) { return myRobot->encoder->get_left_position_counts(); }
+float getRightCounts(void) { return myRobot->encoder->get_right_position_counts(); }
+#endif
+
+void setup() {
+  Serial.begin(115200);
+  delay(2000);
+  myRobot->board->initialize();
+  myRobot->diffDrive->initialize(true, true);
+  myRobot->reflectance->initialize();
+  myRobot->rangefinder->initialize();
+  #if defined(ARDUINO_SPARKFUN_XRP_CONTROLLER) || defined(ARDUINO_SPARKFUN_XRP_CONTROLLER_BETA)
+  myRobot->encoder->initialize();
+  #else
+  if (!myRobot->imu->initialize())
+  {
+    Serial.println("Failed to initialize IMU!. Stopping.");
+    while (1);
+  }
+  #endif
+
+  // Define the channels: name, scale (resolution = 1/scale), source
+  myRobot->datalog->add_channel("leftEffort", 1000.0, getLeftEffort);
+  myRobot->datalog->add_channel("rightEffort", 1000.0, getRightEffort);
+  myRobot->datalog->add_channel("leftSensor", 1000.0, myRobot->reflectance->get_left_sensor);
+  myRobot->datalog->add_channel("rightSensor", 1000.0, myRobot->reflectance->get_right_sensor);
+  distanceChannel = myRobot->datalog->add_channel("distance", 10.0, NULL);
+  #if defined(ARDUINO_SPARKFUN_XRP_CONTROLLER) || defined(ARDUINO_SPARKFUN_XRP_CONTROLLER_BETA)
+  myRobot->datalog->add_channel("leftCounts", 1.0, getLeftCounts);
+  myRobot->datalog->add_channel("rightCounts", 1.0, getRightCounts);
+  #else
+  myRobot->datalog->add_channel("heading", 100.0, myRobot->imu->get_heading);
+  #endif
+  Serial.println("Press the USER pushbutton to start");
+}
+
+void loop() {
+  // Run the background tasks (also writes the log buffers to flash)
+  myRobot->board->tasks();
+  #if defined(ARDUINO_RASPBERRY_PI_PICO_W)
+  myRobot->imu->tasks();
+  #endif
+
+  if (myRobot->board->is_button_pressed())
+  {
+    if (!running)
+    {
+      running = myRobot->datalog->start(logFileName);
+      if (!running)
+      {
+        Serial.println("Failed to create the log file! Is a flash file system selected?");
+      }
+    }
+    else
+    {
+      running = false;
+      myRobot->diffDrive->stop();
+      myRobot->datalog->stop();
+      reportStats();
+      myRobot->datalog->dump(logFileName);
+    }
+  }
+
+  controlCurrentTime = millis();
+  if (running && ((controlCurrentTime - controlPrevTime) >= controlInterval))
+  {
+    controlPrevTime = controlCurrentTime;
+
+    // Steer towards the darker sensor
+    float error = myRobot->reflectance->get_left_sensor() - myRobot->reflectance->get_right_sensor();
+    leftEffort = baseEffort - (steeringGain * error);
+    rightEffort = baseEffort + (steeringGain * error);
+    myRobot->diffDrive->set_efforts(leftEffort, rightEffort);
+
+    if (++controlCount >= 5)
+    {
+      controlCount = 0;
+      myRobot->datalog->update(distanceChannel, myRobot->rangefinder->get_distance());
+    }
+
+    // Record all channels
+    myRobot->datalog->sample();
+  }
+}
+
+void reportStats(void)
+{
+  DATALOG_STATS *stats = myRobot->datalog->get_stats();
+  sprintf(serialOutBuffer, "samples: %lu  dropped: %lu  bytes/sample: %.1f  blocks: %lu  max write: %lu uS",
+          stats->samples, stats->samplesDropped, stats->samples ? (float)stats->encodedBytes / stats->samples : 0.0,
+          stats->blocksWritten, stats->maxWriteTime);
+  Serial.println(serialOutBuffer);
+}
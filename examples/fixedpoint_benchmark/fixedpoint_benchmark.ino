@@ -0,0 +1,246 @@
+/*
+  CETALIB Fixed-Point API Example: "fixedpoint_benchmark.ino"
+
+  This example compares the CPU cycles used by the float API and the
+  fixed-point (Q15/Q16) API of the "motor", "reflectance", "encoder" and
+  "joystick" modules.
+
+  The RP2040 (CETA IoT Robot, XRP Beta) has no FPU: every float add, multiply,
+  divide and float/int conversion is a software library call. The RP2350 (XRP)
+  has an FPU, so the savings there are much smaller.
+
+  Two sets of results are displayed (cycles per call, minimum of 5 runs):
+    - conversion math: the float math the modules used before the fixed-point
+      API (copied below), against the integer math they use now
+    - API calls: each float function (a thin wrapper) against its "_q15" or
+      "_q16" function, including the hardware access (PWM, ADC, PIO)
+
+  Q15 values are "value x 32768" (efforts -1.0 to 1.0, sensors 0.0 to 1.0),
+  Q16 values are "value x 65536" (encoder positions in revolutions).
+
+  The motors are driven at low effort during the "motor" API measurement, so
+  place the robot on a stand with the wheels off the ground. Press the USER
+  switch to repeat the test.
+
+  Hardware Configurations Supported:
+
+  CETA IoT Robot (Schematic #14-00069A/B), based on RPI-Pico-WH
+  (Select "Board = Raspberry Pi Pico W")
+
+  Sparkfun XRP Robot Platform (#KIT-27644), based on the RPI RP2350B MCU
+  (Select "Board = SparkFun XRP Controller")
+
+  Sparkfun XRP (Beta) Robot Platform (#KIT-22230), based on the RPI Pico W
+  (Select "Board = SparkFun XRP Controller (Beta)")
+
+  created 19 Oct 2026
+  by dBm Signal Dynamics Inc.
+
+*/
+
+#include <cetalib.h>
+
+// define & initialize a pointer to the CETALIB functions
+const struct CETALIB_INTERFACE *myRobot = &CETALIB;
+
+// calls per measurement, and measurements per result (the fastest is kept)
+const int numIterations = 1000;
+const int numRuns = 5;
+
+// test inputs and result sinks are volatile, so the compiler can not
+// precompute the results or remove the loops
+volatile float effortIn[8] = {0.25f, -0.25f, 0.1f, -0.1f, 0.2f, -0.2f, 0.05f, -0.05f};
+volatile q15_t effortInQ15[8];
+volatile int adcIn[8] = {310, 3020, 1875, 4095, 0, 2999, 512, 2048};
+volatile int countsIn[8] = {0, 585, -1170, 123456, -98765, 42, 7, -3};
+volatile uint8_t stickIn[8] = {0, 255, 128, 125, 64, 192, 131, 1};
+volatile int32_t sinkInt;
+volatile float sinkFloat;
+
+// trip threshold used by the line detection comparison
+const float tripFloat = 0.733f;
+const int32_t tripQ15 = (int32_t)(0.733f * 32768.0f);
+
+typedef void (*BENCH_FUNCTION)(int i);
+
+/*** conversion math: float (as before the fixed-point API) ***/
+
+void motorDutyFloat(int i)
+{
+  float effort = effortIn[i & 7];
+  if (effort < 0) effort = -effort;
+  sinkInt = int((1 - effort) * 1000);
+}
+
+void lineDetectFloat(int i)
+{
+  sinkInt = ((adcIn[i & 7] / 4096.0f) > tripFloat);
+}
+
+void encoderPositionFloat(int i)
+{
+  sinkFloat = countsIn[i & 7] / 585.0;
+}
+
+void tankEffortFloat(int i)
+{
+  float effort = (128.0 - (float)stickIn[i & 7]) / 128.0;
+  if (abs(effort) < 0.05) effort = 0.0;
+  sinkFloat = effort;
+}
+
+/*** conversion math: fixed-point (as used by the modules now) ***/
+
+void motorDutyQ15(int i)
+{
+  q15_t effort = effortInQ15[i & 7];
+  if (effort < 0) effort = -effort;
+  sinkInt = 1000 - q15_scale(effort, 1000);
+}
+
+void lineDetectQ15(int i)
+{
+  sinkInt = ((adcIn[i & 7] << 3) > tripQ15);
+}
+
+void encoderPositionQ16(int i)
+{
+  int count = countsIn[i & 7];
+  sinkInt = (count / 585) * 65536 + ((count % 585) * 65536 + ((count < 0) ? -292 : 292)) / 585;
+}
+
+void tankEffortQ15(int i)
+{
+  int32_t effort = (128 - stickIn[i & 7]) * 256;
+  if (abs(effort) < 1639) effort = 0;
+  sinkInt = q15_saturate(effort);
+}
+
+/*** API calls ***/
+
+void motorApiFloat(int i)
+{
+  myRobot->motor->set_efforts(effortIn[i & 7], effortIn[(i + 1) & 7]);
+}
+
+void motorApiQ15(int i)
+{
+  myRobot->motor->set_efforts_q15(effortInQ15[i & 7], effortInQ15[(i + 1) & 7]);
+}
+
+void reflectanceApiFloat(int i)
+{
+  sinkFloat = myRobot->reflectance->get_left_sensor() - myRobot->reflectance->get_right_sensor();
+}
+
+void reflectanceApiQ15(int i)
+{
+  sinkInt = myRobot->reflectance->get_left_sensor_q15() - myRobot->reflectance->get_right_sensor_q15();
+}
+
+#if defined(ARDUINO_SPARKFUN_XRP_CONTROLLER) || defined(ARDUINO_SPARKFUN_XRP_CONTROLLER_BETA)
+void encoderApiFloat(int i)
+{
+  sinkFloat = myRobot->encoder->get_left_position();
+}
+
+void encoderApiQ16(int i)
+{
+  sinkInt = myRobot->encoder->get_left_position_q16();
+}
+#endif
+
+void joystickApiFloat(int i)
+{
+  float left, right;
+  myRobot->joystick->get_drive_efforts(&left, &right);
+  sinkFloat = left + right;
+}
+
+void joystickApiQ15(int i)
+{
+  q15_t left, right;
+  myRobot->joystick->get_drive_efforts_q15(&left, &right);
+  sinkInt = left + right;
+}
+
+void emptyBench(int i)
+{
+  sinkInt = i;
+}
+
+// Cycles per call of "function", minus the loop overhead
+float measureCycles(BENCH_FUNCTION function, uint32_t overhead)
+{
+  uint32_t best = 0xFFFFFFFF;
+  for (int run = 0; run < numRuns; run++)
+  {
+    uint32_t startCycles = rp2040.getCycleCount();
+    for (int i = 0; i < numIterations; i++)
+    {
+      function(i);
+    }
+    uint32_t cycles = rp2040.getCycleCount() - startCycles;
+    if (cycles < best)
+    {
+      best = cycles;    // the fastest run was not interrupted
+    }
+  }
+  return (float)(int32_t)(best - overhead) / numIterations;
+}
+
+void report(const char *name, BENCH_FUNCTION floatFunction, BENCH_FUNCTION fixedFunction, uint32_t overhead)
+{
+  float floatCycles = measureCycles(floatFunction, overhead);
+  float fixedCycles = measureCycles(fixedFunction, overhead);
+  Serial.printf("%-28s %8.1f %8.1f %6.1fx\r\n", name, floatCycles, fixedCycles,
+                (fixedCycles > 0.0f) ? (floatCycles / fixedCycles) : 0.0f);
+}
+
+void runBenchmark(void)
+{
+  // loop and call overhead, subtracted from every measurement
+  uint32_t overhead = (uint32_t)(measureCycles(emptyBench, 0) * numIterations);
+
+  Serial.printf("CPU clock: %lu MHz, cycles per call (loop overhead removed)\r\n", (unsigned long)(rp2040.f_cpu() / 1000000));
+  Serial.printf("%-28s %8s %8s %7s\r\n", "conversion math", "float", "Q15/Q16", "speedup");
+  report("motor effort to PWM duty", motorDutyFloat, motorDutyQ15, overhead);
+  report("line detection compare", lineDetectFloat, lineDetectQ15, overhead);
+  report("encoder counts to revs", encoderPositionFloat, encoderPositionQ16, overhead);
+  report("joystick tank effort", tankEffortFloat, tankEffortQ15, overhead);
+
+  Serial.printf("%-28s %8s %8s %7s\r\n", "API calls", "float", "Q15/Q16", "speedup");
+  report("motor->set_efforts", motorApiFloat, motorApiQ15, overhead);
+  myRobot->motor->set_efforts_q15(0, 0);
+  report("reflectance left - right", reflectanceApiFloat, reflectanceApiQ15, overhead);
+  #if defined(ARDUINO_SPARKFUN_XRP_CONTROLLER) || defined(ARDUINO_SPARKFUN_XRP_CONTROLLER_BETA)
+  report("encoder->get_left_position", encoderApiFloat, encoderApiQ16, overhead);
+  #endif
+  report("joystick->get_drive_efforts", joystickApiFloat, joystickApiQ15, overhead);
+  Serial.println();
+}
+
+void setup() {
+  Serial.begin(115200);
+  while(!Serial);
+  myRobot->board->initialize();
+  myRobot->motor->initialize(false, false);
+  #if defined(ARDUINO_SPARKFUN_XRP_CONTROLLER) || defined(ARDUINO_SPARKFUN_XRP_CONTROLLER_BETA)
+  myRobot->encoder->initialize();
+  #endif
+  // the reflectance sensors are read without "initialize()" (no calibration is needed to time them)
+  analogReadResolution(12);
+  for (int i = 0; i < 8; i++)
+  {
+    effortInQ15[i] = q15_from_float(effortIn[i]);
+  }
+  runBenchmark();
+}
+
+void loop() {
+  myRobot->board->tasks();
+  if(myRobot->board->is_button_pressed())
+  {
+    runBenchmark();
+  }
+}
@@ -0,0 +1,229 @@
+/*
+  CETALIB "joystick" Library Example: "joystick_decode_benchmark.ino"
+
+  This example measures the CPU cycles the "joystick" module spends on each
+  received gamepad packet, before and after the zero-formatting ingest path.
+
+    - before: the client IP was formatted into a String for every packet, and
+      the 8-byte report was decoded with one if/else chain per button
+    - after: the binary client IPAddress is copied (get_data() formats it
+      only when it changes), the buttons are packed into a button word with
+      shifts and a D-Pad table, and the pressed/released edges are updated
+
+  Both ingest paths are copied below from the "joystick" module, so no PC
+  client or WiFi connection is needed: they decode a fixed set of reports.
+  The API calls a sketch makes after each packet (get_data() and
+  get_buttons_pressed()) are measured on the library itself.
+
+  Results are cycles per packet (minimum of 5 runs, loop overhead removed).
+  Press the USER switch to repeat the test.
+
+  Hardware Configurations Supported:
+
+  CETA IoT Robot (Schematic #14-00069A/B), based on RPI-Pico-WH
+  (Select "Board = Raspberry Pi Pico W")
+
+  Sparkfun XRP Robot Platform (#KIT-27644), based on the RPI RP2350B MCU
+  (Select "Board = SparkFun XRP Controller")
+
+  Sparkfun XRP (Beta) Robot Platform (#KIT-22230), based on the RPI Pico W
+  (Select "Board = SparkFun XRP Controller (Beta)")
+
+  created 19 Oct 2026
+  by dBm Signal Dynamics Inc.
+
+*/
+
+#include <stdio.h>              // needed for "sprintf()" function
+#include <hardware/sync.h>      // needed for the button edge spin lock
+#include <cetalib.h>
+
+// define & initialize a pointer to the CETALIB functions
+const struct CETALIB_INTERFACE *myRobot = &CETALIB;
+
+// packets per measurement, and measurements per result (the fastest is kept)
+const int numIterations = 1000;
+const int numRuns = 5;
+
+// test reports: sticks moving, D-Pad, action buttons, bumpers/triggers, back/start
+const uint8_t reports[8][8] = {
+  {128, 128, 128, 128,   8, 0x00, 0, 0},
+  {200,  60, 128, 128,   8, 0x00, 0, 0},
+  {128, 128, 140,  10,   0, 0x00, 0, 0},
+  {128, 128, 128, 128,  0x28, 0x00, 0, 0},
+  { 10, 250,  30, 128,   6, 0x05, 0, 0},
+  {128, 128, 128, 128, 0xF8, 0x0A, 0, 0},
+  {255,   0, 255,   0,   4, 0x30, 0, 0},
+  {128, 128, 128, 128,   2, 0x3F, 0, 0},
+};
+IPAddress remoteIP(192, 168, 42, 16);
+const unsigned int remotePort = 50123;
+
+// decode results (globals, so the compiler can not remove the stores)
+GAMEPAD gamepad;
+volatile uint16_t sinkButtons;
+
+typedef void (*BENCH_FUNCTION)(int i);
+
+/*** before: String formatting and if/else chains ***/
+
+void ingestBefore(int i)
+{
+  const uint8_t *packetBuffer = reports[i & 7];
+  GAMEPAD *g = &gamepad;
+
+  // save the remote client IP and port
+  sprintf(g->clientIP, "%s", remoteIP.toString().c_str());
+  g->clientPort = remotePort;
+
+  // gamepad raw bytes and joysticks
+  for (int k = 0; k < 8; k++)
+  {
+    g->gamepadRaw[k] = packetBuffer[k];
+  }
+  g->leftStickX = packetBuffer[0];
+  g->leftStickY = packetBuffer[1];
+  g->rightStickX = packetBuffer[2];
+  g->rightStickY = packetBuffer[3];
+
+  // dPad buttons
+  if(packetBuffer[4] == 8){ g->dPad.isNeutral = true; } else{ g->dPad.isNeutral = false; }
+  if(packetBuffer[4] == 0){ g->dPad.isNorthPressed = true; } else{ g->dPad.isNorthPressed = false; }
+  if(packetBuffer[4] == 2){ g->dPad.isEastPressed = true; } else{ g->dPad.isEastPressed = false; }
+  if(packetBuffer[4] == 4){ g->dPad.isSouthPressed = true; } else{ g->dPad.isSouthPressed = false; }
+  if(packetBuffer[4] == 6){ g->dPad.isWestPressed = true; } else{ g->dPad.isWestPressed = false; }
+
+  // action, trigger, bumper, back and start buttons
+  if(packetBuffer[4] & 32){ g->actionButtons.isAPressed = true; } else{ g->actionButtons.isAPressed = false; }
+  if(packetBuffer[4] & 64){ g->actionButtons.isBPressed = true; } else{ g->actionButtons.isBPressed = false; }
+  if(packetBuffer[4] & 16){ g->actionButtons.isXPressed = true; } else{ g->actionButtons.isXPressed = false; }
+  if(packetBuffer[4] & 128){ g->actionButtons.isYPressed = true; } else{ g->actionButtons.isYPressed = false; }
+  if(packetBuffer[5] & 4){ g->triggerButtons.isLeftTriggerPressed = true; } else{ g->triggerButtons.isLeftTriggerPressed = false; }
+  if(packetBuffer[5] & 8){ g->triggerButtons.isRightTriggerPressed = true; } else{ g->triggerButtons.isRightTriggerPressed = false; }
+  if(packetBuffer[5] & 1){ g->bumperButtons.isLeftBumperPressed = true; } else{ g->bumperButtons.isLeftBumperPressed = false; }
+  if(packetBuffer[5] & 2){ g->bumperButtons.isRightBumperPressed = true; } else{ g->bumperButtons.isRightBumperPressed = false; }
+  if(packetBuffer[5] & 16){ g->isBackPressed = true; } else{ g->isBackPressed = false; }
+  if(packetBuffer[5] & 32){ g->isStartPressed = true; } else{ g->isStartPressed = false; }
+}
+
+/*** after: binary address, packed button word, edge tracking ***/
+
+const uint16_t dPadTable[16] = {
+  JOYSTICK_BUTTON_DPAD_N, 0, JOYSTICK_BUTTON_DPAD_E, 0,
+  JOYSTICK_BUTTON_DPAD_S, 0, JOYSTICK_BUTTON_DPAD_W, 0,
+  0, 0, 0, 0, 0, 0, 0, 0
+};
+uint16_t edgeButtons;
+volatile uint16_t buttonsPressed;
+volatile uint16_t buttonsReleased;
+
+void ingestAfter(int i)
+{
+  const uint8_t *report = reports[i & 7];
+  GAMEPAD *g = &gamepad;
+
+  // save the remote client address and port (clientIP is formatted by get_data())
+  g->clientAddress = remoteIP;
+  g->clientPort = remotePort;
+
+  memcpy(g->gamepadRaw, report, 8);
+  g->leftStickX = report[0];
+  g->leftStickY = report[1];
+  g->rightStickX = report[2];
+  g->rightStickY = report[3];
+
+  uint16_t buttons = (uint16_t)(report[4] >> 4) | ((uint16_t)(report[5] & 0x3F) << 4) | dPadTable[report[4] & 0x0F];
+
+  // pressed/released edges, under the spin lock
+  uint16_t changed = buttons ^ edgeButtons;
+  spin_lock_t *lock = spin_lock_instance(PICO_SPINLOCK_ID_STRIPED_FIRST);
+  uint32_t irqState = spin_lock_blocking(lock);
+  buttonsPressed |= changed & buttons;
+  buttonsReleased |= changed & ~buttons;
+  spin_unlock(lock, irqState);
+  edgeButtons = buttons;
+  g->buttons = buttons;
+
+  g->dPad.isNeutral = ((report[4] & 0x0F) == 8);
+  g->dPad.isNorthPressed = (buttons & JOYSTICK_BUTTON_DPAD_N) != 0;
+  g->dPad.isEastPressed = (buttons & JOYSTICK_BUTTON_DPAD_E) != 0;
+  g->dPad.isSouthPressed = (buttons & JOYSTICK_BUTTON_DPAD_S) != 0;
+  g->dPad.isWestPressed = (buttons & JOYSTICK_BUTTON_DPAD_W) != 0;
+  g->actionButtons.isAPressed = (buttons & JOYSTICK_BUTTON_A) != 0;
+  g->actionButtons.isBPressed = (buttons & JOYSTICK_BUTTON_B) != 0;
+  g->actionButtons.isXPressed = (buttons & JOYSTICK_BUTTON_X) != 0;
+  g->actionButtons.isYPressed = (buttons & JOYSTICK_BUTTON_Y) != 0;
+  g->triggerButtons.isLeftTriggerPressed = (buttons & JOYSTICK_BUTTON_LT) != 0;
+  g->triggerButtons.isRightTriggerPressed = (buttons & JOYSTICK_BUTTON_RT) != 0;
+  g->bumperButtons.isLeftBumperPressed = (buttons & JOYSTICK_BUTTON_LB) != 0;
+  g->bumperButtons.isRightBumperPressed = (buttons & JOYSTICK_BUTTON_RB) != 0;
+  g->isBackPressed = (buttons & JOYSTICK_BUTTON_BACK) != 0;
+  g->isStartPressed = (buttons & JOYSTICK_BUTTON_START) != 0;
+}
+
+/*** API calls after each packet ***/
+
+void getDataApi(int i)
+{
+  sinkButtons = myRobot->joystick->get_data()->buttons;    // client IP unchanged: no formatting
+}
+
+void buttonsPressedApi(int i)
+{
+  sinkButtons = myRobot->joystick->get_buttons_pressed();
+}
+
+void emptyBench(int i)
+{
+  sinkButtons = i;
+}
+
+// Cycles per call of "function", minus the loop overhead
+float measureCycles(BENCH_FUNCTION function, uint32_t overhead)
+{
+  uint32_t best = 0xFFFFFFFF;
+  for (int run = 0; run < numRuns; run++)
+  {
+    uint32_t startCycles = rp2040.getCycleCount();
+    for (int i = 0; i < numIterations; i++)
+    {
+      function(i);
+    }
+    uint32_t cycles = rp2040.getCycleCount() - startCycles;
+    if (cycles < best)
+    {
+      best = cycles;    // the fastest run was not interrupted
+    }
+  }
+  return (float)(int32_t)(best - overhead) / numIterations;
+}
+
+void runBenchmark(void)
+{
+  // loop and call overhead, subtracted from every measurement
+  uint32_t overhead = (uint32_t)(measureCycles(emptyBench, 0) * numIterations);
+
+  float before = measureCycles(ingestBefore, overhead);
+  float after = measureCycles(ingestAfter, overhead);
+  Serial.printf("CPU clock: %lu MHz, cycles per packet (loop overhead removed)\r\n", (unsigned long)(rp2040.f_cpu() / 1000000));
+  Serial.printf("%-36s %8.1f\r\n", "ingest before (String IP, if/else)", before);
+  Serial.printf("%-36s %8.1f  (%.1fx faster)\r\n", "ingest after (IPAddress, packed)", after, (after > 0.0f) ? (before / after) : 0.0f);
+  Serial.printf("%-36s %8.1f\r\n", "joystick->get_data()", measureCycles(getDataApi, overhead));
+  Serial.printf("%-36s %8.1f\r\n", "joystick->get_buttons_pressed()", measureCycles(buttonsPressedApi, overhead));
+  Serial.println();
+}
+
+void setup() {
+  Serial.begin(115200);
+  while(!Serial);
+  myRobot->board->initialize();
+  runBenchmark();
+}
+
+void loop() {
+  myRobot->board->tasks();
+  if(myRobot->board->is_button_pressed())
+  {
+    runBenchmark();
+  }
+}
@@ -0,0 +1,109 @@
+/*
+  CETALIB "joystick" Library Example: "joystick_drive_modes.ino"
+
+  Drive the robot with the joystick drive mixer.
+
+  get_drive_efforts() returns both motor efforts from a single call, using
+  stick response curves that are computed once in setup():
+    - deadzone: stick movement ignored around center
+    - expo: 0.0 = linear, 1.0 = cubic (fine control near center)
+    - rate: maximum effort at full stick
+
+  Press "Start" to cycle through the drive modes:
+    ARCADE:     Left Stick Y = throttle, Right Stick X = turn
+    TANK:       Left Stick Y = left motor, Right Stick Y = right motor
+    CURVATURE:  Left Stick Y = throttle, Right Stick X = turn (turn rate follows
+                speed, spin in place when the throttle is centered)
+
+  Press "Back" to toggle a "precision" curve (expo + reduced rate).
+
+  Hardware Configuration:
+
+  Windows/MacOS PC with Logitech F310 Gamepad connected in "D" mode.
+  Follow the provided instructions for running the gamepad python script on your PC.
+
+  CETA IoT Robot (Schematic #14-00069A/B), based on RPI-Pico-WH
+  (Select Board: "Raspberry Pi Pico W")
+
+  Sparkfun XRP Robot Platform (#KIT-27644), based on the RPI RP2350B MCU
+  (Select Board: "SparkFun XRP Controller")
+
+  Sparkfun XRP (Beta) Robot Platform (#KIT-22230), based on the RPI Pico W
+  (Select "Board = SparkFun XRP Controller (Beta)")
+
+  created 19 Oct 2026
+  by dBm Signal Dynamics Inc.
+
+*/
+
+#include <cetalib.h>
+
+// define & initialize a pointer to the CETALIB functions
+const struct CETALIB_INTERFACE *myRobot = &CETALIB;
+
+// define motor effort parameters
+float leftDriveEffort, rightDriveEffort;
+
+// drive mode and curve selection
+enum JOYSTICK_DRIVE_MODE driveMode = JOYSTICK_DRIVE_ARCADE;
+const char *driveModeNames[] = {"ARCADE", "TANK", "CURVATURE"};
+bool precisionCurve = false;
+
+// define USER LED blink patterns for joystick initialization status
+int ledPatternSuccess = 1;    // 1 blink per second on successful init
+int ledPatternFailure = 5;    // 5 blinks per second on failed init
+
+// the setup function runs once when you press reset or power the board
+void setup() {
+  Serial.begin(115200);
+  delay(5000);
+  myRobot->board->initialize();
+  myRobot->diffDrive->initialize(false, false); // adjust parameters for forward motion in your robot
+  if(!myRobot->joystick->initialize())
+  {
+    Serial.println("Joystick Initialization failed. Stopping.");
+    myRobot->board->led_pattern(ledPatternFailure);
+    while(1)
+    {
+      // blink the USER LED to indicate joystick error
+      myRobot->board->tasks();
+    }
+  }
+  myRobot->joystick->set_drive_mode(driveMode);
+  myRobot->board->led_pattern(ledPatternSuccess);
+}
+
+// the loop function runs over and over again forever
+void loop() {
+  myRobot->board->tasks();
+  myRobot->joystick->tasks();
+  if(myRobot->joystick->is_active())
+  {
+    uint16_t pressed = myRobot->joystick->get_buttons_pressed();
+    if (pressed & JOYSTICK_BUTTON_START)
+    {
+      driveMode = (enum JOYSTICK_DRIVE_MODE)((driveMode + 1) % 3);
+      myRobot->joystick->set_drive_mode(driveMode);
+      Serial.printf("Drive mode: %s\r\n", driveModeNames[driveMode]);
+    }
+    if (pressed & JOYSTICK_BUTTON_BACK)
+    {
+      precisionCurve = !precisionCurve;
+      if (precisionCurve)
+      {
+        // deadzone, expo, rate
+        myRobot->joystick->set_throttle_curve(0.05, 0.6, 0.6);
+        myRobot->joystick->set_turn_curve(0.05, 0.6, 0.4);
+      }
+      else
+      {
+        myRobot->joystick->set_throttle_curve(0.05, 0.0, 1.0);
+        myRobot->joystick->set_turn_curve(0.05, 0.0, 1.0);
+      }
+      Serial.printf("Precision curve: %s\r\n", precisionCurve ? "ON" : "OFF");
+    }
+
+    myRobot->joystick->get_drive_efforts(&leftDriveEffort, &rightDriveEffort);
+    myRobot->diffDrive->set_efforts(leftDriveEffort, rightDriveEffort);
+  }
+}
@@ -0,0 +1,99 @@
+/*
+  CETALIB "joystick" Library Example: "joystick_failsafe.ino"
+
+  Tank drive with the joystick link-loss failsafe.
+
+  If the robot stops receiving gamepad reports (PC client closed, gamepad
+  unplugged, robot out of WiFi range) for longer than the failsafe timeout,
+  the joystick data returns to neutral and the drive motors are ramped down to
+  a stop. The failsafe runs from a hardware timer, so it also stops the robot
+  when the sketch loop is blocked.
+
+  Hold the "A" button to block the loop for 3 seconds and watch the robot stop
+  on its own. The link state and the number of failsafe trips are displayed on
+  the serial terminal.
+
+  Hardware Configuration:
+
+  Windows/MacOS PC with Logitech F310 Gamepad connected in "D" mode.
+  Follow the provided instructions for running the gamepad python script on your PC.
+
+  CETA IoT Robot (Schematic #14-00069A/B), based on RPI-Pico-WH
+  (Select Board: "Raspberry Pi Pico W")
+
+  Sparkfun XRP Robot Platform (#KIT-27644), based on the RPI RP2350B MCU
+  (Select Board: "SparkFun XRP Controller")
+
+  Sparkfun XRP (Beta) Robot Platform (#KIT-22230), based on the RPI Pico W
+  (Select "Board = SparkFun XRP Controller (Beta)")
+
+  created 19 Oct 2026
+  by dBm Signal Dynamics Inc.
+
+*/
+
+#include <cetalib.h>
+
+// define & initialize a pointer to the CETALIB functions
+const struct CETALIB_INTERFACE *myRobot = &CETALIB;
+
+// define a pointer to the captured gamepad data
+GAMEPAD* joystick_data;
+
+// link-loss timeout (in mS)
+const unsigned long failsafeTimeout = 300;    // EDIT
+
+// track link state changes
+enum JOYSTICK_LINK_STATE linkState = JOYSTICK_LINK_WAITING;
+const char *linkStateNames[] = {"WAITING", "UP", "LOST"};
+
+// define USER LED blink patterns for joystick initialization status
+int ledPatternSuccess = 1;    // 1 blink per second on successful init
+int ledPatternFailure = 5;    // 5 blinks per second on failed init
+
+// the setup function runs once when you press reset or power the board
+void setup() {
+  Serial.begin(115200);
+  delay(5000);
+  myRobot->board->initialize();
+  myRobot->diffDrive->initialize(false, false); // adjust parameters for forward motion in your robot
+  if(!myRobot->joystick->initialize())
+  {
+    Serial.println("Joystick Initialization failed. Stopping.");
+    myRobot->board->led_pattern(ledPatternFailure);
+    while(1)
+    {
+      // blink the USER LED to indicate joystick error
+      myRobot->board->tasks();
+    }
+  }
+  myRobot->joystick->set_failsafe_timeout(failsafeTimeout);
+  myRobot->board->led_pattern(ledPatternSuccess);
+}
+
+// the loop function runs over and over again forever
+void loop() {
+  myRobot->board->tasks();
+  myRobot->joystick->tasks();
+
+  // report link state changes
+  enum JOYSTICK_LINK_STATE newLinkState = myRobot->joystick->get_link_state();
+  if (newLinkState != linkState)
+  {
+    linkState = newLinkState;
+    Serial.printf("Joystick link %s (failsafe trips: %lu)\r\n", linkStateNames[linkState], myRobot->joystick->get_stats()->failsafeTrips);
+  }
+
+  if(myRobot->joystick->is_active())
+  {
+    joystick_data = myRobot->joystick->get_data();
+    if (joystick_data->actionButtons.isAPressed)
+    {
+      // simulate a blocked loop: the failsafe stops the motors while we wait here
+      Serial.println("Blocking the loop for 3 seconds...");
+      delay(3000);
+      return;
+    }
+    myRobot->diffDrive->set_efforts(myRobot->joystick->get_left_tank_effort(), myRobot->joystick->get_right_tank_effort());
+  }
+}
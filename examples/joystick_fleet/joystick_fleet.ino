@@ -0,0 +1,80 @@
+/*
+  CETALIB "joystick" Library Example: "joystick_fleet.ino"
+
+  Arcade drive in joystick "fleet mode".
+
+  Instead of starting its own WiFi Access Point, the robot joins a shared
+  classroom network and only accepts gamepad packets carrying its robot ID.
+  One PC with several F310 gamepads drives the whole fleet:
+
+    python cetalib-joystick-client.py --fleet 1 2 3
+
+  Upload this sketch to every robot with a different "robotId". The robot IP
+  address is displayed on the serial terminal (use it with "--fleet ID@IP" to
+  send packets directly to each robot).
+
+  Hardware Configuration:
+
+  Windows/MacOS PC with Logitech F310 Gamepads connected in "D" mode.
+  Follow the provided instructions for running the gamepad python script on your PC.
+
+  CETA IoT Robot (Schematic #14-00069A/B), based on RPI-Pico-WH
+  (Select Board: "Raspberry Pi Pico W")
+
+  Sparkfun XRP Robot Platform (#KIT-27644), based on the RPI RP2350B MCU
+  (Select Board: "SparkFun XRP Controller")
+
+  Sparkfun XRP (Beta) Robot Platform (#KIT-22230), based on the RPI Pico W
+  (Select "Board = SparkFun XRP Controller (Beta)")
+
+  created 19 Oct 2026
+  by dBm Signal Dynamics Inc.
+
+*/
+
+#include <cetalib.h>
+
+// define & initialize a pointer to the CETALIB functions
+const struct CETALIB_INTERFACE *myRobot = &CETALIB;
+
+// Shared WiFi network and robot ID
+const char ssid[] = "CLASSROOM_SSID";         // EDIT
+const char pass[] = "CLASSROOM_PASSPHRASE";   // EDIT
+const uint8_t robotId = 1;                    // EDIT: unique for every robot (1-255)
+
+// define motor effort parameters
+float leftDriveEffort, rightDriveEffort;
+
+// define USER LED blink patterns for joystick initialization status
+int ledPatternSuccess = 1;    // 1 blink per second on successful init
+int ledPatternFailure = 5;    // 5 blinks per second on failed init
+
+// the setup function runs once when you press reset or power the board
+void setup() {
+  Serial.begin(115200);
+  delay(5000);
+  myRobot->board->initialize();
+  myRobot->diffDrive->initialize(false, false); // adjust parameters for forward motion in your robot
+  if(!myRobot->joystick->initialize_fleet(ssid, pass, robotId))
+  {
+    Serial.println("Joystick fleet initialization failed. Stopping.");
+    myRobot->board->led_pattern(ledPatternFailure);
+    while(1)
+    {
+      // blink the USER LED to indicate joystick error
+      myRobot->board->tasks();
+    }
+  }
+  myRobot->board->led_pattern(ledPatternSuccess);
+}
+
+// the loop function runs over and over again forever
+void loop() {
+  myRobot->board->tasks();
+  myRobot->joystick->tasks();
+  if(myRobot->joystick->is_active())
+  {
+    myRobot->joystick->get_drive_efforts(&leftDriveEffort, &rightDriveEffort);
+    myRobot->diffDrive->set_efforts(leftDriveEffort, rightDriveEffort);
+  }
+}
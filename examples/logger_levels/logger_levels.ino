@@ -0,0 +1,72 @@
+/*
+  CETALIB "logger" Library Example: "logger_levels.ino"
+
+  This example shows how to use the CETALIB_LOG_xxx() macros in a sketch.
+
+  Log messages are queued and sent to the serial terminal by the board "tasks()"
+  function, so logging does not slow down the main loop. Messages above the
+  compile-time log level are removed completely by the compiler.
+
+  Defining CETALIB_LOG_LEVEL before including <cetalib.h> sets the log level for
+  this sketch only. To change the log level of the library modules (e.g. to
+  hide the "mqttc" connection messages), edit CETALIB_LOG_LEVEL in
+  "src/modules/logger_interface.h", or add a build flag:
+  "-DCETALIB_LOG_LEVEL=CETALIB_LOG_LEVEL_WARN"
+
+  Pressing the USER pushbutton logs a burst of 40 messages. Only 16 messages can
+  be queued, so some are discarded and counted.
+
+  Hardware Configurations Supported:
+
+  CETA IoT Robot (Schematic #14-00069A/B), based on RPI-Pico-WH
+  (Select "Board = Raspberry Pi Pico W")
+
+  Sparkfun XRP Robot Platform (#KIT-27644), based on the RPI RP2350B MCU
+  (Select "Board = SparkFun XRP Controller")
+
+  Sparkfun XRP (Beta) Robot Platform (#KIT-22230), based on the RPI Pico W
+  (Select "Board = SparkFun XRP Controller (Beta)")
+
+  created 19 Oct 2026
+  by dBm Signal Dynamics Inc.
+
+*/
+
+#define CETALIB_LOG_LEVEL CETALIB_LOG_LEVEL_DEBUG   // EDIT: log level for this sketch
+#include <cetalib.h>
+
+const struct CETALIB_INTERFACE *myRobot = &CETALIB;
+
+// Define status message interval variables
+unsigned long statusCurrentTime, statusPrevTime;
+const long statusInterval = 2000;     // (status interval in mS)
+
+void setup() {
+  Serial.begin(115200);
+  delay(2000);
+  myRobot->board->initialize();
+  CETALIB_LOG_INFO("logger_levels example started");
+  CETALIB_LOG_WARN("This is a warning message");
+  CETALIB_LOG_ERROR("This is an error message");
+}
+
+void loop() {
+  // Run the background tasks (also sends the queued log messages)
+  myRobot->board->tasks();
+
+  statusCurrentTime = millis();
+  if ((statusCurrentTime - statusPrevTime) >= statusInterval)
+  {
+    statusPrevTime = statusCurrentTime;
+    CETALIB_LOG_DEBUG("Button level: %d", myRobot->board->get_button_level());
+  }
+
+  if (myRobot->board->is_button_pressed())
+  {
+    for (int i = 0; i < 40; i++)
+    {
+      CETALIB_LOG_INFO("Burst message %d", i);
+    }
+    CETALIB_LOG_INFO("Messages dropped so far: %lu", myRobot->logger->get_dropped());
+  }
+}
@@ -0,0 +1,155 @@
+/*
+  CETALIB "motor" Library Example: "motor_esc_min_speed.ino"
+
+  This example calibrates the ESC pulse widths of the CETA IoT Robot motors,
+  and measures the slowest turn rate the robot can hold.
+
+  The motor controller (ESC) inputs are driven with 50 Hz servo pulses. The
+  "motor" module sets the pulse width in PWM counter clocks (about 0.3 uS),
+  from a neutral ("stop") pulse width and a deadband calibrated for each
+  motor. The previous driver used the Servo library, with 90 one-degree steps
+  (about 10 uS each) from stop to full effort in each direction.
+
+  Calibration: send 'c' on the serial monitor, then follow the instructions
+  (the robot on a stand, the POT connected to AN2). For each motor, rotate
+  the POT until the wheel stops, then until the wheel just starts to turn.
+  The pulse widths are saved in flash.
+
+  Benchmark: place the robot on the floor and press the USER switch. The
+  robot turns in place with slowly increasing effort, and the turn rate is
+  measured with the IMU heading. The test runs twice: once with the efforts
+  rounded to the 90 steps of the previous driver, and once with the full
+  resolution. For each run the sketch reports the smallest effort that turns
+  the robot, and the slowest turn rate measured.
+
+  Hardware Configuration:
+
+  CETA IoT Robot (Schematic #14-00069A/B), based on RPI-Pico-WH
+  (Select Board: "Raspberry Pi Pico W")
+
+  created 19 Oct 2026
+  by dBm Signal Dynamics Inc.
+
+*/
+
+#include <Arduino.h>
+#include <stdio.h>
+#include <cetalib.h>
+
+#if !defined(ARDUINO_RASPBERRY_PI_PICO_W)
+  #error This example requires the CETA IoT Robot (Board = "Raspberry Pi Pico W")
+#endif
+
+// define & initialize a pointer to the CETALIB functions
+const struct CETALIB_INTERFACE *myRobot = &CETALIB;
+
+// define an output buffer for Serial.print()
+char outBuffer[128];
+
+// benchmark settings
+const float effortStep = 0.0025f;       // effort increase per measurement
+const float maxEffort = 0.3f;           // end of the effort sweep
+const float turnThreshold = 2.0f;       // turn rate that counts as "moving" (degrees/second)
+const float stopRate = 90.0f;           // end the sweep early above this turn rate (degrees/second)
+const unsigned long settleTime = 300;   // time for the robot to reach a steady rate (in mS)
+const unsigned long measureTime = 700;  // turn rate measurement time (in mS)
+const int legacySteps = 90;             // effort steps of the previous Servo driver
+
+// Run the background tasks for "duration" mS
+void runTasks(unsigned long duration)
+{
+  unsigned long startTime = millis();
+  while ((millis() - startTime) < duration)
+  {
+    myRobot->board->tasks();
+    myRobot->imu->tasks();
+  }
+}
+
+// Turn rate at "effort" (degrees/second)
+float measureTurnRate(float effort)
+{
+  myRobot->motor->set_efforts(effort, -effort);
+  runTasks(settleTime);
+  float startHeading = myRobot->imu->get_heading();
+  runTasks(measureTime);
+  float change = myRobot->imu->get_heading() - startHeading;
+  if (change > 180.0f) change -= 360.0f;
+  if (change < -180.0f) change += 360.0f;
+  return fabsf(change) * 1000.0f / measureTime;
+}
+
+void runSweep(const char *name, int steps)
+{
+  float startEffort = 0.0f;
+  float minRate = 0.0f;
+
+  for (float effort = effortStep; effort <= maxEffort; effort += effortStep)
+  {
+    // round down to the driver resolution (0 = full resolution)
+    float appliedEffort = (steps > 0) ? floorf(effort * steps) / steps : effort;
+    float rate = measureTurnRate(appliedEffort);
+    if (rate >= turnThreshold)
+    {
+      if (startEffort == 0.0f)
+      {
+        startEffort = appliedEffort;
+      }
+      if ((minRate == 0.0f) || (rate < minRate))
+      {
+        minRate = rate;
+      }
+      if (rate >= stopRate)
+      {
+        break;
+      }
+    }
+  }
+  myRobot->motor->set_efforts(0.0f, 0.0f);
+  runTasks(1000);
+
+  sprintf(outBuffer, "%-24s start effort: %.4f  slowest turn rate: %.1f deg/s", name, startEffort, minRate);
+  Serial.println(outBuffer);
+}
+
+void runBenchmark(void)
+{
+  sprintf(outBuffer, "Effort steps (stop to full effort): %d (previous driver), %lu (pulse width driver)",
+          legacySteps, myRobot->motor->get_effort_steps());
+  Serial.println(outBuffer);
+  runSweep("Previous driver steps:", legacySteps);
+  runSweep("Pulse width driver:", 0);
+  Serial.println();
+}
+
+// the setup function runs once when you press reset or power the board
+void setup() {
+  Serial.begin(115200);
+  delay(2000);
+  Serial.println();
+  myRobot->board->initialize();
+  myRobot->motor->initialize(false, false);
+  if (!myRobot->imu->initialize())
+  {
+    Serial.println("Failed to initialize IMU!. Stopping.");
+    while (1);
+  }
+  Serial.println("Send 'c' to calibrate the ESC pulse widths, press the user button to run the benchmark");
+}
+
+// the loop function runs over and over again forever
+void loop() {
+  myRobot->board->tasks();
+  myRobot->imu->tasks();
+
+  if ((Serial.available() > 0) && (Serial.read() == 'c'))
+  {
+    myRobot->motor->calibrate();
+  }
+
+  if (myRobot->board->is_button_pressed())
+  {
+    myRobot->imu->reset_heading();
+    runBenchmark();
+  }
+}
@@ -0,0 +1,176 @@
+/*
+  CETALIB "motor" Library Example: "motor_pwm_benchmark.ino"
+
+  This example compares the "motor" PWM slice driver against the previous
+  driver, which used digitalWrite() and analogWrite() for each motor pin
+  (copied below as "analogWriteSetEfforts()").
+
+  For each driver the sketch reports:
+    - call cost: CPU cycles per "set both motor efforts" call
+    - update skew: cycles between the first and the last pin update of a call
+    - slice phase: offset between the left and right PWM counters (in uS)
+
+  Every new duty level takes effect at the end of a PWM period. With the slice
+  driver both slices run in phase and both levels are written back-to-back, so
+  both wheels change at the same instant. With analogWrite() the slices start
+  whenever each pin is first written, so the wheels change up to one PWM
+  period apart, causing a small "yaw kick" on every effort change.
+
+  Press the USER switch to step the PWM frequency (500 Hz, 2 kHz, 20 kHz) and
+  repeat the test. The motors are driven at low effort during the test, so
+  place the robot on a stand with the wheels off the ground.
+
+  Hardware Configuration:
+
+  Sparkfun XRP Robot Platform (#KIT-27644), based on the RPI RP2350B MCU
+  (Select "Board = SparkFun XRP Controller")
+
+  Sparkfun XRP (Beta) Robot Platform (#KIT-22230), based on the RPI Pico W
+  (Select "Board = SparkFun XRP Controller (Beta)")
+
+  created 19 Oct 2026
+  by dBm Signal Dynamics Inc.
+
+*/
+
+#include <hardware/pwm.h>   // needed to read the PWM slice counters
+#include <hardware/sync.h>  // needed for save_and_disable_interrupts()
+#include <cetalib.h>
+
+// define & initialize a pointer to the CETALIB functions
+const struct CETALIB_INTERFACE *myRobot = &CETALIB;
+
+// motor pins (see "src/modules/motor.h")
+#if defined(ARDUINO_SPARKFUN_XRP_CONTROLLER)
+  const int leftPin1 = 35, leftPin2 = 34;     // IN1, IN2
+  const int rightPin1 = 32, rightPin2 = 33;
+#elif defined(ARDUINO_SPARKFUN_XRP_CONTROLLER_BETA)
+  const int leftPin1 = 6, leftPin2 = 7;       // DIR, SPEED
+  const int rightPin1 = 14, rightPin2 = 15;
+#else
+  #error Unsupported board selection
+#endif
+
+const int numIterations = 1000;
+const unsigned long pwmFrequencies[] = {500, 2000, 20000};
+const int numPwmFrequencies = sizeof(pwmFrequencies)/sizeof(pwmFrequencies[0]);
+int pwmFrequencyIndex = 0;
+
+// low efforts, alternating direction, so every call changes both motors
+const float testEfforts[4] = {0.2f, -0.2f, 0.1f, -0.1f};
+uint32_t lastUpdateSkew;
+
+/*** previous driver: digitalWrite() + analogWrite() per pin ***/
+
+void analogWriteEffort(int pin1, int pin2, float effort)
+{
+  int reverse = (effort < 0);
+  if (reverse) effort = -effort;
+  #if defined(ARDUINO_SPARKFUN_XRP_CONTROLLER)
+  if (!reverse)
+  {
+    digitalWrite(pin1, HIGH);
+    analogWrite(pin2, int((1 - effort) * 1000));
+  }
+  else
+  {
+    analogWrite(pin1, int((1 - effort) * 1000));
+    digitalWrite(pin2, HIGH);
+  }
+  #else
+  digitalWrite(pin1, reverse);
+  analogWrite(pin2, (effort * 1000));
+  #endif
+}
+
+void analogWriteSetEfforts(float leftEffort, float rightEffort)
+{
+  uint32_t startCycles = rp2040.getCycleCount();
+  analogWriteEffort(leftPin1, leftPin2, leftEffort);
+  analogWriteEffort(rightPin1, rightPin2, rightEffort);
+  lastUpdateSkew = rp2040.getCycleCount() - startCycles;
+}
+
+void analogWriteInit(unsigned long frequency)
+{
+  pinMode(leftPin1, OUTPUT);
+  pinMode(leftPin2, OUTPUT);
+  pinMode(rightPin1, OUTPUT);
+  pinMode(rightPin2, OUTPUT);
+  analogWriteFreq(frequency);
+  analogWriteRange(1000);
+}
+
+/*** measurements ***/
+
+// Offset between the left and right slice counters, in uS
+float slicePhase(void)
+{
+  uint leftSlice = pwm_gpio_to_slice_num(leftPin2);
+  uint rightSlice = pwm_gpio_to_slice_num(rightPin2);
+  uint32_t period = pwm_hw->slice[leftSlice].top + 1;
+  uint32_t irqState = save_and_disable_interrupts();
+  uint32_t leftCount = pwm_get_counter(leftSlice);
+  uint32_t rightCount = pwm_get_counter(rightSlice);
+  restore_interrupts(irqState);
+  uint32_t offset = (leftCount + period - rightCount) % period;
+  if (offset > period / 2)
+  {
+    offset = period - offset;
+  }
+  return (offset * 1000000.0f) / (period * pwmFrequencies[pwmFrequencyIndex]);
+}
+
+void runBenchmark(void)
+{
+  unsigned long frequency = pwmFrequencies[pwmFrequencyIndex];
+  uint32_t startCycles, cycles, maxSkew;
+
+  // previous driver
+  analogWriteInit(frequency);
+  maxSkew = 0;
+  startCycles = rp2040.getCycleCount();
+  for (int i = 0; i < numIterations; i++)
+  {
+    analogWriteSetEfforts(testEfforts[i & 3], testEfforts[(i + 1) & 3]);
+    maxSkew = max(maxSkew, lastUpdateSkew);
+  }
+  cycles = rp2040.getCycleCount() - startCycles;
+  analogWriteSetEfforts(0.0f, 0.0f);
+  Serial.printf("analogWrite driver, %5lu Hz: %6lu cycles/call, update skew %6lu cycles, slice phase %7.1f uS\r\n",
+                frequency, (unsigned long)(cycles / numIterations), (unsigned long)maxSkew, slicePhase());
+
+  // PWM slice driver ("initialize()" takes the pins back from analogWrite())
+  myRobot->motor->initialize(false, false);
+  myRobot->motor->set_pwm_frequency(frequency);
+  maxSkew = 0;
+  startCycles = rp2040.getCycleCount();
+  for (int i = 0; i < numIterations; i++)
+  {
+    uint32_t callCycles = rp2040.getCycleCount();
+    myRobot->motor->set_efforts(testEfforts[i & 3], testEfforts[(i + 1) & 3]);
+    maxSkew = max(maxSkew, rp2040.getCycleCount() - callCycles);   // upper bound: the whole call
+  }
+  cycles = rp2040.getCycleCount() - startCycles;
+  myRobot->motor->set_efforts(0.0f, 0.0f);
+  Serial.printf("PWM slice driver,   %5lu Hz: %6lu cycles/call, update skew %6lu cycles, slice phase %7.1f uS\r\n",
+                myRobot->motor->get_pwm_frequency(), (unsigned long)(cycles / numIterations), (unsigned long)maxSkew, slicePhase());
+  Serial.println();
+}
+
+void setup() {
+  Serial.begin(115200);
+  while(!Serial);
+  myRobot->board->initialize();
+  myRobot->motor->initialize(false, false);
+  runBenchmark();
+}
+
+void loop() {
+  myRobot->board->tasks();
+  if(myRobot->board->is_button_pressed())
+  {
+    pwmFrequencyIndex = (pwmFrequencyIndex + 1) % numPwmFrequencies;
+    runBenchmark();
+  }
+}
@@ -0,0 +1,101 @@
+/*
+  CETALIB "motor" Library Example: "motor_slew_soft_start.ino"
+
+  This example uses the "motor->set_slew_rates()" API to soft start the motors.
+  Each press of the user push button steps the robot through full forward,
+  full reverse and stop. The efforts jump instantly, but the motor layer ramps
+  the applied effort up at the slew rate, from a timer, so the wheels do not
+  slip and the battery does not brown out on the current spike.
+
+  Slowing down is never limited, and a reversal stops the motor first, then
+  ramps up in the new direction.
+
+  With "motor->set_battery_scaling()" the slew rates are reduced as the
+  battery voltage drops toward the brownout voltage. Adjust the voltages to
+  your battery pack (the example values are for 4 x AA cells). Battery
+  scaling is available on the CETA only: the XRP battery divider is not
+  documented, so the XRP boards keep the full slew rates.
+
+  Every second the sketch prints the applied efforts, the number and timing
+  of the ramps, and the battery readings. Place the robot on a stand with the
+  wheels off the ground.
+
+  Hardware Configurations Supported:
+
+  CETA IoT Robot (Schematic #14-00069A/B), based on RPI-Pico-WH
+  (Select Board: "Raspberry Pi Pico W")
+
+  Sparkfun XRP Robot Platform (#KIT-27644), based on the RPI RP2350B MCU
+  (Select Board: "SparkFun XRP Controller")
+
+  Sparkfun XRP (Beta) Robot Platform (#KIT-22230), based on the RPI Pico W
+  (Select "Board = SparkFun XRP Controller (Beta)")
+
+  created 19 Oct 2026
+  by dBm Signal Dynamics Inc.
+
+*/
+
+#include <Arduino.h>
+#include <stdio.h>
+#include <cetalib.h>
+
+// define & initialize a pointer to the CETALIB functions
+const struct CETALIB_INTERFACE *myRobot = &CETALIB;
+
+// define an output buffer for Serial.print()
+char outBuffer[160];
+
+// slew rates (effort/second): full effort is reached in 0.5 seconds
+const float leftSlewRate = 2.0f;
+const float rightSlewRate = 2.0f;
+
+// battery pack voltages (4 x AA cells)
+const float nominalVoltage = 6.0f;
+const float brownoutVoltage = 4.4f;
+
+// the button steps through these efforts
+const float efforts[] = {1.0f, -1.0f, 0.0f};
+const int numEfforts = sizeof(efforts)/sizeof(efforts[0]);
+int effortIndex = numEfforts - 1;
+
+unsigned long prevPrintTime = 0;
+
+// the setup function runs once when you press reset or power the board
+void setup() {
+  Serial.begin(115200);
+  delay(2000);
+  Serial.println();
+  myRobot->board->initialize();
+  myRobot->motor->initialize(false, false);
+  myRobot->motor->set_slew_rates(leftSlewRate, rightSlewRate);
+  myRobot->motor->set_battery_scaling(nominalVoltage, brownoutVoltage);
+  Serial.println("Press the user button to change the motor efforts");
+}
+
+// the loop function runs over and over again forever
+void loop() {
+  myRobot->board->tasks();
+  myRobot->motor->tasks();      // reads the battery voltage for the slew scaling
+
+  if(myRobot->board->is_button_pressed())
+  {
+    effortIndex = (effortIndex + 1) % numEfforts;
+    myRobot->motor->set_efforts(efforts[effortIndex], efforts[effortIndex]);
+    sprintf(outBuffer, "Target effort: %.2f", efforts[effortIndex]);
+    Serial.println(outBuffer);
+  }
+
+  if((millis() - prevPrintTime) >= 1000)
+  {
+    prevPrintTime = millis();
+    MOTOR_STATS *stats = myRobot->motor->get_stats();
+    sprintf(outBuffer, "Ramps L/R: %lu/%lu  Last ramp: %lu/%lu mS  Max ramp: %lu/%lu mS",
+            stats->ramps[0], stats->ramps[1], stats->lastRampTime[0], stats->lastRampTime[1],
+            stats->maxRampTime[0], stats->maxRampTime[1]);
+    Serial.println(outBuffer);
+    sprintf(outBuffer, "Battery: %.2f V (min %.2f V)  Brownouts: %lu  Slew scale: %.2f",
+            stats->batteryVoltage, stats->minBatteryVoltage, stats->brownouts, stats->slewScale);
+    Serial.println(outBuffer);
+  }
+}
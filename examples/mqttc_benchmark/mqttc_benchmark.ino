@@ -0,0 +1,229 @@
+/*
+  CETALIB "mqttc" Library Example: "mqttc_benchmark.ino"
+
+  This example measures "mqttc" performance against the local benchmark broker
+  stand-in (utilities/mqtt-bench/cetalib-mqtt-bench-broker.py) running on a PC
+  on the same WiFi network.
+
+  The robot subscribes to a benchmark topic, then for each QoS level (0 and 1)
+  and each payload size:
+    - publishes a burst of binary messages as fast as possible (throughput)
+    - publishes messages one at a time and waits for the broker to deliver each
+      one back to the robot (round trip latency percentiles)
+
+  The connect time, number of reconnects, last reconnect time and the free heap
+  low-water mark are reported at the end of each pass. Edit the broker IP address
+  and port below. For TLS (port 8883), paste the test CA certificate ("ca.crt")
+  into "testRootCACert" (see utilities/mqtt-bench/README.md).
+
+  Hardware Configurations Supported:
+
+  CETA IoT Robot (Schematic #14-00069A/B), based on RPI-Pico-WH
+  (Select "Board = Raspberry Pi Pico W")
+
+  Sparkfun XRP Robot Platform (#KIT-27644), based on the RPI RP2350B MCU
+  (Select "Board = SparkFun XRP Controller")
+
+  Sparkfun XRP (Beta) Robot Platform (#KIT-22230), based on the RPI Pico W
+  (Select "Board = SparkFun XRP Controller (Beta)")
+
+  created 19 Oct 2026
+  by dBm Signal Dynamics Inc.
+
+*/
+
+#include <stdio.h>    // needed for "sprintf()" function
+#include <string.h>   // needed for "memcpy()" function
+#include <cetalib.h>
+
+const struct CETALIB_INTERFACE *myRobot = &CETALIB;
+
+// WiFi Parameters
+const char ssid[] = "MY_SSID";        // EDIT
+const char pass[] = "MY_PASSPHRASE";  // EDIT
+
+// MQTT Broker IP address (PC running the benchmark broker), Username, Password
+const char MQTTbroker[] = "192.168.1.50";   // EDIT
+int MQTTport = 1883;    // EDIT: 1883 for open connection, or 8883 for secure connection
+const char MQTTusername[] = "";
+const char MQTTpassword[] = "";
+
+// Test CA certificate (PEM) for secure connections to the benchmark broker
+const char testRootCACert[] = R"EOF(
+-----BEGIN CERTIFICATE-----
+PASTE_THE_CONTENTS_OF_ca.crt_HERE
+-----END CERTIFICATE-----
+)EOF";
+
+// The robot subscribes to the same topic it publishes to
+const char benchTopic[] = "cetalib/bench";
+const char *subscribeTopicIDs[] = {benchTopic};
+int num_subscribeTopicIDs = sizeof(subscribeTopicIDs)/sizeof(subscribeTopicIDs[0]);
+
+// Benchmark parameters (payloads must fit the 127 byte "mqttc" receive buffer)
+const int payloadSizes[] = {8, 32, 64, 120};
+const int numPayloadSizes = sizeof(payloadSizes)/sizeof(payloadSizes[0]);
+const int burstMessages = 200;            // messages per throughput measurement
+const int latencySamples = 50;            // messages per latency measurement
+const unsigned long echoTimeout = 2000;   // max wait for each round trip (in mS)
+
+uint8_t txPayload[128];
+uint8_t rxPayload[128];
+unsigned long latency[latencySamples];
+uint32_t minFreeHeap;
+
+// Define a serial terminal output buffer for messages
+char serialOutBuffer[256];
+
+void setup() {
+  Serial.begin(115200);
+  delay(2000);
+  myRobot->board->initialize();
+  // Subscribe at QoS 1, so the broker delivers at the QoS used by each publish
+  myRobot->mqttc->set_qos(0, 1);
+  if (MQTTport == 8883)
+  {
+    myRobot->mqttc->set_ca_cert(testRootCACert);
+  }
+  // Attempt to connect to AP and Broker
+  if (!myRobot->mqttc->connect(ssid, pass, MQTTbroker, MQTTport, MQTTusername, MQTTpassword, subscribeTopicIDs, num_subscribeTopicIDs))
+  {
+    Serial.println("Failed to initialize MQTT Client!. Stopping.");
+    myRobot->board->led_blink(10);
+    while (1)
+    {
+      myRobot->board->tasks();
+    }
+  }
+  sprintf(serialOutBuffer, "Connected to %s:%d in %lu mS", MQTTbroker, MQTTport, myRobot->mqttc->get_stats()->lastConnectTime);
+  Serial.println(serialOutBuffer);
+  minFreeHeap = rp2040.getFreeHeap();
+}
+
+void loop() {
+  for (int qos = 0; qos <= 1; qos++)
+  {
+    myRobot->mqttc->set_qos(qos, 1);
+    for (int i = 0; i < numPayloadSizes; i++)
+    {
+      runThroughput(qos, payloadSizes[i]);
+      runLatency(qos, payloadSizes[i]);
+    }
+  }
+
+  MQTTC_STATS *stats = myRobot->mqttc->get_stats();
+  sprintf(serialOutBuffer, "Totals: sent %lu msgs (%lu B), received %lu msgs (%lu B), reconnects %lu (last %lu mS), min free heap %lu B",
+          stats->messagesSent, stats->bytesSent, stats->messagesReceived, stats->bytesReceived,
+          stats->reconnects, stats->lastConnectTime, (unsigned long)minFreeHeap);
+  Serial.println(serialOutBuffer);
+  Serial.println();
+
+  // Repeat the benchmark every 10s
+  unsigned long pauseStartTime = millis();
+  while ((millis() - pauseStartTime) < 10000)
+  {
+    runTasks();
+  }
+}
+
+// Run the background tasks and track the free heap low-water mark
+void runTasks(void)
+{
+  myRobot->mqttc->tasks();
+  myRobot->board->tasks();
+  uint32_t freeHeap = rp2040.getFreeHeap();
+  if (freeHeap < minFreeHeap)
+  {
+    minFreeHeap = freeHeap;
+  }
+}
+
+// Payload layout: [sequence (4 bytes), send time in uS (4 bytes), padding...]
+void fillPayload(uint32_t sequence, int size)
+{
+  uint32_t sendTime = micros();
+  memset(txPayload, 0xA5, size);
+  memcpy(&txPayload[0], &sequence, 4);
+  memcpy(&txPayload[4], &sendTime, 4);
+}
+
+void runThroughput(int qos, int size)
+{
+  unsigned long startTime = micros();
+  for (int i = 0; i < burstMessages; i++)
+  {
+    fillPayload(i, size);
+    myRobot->mqttc->send_binary(benchTopic, txPayload, size);
+    runTasks();
+  }
+  unsigned long elapsed = micros() - startTime;
+  float msgsPerSecond = (burstMessages * 1000000.0) / elapsed;
+  sprintf(serialOutBuffer, "QoS %d, %3d B: publish %7.1f msg/s, %8.1f B/s", qos, size, msgsPerSecond, msgsPerSecond * size);
+  Serial.println(serialOutBuffer);
+
+  // let the echoed burst drain before measuring latency
+  unsigned long drainStartTime = millis();
+  while ((millis() - drainStartTime) < 1000)
+  {
+    runTasks();
+    if (myRobot->mqttc->is_message_available(benchTopic))
+    {
+      myRobot->mqttc->receive_binary(rxPayload, sizeof(rxPayload));
+    }
+  }
+}
+
+void runLatency(int qos, int size)
+{
+  int samples = 0;
+  int lost = 0;
+  for (uint32_t sequence = 0x10000; sequence < (0x10000 + latencySamples); sequence++)
+  {
+    fillPayload(sequence, size);
+    unsigned long sendTime = micros();
+    myRobot->mqttc->send_binary(benchTopic, txPayload, size);
+    bool received = false;
+    while (!received && ((micros() - sendTime) < (echoTimeout * 1000)))
+    {
+      runTasks();
+      if (myRobot->mqttc->is_message_available(benchTopic))
+      {
+        uint32_t rxSequence;
+        myRobot->mqttc->receive_binary(rxPayload, sizeof(rxPayload));
+        memcpy(&rxSequence, &rxPayload[0], 4);
+        if (rxSequence == sequence)
+        {
+          latency[samples++] = micros() - sendTime;
+          received = true;
+        }
+      }
+    }
+    if (!received)
+    {
+      lost++;
+    }
+  }
+
+  // sort the samples (insertion sort) to extract the percentiles
+  for (int i = 1; i < samples; i++)
+  {
+    unsigned long key = latency[i];
+    int j = i - 1;
+    while ((j >= 0) && (latency[j] > key))
+    {
+      latency[j + 1] = latency[j];
+      j--;
+    }
+    latency[j + 1] = key;
+  }
+  if (samples)
+  {
+    sprintf(serialOutBuffer, "QoS %d, %3d B: round trip p50 %lu uS, p90 %lu uS, p99 %lu uS, max %lu uS, lost %d",
+            qos, size, latency[samples / 2], latency[(samples * 9) / 10], latency[(samples * 99) / 100], latency[samples - 1], lost);
+  }
+  else
+  {
+    sprintf(serialOutBuffer, "QoS %d, %3d B: no round trip messages received", qos, size);
+  }
+  Serial.println(serialOutBuffer);
+}
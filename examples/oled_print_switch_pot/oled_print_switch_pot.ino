@@ -5,6 +5,10 @@
   user switch state ("pressed" or "released") as well as the potentiometer
   value in the upper left corner of the display.
 
+  The text is drawn into a framebuffer, and the board "tasks()" function sends
+  only the changed characters to the display in small I2C transfers, so the
+  main loop is never held up by display updates.
+
   Hardware Configuration:
 
   CETA IoT Robot (Schematic #14-00069A/B), based on RPI-Pico-WH
@@ -28,6 +32,10 @@ char oledOutBuffer[64];
 
 int potValue, switchLevel;
 
+// Define display update interval variables
+unsigned long displayCurrentTime, displayPrevTime;
+const long displayInterval = 100;     // (display update interval in mS)
+
 // define & initialize a pointer to the CETALIB functions
 const struct CETALIB_INTERFACE *myRobot = &CETALIB;
 
@@ -46,23 +54,30 @@ void setup() {
 
 // the loop function runs over and over again forever
 void loop() {
-  #if defined(ARDUINO_RASPBERRY_PI_PICO_W)
-  potValue = myRobot->board->get_potentiometer();
-  #else
-  potValue = random(0, 4096);
-  #endif
-  switchLevel = myRobot->board->get_button_level();
-  if (0 == switchLevel)
-  {
-    sprintf(oledOutBuffer, "Switch: Pressed \nPotentiometer: %4d\n", potValue);
-    myRobot->oled->print(oledOutBuffer);
-    myRobot->oled->home();
-  }
-  else
+  // Run the background tasks (also sends the display changes)
+  myRobot->board->tasks();
+
+  displayCurrentTime = millis();
+  if ((displayCurrentTime - displayPrevTime) >= displayInterval)
   {
-    sprintf(oledOutBuffer, "Switch: Released\nPotentiometer: %4d\n", potValue);
-    myRobot->oled->print(oledOutBuffer);
-    myRobot->oled->home();
+    displayPrevTime = displayCurrentTime;
+    #if defined(ARDUINO_RASPBERRY_PI_PICO_W)
+    potValue = myRobot->board->get_potentiometer();
+    #else
+    potValue = random(0, 4096);
+    #endif
+    switchLevel = myRobot->board->get_button_level();
+    if (0 == switchLevel)
+    {
+      sprintf(oledOutBuffer, "Switch: Pressed \nPotentiometer: %4d\n", potValue);
+      myRobot->oled->print(oledOutBuffer);
+      myRobot->oled->home();
+    }
+    else
+    {
+      sprintf(oledOutBuffer, "Switch: Released\nPotentiometer: %4d\n", potValue);
+      myRobot->oled->print(oledOutBuffer);
+      myRobot->oled->home();
+    }
   }
-  delay(100);
 }
\ No newline at end of file
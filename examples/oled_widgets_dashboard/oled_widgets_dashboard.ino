@@ -0,0 +1,117 @@
+/*
+  CETALIB "oled" Library Example: "oled_widgets_dashboard.ino"
+
+  This example shows live sensor values on the OLED using widgets instead of
+  "sprintf()" and print():
+    - numeric fields for the heading (CETA) or wheel speed (XRP), distance
+      and line status
+    - a bar gauge for the distance
+    - a scrolling sparkline of the heading (CETA) or wheel speed (XRP)
+
+  Widgets are redrawn by the board "tasks()" function at a capped frame rate
+  (10 frames per second by default), and only the pixels that changed are sent
+  to the display.
+
+  Widgets with a data source function are sampled at each frame. The
+  rangefinder blocks while it measures, so the distance is sampled by the
+  sketch and passed to its widgets with "set_value()" instead (as is the XRP
+  wheel speed, which is calculated from the encoder position).
+
+  Hardware Configurations Supported:
+
+  CETA IoT Robot (Schematic #14-00069A/B), based on RPI-Pico-WH
+  (Select "Board = Raspberry Pi Pico W")
+
+  Sparkfun XRP Robot Platform (#KIT-27644), based on the RPI RP2350B MCU
+  (Select "Board = SparkFun XRP Controller")
+
+  created 19 Oct 2026
+  by dBm Signal Dynamics Inc.
+
+*/
+
+#include <cetalib.h>
+
+const struct CETALIB_INTERFACE *myRobot = &CETALIB;
+
+// Widget numbers of the values set by the sketch
+int distanceField, distanceBar;
+#if defined(ARDUINO_SPARKFUN_XRP_CONTROLLER)
+int speedField, speedSparkline;
+float prevLeftPosition;
+#endif
+
+// Define sample interval variables
+unsigned long sampleCurrentTime, samplePrevTime;
+const long sampleInterval = 100;      // (sample interval in mS)
+
+// Data source functions, sampled by the oled module at each frame
+float lineStatus(void) { return myRobot->reflectance->get_line_status(); }
+
+#if defined(ARDUINO_RASPBERRY_PI_PICO_W)
+float heading(void) { return myRobot->imu->get_heading(); }
+#endif
+
+void setup() {
+  Serial.begin(115200);
+  delay(2000);
+  myRobot->board->initialize();
+  myRobot->reflectance->initialize();
+  myRobot->rangefinder->initialize();
+  #if defined(ARDUINO_RASPBERRY_PI_PICO_W)
+  myRobot->imu->initialize();
+  #else
+  myRobot->encoder->initialize();
+  #endif
+  if (!myRobot->oled->initialize())
+  {
+    Serial.println("Failed to initialize OLED!. Stopping.");
+    myRobot->board->led_blink(10);
+    while (1)
+    {
+      myRobot->board->tasks();
+    }
+  }
+
+  // Fields: row, column, label, value width (characters), decimal places, source
+  #if defined(ARDUINO_RASPBERRY_PI_PICO_W)
+  myRobot->oled->add_field(0, 0, "Heading:", 6, 1, heading);
+  #else
+  speedField = myRobot->oled->add_field(0, 0, "Speed rps:", 6, 2, NULL);
+  #endif
+  distanceField = myRobot->oled->add_field(1, 0, "Dist cm:", 6, 1, NULL);
+  myRobot->oled->add_field(2, 0, "Line:", 2, 0, lineStatus);
+
+  // Bar gauge: row, column, width (characters), min, max, source
+  distanceBar = myRobot->oled->add_bar(3, 0, 21, 0.0, 100.0, NULL);
+
+  // Sparkline: row, column, width (characters), height (rows), min, max, source
+  #if defined(ARDUINO_RASPBERRY_PI_PICO_W)
+  myRobot->oled->add_sparkline(4, 0, 21, 4, 0.0, 360.0, heading);
+  #else
+  speedSparkline = myRobot->oled->add_sparkline(4, 0, 21, 4, -3.0, 3.0, NULL);
+  #endif
+}
+
+void loop() {
+  // Run the background tasks (also redraws the widgets and updates the display)
+  myRobot->board->tasks();
+
+  sampleCurrentTime = millis();
+  if ((sampleCurrentTime - samplePrevTime) >= sampleInterval)
+  {
+    samplePrevTime = sampleCurrentTime;
+    float distance = myRobot->rangefinder->get_distance();
+    myRobot->oled->set_value(distanceField, distance);
+    myRobot->oled->set_value(distanceBar, distance);
+
+    #if defined(ARDUINO_SPARKFUN_XRP_CONTROLLER)
+    // Left wheel speed (in revolutions per second)
+    float leftPosition = myRobot->encoder->get_left_position();
+    float leftSpeed = ((leftPosition - prevLeftPosition) * 1000.0) / sampleInterval;
+    prevLeftPosition = leftPosition;
+    myRobot->oled->set_value(speedField, leftSpeed);
+    myRobot->oled->set_value(speedSparkline, leftSpeed);
+    #endif
+  }
+}
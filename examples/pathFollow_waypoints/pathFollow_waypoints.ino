@@ -0,0 +1,139 @@
+/*
+  CETALIB "pathFollow" Library Example: "pathFollow_waypoints.ino"
+
+  This example drives the robot along a path with the "pathFollow" module,
+  instead of a sequence of timed efforts and blocking turns.
+
+  Each press of the user push button starts the next path:
+    - a 50 cm square of waypoints (straight lines, the corners are cut)
+    - an S-curve spline (a smooth curve through the points)
+  The robot returns to its start position at the end of each path, so place
+  it on the floor with about 1 m of free space ahead and to its left.
+
+  The loop keeps running while the robot drives: every 250 mS the sketch
+  prints the pose, the cross-track error and the progress. At the end of the
+  path it prints the tracking statistics and the distance from the start
+  position (the odometry error of a closed path).
+
+  Hardware Configurations Supported:
+
+  Sparkfun XRP Robot Platform (#KIT-27644), based on the RPI RP2350B MCU
+  (Select "Board = SparkFun XRP Controller")
+
+  Sparkfun XRP (Beta) Robot Platform (#KIT-22230), based on the RPI Pico W
+  (Select "Board = SparkFun XRP Controller (Beta)")
+
+  created 19 Oct 2026
+  by dBm Signal Dynamics Inc.
+
+*/
+
+#include <Arduino.h>
+#include <stdio.h>
+#include <cetalib.h>
+
+#if !defined(ARDUINO_SPARKFUN_XRP_CONTROLLER) && !defined(ARDUINO_SPARKFUN_XRP_CONTROLLER_BETA)
+  #error This example requires the wheel encoders of the XRP Robot
+#endif
+
+// define & initialize a pointer to the CETALIB functions
+const struct CETALIB_INTERFACE *myRobot = &CETALIB;
+
+// define an output buffer for Serial.print()
+char outBuffer[128];
+
+// paths (in cm): the robot starts at (0, 0), facing +x, +y is to its left
+const PATHFOLLOW_POINT square[] = {{0, 0}, {50, 0}, {50, 50}, {0, 50}, {0, 0}};
+const PATHFOLLOW_POINT sCurve[] = {{0, 0}, {30, 15}, {60, -15}, {90, 0}, {60, 40}, {0, 20}, {0, 0}};
+
+const float pathSpeed = 20.0f;          // cruise speed (in cm/s)
+const float lookahead = 10.0f;          // pure-pursuit lookahead distance (in cm)
+
+int pathIndex = 0;
+bool following = false;
+unsigned long prevPrintTime = 0;
+
+void startPath(void)
+{
+  bool pathSet;
+  if (pathIndex == 0)
+  {
+    pathSet = myRobot->pathFollow->set_waypoints(square, sizeof(square)/sizeof(square[0]));
+  }
+  else
+  {
+    pathSet = myRobot->pathFollow->set_spline(sCurve, sizeof(sCurve)/sizeof(sCurve[0]));
+  }
+  myRobot->pathFollow->set_pose(0.0f, 0.0f, 0.0f);
+  if (pathSet && myRobot->pathFollow->start(pathSpeed))
+  {
+    following = true;
+    sprintf(outBuffer, "Following the %s path at %.0f cm/s", (pathIndex == 0) ? "square" : "S-curve", pathSpeed);
+    Serial.println(outBuffer);
+  }
+}
+
+void printResults(void)
+{
+  float x, y, heading;
+  PATHFOLLOW_STATS *stats = myRobot->pathFollow->get_stats();
+  myRobot->pathFollow->get_pose(&x, &y, &heading);
+  sprintf(outBuffer, "Done in %lu mS  RMS error: %.2f cm  Max error: %.2f cm  Late updates: %lu",
+          stats->pathTime, stats->rmsCrossTrackError, stats->maxCrossTrackError, stats->lateUpdates);
+  Serial.println(outBuffer);
+  sprintf(outBuffer, "End position: (%.1f, %.1f) cm, %.1f cm from the start point", x, y, hypotf(x, y));
+  Serial.println(outBuffer);
+}
+
+// the setup function runs once when you press reset or power the board
+void setup() {
+  Serial.begin(115200);
+  delay(2000);
+  Serial.println();
+  myRobot->board->initialize();
+  myRobot->diffDrive->initialize(false, false);
+  myRobot->encoder->initialize();
+  myRobot->pathFollow->initialize();
+  myRobot->pathFollow->set_lookahead(lookahead);
+  Serial.println("Press the user button to start the next path");
+}
+
+// the loop function runs over and over again forever
+void loop() {
+  myRobot->board->tasks();
+  myRobot->pathFollow->tasks();
+
+  if (myRobot->board->is_button_pressed())
+  {
+    if (following)
+    {
+      myRobot->pathFollow->stop();
+      following = false;
+      Serial.println("Stopped");
+    }
+    else
+    {
+      startPath();
+      pathIndex = (pathIndex + 1) % 2;
+    }
+  }
+
+  if (following)
+  {
+    if (myRobot->pathFollow->is_complete())
+    {
+      following = false;
+      printResults();
+    }
+    else if ((millis() - prevPrintTime) >= 250)
+    {
+      float x, y, heading;
+      prevPrintTime = millis();
+      myRobot->pathFollow->get_pose(&x, &y, &heading);
+      sprintf(outBuffer, "x: %6.1f  y: %6.1f  heading: %5.1f  error: %5.2f cm  progress: %3.0f%%",
+              x, y, heading, myRobot->pathFollow->get_cross_track_error(),
+              myRobot->pathFollow->get_progress() * 100.0f);
+      Serial.println(outBuffer);
+    }
+  }
+}
@@ -0,0 +1,198 @@
+/*
+  CETALIB "replay" Library Example: "replay_line_follow_benchmark.ino"
+
+  This example records the sensor inputs of a line follower run, then replays
+  them to run the same line follower again without the robot moving, to
+  compare the results and the processing time.
+
+  Press the USER pushbutton to start following the line. The raw sensor
+  inputs (reflectance readings, encoder counts or gyro rates) are recorded
+  to a trace file in flash. Press the pushbutton again to stop: the motors
+  stop and the trace is replayed immediately, through the same control loop.
+
+  At the end of each run, the serial terminal shows:
+    - a checksum of all the motor efforts computed by the control loop (it
+      is identical for the recorded and the replayed runs: the replay is
+      bit-exact)
+    - the final heading (CETA) or encoder counts (XRP), also identical
+    - the average and maximum control loop processing time (the replayed
+      run does not wait for the sensors)
+
+  To tune the line follower, edit the control loop (e.g. "steeringGain"),
+  upload the sketch, and replay the same trace: the efforts checksum changes,
+  but the inputs are the same, so runs can be compared directly.
+
+  A flash file system must be selected in the Arduino IDE before uploading:
+  "Tools > Flash Size", e.g. "2MB (Sketch: 1MB, FS: 1MB)".
+
+  Hardware Configurations Supported:
+
+  CETA IoT Robot (Schematic #14-00069A/B), based on RPI-Pico-WH
+  (Select "Board = Raspberry Pi Pico W")
+
+  Sparkfun XRP Robot Platform (#KIT-27644), based on the RPI RP2350B MCU
+  (Select "Board = SparkFun XRP Controller")
+
+  Sparkfun XRP (Beta) Robot Platform (#KIT-22230), based on the RPI Pico W
+  (Select "Board = SparkFun XRP Controller (Beta)")
+
+  created 19 Oct 2026
+  by dBm Signal Dynamics Inc.
+
+*/
+
+#include <stdio.h>    // needed for "sprintf()" function
+#include <string.h>   // needed for "memcpy()" function
+#include <cetalib.h>
+
+const struct CETALIB_INTERFACE *myRobot = &CETALIB;
+
+const char traceFileName[] = "/trace.bin";
+
+// Line follower parameters
+const float baseEffort = 0.3;
+const float steeringGain = 0.4;
+
+// Define control loop interval variables
+unsigned long controlCurrentTime, controlPrevTime;
+const long controlInterval = 10;      // (control interval in mS)
+
+// Run results
+#if defined(ARDUINO_SPARKFUN_XRP_CONTROLLER) || defined(ARDUINO_SPARKFUN_XRP_CONTROLLER_BETA)
+int leftCounts, rightCounts;
+#endif
+uint32_t effortsChecksum;
+unsigned long controlSteps, controlTotalTime, controlMaxTime;
+
+// Define a serial terminal output buffer for messages
+char serialOutBuffer[256];
+
+void setup() {
+  Serial.begin(115200);
+  delay(2000);
+  myRobot->board->initialize();
+  myRobot->diffDrive->initialize(true, true);
+  myRobot->reflectance->initialize();
+  #if defined(ARDUINO_SPARKFUN_XRP_CONTROLLER) || defined(ARDUINO_SPARKFUN_XRP_CONTROLLER_BETA)
+  myRobot->encoder->initialize();
+  #else
+  if (!myRobot->imu->initialize())
+  {
+    Serial.println("Failed to initialize IMU!. Stopping.");
+    while (1);
+  }
+  #endif
+  Serial.println("Press the USER pushbutton to start");
+}
+
+void loop() {
+  // Run the background tasks (also writes and reads the trace file)
+  myRobot->board->tasks();
+  #if defined(ARDUINO_RASPBERRY_PI_PICO_W)
+  myRobot->imu->tasks();
+  #endif
+
+  enum REPLAY_MODE mode = myRobot->replay->get_mode();
+  if (myRobot->board->is_button_pressed())
+  {
+    if (mode == REPLAY_OFF)
+    {
+      startRun();
+      if (!myRobot->replay->record(traceFileName))
+      {
+        Serial.println("Failed to create the trace file! Is a flash file system selected?");
+      }
+      #if defined(ARDUINO_RASPBERRY_PI_PICO_W)
+      myRobot->imu->reset_heading();
+      #endif
+    }
+    else if (mode == REPLAY_RECORDING)
+    {
+      myRobot->diffDrive->stop();
+      myRobot->replay->stop();
+      reportRun("Recorded");
+
+      // run the same control loop again, on the recorded inputs
+      startRun();
+      #if defined(ARDUINO_RASPBERRY_PI_PICO_W)
+      myRobot->imu->reset_heading();
+      #endif
+      myRobot->replay->play(traceFileName);
+    }
+  }
+
+  if ((mode == REPLAY_PLAYING) && myRobot->replay->is_finished())
+  {
+    myRobot->replay->stop();
+    reportRun("Replayed");
+    return;
+  }
+
+  controlCurrentTime = millis();
+  if ((mode != REPLAY_OFF) && ((controlCurrentTime - controlPrevTime) >= controlInterval))
+  {
+    controlPrevTime = controlCurrentTime;
+    unsigned long startTime = micros();
+
+    // Steer towards the darker sensor
+    float error = myRobot->reflectance->get_left_sensor() - myRobot->reflectance->get_right_sensor();
+    float leftEffort = baseEffort - (steeringGain * error);
+    float rightEffort = baseEffort + (steeringGain * error);
+    #if defined(ARDUINO_SPARKFUN_XRP_CONTROLLER) || defined(ARDUINO_SPARKFUN_XRP_CONTROLLER_BETA)
+    leftCounts = myRobot->encoder->get_left_position_counts();
+    rightCounts = myRobot->encoder->get_right_position_counts();
+    #endif
+    if (mode == REPLAY_RECORDING)
+    {
+      myRobot->diffDrive->set_efforts(leftEffort, rightEffort);
+    }
+
+    unsigned long stepTime = micros() - startTime;
+    controlSteps++;
+    controlTotalTime += stepTime;
+    if (stepTime > controlMaxTime)
+    {
+      controlMaxTime = stepTime;
+    }
+    addToChecksum(leftEffort);
+    addToChecksum(rightEffort);
+  }
+}
+
+void startRun(void)
+{
+  effortsChecksum = 2166136261UL;
+  #if defined(ARDUINO_SPARKFUN_XRP_CONTROLLER) || defined(ARDUINO_SPARKFUN_XRP_CONTROLLER_BETA)
+  leftCounts = 0;
+  rightCounts = 0;
+  #endif
+  controlSteps = 0;
+  controlTotalTime = 0;
+  controlMaxTime = 0;
+}
+
+// FNV-1a hash of the exact bits of each effort
+void addToChecksum(float value)
+{
+  uint8_t bytes[sizeof(value)];
+  memcpy(bytes, &value, sizeof(value));
+  for (unsigned int i = 0; i < sizeof(bytes); i++)
+  {
+    effortsChecksum = (effortsChecksum ^ bytes[i]) * 16777619UL;
+  }
+}
+
+void reportRun(const char *name)
+{
+  REPLAY_STATS *stats = myRobot->replay->get_stats();
+  sprintf(serialOutBuffer, "%s: %lu steps, efforts checksum %08lx, step time avg %lu uS max %lu uS, %lu inputs (%lu bytes)",
+          name, controlSteps, (unsigned long)effortsChecksum, controlSteps ? (controlTotalTime / controlSteps) : 0,
+          controlMaxTime, stats->records, stats->bytes);
+  Serial.println(serialOutBuffer);
+  #if defined(ARDUINO_SPARKFUN_XRP_CONTROLLER) || defined(ARDUINO_SPARKFUN_XRP_CONTROLLER_BETA)
+  sprintf(serialOutBuffer, "    final encoder counts: left %d, right %d", leftCounts, rightCounts);
+  #else
+  sprintf(serialOutBuffer, "    final heading: %.4f", myRobot->imu->get_heading());
+  #endif
+  Serial.println(serialOutBuffer);
+}
@@ -0,0 +1,143 @@
+/*
+  CETALIB "telemetry" Library Example: "telemetry_publish_on_change.ino"
+
+  This example publishes rangefinder distance, line status and (on XRP robots)
+  encoder counts to the public EMQX broker (broker.emqx.io) on port 1883, but
+  only when a value changes significantly, instead of on a fixed timer.
+
+  Each telemetry channel has:
+    - a deadband: the minimum change that is published
+    - a minimum interval: limits the publish rate of a rapidly changing value
+    - a maximum interval: a "heartbeat" publish, even if the value is unchanged
+    - smoothing: exponential moving average applied to noisy sensors
+
+  Every 10 seconds the number of sent and suppressed samples for each channel
+  is displayed on the serial terminal.
+
+  Use any MQTT Client app to view the published values, for example:
+    - MQTTX (https://mqttx.app/)
+    - IoT MQTT Panel App (download from Google Play or Apple App Store)
+
+  Hardware Configurations Supported:
+
+  CETA IoT Robot (Schematic #14-00069A/B), based on RPI-Pico-WH
+  (Select "Board = Raspberry Pi Pico W")
+
+  Sparkfun XRP Robot Platform (#KIT-27644), based on the RPI RP2350B MCU
+  (Select "Board = SparkFun XRP Controller")
+
+  Sparkfun XRP (Beta) Robot Platform (#KIT-22230), based on the RPI Pico W
+  (Select "Board = SparkFun XRP Controller (Beta)")
+
+  created 19 Oct 2026
+  by dBm Signal Dynamics Inc.
+
+*/
+
+#include <stdio.h>    // needed for "sprintf()" function
+#include <cetalib.h>
+
+const struct CETALIB_INTERFACE *myRobot = &CETALIB;
+
+// WiFi Parameters
+const char ssid[] = "MY_SSID";        // EDIT
+const char pass[] = "MY_PASSPHRASE";  // EDIT
+
+// MQTT Broker URL, Username, Password
+const char MQTTbroker[] = "broker.emqx.io";
+int MQTTport = 1883;    // EDIT: 1883 for open connection, or 8883 for secure connection
+const char MQTTusername[] = "";
+const char MQTTpassword[] = "";
+
+// No subscribe topics
+const char *subscribeTopicIDs[] = {""};
+int num_subscribeTopicIDs = 0;
+
+// Telemetry channel numbers
+int distanceChannel, lineChannel;
+#if defined(ARDUINO_SPARKFUN_XRP_CONTROLLER) || defined(ARDUINO_SPARKFUN_XRP_CONTROLLER_BETA)
+int leftCountsChannel, rightCountsChannel;
+#endif
+
+// Define sensor sample interval variables
+unsigned long sensorSampleCurrentTime, sensorSamplePrevTime;
+const long sensorSampleInterval = 50;     // (sample interval in mS)
+
+// Define statistics report interval variables
+unsigned long reportCurrentTime, reportPrevTime;
+const long reportInterval = 10000;        // (report interval in mS)
+
+// Define a serial terminal output buffer for messages
+char serialOutBuffer[256];
+
+void setup() {
+  Serial.begin(115200);
+  delay(2000);
+  myRobot->board->initialize();
+  myRobot->reflectance->initialize();
+  myRobot->rangefinder->initialize();
+  #if defined(ARDUINO_SPARKFUN_XRP_CONTROLLER) || defined(ARDUINO_SPARKFUN_XRP_CONTROLLER_BETA)
+  myRobot->encoder->initialize();
+  #endif
+
+  // Attempt to connect to AP and Broker
+  if (!myRobot->mqttc->connect(ssid, pass, MQTTbroker, MQTTport, MQTTusername, MQTTpassword, subscribeTopicIDs, num_subscribeTopicIDs))
+  {
+    Serial.println("Failed to initialize MQTT Client!. Stopping.");
+    myRobot->board->led_blink(10);
+    while (1)
+    {
+      myRobot->board->tasks();
+    }
+  }
+
+  // Define the channels: topic, deadband, min interval (mS), max interval (mS), smoothing
+  distanceChannel = myRobot->telemetry->add_channel("cetalib/out/distance", 2.0, 250, 30000, 0.7);
+  lineChannel = myRobot->telemetry->add_channel("cetalib/out/lineStatus", 1.0, 0, 30000, 0.0);
+  #if defined(ARDUINO_SPARKFUN_XRP_CONTROLLER) || defined(ARDUINO_SPARKFUN_XRP_CONTROLLER_BETA)
+  leftCountsChannel = myRobot->telemetry->add_channel("cetalib/out/leftCounts", 50.0, 500, 60000, 0.0);
+  rightCountsChannel = myRobot->telemetry->add_channel("cetalib/out/rightCounts", 50.0, 500, 60000, 0.0);
+  #endif
+}
+
+void loop() {
+  // Run the background tasks
+  myRobot->mqttc->tasks();
+  myRobot->board->tasks();
+  myRobot->telemetry->tasks();
+
+  // Sample the sensors
+  sensorSampleCurrentTime = millis();
+  if ((sensorSampleCurrentTime - sensorSamplePrevTime) >= sensorSampleInterval)
+  {
+    sensorSamplePrevTime = sensorSampleCurrentTime;
+    myRobot->telemetry->update(distanceChannel, myRobot->rangefinder->get_distance());
+    myRobot->telemetry->update(lineChannel, myRobot->reflectance->get_line_status());
+    #if defined(ARDUINO_SPARKFUN_XRP_CONTROLLER) || defined(ARDUINO_SPARKFUN_XRP_CONTROLLER_BETA)
+    myRobot->telemetry->update(leftCountsChannel, myRobot->encoder->get_left_position_counts());
+    myRobot->telemetry->update(rightCountsChannel, myRobot->encoder->get_right_position_counts());
+    #endif
+  }
+
+  // Report the sent/suppressed sample counts
+  reportCurrentTime = millis();
+  if ((reportCurrentTime - reportPrevTime) >= reportInterval)
+  {
+    reportPrevTime = reportCurrentTime;
+    reportChannel("distance", distanceChannel);
+    reportChannel("lineStatus", lineChannel);
+    #if defined(ARDUINO_SPARKFUN_XRP_CONTROLLER) || defined(ARDUINO_SPARKFUN_XRP_CONTROLLER_BETA)
+    reportChannel("leftCounts", leftCountsChannel);
+    reportChannel("rightCounts", rightCountsChannel);
+    #endif
+    Serial.println();
+  }
+}
+
+void reportChannel(const char *name, int channel)
+{
+  TELEMETRY_STATS *stats = myRobot->telemetry->get_stats(channel);
+  sprintf(serialOutBuffer, "%-12s samples: %6lu  sent: %5lu (heartbeats: %lu)  suppressed: %6lu",
+          name, stats->samplesIn, stats->samplesSent, stats->heartbeatsSent, stats->samplesSuppressed);
+  Serial.println(serialOutBuffer);
+}
@@ -0,0 +1 @@
+-DCETALIB_TRACE=1
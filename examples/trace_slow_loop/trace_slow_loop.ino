@@ -0,0 +1,107 @@
+/*
+  CETALIB "trace" Library Example: "trace_slow_loop.ino"
+
+  This example finds out why some iterations of the main loop are slow.
+
+  The loop samples the rangefinder (the echo measurement waits for the echo)
+  and the line sensors, and shows them on the OLED display (one I2C transfer
+  per call to board "tasks()"). While the trace is running, every tasks()
+  function, blocking wait and packet of the library is recorded with its start
+  and end time, and the sketch adds a "sketch loop" event around each loop.
+
+  When a loop takes longer than "slowLoopThreshold", tracing stops and the
+  events that led up to the slow loop are sent to the serial terminal. Press
+  the USER pushbutton to start tracing again.
+
+  Close the serial monitor and capture the trace with the
+  "utilities/trace/cetalib-trace-export.py" script, then open the JSON file it
+  writes in Perfetto (https://ui.perfetto.dev) to view the timeline.
+
+  Tracing must be built into the library: the "build_opt.h" file in this
+  sketch folder adds "-DCETALIB_TRACE=1" to the build flags.
+
+  Hardware Configurations Supported:
+
+  CETA IoT Robot (Schematic #14-00069A/B), based on RPI-Pico-WH
+  (Select "Board = Raspberry Pi Pico W")
+
+  Sparkfun XRP Robot Platform (#KIT-27644), based on the RPI RP2350B MCU
+  (Select "Board = SparkFun XRP Controller")
+
+  Sparkfun XRP (Beta) Robot Platform (#KIT-22230), based on the RPI Pico W
+  (Select "Board = SparkFun XRP Controller (Beta)")
+
+  created 19 Oct 2026
+  by dBm Signal Dynamics Inc.
+
+*/
+
+#include <stdio.h>    // needed for "sprintf()" function
+#include <cetalib.h>
+
+const struct CETALIB_INTERFACE *myRobot = &CETALIB;
+
+const unsigned long slowLoopThreshold = 15000;   // EDIT: slow loop duration (in uS)
+
+// Widget numbers of the values set by the sketch
+int distanceField, lineField;
+
+unsigned long loopCount;
+
+// Define a serial terminal output buffer for messages
+char serialOutBuffer[128];
+
+void setup() {
+  Serial.begin(115200);
+  delay(2000);
+  myRobot->board->initialize();
+  myRobot->reflectance->initialize();
+  myRobot->rangefinder->initialize();
+  if (!myRobot->oled->initialize())
+  {
+    Serial.println("Failed to initialize OLED!. Stopping.");
+    myRobot->board->led_blink(10);
+    while (1)
+    {
+      myRobot->board->tasks();
+    }
+  }
+  distanceField = myRobot->oled->add_field(0, 0, "Dist cm:", 6, 1, NULL);
+  lineField = myRobot->oled->add_field(1, 0, "Line:", 2, 0, NULL);
+
+  if (!myRobot->trace->start())
+  {
+    Serial.println("Tracing is not built in (add -DCETALIB_TRACE=1 to the build flags)");
+  }
+}
+
+void loop() {
+  unsigned long loopStartTime = micros();
+  CETALIB_TRACE_BEGIN("sketch", "loop", loopCount);
+
+  // Run the background tasks (also updates the display)
+  myRobot->board->tasks();
+
+  myRobot->oled->set_value(distanceField, myRobot->rangefinder->get_distance());
+  myRobot->oled->set_value(lineField, myRobot->reflectance->get_line_status());
+
+  CETALIB_TRACE_END("sketch", "loop", loopCount);
+  loopCount++;
+  unsigned long loopTime = micros() - loopStartTime;
+
+  if (myRobot->trace->is_running() && (loopTime >= slowLoopThreshold))
+  {
+    TRACE_STATS *stats = myRobot->trace->get_stats();
+    sprintf(serialOutBuffer, "Slow loop #%lu: %lu uS, sending %lu + %lu events",
+            loopCount - 1, loopTime, stats->events[0] - stats->overwritten[0], stats->events[1] - stats->overwritten[1]);
+    myRobot->logger->flush();
+    Serial.println(serialOutBuffer);
+    myRobot->trace->dump();
+  }
+
+  if (myRobot->board->is_button_pressed())
+  {
+    Serial.println("Tracing restarted");
+    myRobot->trace->start();
+  }
+}
@@ -41,6 +41,14 @@ extern const struct MQTTC_INTERFACE MQTTC;
 extern const struct DIFFDRIVE_INTERFACE DIFFDRIVE;
 extern const struct OLED_INTERFACE OLED;
 extern const struct JOYSTICK_INTERFACE JOYSTICK;
+extern const struct CBOR_INTERFACE CBOR;
+extern const struct TELEMETRY_INTERFACE TELEMETRY;
+extern const struct LOGGER_INTERFACE LOGGER;
+extern const struct CALSTORE_INTERFACE CALSTORE;
+extern const struct BOOT_INTERFACE BOOT;
+extern const struct DATALOG_INTERFACE DATALOG;
+extern const struct REPLAY_INTERFACE REPLAY;
+extern const struct TRACE_INTERFACE TRACE;
 
 extern const struct CETALIB_INTERFACE CETALIB = {
   .board = &BOARD,
@@ -52,7 +60,15 @@ extern const struct CETALIB_INTERFACE CETALIB = {
   .mqttc = &MQTTC,
   .diffDrive = &DIFFDRIVE,
   .oled = &OLED,
-  .joystick = &JOYSTICK
+  .joystick = &JOYSTICK,
+  .cbor = &CBOR,
+  .telemetry = &TELEMETRY,
+  .logger = &LOGGER,
+  .calstore = &CALSTORE,
+  .boot = &BOOT,
+  .datalog = &DATALOG,
+  .replay = &REPLAY,
+  .trace = &TRACE
 };
 
 #elif defined(ARDUINO_SPARKFUN_XRP_CONTROLLER)
@@ -66,6 +82,15 @@ extern const struct MQTTC_INTERFACE MQTTC;
 extern const struct DIFFDRIVE_INTERFACE DIFFDRIVE;
 extern const struct OLED_INTERFACE OLED;
 extern const struct JOYSTICK_INTERFACE JOYSTICK;
+extern const struct CBOR_INTERFACE CBOR;
+extern const struct TELEMETRY_INTERFACE TELEMETRY;
+extern const struct LOGGER_INTERFACE LOGGER;
+extern const struct CALSTORE_INTERFACE CALSTORE;
+extern const struct BOOT_INTERFACE BOOT;
+extern const struct DATALOG_INTERFACE DATALOG;
+extern const struct REPLAY_INTERFACE REPLAY;
+extern const struct TRACE_INTERFACE TRACE;
+extern const struct PATHFOLLOW_INTERFACE PATHFOLLOW;
 
 
 
@@ -80,7 +105,16 @@ extern const struct CETALIB_INTERFACE CETALIB = {
   .mqttc = &MQTTC,
   .diffDrive = &DIFFDRIVE,
   .oled = &OLED,
-  .joystick = &JOYSTICK
+  .joystick = &JOYSTICK,
+  .cbor = &CBOR,
+  .telemetry = &TELEMETRY,
+  .logger = &LOGGER,
+  .calstore = &CALSTORE,
+  .boot = &BOOT,
+  .datalog = &DATALOG,
+  .replay = &REPLAY,
+  .trace = &TRACE,
+  .pathFollow = &PATHFOLLOW
 };
 
 #elif defined(ARDUINO_SPARKFUN_XRP_CONTROLLER_BETA)
@@ -94,6 +128,15 @@ extern const struct MQTTC_INTERFACE MQTTC;
 extern const struct DIFFDRIVE_INTERFACE DIFFDRIVE;
 //extern const struct OLED_INTERFACE OLED;  // oled module not yet working on this platform
 extern const struct JOYSTICK_INTERFACE JOYSTICK;
+extern const struct CBOR_INTERFACE CBOR;
+extern const struct TELEMETRY_INTERFACE TELEMETRY;
+extern const struct LOGGER_INTERFACE LOGGER;
+extern const struct CALSTORE_INTERFACE CALSTORE;
+extern const struct BOOT_INTERFACE BOOT;
+extern const struct DATALOG_INTERFACE DATALOG;
+extern const struct REPLAY_INTERFACE REPLAY;
+extern const struct TRACE_INTERFACE TRACE;
+extern const struct PATHFOLLOW_INTERFACE PATHFOLLOW;
 
 
 
@@ -107,7 +150,16 @@ extern const struct CETALIB_INTERFACE CETALIB = {
   .rangefinder = &RANGEFINDER,
   .mqttc = &MQTTC,
   .diffDrive = &DIFFDRIVE,
-  .joystick = &JOYSTICK
+  .joystick = &JOYSTICK,
+  .cbor = &CBOR,
+  .telemetry = &TELEMETRY,
+  .logger = &LOGGER,
+  .calstore = &CALSTORE,
+  .boot = &BOOT,
+  .datalog = &DATALOG,
+  .replay = &REPLAY,
+  .trace = &TRACE,
+  .pathFollow = &PATHFOLLOW
   //.oled = &OLED
 };
 
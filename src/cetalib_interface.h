@@ -38,6 +38,15 @@
  #include "./modules/diffDrive_interface.h"
  #include "./modules/oled_interface.h"
  #include "./modules/joystick_interface.h"
+ #include "./modules/cbor_interface.h"
+ #include "./modules/telemetry_interface.h"
+ #include "./modules/logger_interface.h"
+ #include "./modules/calstore_interface.h"
+ #include "./modules/boot_interface.h"
+ #include "./modules/datalog_interface.h"
+ #include "./modules/replay_interface.h"
+ #include "./modules/trace_interface.h"
+ #include "./modules/pathFollow_interface.h"
  
  /*** Macros *******************************************************************/
  
@@ -56,6 +65,14 @@
    const struct DIFFDRIVE_INTERFACE *diffDrive;      // Pointer to a DIFFDRIVE_INTERFACE instance
    const struct OLED_INTERFACE *oled;                // Pointer to a OLED_INTERFACE instance
    const struct JOYSTICK_INTERFACE *joystick;        // Pointer to a JOYSTICK_INTERFACE instance
+   const struct CBOR_INTERFACE *cbor;                // Pointer to a CBOR_INTERFACE instance
+   const struct TELEMETRY_INTERFACE *telemetry;      // Pointer to a TELEMETRY_INTERFACE instance
+   const struct LOGGER_INTERFACE *logger;            // Pointer to a LOGGER_INTERFACE instance
+   const struct CALSTORE_INTERFACE *calstore;        // Pointer to a CALSTORE_INTERFACE instance
+   const struct BOOT_INTERFACE *boot;                // Pointer to a BOOT_INTERFACE instance
+   const struct DATALOG_INTERFACE *datalog;          // Pointer to a DATALOG_INTERFACE instance
+   const struct REPLAY_INTERFACE *replay;            // Pointer to a REPLAY_INTERFACE instance
+   const struct TRACE_INTERFACE *trace;              // Pointer to a TRACE_INTERFACE instance
  };
 
  #elif defined(ARDUINO_SPARKFUN_XRP_CONTROLLER)
@@ -71,6 +88,15 @@
    const struct DIFFDRIVE_INTERFACE *diffDrive;      // Pointer to a DIFFDRIVE_INTERFACE instance 
    const struct OLED_INTERFACE *oled;                // Pointer to a OLED_INTERFACE instance
    const struct JOYSTICK_INTERFACE *joystick;        // Pointer to a JOYSTICK_INTERFACE instance
+   const struct CBOR_INTERFACE *cbor;                // Pointer to a CBOR_INTERFACE instance
+   const struct TELEMETRY_INTERFACE *telemetry;      // Pointer to a TELEMETRY_INTERFACE instance
+   const struct LOGGER_INTERFACE *logger;            // Pointer to a LOGGER_INTERFACE instance
+   const struct CALSTORE_INTERFACE *calstore;        // Pointer to a CALSTORE_INTERFACE instance
+   const struct BOOT_INTERFACE *boot;                // Pointer to a BOOT_INTERFACE instance
+   const struct DATALOG_INTERFACE *datalog;          // Pointer to a DATALOG_INTERFACE instance
+   const struct REPLAY_INTERFACE *replay;            // Pointer to a REPLAY_INTERFACE instance
+   const struct TRACE_INTERFACE *trace;              // Pointer to a TRACE_INTERFACE instance
+   const struct PATHFOLLOW_INTERFACE *pathFollow;    // Pointer to a PATHFOLLOW_INTERFACE instance
  };
  
  #elif defined(ARDUINO_SPARKFUN_XRP_CONTROLLER_BETA)
@@ -86,6 +112,15 @@
    const struct DIFFDRIVE_INTERFACE *diffDrive;      // Pointer to a DIFFDRIVE_INTERFACE instance
    // const struct OLED_INTERFACE *oled;                // Pointer to a OLED_INTERFACE instance
    const struct JOYSTICK_INTERFACE *joystick;        // Pointer to a JOYSTICK_INTERFACE instance
+   const struct CBOR_INTERFACE *cbor;                // Pointer to a CBOR_INTERFACE instance
+   const struct TELEMETRY_INTERFACE *telemetry;      // Pointer to a TELEMETRY_INTERFACE instance
+   const struct LOGGER_INTERFACE *logger;            // Pointer to a LOGGER_INTERFACE instance
+   const struct CALSTORE_INTERFACE *calstore;        // Pointer to a CALSTORE_INTERFACE instance
+   const struct BOOT_INTERFACE *boot;                // Pointer to a BOOT_INTERFACE instance
+   const struct DATALOG_INTERFACE *datalog;          // Pointer to a DATALOG_INTERFACE instance
+   const struct REPLAY_INTERFACE *replay;            // Pointer to a REPLAY_INTERFACE instance
+   const struct TRACE_INTERFACE *trace;              // Pointer to a TRACE_INTERFACE instance
+   const struct PATHFOLLOW_INTERFACE *pathFollow;    // Pointer to a PATHFOLLOW_INTERFACE instance
    
  };
 
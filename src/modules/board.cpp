@@ -17,18 +17,39 @@
  * 
  * Sparkfun XRP Robot Platform (#KIT-27644), based on the RPI RP2350B MCU
  * (Select Board: "SparkFun XRP Controller")
- * USER LED is a WS2812B NeoPixel driven with fixed color (RED)
+ * USER LED is a WS2812B NeoPixel (default color RED)
  *
  * Sparkfun XRP (Beta) Robot Platform (#KIT-22230), based on the RPI Pico W
  * (Select "Board = SparkFun XRP Controller (Beta)")
  * USER LED is the built-in LED on the Pico W board
  *
+ * The pushbutton is read from a GPIO interrupt and debounced with a timer
+ * alarm (the level must be steady for BUTTON_DEBOUNCE_TIME). Press, release,
+ * long press and double click events are queued with their time, so presses
+ * are not missed when the loop is slow.
+ *
+ * LED blink rates, patterns and tables are played from a hardware timer, so
+ * their timing does not depend on how often board tasks() is called. The Pico W
+ * built-in LED is on the WiFi chip and cannot be written from an interrupt, so
+ * on the XRP (Beta) the timer only selects the LED level and board tasks()
+ * writes it.
+ *
  */
 
 /** Include Files *************************************************************/
 #include <Arduino.h>            // Required for Arduino functions
 #include "board.h"              // "board" API declarations
+#include "logger.h"             // "logger" functions
+#include "calstore.h"           // "calstore" functions
+#include "boot.h"               // "boot" functions
+#include "oled.h"               // "oled" functions
+#include "datalog.h"            // "datalog" functions
+#include "replay.h"             // "replay" functions
+#include "trace.h"              // "trace" event macros
 #include "board.pio.h"          // "board" PIO program declarations
+#include <string.h>             // Required for memcpy()
+#include <pico/time.h>          // Required for the LED repeating timer and button alarms
+#include <hardware/sync.h>      // Required for __wfi() and __dmb()
 
 /*** Symbolic Constants used in this module ***********************************/
 #define SERIAL_PORT Serial  // Default to Serial
@@ -49,10 +70,13 @@ extern const struct BOARD_INTERFACE BOARD = {
     .led_toggle             = &board_led_toggle,
     .led_blink              = &board_led_blink,
     .led_pattern            = &board_led_pattern,
+    .led_play               = &board_led_play,
+    .led_set_color          = &board_led_set_color,
     .is_button_pressed      = &board_is_button_pressed,
     .is_button_released     = &board_is_button_released,
     .get_button_level       = &board_get_button_level,
     .wait_for_button        = &board_wait_for_button,
+    .get_button_event       = &board_get_button_event,
     .get_potentiometer      = &board_get_potentiometer
 };
 #elif defined(ARDUINO_SPARKFUN_XRP_CONTROLLER)
@@ -64,10 +88,13 @@ extern const struct BOARD_INTERFACE BOARD = {
     .led_toggle             = &board_led_toggle,
     .led_blink              = &board_led_blink,
     .led_pattern            = &board_led_pattern,
+    .led_play               = &board_led_play,
+    .led_set_color          = &board_led_set_color,
     .is_button_pressed      = &board_is_button_pressed,
     .is_button_released     = &board_is_button_released,
     .get_button_level       = &board_get_button_level,
-    .wait_for_button        = &board_wait_for_button
+    .wait_for_button        = &board_wait_for_button,
+    .get_button_event       = &board_get_button_event
 };
 #elif defined(ARDUINO_SPARKFUN_XRP_CONTROLLER_BETA)
 extern const struct BOARD_INTERFACE BOARD = {
@@ -78,10 +105,13 @@ extern const struct BOARD_INTERFACE BOARD = {
     .led_toggle             = &board_led_toggle,
     .led_blink              = &board_led_blink,
     .led_pattern            = &board_led_pattern,
+    .led_play               = &board_led_play,
+    .led_set_color          = &board_led_set_color,
     .is_button_pressed      = &board_is_button_pressed,
     .is_button_released     = &board_is_button_released,
     .get_button_level       = &board_get_button_level,
-    .wait_for_button        = &board_wait_for_button
+    .wait_for_button        = &board_wait_for_button,
+    .get_button_event       = &board_get_button_event
 };
 #else
   #error Unsupported board selection
@@ -90,21 +120,30 @@ extern const struct BOARD_INTERFACE BOARD = {
 // led-related variables
 static LED_STATE ledState;
 static LED_FUNCTION_STATE ledFunctionState;
-static unsigned long ledBlinkCurrentTime, ledBlinkPrevTime, ledBlinkInterval;
-static unsigned long ledPatternCurrentTime, ledPatternPrevTime;
-static const long ledPatternInterval = LED_PATTERN_INTERVAL;
-static int ledOutputValue[5][10] = {       // provide 5 unique flashing patterns
-  {1, 0, 0, 0, 0, 0, 0, 0, 0, 0},   // Pattern 1 - blink 1x/sec
-  {1, 0, 1, 0, 0, 0, 0, 0, 0, 0},   // Pattern 2 - blink 2x/sec
-  {1, 0, 1, 0, 1, 0, 0, 0, 0, 0},   // Pattern 3 - blink 3x/sec
-  {1, 0, 1, 0, 1, 0, 1, 0, 0, 0},   // Pattern 4 - blink 4x/sec
-  {1, 0, 1, 0, 1, 0, 1, 0, 1, 0}    // Pattern 5 - blink 5x/sec (constant)
-};
-static int ledPatternIndex;       // row pointer: selects flashing pattern
-static int ledValueIndex;         // column pointer: selects current LED value
+static uint32_t ledColor = LED_DEFAULT_COLOR;
+static LED_STEP ledSteps[LED_MAX_STEPS];  // table played by the LED timer
+static volatile int ledNumSteps;
+static volatile int ledStepIndex;
+static repeating_timer_t ledTimer;
+static bool ledTimerRunning = false;
+#if defined(ARDUINO_SPARKFUN_XRP_CONTROLLER_BETA)
+static volatile uint32_t ledPendingColor;   // LED color selected by the timer, written by board tasks()
+static volatile bool ledOutputPending = false;
+#endif
 
 // button-related variables
-static int buttonLevelCurrent, buttonLevelPrevious;
+static volatile int buttonLevelStable;              // debounced button level
+static volatile unsigned long buttonFirstEdgeTime;  // time of the first edge of a bounce burst (in mS)
+static volatile unsigned long buttonLastEdgeTime;   // time of the most recent edge (in mS)
+static volatile bool buttonCheckPending = false;    // debounce alarm scheduled
+static volatile unsigned long buttonPressCount, buttonReleaseCount;   // debounced edges since reset
+static unsigned long buttonPressSeen, buttonReleaseSeen;  // edge counts at the previous tasks()
+static bool buttonPressed, buttonReleased;          // edge detected by the most recent tasks()
+static unsigned long buttonPressTime;               // time of the most recent press (in mS)
+static bool buttonDoubleClickArmed = false;         // the next press can complete a double click
+static alarm_id_t buttonLongPressAlarm = 0;
+static BUTTON_EVENT buttonEvents[BUTTON_EVENT_QUEUE_SIZE];
+static volatile int buttonEventHead, buttonEventTail;
 
 // define neopixel-related variables/functions
 #if defined(ARDUINO_SPARKFUN_XRP_CONTROLLER)
@@ -112,7 +151,10 @@ PIO pio;
 uint sm;
 uint offset;
 static inline void put_pixel(PIO pio, uint sm, uint32_t pixel_grb) {
-    pio_sm_put_blocking(pio, sm, pixel_grb << 8u);
+    // Never waits: the FIFO holds 4 pixels, and only the newest one matters
+    if (!pio_sm_is_tx_fifo_full(pio, sm)) {
+        pio_sm_put(pio, sm, pixel_grb << 8u);
+    }
 }
 static inline uint32_t urgb_u32(uint8_t r, uint8_t g, uint8_t b) {
     return
@@ -123,6 +165,14 @@ static inline uint32_t urgb_u32(uint8_t r, uint8_t g, uint8_t b) {
 #endif
 
 /*** Private Function Prototypes **********************************************/
+static void ledOutput(uint32_t color);                  // Write a color to the USER LED
+static void ledStart(int numSteps);                     // Play the steps in "ledSteps" from the LED timer
+static void ledStop(void);                              // Stop the LED timer
+static bool ledTimerCallback(repeating_timer_t *rt);    // Show the next LED step (timer interrupt)
+static void buttonIsr(void);                            // Pushbutton edge (GPIO interrupt)
+static int64_t buttonDebounceCallback(alarm_id_t id, void *userData);   // Accept a steady button level (timer interrupt)
+static int64_t buttonLongPressCallback(alarm_id_t id, void *userData);  // Button still held (timer interrupt)
+static void buttonQueueEvent(enum BUTTON_EVENT_TYPE type, unsigned long time);  // Add an event to the queue
 
 /*** Public Function Definitions **********************************************/
 
@@ -136,7 +186,7 @@ void board_init(void)
         bool success = pio_claim_free_sm_and_add_program_for_gpio_range(&ws2812_program, &pio, &sm, &offset, LED_PIN, 1, true);
         hard_assert(success);
         ws2812_program_init(pio, sm, offset, LED_PIN, 800000, IS_RGBW);
-        put_pixel(pio, sm, urgb_u32(0, 0, 0));
+        ledOutput(0);
     #else
         #error Unsupported board selection
     #endif
@@ -146,8 +196,13 @@ void board_init(void)
     // initiallize pushbutton
     pinMode(BUTTON_PIN, INPUT); // set digital pin as input
     
-    delay(500);                                     // wait for button level to stabilize
-    buttonLevelCurrent = digitalRead(BUTTON_PIN);   // save button level
+    delayMicroseconds(BUTTON_SETTLE_TIME);          // wait for button level to stabilize
+    buttonLevelStable = digitalRead(BUTTON_PIN);    // save button level
+    buttonPressSeen = buttonPressCount;             // no button edge until the next press/release
+    buttonReleaseSeen = buttonReleaseCount;
+    buttonPressed = false;
+    buttonReleased = false;
+    attachInterrupt(digitalPinToInterrupt(BUTTON_PIN), buttonIsr, CHANGE);
 
     #if defined(ARDUINO_RASPBERRY_PI_PICO_W)
     // initialize ADC resolution to 12-bit
@@ -157,108 +212,62 @@ void board_init(void)
 
 void board_tasks(void)
 {
-    switch(ledFunctionState)
-    {
-        case DEFAULT:
-            break;
+    CETALIB_TRACE_BEGIN("board", "tasks", 0);
 
-        case BLINK:
-            ledBlinkCurrentTime = millis();
-            if((ledBlinkCurrentTime - ledBlinkPrevTime) >= ledBlinkInterval)
-            {
-                switch(ledState)
-                {
-                    case OFF:
-                        #if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_SPARKFUN_XRP_CONTROLLER_BETA)
-                            digitalWrite(LED_PIN, 1);
-                        #elif defined(ARDUINO_SPARKFUN_XRP_CONTROLLER)
-                            put_pixel(pio, sm, urgb_u32(10, 0, 0));
-                        #else
-                            #error Unsupported board selection
-                        #endif
-                        ledState = ON;
-                        break;
-                    case ON:
-                        #if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_SPARKFUN_XRP_CONTROLLER_BETA)
-                            digitalWrite(LED_PIN, 0);
-                        #elif defined(ARDUINO_SPARKFUN_XRP_CONTROLLER)
-                            put_pixel(pio, sm, urgb_u32(0, 0, 0));
-                        #else
-                            #error Unsupported board selection
-                        #endif
-                        ledState = OFF;
-                        break;
-                    default:
-                        break;
-                }
-                ledBlinkPrevTime = ledBlinkCurrentTime;        
-            }
-            break;
-        
-        case PATTERN:
-            ledPatternCurrentTime = millis();
-            if((ledPatternCurrentTime - ledPatternPrevTime) >= ledPatternInterval)
-            {
-                ledPatternPrevTime = ledPatternCurrentTime;
-                if(ledValueIndex > 9)
-                {
-                    ledValueIndex = 0;
-                }
-
-                if(0 == ledOutputValue[ledPatternIndex][ledValueIndex++])
-                {
-                    #if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_SPARKFUN_XRP_CONTROLLER_BETA)
-                        digitalWrite(LED_PIN, 0);
-                    #elif defined(ARDUINO_SPARKFUN_XRP_CONTROLLER)
-                        put_pixel(pio, sm, urgb_u32(0, 0, 0));
-                    #else
-                        #error Unsupported board selection
-                    #endif
-                }
-                else
-                {
-                    #if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_SPARKFUN_XRP_CONTROLLER_BETA)
-                        digitalWrite(LED_PIN, 1);
-                    #elif defined(ARDUINO_SPARKFUN_XRP_CONTROLLER)
-                        put_pixel(pio, sm, urgb_u32(10, 0, 0));
-                    #else
-                        #error Unsupported board selection
-                    #endif
-                }
-            }
-            break;
-        
-        default:
-            break;
+    // The module tasks below return at once while their module is not in use
+    // (no log message queued, no unsaved calibration, no boot steps, no OLED,
+    // no data log or trace running), so an unused module costs one call
+
+    // Send queued log messages to the serial port
+    logger_tasks();
+
+    // Save deferred calibration store changes
+    calstore_tasks();
+
+    // Poll the module initializations started by the boot orchestrator
+    boot_tasks();
+
+    // Send the next changed part of the OLED framebuffer
+    oled_tasks();
+
+    // Write a full data log buffer to flash
+    datalog_tasks();
+
+    // Write (or read ahead) the sensor input trace
+    replay_tasks();
+
+    #if defined(ARDUINO_SPARKFUN_XRP_CONTROLLER_BETA)
+    // Write the LED level selected by the LED timer
+    if (ledOutputPending)
+    {
+        ledOutputPending = false;
+        ledOutput(ledPendingColor);
     }
+    #endif
 
-    buttonLevelPrevious = buttonLevelCurrent;
-    buttonLevelCurrent = digitalRead(BUTTON_PIN);
+    // Latch the button edges accepted since the previous call
+    unsigned long count = buttonPressCount;
+    buttonPressed = (count != buttonPressSeen);
+    buttonPressSeen = count;
+    count = buttonReleaseCount;
+    buttonReleased = (count != buttonReleaseSeen);
+    buttonReleaseSeen = count;
 
+    CETALIB_TRACE_END("board", "tasks", 0);
 }
 
 void board_led_on(void)
 {
-    #if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_SPARKFUN_XRP_CONTROLLER_BETA)
-        digitalWrite(LED_PIN, 1);
-    #elif defined(ARDUINO_SPARKFUN_XRP_CONTROLLER)
-        put_pixel(pio, sm, urgb_u32(10, 0, 0));
-    #else
-        #error Unsupported board selection
-    #endif
+    ledStop();
+    ledOutput(ledColor);
     ledState = ON;
     ledFunctionState = DEFAULT;
 }
 
 void board_led_off(void)
 {
-    #if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_SPARKFUN_XRP_CONTROLLER_BETA)
-        digitalWrite(LED_PIN, 0);
-    #elif defined(ARDUINO_SPARKFUN_XRP_CONTROLLER)
-        put_pixel(pio, sm, urgb_u32(0, 0, 0));
-    #else
-        #error Unsupported board selection
-    #endif
+    ledStop();
+    ledOutput(0);
     ledState = OFF;
     ledFunctionState = DEFAULT;
 }
@@ -280,80 +289,117 @@ void board_led_toggle(void)
 
 void board_led_blink(int frequency)
 {
-    float blinkInterval;
     if(frequency <= 0)
     {
-        SERIAL_PORT.println("Led Blink Frequency out of range (<= 0 Hz). Led Off");
+        CETALIB_LOG_WARN("Led Blink Frequency out of range (<= 0 Hz). Led Off");
         board_led_off();
         return;
     }
     else if(frequency > 20)
     {
-        ledBlinkInterval = 25;
-        SERIAL_PORT.println("Led Blink Frequency out of range (> 20 Hz). Freq = 20 Hz");
-        ledBlinkPrevTime = millis();
-        ledFunctionState = BLINK;
+        CETALIB_LOG_WARN("Led Blink Frequency out of range (> 20 Hz). Freq = 20 Hz");
+        frequency = 20;
     }
     else
     {
-        blinkInterval = (1.0/frequency)*0.5;
-        ledBlinkInterval = (unsigned long)(blinkInterval*1000);
-        //SERIAL_PORT.print("Led Blink Frequency (Hz): ");
-        //SERIAL_PORT.println(frequency);
-        ledBlinkPrevTime = millis();
-        ledFunctionState = BLINK;
+        CETALIB_LOG_DEBUG("Led Blink Frequency (Hz): %d", frequency);
     }
+    ledStop();
+    ledSteps[0].color = ledColor;
+    ledSteps[0].duration = 500 / frequency;
+    ledSteps[1].color = 0;
+    ledSteps[1].duration = 500 / frequency;
+    ledStart(2);
+    ledFunctionState = BLINK;
 }
 
 void board_led_pattern(int pattern)
 {
     if((pattern < 1)||(pattern > 5))
     {
-        SERIAL_PORT.println("Led Pattern selection is out of range (1 - 5). Disabled.");
+        CETALIB_LOG_WARN("Led Pattern selection is out of range (1 - 5). Disabled.");
         board_led_off();
         return;
     }
-    else
+
+    // "pattern" flashes, then off for the rest of the second
+    ledStop();
+    int numSteps = 0;
+    for(int i = 0; i < pattern; i++)
     {
-        ledPatternPrevTime = millis();
-        ledPatternIndex = pattern - 1;
-        ledFunctionState = PATTERN;
+        ledSteps[numSteps].color = ledColor;
+        ledSteps[numSteps++].duration = LED_PATTERN_INTERVAL;
+        ledSteps[numSteps].color = 0;
+        ledSteps[numSteps++].duration = LED_PATTERN_INTERVAL;
     }
+    ledSteps[numSteps - 1].duration = (10 - (2 * pattern) + 1) * LED_PATTERN_INTERVAL;
+    ledStart(numSteps);
+    ledFunctionState = PATTERN;
 }
 
-bool board_is_button_pressed(void)
+void board_led_play(const LED_STEP *steps, int numSteps)
 {
-    if((buttonLevelCurrent==0)&&(buttonLevelPrevious==1)){
-        return true;
+    if((steps == NULL) || (numSteps < 1))
+    {
+        board_led_off();
+        return;
     }
-    else
+    if(numSteps > LED_MAX_STEPS)
     {
-        return false;
+        CETALIB_LOG_WARN("Led table too long (> %d steps). Truncated.", LED_MAX_STEPS);
+        numSteps = LED_MAX_STEPS;
     }
+    ledStop();
+    memcpy(ledSteps, steps, numSteps * sizeof(LED_STEP));
+    ledStart(numSteps);
+    ledFunctionState = PATTERN;
 }
 
-bool board_is_button_released(void)
+void board_led_set_color(uint32_t color)
 {
-    if((buttonLevelCurrent==1)&&(buttonLevelPrevious==0)){
-        return true;
-    }
-    else
+    ledColor = color;
+    if((ledFunctionState == DEFAULT) && (ledState == ON))
     {
-        return false;
-    } 
+        ledOutput(ledColor);
+    }
+}
+
+bool board_is_button_pressed(void)
+{
+    return buttonPressed;
+}
+
+bool board_is_button_released(void)
+{
+    return buttonReleased;
 }
 
 void board_wait_for_button(void)
 {
-    do
+    // Sleep until the next interrupt (button, timers, USB...) between checks
+    board_tasks();
+    while (!board_is_button_pressed())
     {
+        __wfi();
         board_tasks();
-    } while (!board_is_button_pressed());  
+    }
 }
 
 int board_get_button_level(void)
 {
-    return (digitalRead(BUTTON_PIN));
+    return buttonLevelStable;
+}
+
+bool board_get_button_event(BUTTON_EVENT *event)
+{
+    if(buttonEventTail == buttonEventHead)
+    {
+        return false;
+    }
+    *event = buttonEvents[buttonEventTail];
+    __dmb();    // finish reading the entry before the ISR may reuse it
+    buttonEventTail = (buttonEventTail + 1) % BUTTON_EVENT_QUEUE_SIZE;
+    return true;
 }
 
 #if defined(ARDUINO_RASPBERRY_PI_PICO_W)
@@ -365,3 +411,142 @@ int board_get_potentiometer(void)
 }
 #endif
 
+/*** Private Function Definitions *********************************************/
+
+static void ledOutput(uint32_t color)
+{
+    #if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_SPARKFUN_XRP_CONTROLLER_BETA)
+        digitalWrite(LED_PIN, (color != 0) ? 1 : 0);
+    #elif defined(ARDUINO_SPARKFUN_XRP_CONTROLLER)
+        put_pixel(pio, sm, urgb_u32((color >> 16) & 0xFF, (color >> 8) & 0xFF, color & 0xFF));
+    #else
+        #error Unsupported board selection
+    #endif
+}
+
+static void ledStart(int numSteps)
+{
+    for(int i = 0; i < numSteps; i++)
+    {
+        if(ledSteps[i].duration == 0)
+        {
+            ledSteps[i].duration = 1;
+        }
+    }
+    ledNumSteps = numSteps;
+    ledStepIndex = 0;
+    ledOutput(ledSteps[0].color);
+    if(numSteps > 1)
+    {
+        // negative delay: each step is timed from the start of the previous one (no drift)
+        ledTimerRunning = add_repeating_timer_ms(-ledSteps[0].duration, ledTimerCallback, NULL, &ledTimer);
+    }
+}
+
+static void ledStop(void)
+{
+    if(ledTimerRunning)
+    {
+        cancel_repeating_timer(&ledTimer);
+        ledTimerRunning = false;
+    }
+    #if defined(ARDUINO_SPARKFUN_XRP_CONTROLLER_BETA)
+    ledOutputPending = false;
+    #endif
+}
+
+// Runs at the end of each LED step from a hardware alarm, so LED timing does
+// not depend on the sketch loop
+static bool ledTimerCallback(repeating_timer_t *rt)
+{
+    int index = ledStepIndex + 1;
+    if(index >= ledNumSteps)
+    {
+        index = 0;
+    }
+    ledStepIndex = index;
+    #if defined(ARDUINO_SPARKFUN_XRP_CONTROLLER_BETA)
+        ledPendingColor = ledSteps[index].color;
+        ledOutputPending = true;
+    #else
+        ledOutput(ledSteps[index].color);
+    #endif
+    rt->delay_us = -((int64_t)ledSteps[index].duration * 1000);
+    return true;
+}
+
+static void buttonIsr(void)
+{
+    buttonLastEdgeTime = millis();
+    if(!buttonCheckPending)
+    {
+        // First edge of a (possibly bouncing) change: check the level once it is steady
+        buttonCheckPending = true;
+        buttonFirstEdgeTime = buttonLastEdgeTime;
+        add_alarm_in_ms(BUTTON_DEBOUNCE_TIME, buttonDebounceCallback, NULL, true);
+    }
+}
+
+static int64_t buttonDebounceCallback(alarm_id_t id, void *userData)
+{
+    unsigned long steadyTime = millis() - buttonLastEdgeTime;
+    if(steadyTime < BUTTON_DEBOUNCE_TIME)
+    {
+        return (BUTTON_DEBOUNCE_TIME - steadyTime) * 1000;     // still bouncing, check again later (in uS)
+    }
+
+    int level = digitalRead(BUTTON_PIN);
+    if(level != buttonLevelStable)
+    {
+        buttonLevelStable = level;
+        if(level == 0)
+        {
+            buttonPressCount++;
+            buttonQueueEvent(BUTTON_EVENT_PRESS, buttonFirstEdgeTime);
+            if(buttonDoubleClickArmed && ((buttonFirstEdgeTime - buttonPressTime) <= BUTTON_DOUBLE_CLICK_TIME))
+            {
+                buttonQueueEvent(BUTTON_EVENT_DOUBLE_CLICK, buttonFirstEdgeTime);
+                buttonDoubleClickArmed = false;     // a third press starts a new click
+            }
+            else
+            {
+                buttonDoubleClickArmed = true;
+            }
+            buttonPressTime = buttonFirstEdgeTime;
+            buttonLongPressAlarm = add_alarm_in_ms(BUTTON_LONG_PRESS_TIME - (millis() - buttonFirstEdgeTime), buttonLongPressCallback, NULL, true);
+        }
+        else
+        {
+            buttonReleaseCount++;
+            buttonQueueEvent(BUTTON_EVENT_RELEASE, buttonFirstEdgeTime);
+            if(buttonLongPressAlarm > 0)
+            {
+                cancel_alarm(buttonLongPressAlarm);
+                buttonLongPressAlarm = 0;
+            }
+        }
+    }
+    buttonCheckPending = false;
+    return 0;
+}
+
+static int64_t buttonLongPressCallback(alarm_id_t id, void *userData)
+{
+    buttonLongPressAlarm = 0;
+    buttonDoubleClickArmed = false;     // a long press is not the first click of a double click
+    buttonQueueEvent(BUTTON_EVENT_LONG_PRESS, millis());
+    return 0;
+}
+
+static void buttonQueueEvent(enum BUTTON_EVENT_TYPE type, unsigned long time)
+{
+    int next = (buttonEventHead + 1) % BUTTON_EVENT_QUEUE_SIZE;
+    if(next == buttonEventTail)
+    {
+        return;     // queue full, the newest event is dropped
+    }
+    buttonEvents[buttonEventHead].type = type;
+    buttonEvents[buttonEventHead].time = time;
+    __dmb();    // the entry must be visible before the head publishes it
+    buttonEventHead = next;
+}
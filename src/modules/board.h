@@ -53,6 +53,14 @@
    #error Unsupported board selection
  #endif
  
+ #define BUTTON_SETTLE_TIME 1000    // Button input settling time after pinMode() (in uS)
+ #define BUTTON_DEBOUNCE_TIME 20   // Time the button level must be steady to be accepted (in mS)
+ #define BUTTON_LONG_PRESS_TIME 1000    // Hold time reported as a long press (in mS)
+ #define BUTTON_DOUBLE_CLICK_TIME 400   // Max time between the presses of a double click (in mS)
+ #define BUTTON_EVENT_QUEUE_SIZE 8  // Max number of queued button events
+ #define LED_DEFAULT_COLOR 0x0A0000 // USER LED color (0xRRGGBB) until led_set_color() is called
+ #define LED_MAX_STEPS 16           // Max number of steps in an LED table
+ 
  /*** Custom Data Types ********************************************************/
  typedef enum {OFF, ON} LED_STATE;
  typedef enum {DEFAULT, BLINK, PATTERN} LED_FUNCTION_STATE;
@@ -67,10 +75,13 @@
  void board_led_toggle(void);            // Toggle USER LED
  void board_led_blink(int frequency);    // Blink the USER LED at a rate of 1-20 Hz
  void board_led_pattern(int pattern);    // Flash a specific pattern on the USER LED (1-5)
+ void board_led_play(const LED_STEP *steps, int numSteps); // Repeat a table of LED colors/durations on the USER LED
+ void board_led_set_color(uint32_t color); // Set the USER LED color (0xRRGGBB)
  bool board_is_button_pressed(void);     // Did we detect a pushbutton press?
  bool board_is_button_released(void);    // Did we detect a pushbutton release?
  int board_get_button_level(void);       // Get current pushbutton level
  void board_wait_for_button(void);       // Careful - this is a blocking function!!!
+ bool board_get_button_event(BUTTON_EVENT *event); // Get the oldest pushbutton event
  int board_get_potentiometer(void);      // Get current potentiometer reading (0-4095)
  #elif defined(ARDUINO_SPARKFUN_XRP_CONTROLLER)
  void board_init(void);                  // Initiallize pins & state variables
@@ -80,10 +91,13 @@
  void board_led_toggle(void);            // Toggle USER LED
  void board_led_blink(int frequency);    // Blink the USER LED at a rate of 1-20 Hz
  void board_led_pattern(int pattern);    // Flash a specific pattern on the USER LED (1-5)
+ void board_led_play(const LED_STEP *steps, int numSteps); // Repeat a table of LED colors/durations on the USER LED
+ void board_led_set_color(uint32_t color); // Set the USER LED color (0xRRGGBB)
  bool board_is_button_pressed(void);     // Did we detect a pushbutton press?
  bool board_is_button_released(void);    // Did we detect a pushbutton release?
  int board_get_button_level(void);       // Get current pushbutton level
  void board_wait_for_button(void);       // Careful - this is a blocking function!!!
+ bool board_get_button_event(BUTTON_EVENT *event); // Get the oldest pushbutton event
  #elif defined(ARDUINO_SPARKFUN_XRP_CONTROLLER_BETA)
  void board_init(void);                  // Initiallize pins & state variables
  void board_tasks(void);                 // Run all background tasks
@@ -92,10 +106,13 @@
  void board_led_toggle(void);            // Toggle USER LED
  void board_led_blink(int frequency);    // Blink the USER LED at a rate of 1-20 Hz
  void board_led_pattern(int pattern);    // Flash a specific pattern on the USER LED (1-5)
+ void board_led_play(const LED_STEP *steps, int numSteps); // Repeat a table of LED colors/durations on the USER LED
+ void board_led_set_color(uint32_t color); // Set the USER LED color (0xRRGGBB)
  bool board_is_button_pressed(void);     // Did we detect a pushbutton press?
  bool board_is_button_released(void);    // Did we detect a pushbutton release?
  int board_get_button_level(void);       // Get current pushbutton level
  void board_wait_for_button(void);       // Careful - this is a blocking function!!!
+ bool board_get_button_event(BUTTON_EVENT *event); // Get the oldest pushbutton event
  #else
    #error Unsupported board selection
  #endif
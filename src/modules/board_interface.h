@@ -32,6 +32,20 @@
  
  /*** Custom Data Types ********************************************************/
  
+ typedef struct
+ {
+   uint32_t color;                       // LED color (0xRRGGBB), 0 = off (single color LEDs: any other value = on)
+   uint16_t duration;                    // time the color is shown (in mS)
+ } LED_STEP;
+ 
+ enum BUTTON_EVENT_TYPE {BUTTON_EVENT_PRESS=0, BUTTON_EVENT_RELEASE, BUTTON_EVENT_LONG_PRESS, BUTTON_EVENT_DOUBLE_CLICK};
+ 
+ typedef struct
+ {
+   enum BUTTON_EVENT_TYPE type;          // press, release, long press or double click
+   unsigned long time;                   // time of the event (in mS since reset)
+ } BUTTON_EVENT;
+ 
  #if defined(ARDUINO_RASPBERRY_PI_PICO_W)
  struct BOARD_INTERFACE
  {
@@ -42,10 +56,13 @@
    void (*led_toggle)(void);             // Toggle USER LED
    void (*led_blink)(int frequency);     // Blink the USER LED at a rate of 1-20 Hz
    void (*led_pattern)(int pattern);     // Flash a specific pattern on the USER LED (1-5)
+   void (*led_play)(const LED_STEP *steps, int numSteps); // Repeat a table of LED colors/durations on the USER LED
+   void (*led_set_color)(uint32_t color); // Set the USER LED color (0xRRGGBB) used by led_on(), led_blink() and led_pattern()
    bool (*is_button_pressed)(void);      // Did we detect a pushbutton press?
    bool (*is_button_released)(void);     // Did we detect a pushbutton release?
    int (*get_button_level)(void);        // Get current pushbutton level
    void (*wait_for_button)(void);        // Careful! This is a blocking function
+   bool (*get_button_event)(BUTTON_EVENT *event); // Get the oldest pushbutton event, returns false if there is none
    int (*get_potentiometer)(void);       // Get current potentiometer reading (0-4095)
  };
  #elif defined(ARDUINO_SPARKFUN_XRP_CONTROLLER)
@@ -58,10 +75,13 @@
    void (*led_toggle)(void);             // Toggle USER LED
    void (*led_blink)(int frequency);     // Blink the USER LED at a rate of 1-20 Hz
    void (*led_pattern)(int pattern);     // Flash a specific pattern on the USER LED (1-5)
+   void (*led_play)(const LED_STEP *steps, int numSteps); // Repeat a table of LED colors/durations on the USER LED
+   void (*led_set_color)(uint32_t color); // Set the USER LED color (0xRRGGBB) used by led_on(), led_blink() and led_pattern()
    bool (*is_button_pressed)(void);      // Did we detect a pushbutton press?
    bool (*is_button_released)(void);     // Did we detect a pushbutton release?
    int (*get_button_level)(void);        // Get current pushbutton level
    void (*wait_for_button)(void);        // Careful! This is a blocking function
+   bool (*get_button_event)(BUTTON_EVENT *event); // Get the oldest pushbutton event, returns false if there is none
  };
  #elif defined(ARDUINO_SPARKFUN_XRP_CONTROLLER_BETA)
  struct BOARD_INTERFACE
@@ -73,10 +93,13 @@
    void (*led_toggle)(void);             // Toggle USER LED
    void (*led_blink)(int frequency);     // Blink the USER LED at a rate of 1-20 Hz
    void (*led_pattern)(int pattern);     // Flash a specific pattern on the USER LED (1-5)
+   void (*led_play)(const LED_STEP *steps, int numSteps); // Repeat a table of LED colors/durations on the USER LED
+   void (*led_set_color)(uint32_t color); // Set the USER LED color (0xRRGGBB) used by led_on(), led_blink() and led_pattern()
    bool (*is_button_pressed)(void);      // Did we detect a pushbutton press?
    bool (*is_button_released)(void);     // Did we detect a pushbutton release?
    int (*get_button_level)(void);        // Get current pushbutton level
    void (*wait_for_button)(void);        // Careful! This is a blocking function
+   bool (*get_button_event)(BUTTON_EVENT *event); // Get the oldest pushbutton event, returns false if there is none
  };
  #else
    #error Unsupported board selection
@@ -0,0 +1,211 @@
+/*
+ * Copyright (C) 2026 dBm Signal Dynamics Inc.
+ *
+ * File:            boot.cpp
+ * Project:
+ * Date:            Oct 19, 2026
+ * Framework:       Arduino w. Arduino-Pico Core Pkge by Earl Philhower
+ *                  (https://github.com/earlephilhower/arduino-pico)
+ *
+ * cetalib "boot" startup orchestrator
+ *
+ * A sketch defines its module initializations as steps, each with a start()
+ * function and an optional poll() function. run() starts every step in turn
+ * without waiting for the slow ones (WiFi association, broker connection...),
+ * and tasks() polls the running steps until they complete, so they overlap.
+ * The start and completion time of each step is recorded, as well as the time
+ * all "required" steps completed (e.g. the robot accepts drive commands).
+ *
+ * Hardware Configurations Supported:
+ *
+ * CETA IoT Robot (Schematic #14-00069A/B), based on RPI-Pico-WH
+ * (Select "Board = Raspberry Pi Pico W")
+ *
+ * Sparkfun XRP Robot Platform (#KIT-27644), based on the RPI RP2350B MCU
+ * (Select "Board = SparkFun XRP Controller")
+ *
+ * Sparkfun XRP (Beta) Robot Platform (#KIT-22230), based on the RPI Pico W
+ * (Select "Board = SparkFun XRP Controller (Beta)")
+ *
+ */
+
+/** Include Files *************************************************************/
+#include <Arduino.h>                // Required for Arduino functions
+#include "logger.h"                 // "logger" functions
+#include "boot.h"                   // "boot" API declarations
+#include "trace.h"                  // "trace" event macros
+
+/*** Symbolic Constants used in this module ***********************************/
+#define SERIAL_PORT Serial  // Default to Serial
+#if defined(NO_USB)
+    #undef SERIAL_PORT
+    #define SERIAL_PORT Serial1     // Use Serial1 if USB is disabled
+#endif
+
+/*** Global Variable Declarations *********************************************/
+
+// define the function interface
+extern const struct BOOT_INTERFACE BOOT = {
+    .add_step               = &boot_add_step,
+    .run                    = &boot_run,
+    .tasks                  = &boot_tasks,
+    .is_ready               = &boot_is_ready,
+    .get_ready_time         = &boot_get_ready_time,
+    .get_num_steps          = &boot_get_num_steps,
+    .get_step               = &boot_get_step,
+    .print_timeline         = &boot_print_timeline
+};
+
+static BOOT_STEP bootSteps[BOOT_MAX_STEPS];
+static int bootNumSteps = 0;
+static bool bootRunning = false;            // run() has been called
+static bool bootPolling = false;            // tasks() is polling the steps (a poll() function may call board tasks())
+static unsigned long bootReadyTime = 0;     // time all required steps completed (in uS since reset)
+
+/*** Type Declarations ********************************************************/
+
+/*** Private Function Prototypes **********************************************/
+static void bootCompleteStep(BOOT_STEP *step, enum BOOT_STEP_STATE state);  // Record the end of a step
+static void bootCheckReady(void);                                           // Record the time all required steps completed
+
+/*** Public Function Definitions **********************************************/
+
+int boot_add_step(const char *name, bool (*start)(void), bool (*poll)(void), bool required)
+{
+  if(bootNumSteps >= BOOT_MAX_STEPS)
+  {
+    CETALIB_LOG_ERROR("boot: too many steps");
+    return -1;
+  }
+  BOOT_STEP *step = &bootSteps[bootNumSteps];
+  step->name = name;
+  step->start = start;
+  step->poll = poll;
+  step->required = required;
+  step->state = BOOT_STEP_PENDING;
+  step->startTime = 0;
+  step->endTime = 0;
+  return bootNumSteps++;
+}
+
+void boot_run(void)
+{
+  bootRunning = true;
+  for(int i = 0; i < bootNumSteps; i++)
+  {
+    BOOT_STEP *step = &bootSteps[i];
+    if(step->state != BOOT_STEP_PENDING)
+    {
+      continue;
+    }
+    step->startTime = micros();
+    step->state = BOOT_STEP_RUNNING;
+    if((step->start != NULL) && !step->start())
+    {
+      bootCompleteStep(step, BOOT_STEP_FAILED);
+    }
+    else if(step->poll == NULL)
+    {
+      bootCompleteStep(step, BOOT_STEP_DONE);
+    }
+  }
+  bootCheckReady();
+}
+
+void boot_tasks(void)
+{
+  if(!bootRunning || bootPolling)
+  {
+    return;
+  }
+  CETALIB_TRACE_BEGIN("boot", "tasks", bootNumSteps);
+  bootPolling = true;
+  for(int i = 0; i < bootNumSteps; i++)
+  {
+    BOOT_STEP *step = &bootSteps[i];
+    if((step->state == BOOT_STEP_RUNNING) && step->poll())
+    {
+      bootCompleteStep(step, BOOT_STEP_DONE);
+    }
+  }
+  bootPolling = false;
+  bootCheckReady();
+  CETALIB_TRACE_END("boot", "tasks", 0);
+}
+
+bool boot_is_ready(void)
+{
+  return (bootReadyTime != 0);
+}
+
+unsigned long boot_get_ready_time(void)
+{
+  return bootReadyTime;
+}
+
+int boot_get_num_steps(void)
+{
+  return bootNumSteps;
+}
+
+const BOOT_STEP* boot_get_step(int step)
+{
+  if((step < 0) || (step >= bootNumSteps))
+  {
+    return NULL;
+  }
+  return &bootSteps[step];
+}
+
+void boot_print_timeline(void)
+{
+  static const char *stateNames[] = {"pending", "running", "done", "FAILED"};
+  CETALIB_LOG_INFO("boot: step            start mS    end mS  time mS");
+  for(int i = 0; i < bootNumSteps; i++)
+  {
+    BOOT_STEP *step = &bootSteps[i];
+    if(step->endTime)
+    {
+      CETALIB_LOG_INFO("boot: %-14s %9.1f %9.1f %8.1f %s%s", step->name, step->startTime / 1000.0f, step->endTime / 1000.0f,
+                       (step->endTime - step->startTime) / 1000.0f, stateNames[step->state], step->required ? "" : " (background)");
+    }
+    else
+    {
+      CETALIB_LOG_INFO("boot: %-14s %9.1f         -        - %s%s", step->name, step->startTime / 1000.0f,
+                       stateNames[step->state], step->required ? "" : " (background)");
+    }
+  }
+  if(bootReadyTime)
+  {
+    CETALIB_LOG_INFO("boot: ready at %.1f mS", bootReadyTime / 1000.0f);
+  }
+}
+
+/*** Private Function Definitions *********************************************/
+
+static void bootCompleteStep(BOOT_STEP *step, enum BOOT_STEP_STATE state)
+{
+  step->endTime = micros();
+  step->state = state;
+  if(state == BOOT_STEP_FAILED)
+  {
+    CETALIB_LOG_ERROR("boot: %s failed", step->name);
+  }
+}
+
+static void bootCheckReady(void)
+{
+  if(bootReadyTime)
+  {
+    return;
+  }
+  for(int i = 0; i < bootNumSteps; i++)
+  {
+    if(bootSteps[i].required && ((bootSteps[i].state == BOOT_STEP_PENDING) || (bootSteps[i].state == BOOT_STEP_RUNNING)))
+    {
+      return;
+    }
+  }
+  bootReadyTime = micros();
+  CETALIB_LOG_INFO("boot: ready at %.1f mS", bootReadyTime / 1000.0f);
+}
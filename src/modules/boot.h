@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2026 dBm Signal Dynamics Inc.
+ *
+ * File:            boot.h
+ * Project:
+ * Date:            Oct 19, 2026
+ * Framework:       Arduino w. Arduino-Pico Core Pkge by Earl Philhower
+ *                  (https://github.com/earlephilhower/arduino-pico)
+ *
+ * cetalib "boot" startup orchestrator
+ *
+ * A sketch defines its module initializations as steps, each with a start()
+ * function and an optional poll() function. run() starts every step in turn
+ * without waiting for the slow ones (WiFi association, broker connection...),
+ * and tasks() polls the running steps until they complete, so they overlap.
+ * The start and completion time of each step is recorded, as well as the time
+ * all "required" steps completed (e.g. the robot accepts drive commands).
+ *
+ * Hardware Configurations Supported:
+ *
+ * CETA IoT Robot (Schematic #14-00069A/B), based on RPI-Pico-WH
+ * (Select "Board = Raspberry Pi Pico W")
+ *
+ * Sparkfun XRP Robot Platform (#KIT-27644), based on the RPI RP2350B MCU
+ * (Select "Board = SparkFun XRP Controller")
+ *
+ * Sparkfun XRP (Beta) Robot Platform (#KIT-22230), based on the RPI Pico W
+ * (Select "Board = SparkFun XRP Controller (Beta)")
+ *
+ */
+
+#ifndef BOOT_H_
+#define BOOT_H_
+
+/*** Include Files ************************************************************/
+#include <Arduino.h>
+#include "boot_interface.h"
+
+/*** Macros *******************************************************************/
+#define BOOT_MAX_STEPS      12      // Max number of initialization steps
+
+/*** Custom Data Types ********************************************************/
+
+/*** Public Function Prototypes ***********************************************/
+int boot_add_step(const char *name, bool (*start)(void), bool (*poll)(void), bool required); // Define an initialization step
+void boot_run(void);                                    // Start all steps
+void boot_tasks(void);                                  // Poll the running steps
+bool boot_is_ready(void);                               // Check if all required steps are complete
+unsigned long boot_get_ready_time(void);                // Returns the time all required steps completed
+int boot_get_num_steps(void);                           // Returns the number of steps
+const BOOT_STEP* boot_get_step(int step);               // Returns a pointer to a step
+void boot_print_timeline(void);                         // Log the startup timeline
+
+#endif /* BOOT_H_ */
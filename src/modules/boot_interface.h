@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2026 dBm Signal Dynamics Inc.
+ *
+ * File:            boot_interface.h
+ * Project:
+ * Date:            Oct 19, 2026
+ * Framework:       Arduino w. Arduino-Pico Core Pkge by Earl Philhower
+ *                  (https://github.com/earlephilhower/arduino-pico)
+ *
+ * "boot" driver interface file - defines "BOOT_INTERFACE" structure
+ *
+ * Hardware Configurations Supported:
+ *
+ * CETA IoT Robot (Schematic #14-00069A/B), based on RPI-Pico-WH
+ * (Select "Board = Raspberry Pi Pico W")
+ *
+ * Sparkfun XRP Robot Platform (#KIT-27644), based on the RPI RP2350B MCU
+ * (Select "Board = SparkFun XRP Controller")
+ *
+ * Sparkfun XRP (Beta) Robot Platform (#KIT-22230), based on the RPI Pico W
+ * (Select "Board = SparkFun XRP Controller (Beta)")
+ *
+ */
+
+#ifndef BOOT_INTERFACE_H_
+#define BOOT_INTERFACE_H_
+
+/*** Include Files ************************************************************/
+#include <Arduino.h>
+
+/*** Macros *******************************************************************/
+
+/*** Custom Data Types ********************************************************/
+
+enum BOOT_STEP_STATE {BOOT_STEP_PENDING=0, BOOT_STEP_RUNNING, BOOT_STEP_DONE, BOOT_STEP_FAILED};
+
+typedef struct
+{
+  const char *name;                 // name displayed in the timeline
+  bool (*start)(void);              // starts the initialization, returns false if it failed
+  bool (*poll)(void);               // returns true when the initialization is complete (NULL: complete when start() returns)
+  bool required;                    // the robot is not "ready" until this step is complete
+  enum BOOT_STEP_STATE state;       // current state of the step
+  unsigned long startTime;          // time start() was called (in uS since reset)
+  unsigned long endTime;            // time the step completed or failed (in uS since reset)
+} BOOT_STEP;
+
+struct BOOT_INTERFACE
+{
+  int (*add_step)(const char *name, bool (*start)(void), bool (*poll)(void), bool required); // Define an initialization step, returns step number (-1 if full)
+  void (*run)(void);                                        // Start all steps (does not wait for them to complete)
+  void (*tasks)(void);                                      // Poll the running steps (called by board tasks())
+  bool (*is_ready)(void);                                   // Returns true when all required steps are complete
+  unsigned long (*get_ready_time)(void);                    // Returns the time all required steps completed (in uS since reset, 0 if not ready)
+  int (*get_num_steps)(void);                               // Returns the number of steps
+  const BOOT_STEP* (*get_step)(int step);                   // Returns a pointer to a step (timeline entry)
+  void (*print_timeline)(void);                             // Log the startup timeline
+};
+
+/*** Public Function Prototypes ***********************************************/
+
+
+#endif /* BOOT_INTERFACE_H_ */
@@ -0,0 +1,354 @@
+/*
+ * Copyright (C) 2026 dBm Signal Dynamics Inc.
+ *
+ * File:            calstore.cpp
+ * Project:
+ * Date:            Oct 19, 2026
+ * Framework:       Arduino w. Arduino-Pico Core Pkge by Earl Philhower
+ *                  (https://github.com/earlephilhower/arduino-pico)
+ *
+ * cetalib "calstore" calibration store
+ *
+ * Holds the calibration records of the reflectance, servoarm, imu, diffDrive
+ * and motor modules in the emulated EEPROM. The EEPROM image is read from flash once
+ * (the first time a record is accessed) and kept in RAM. Records are read and
+ * updated in RAM, and commit() saves all the changes with a single flash
+ * sector write, only if something changed.
+ *
+ * A header (after the records) holds the layout version, a "valid" flag,
+ * size and CRC32 for each record, and the number of flash writes over the
+ * life of the store. Records written by previous library versions (no header)
+ * are adopted as-is the first time they are read.
+ *
+ * Hardware Configurations Supported:
+ *
+ * CETA IoT Robot (Schematic #14-00069A/B), based on RPI-Pico-WH
+ * (Select "Board = Raspberry Pi Pico W")
+ *
+ * Sparkfun XRP Robot Platform (#KIT-27644), based on the RPI RP2350B MCU
+ * (Select "Board = SparkFun XRP Controller")
+ *
+ * Sparkfun XRP (Beta) Robot Platform (#KIT-22230), based on the RPI Pico W
+ * (Select "Board = SparkFun XRP Controller (Beta)")
+ *
+ */
+
+/** Include Files *************************************************************/
+#include <Arduino.h>                // Required for Arduino functions
+#include <EEPROM.h>                 // Required for EEPROM emulation functions
+#include <string.h>                 // needed for "memcmp()" function
+#include <stddef.h>                 // needed for "offsetof()" macro
+#include "logger.h"                 // "logger" functions
+#include "calstore.h"               // "calstore" API declarations
+#include "trace.h"                  // "trace" event macros
+
+/*** Symbolic Constants used in this module ***********************************/
+#define SERIAL_PORT Serial  // Default to Serial
+#if defined(NO_USB)
+    #undef SERIAL_PORT
+    #define SERIAL_PORT Serial1     // Use Serial1 if USB is disabled
+#endif
+
+/*** Global Variable Declarations *********************************************/
+
+// define the function interface
+extern const struct CALSTORE_INTERFACE CALSTORE = {
+    .read                   = &calstore_read,
+    .write                  = &calstore_write,
+    .clear                  = &calstore_clear,
+    .clear_all              = &calstore_clear_all,
+    .commit                 = &calstore_commit,
+    .tasks                  = &calstore_tasks,
+    .get_stats              = &calstore_get_stats
+};
+
+// EEPROM address of each record
+static const int calstoreAddress[CALSTORE_NUM_RECORDS] = {
+    CALSTORE_REFLECTANCE_ADDRESS,
+    CALSTORE_SERVOARM_ADDRESS,
+    CALSTORE_IMU_ADDRESS,
+    CALSTORE_DIFFDRIVE_ADDRESS,
+    CALSTORE_MOTOR_ADDRESS
+};
+
+static struct CALSTORE_HEADER calstoreHeader;
+static CALSTORE_STATS calstoreStats;
+static bool calstoreLoaded = false;         // EEPROM image has been read into RAM
+static bool calstoreDirty = false;          // RAM image has changes that are not saved yet
+static uint16_t calstoreClearedMask = 0;    // records cleared since the last commit
+static uint16_t calstoreHoldMask = 0;       // cleared records being re-calibrated, delay saving the clear on its own
+static unsigned long calstoreChangeTime;    // time of the most recent change (in mS)
+
+/*** Type Declarations ********************************************************/
+
+/*** Private Function Prototypes **********************************************/
+static void calstoreLoad(void);                                     // Read the EEPROM image and check the header
+static bool calstoreUpgradeHeader(void);                            // Adopt a layout version 1 header
+static bool calstoreIsRecord(int record, size_t size);              // Check the record number and size
+static void calstoreMarkDirty(void);                                // Flag a change to save
+static uint32_t calstoreCrc32(const void *data, size_t size);       // Compute a CRC32 (IEEE 802.3)
+
+/*** Public Function Definitions **********************************************/
+
+bool calstore_read(int record, void *data, size_t size)
+{
+  if(!calstoreIsRecord(record, size))
+  {
+    return false;
+  }
+  calstoreLoad();
+  uint16_t recordBit = (1 << record);
+  if(!(calstoreHeader.validMask & recordBit))
+  {
+    // a module reading a record it just cleared is about to re-calibrate it,
+    // so hold the clear until the new record is written
+    calstoreHoldMask |= (calstoreClearedMask & recordBit);
+    return false;
+  }
+  const uint8_t *recordData = EEPROM.getConstDataPtr() + calstoreAddress[record];
+  if(calstoreHeader.recordSize[record] == 0)
+  {
+    // record written by a previous library version, adopt it
+    calstoreHeader.recordSize[record] = size;
+    calstoreHeader.recordCrc[record] = calstoreCrc32(recordData, size);
+    calstoreStats.migrated++;
+    CETALIB_LOG_INFO("calstore: record %d adopted from previous version", record);
+  }
+  else if((calstoreHeader.recordSize[record] != size) || (calstoreHeader.recordCrc[record] != calstoreCrc32(recordData, size)))
+  {
+    calstoreHeader.validMask &= ~recordBit;
+    calstoreStats.crcErrors++;
+    CETALIB_LOG_WARN("calstore: record %d failed size/CRC check, calibration required", record);
+    return false;
+  }
+  memcpy(data, recordData, size);
+  return true;
+}
+
+bool calstore_write(int record, const void *data, size_t size)
+{
+  if(!calstoreIsRecord(record, size))
+  {
+    return false;
+  }
+  calstoreLoad();
+  uint16_t recordBit = (1 << record);
+  int address = calstoreAddress[record];
+  if((calstoreHeader.validMask & recordBit) && (calstoreHeader.recordSize[record] == size) &&
+     (memcmp(EEPROM.getConstDataPtr() + address, data, size) == 0))
+  {
+    // unchanged, nothing to save
+    return true;
+  }
+  memcpy(EEPROM.getDataPtr() + address, data, size);
+  calstoreHeader.validMask |= recordBit;
+  calstoreHeader.recordSize[record] = size;
+  calstoreHeader.recordCrc[record] = calstoreCrc32(data, size);
+  calstoreClearedMask &= ~recordBit;
+  calstoreHoldMask &= ~recordBit;
+  calstoreMarkDirty();
+  return true;
+}
+
+void calstore_clear(int record)
+{
+  if(!calstoreIsRecord(record, 0))
+  {
+    return;
+  }
+  calstoreLoad();
+  uint16_t recordBit = (1 << record);
+  int address = calstoreAddress[record];
+  uint32_t testRead = 0;
+  if(!(calstoreHeader.validMask & recordBit) && (EEPROM.get(address, testRead) == 0xFFFFFFFF))
+  {
+    // already blank
+    return;
+  }
+  // also blank the record data, so previous library versions re-calibrate too
+  memset(EEPROM.getDataPtr() + address, 0xFF, CALSTORE_MAX_RECORD_SIZE);
+  calstoreHeader.validMask &= ~recordBit;
+  calstoreHeader.recordSize[record] = 0;
+  calstoreHeader.recordCrc[record] = 0;
+  calstoreClearedMask |= recordBit;
+  calstoreMarkDirty();
+}
+
+void calstore_clear_all(void)
+{
+  for(int record = 0; record < CALSTORE_NUM_RECORDS; record++)
+  {
+    calstore_clear(record);
+  }
+}
+
+bool calstore_commit(void)
+{
+  if(!calstoreDirty)
+  {
+    calstoreStats.commitsSkipped++;
+    return true;
+  }
+  calstoreHeader.commitCount++;
+  calstoreHeader.headerCrc = calstoreCrc32(&calstoreHeader, offsetof(struct CALSTORE_HEADER, headerCrc));
+  EEPROM.put(CALSTORE_HEADER_ADDRESS, calstoreHeader);
+
+  // a single sector erase/program, with interrupts disabled
+  unsigned long startTime = micros();
+  CETALIB_TRACE_BEGIN("calstore", "commit", sizeof(calstoreHeader));
+  bool committed = EEPROM.commit();
+  CETALIB_TRACE_END("calstore", "commit", committed);
+  unsigned long commitTime = micros() - startTime;
+
+  calstoreDirty = false;
+  calstoreClearedMask = 0;
+  calstoreHoldMask = 0;
+  calstoreStats.commits++;
+  calstoreStats.lifetimeCommits = calstoreHeader.commitCount;
+  calstoreStats.lastCommitTime = commitTime;
+  if(commitTime > calstoreStats.maxCommitTime)
+  {
+    calstoreStats.maxCommitTime = commitTime;
+  }
+  if(!committed)
+  {
+    CETALIB_LOG_ERROR("calstore: flash write failed");
+  }
+  return committed;
+}
+
+void calstore_tasks(void)
+{
+  if(!calstoreDirty)
+  {
+    return;                     // nothing to save (or the store is not used)
+  }
+
+  // save deferred changes (e.g. a cleared record that is not re-calibrated),
+  // wait longer while a cleared record is being re-calibrated, so the clear
+  // and the new record are saved together
+  unsigned long commitDelay = calstoreHoldMask ? CALSTORE_HOLD_TIMEOUT : CALSTORE_COMMIT_DELAY;
+  CETALIB_TRACE_BEGIN("calstore", "tasks", calstoreDirty);
+  if(calstoreDirty && ((millis() - calstoreChangeTime) >= commitDelay))
+  {
+    calstore_commit();
+  }
+  CETALIB_TRACE_END("calstore", "tasks", 0);
+}
+
+CALSTORE_STATS* calstore_get_stats(void)
+{
+  return &calstoreStats;
+}
+
+/*** Private Function Definitions *********************************************/
+
+static void calstoreLoad(void)
+{
+  if(calstoreLoaded)
+  {
+    return;
+  }
+  EEPROM.begin(CALSTORE_EEPROM_SIZE);
+  calstoreLoaded = true;
+  calstoreStats.loads++;
+
+  EEPROM.get(CALSTORE_HEADER_ADDRESS, calstoreHeader);
+  bool hasHeader = (calstoreHeader.magic == CALSTORE_MAGIC);
+  bool headerOk = hasHeader && (calstoreHeader.headerCrc == calstoreCrc32(&calstoreHeader, offsetof(struct CALSTORE_HEADER, headerCrc)));
+  if(headerOk && (calstoreHeader.version == CALSTORE_VERSION))
+  {
+    calstoreStats.lifetimeCommits = calstoreHeader.commitCount;
+    return;
+  }
+  if(hasHeader && (calstoreHeader.version == 1) && calstoreUpgradeHeader())
+  {
+    return;
+  }
+
+  // start a new header, written with the next commit
+  uint32_t commitCount = headerOk ? calstoreHeader.commitCount : 0;
+  memset(&calstoreHeader, 0, sizeof(calstoreHeader));
+  calstoreHeader.magic = CALSTORE_MAGIC;
+  calstoreHeader.version = CALSTORE_VERSION;
+  calstoreHeader.commitCount = commitCount;
+  calstoreStats.lifetimeCommits = commitCount;
+  if(hasHeader)
+  {
+    // corrupt header or different record layout, all modules must re-calibrate
+    if(!headerOk)
+    {
+      calstoreStats.crcErrors++;
+    }
+    CETALIB_LOG_WARN("calstore: %s, calibration required", headerOk ? "record layout changed" : "header failed CRC check");
+    return;
+  }
+
+  // no header: EEPROM written by a previous library version (or blank),
+  // non-blank records are checked and adopted when they are first read
+  for(int record = 0; record < CALSTORE_NUM_RECORDS; record++)
+  {
+    uint32_t testRead = 0;
+    if(EEPROM.get(calstoreAddress[record], testRead) != 0xFFFFFFFF)
+    {
+      calstoreHeader.validMask |= (1 << record);
+    }
+  }
+}
+
+// Layout version 1 has the same records at the same addresses, without the
+// records added since, so its records stay valid (the new header is written
+// with the next commit)
+static bool calstoreUpgradeHeader(void)
+{
+  struct CALSTORE_HEADER_V1 oldHeader;
+  EEPROM.get(CALSTORE_HEADER_ADDRESS, oldHeader);
+  if(oldHeader.headerCrc != calstoreCrc32(&oldHeader, offsetof(struct CALSTORE_HEADER_V1, headerCrc)))
+  {
+    return false;
+  }
+  memset(&calstoreHeader, 0, sizeof(calstoreHeader));
+  calstoreHeader.magic = CALSTORE_MAGIC;
+  calstoreHeader.version = CALSTORE_VERSION;
+  calstoreHeader.validMask = oldHeader.validMask & ((1 << CALSTORE_V1_NUM_RECORDS) - 1);
+  calstoreHeader.commitCount = oldHeader.commitCount;
+  for(int record = 0; record < CALSTORE_V1_NUM_RECORDS; record++)
+  {
+    calstoreHeader.recordSize[record] = oldHeader.recordSize[record];
+    calstoreHeader.recordCrc[record] = oldHeader.recordCrc[record];
+  }
+  calstoreStats.lifetimeCommits = calstoreHeader.commitCount;
+  CETALIB_LOG_INFO("calstore: header upgraded from layout version 1");
+  return true;
+}
+
+static bool calstoreIsRecord(int record, size_t size)
+{
+  if((record < 0) || (record >= CALSTORE_NUM_RECORDS) || (size > CALSTORE_MAX_RECORD_SIZE))
+  {
+    CETALIB_LOG_ERROR("calstore: invalid record %d (size %u)", record, (unsigned int)size);
+    return false;
+  }
+  return true;
+}
+
+static void calstoreMarkDirty(void)
+{
+  calstoreDirty = true;
+  calstoreChangeTime = millis();
+}
+
+static uint32_t calstoreCrc32(const void *data, size_t size)
+{
+  const uint8_t *bytes = (const uint8_t *)data;
+  uint32_t crc = 0xFFFFFFFF;
+  while(size--)
+  {
+    crc ^= *bytes++;
+    for(int bit = 0; bit < 8; bit++)
+    {
+      crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+    }
+  }
+  return ~crc;
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2026 dBm Signal Dynamics Inc.
+ *
+ * File:            calstore.h
+ * Project:
+ * Date:            Oct 19, 2026
+ * Framework:       Arduino w. Arduino-Pico Core Pkge by Earl Philhower
+ *                  (https://github.com/earlephilhower/arduino-pico)
+ *
+ * cetalib "calstore" calibration store
+ *
+ * Holds the calibration records of the reflectance, servoarm, imu, diffDrive
+ * and motor modules in the emulated EEPROM. The EEPROM image is read from flash once
+ * (the first time a record is accessed) and kept in RAM. Records are read and
+ * updated in RAM, and commit() saves all the changes with a single flash
+ * sector write, only if something changed.
+ *
+ * A header (after the records) holds the layout version, a "valid" flag,
+ * size and CRC32 for each record, and the number of flash writes over the
+ * life of the store. Records written by previous library versions (no header)
+ * are adopted as-is the first time they are read.
+ *
+ * Hardware Configurations Supported:
+ *
+ * CETA IoT Robot (Schematic #14-00069A/B), based on RPI-Pico-WH
+ * (Select "Board = Raspberry Pi Pico W")
+ *
+ * Sparkfun XRP Robot Platform (#KIT-27644), based on the RPI RP2350B MCU
+ * (Select "Board = SparkFun XRP Controller")
+ *
+ * Sparkfun XRP (Beta) Robot Platform (#KIT-22230), based on the RPI Pico W
+ * (Select "Board = SparkFun XRP Controller (Beta)")
+ *
+ */
+
+#ifndef CALSTORE_H_
+#define CALSTORE_H_
+
+/*** Include Files ************************************************************/
+#include <Arduino.h>
+#include "calstore_interface.h"
+
+/*** Macros *******************************************************************/
+#define CALSTORE_EEPROM_SIZE        1024        // Size of the emulated EEPROM (in bytes)
+#define CALSTORE_HEADER_ADDRESS     512         // EEPROM address of the store header
+#define CALSTORE_MAGIC              0x4C414343  // "CCAL"
+#define CALSTORE_VERSION            2           // Layout version, change when the record layout changes
+#define CALSTORE_COMMIT_DELAY       1000        // Time without changes before tasks() saves deferred changes (in mS)
+#define CALSTORE_HOLD_TIMEOUT       60000       // Max time tasks() waits for a cleared record to be re-calibrated (in mS)
+
+// Record addresses (same as previous library versions)
+#define CALSTORE_REFLECTANCE_ADDRESS    0
+#define CALSTORE_SERVOARM_ADDRESS       128
+#define CALSTORE_IMU_ADDRESS            256
+#define CALSTORE_DIFFDRIVE_ADDRESS      385
+#define CALSTORE_MOTOR_ADDRESS          640     // after the header (added in layout version 2)
+#define CALSTORE_MAX_RECORD_SIZE        127     // Max size of a record (in bytes)
+
+/*** Custom Data Types ********************************************************/
+
+struct CALSTORE_HEADER
+{
+  uint32_t magic;                               // CALSTORE_MAGIC
+  uint16_t version;                             // CALSTORE_VERSION
+  uint16_t validMask;                           // one bit per valid record
+  uint32_t commitCount;                         // number of flash writes over the life of the store
+  uint16_t recordSize[CALSTORE_NUM_RECORDS];    // size of each record, 0 = adopted from a previous library version, not checked yet
+  uint32_t recordCrc[CALSTORE_NUM_RECORDS];     // CRC32 of each record
+  uint32_t headerCrc;                           // CRC32 of all of the above
+};
+
+// Header of layout version 1 (reflectance, servoarm, imu and diffDrive records),
+// upgraded to the current layout when it is read
+#define CALSTORE_V1_NUM_RECORDS     4
+
+struct CALSTORE_HEADER_V1
+{
+  uint32_t magic;
+  uint16_t version;
+  uint16_t validMask;
+  uint32_t commitCount;
+  uint16_t recordSize[CALSTORE_V1_NUM_RECORDS];
+  uint32_t recordCrc[CALSTORE_V1_NUM_RECORDS];
+  uint32_t headerCrc;
+};
+
+/*** Public Function Prototypes ***********************************************/
+bool calstore_read(int record, void *data, size_t size);          // Copy a valid record to "data"
+bool calstore_write(int record, const void *data, size_t size);   // Update a record in RAM
+void calstore_clear(int record);                                  // Delete a record
+void calstore_clear_all(void);                                    // Delete all records
+bool calstore_commit(void);                                       // Save all changes with a single flash write
+void calstore_tasks(void);                                        // Save deferred changes
+CALSTORE_STATS* calstore_get_stats(void);                         // Returns a pointer to the load/commit counters
+
+#endif /* CALSTORE_H_ */
@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2026 dBm Signal Dynamics Inc.
+ *
+ * File:            calstore_interface.h
+ * Project:
+ * Date:            Oct 19, 2026
+ * Framework:       Arduino w. Arduino-Pico Core Pkge by Earl Philhower
+ *                  (https://github.com/earlephilhower/arduino-pico)
+ *
+ * "calstore" driver interface file - defines "CALSTORE_INTERFACE" structure
+ *
+ * Hardware Configurations Supported:
+ *
+ * CETA IoT Robot (Schematic #14-00069A/B), based on RPI-Pico-WH
+ * (Select "Board = Raspberry Pi Pico W")
+ *
+ * Sparkfun XRP Robot Platform (#KIT-27644), based on the RPI RP2350B MCU
+ * (Select "Board = SparkFun XRP Controller")
+ *
+ * Sparkfun XRP (Beta) Robot Platform (#KIT-22230), based on the RPI Pico W
+ * (Select "Board = SparkFun XRP Controller (Beta)")
+ *
+ */
+
+#ifndef CALSTORE_INTERFACE_H_
+#define CALSTORE_INTERFACE_H_
+
+/*** Include Files ************************************************************/
+#include <Arduino.h>
+
+/*** Macros *******************************************************************/
+
+/*** Custom Data Types ********************************************************/
+
+// Calibration records (one per module)
+enum CALSTORE_RECORD {CALSTORE_RECORD_REFLECTANCE=0, CALSTORE_RECORD_SERVOARM, CALSTORE_RECORD_IMU, CALSTORE_RECORD_DIFFDRIVE, CALSTORE_RECORD_MOTOR, CALSTORE_NUM_RECORDS};
+
+typedef struct
+{
+  unsigned long loads;              // number of times the store was read from flash (once per boot)
+  unsigned long commits;            // number of flash writes since boot
+  unsigned long commitsSkipped;     // number of commit requests with nothing to write
+  unsigned long lastCommitTime;     // duration of the most recent flash write (in uS)
+  unsigned long maxCommitTime;      // longest flash write since boot (in uS)
+  unsigned long lifetimeCommits;    // number of flash writes over the life of the store
+  unsigned long crcErrors;          // number of records/headers rejected by the size or CRC checks
+  unsigned long migrated;           // number of records adopted from a previous library version
+} CALSTORE_STATS;
+
+struct CALSTORE_INTERFACE
+{
+  bool (*read)(int record, void *data, size_t size);        // Copy a valid record to "data", returns false if missing or corrupt
+  bool (*write)(int record, const void *data, size_t size); // Update a record in RAM (use commit() to save it)
+  void (*clear)(int record);                                // Delete a record (saved by commit() or tasks())
+  void (*clear_all)(void);                                  // Delete all records (saved by commit() or tasks())
+  bool (*commit)(void);                                     // Save all changes with a single flash write
+  void (*tasks)(void);                                      // Save deferred changes (called by board tasks())
+  CALSTORE_STATS* (*get_stats)(void);                       // Returns a pointer to the load/commit counters
+};
+
+/*** Public Function Prototypes ***********************************************/
+
+
+#endif /* CALSTORE_INTERFACE_H_ */
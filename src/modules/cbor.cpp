@@ -0,0 +1,346 @@
+/*
+ * Copyright (C) 2026 dBm Signal Dynamics Inc.
+ *
+ * File:            cbor.cpp
+ * Project:
+ * Date:            Oct 19, 2026
+ * Framework:       Arduino w. Arduino-Pico Core Pkge by Earl Philhower
+ *                  (https://github.com/earlephilhower/arduino-pico)
+ *
+ * cetalib "cbor" compact binary telemetry record encoder/decoder
+ *
+ * Encodes fixed-layout sensor records as RFC 8949 CBOR arrays of integers:
+ *
+ *  IMU:          [1, timestamp, temperature (0.01 C), heading (0.01 deg)]
+ *  ENCODER:      [2, timestamp, left counts, right counts]
+ *  REFLECTANCE:  [3, timestamp, left, middle, right (12-bit ADC), line status]
+ *  POSE:         [4, timestamp, x (mm), y (mm), heading (0.01 deg)]
+ *
+ * Records are written directly into a caller supplied buffer (no heap use),
+ * and can be decoded by any standard CBOR library on the receiving side.
+ * Send encoded records with mqttc->send_binary().
+ *
+ * Hardware Configurations Supported:
+ *
+ * CETA IoT Robot (Schematic #14-00069A/B), based on RPI-Pico-WH
+ * (Select "Board = Raspberry Pi Pico W")
+ *
+ * Sparkfun XRP Robot Platform (#KIT-27644), based on the RPI RP2350B MCU
+ * (Select "Board = SparkFun XRP Controller")
+ *
+ * Sparkfun XRP (Beta) Robot Platform (#KIT-22230), based on the RPI Pico W
+ * (Select "Board = SparkFun XRP Controller (Beta)")
+ *
+ */
+
+/** Include Files *************************************************************/
+#include <Arduino.h>                // Required for Arduino functions
+#include <stdint.h>                 // Fixed width integer types
+#include <math.h>                   // Required for isnan()
+#include "cbor.h"                   // "cbor" API declarations
+
+/*** Symbolic Constants used in this module ***********************************/
+#define CBOR_MAJOR_UINT     0       // Major type 0: unsigned integer
+#define CBOR_MAJOR_NINT     1       // Major type 1: negative integer
+#define CBOR_MAJOR_ARRAY    4       // Major type 4: array of data items
+
+#define CBOR_SCALE_CENTI    100.0f  // 0.01 unit fields (temperature, heading)
+#define CBOR_SCALE_MM       10.0f   // cm to mm fields (pose x/y)
+#define CBOR_SCALE_ADC      4096.0f // 0.0-1.0 sensor fields sent as 12-bit ADC units (reading = ADC count / 4096)
+#define CBOR_ADC_MAX        4095    // Largest 12-bit ADC unit (a reading of 1.0 is sent as 4095)
+
+/*** Global Variable Declarations *********************************************/
+
+// define the function interface
+extern const struct CBOR_INTERFACE CBOR = {
+    .encode_imu             = &cbor_encode_imu,
+    .encode_encoder         = &cbor_encode_encoder,
+    .encode_reflectance     = &cbor_encode_reflectance,
+    .encode_pose            = &cbor_encode_pose,
+    .decode                 = &cbor_decode
+};
+
+/*** Type Declarations ********************************************************/
+
+// output cursor used while encoding a record
+struct CBOR_WRITER
+{
+  uint8_t *buf;
+  int size;
+  int pos;
+  bool overflow;
+};
+
+/*** Private Function Prototypes **********************************************/
+static void cborPutHead(struct CBOR_WRITER *w, uint8_t major, uint32_t value);  // Write an item header (major type + argument)
+static void cborPutInt(struct CBOR_WRITER *w, int32_t value);                   // Write a signed integer item
+static int32_t cborScale(float value, float scale);                            // Convert an engineering value to a rounded scaled integer
+static int32_t cborScaleAdc(float value);                                      // Convert a 0.0-1.0 reading to 12-bit ADC units
+static int cborGetHead(const uint8_t *buf, int length, int *pos, uint8_t *major, uint32_t *value);  // Read an item header
+static float cborUnscale(int32_t value, float scale);                          // Convert a scaled integer back to engineering units
+
+/*** Public Function Definitions **********************************************/
+
+int cbor_encode_imu(uint8_t *buf, int bufSize, const struct CBOR_IMU_RECORD *rec)
+{
+  struct CBOR_WRITER w = {buf, bufSize, 0, false};
+  cborPutHead(&w, CBOR_MAJOR_ARRAY, 4);
+  cborPutHead(&w, CBOR_MAJOR_UINT, CBOR_RECORD_IMU);
+  cborPutHead(&w, CBOR_MAJOR_UINT, rec->timestamp);
+  cborPutInt(&w, cborScale(rec->temperature, CBOR_SCALE_CENTI));
+  cborPutInt(&w, cborScale(rec->heading, CBOR_SCALE_CENTI));
+  return w.overflow ? 0 : w.pos;
+}
+
+int cbor_encode_encoder(uint8_t *buf, int bufSize, const struct CBOR_ENCODER_RECORD *rec)
+{
+  struct CBOR_WRITER w = {buf, bufSize, 0, false};
+  cborPutHead(&w, CBOR_MAJOR_ARRAY, 4);
+  cborPutHead(&w, CBOR_MAJOR_UINT, CBOR_RECORD_ENCODER);
+  cborPutHead(&w, CBOR_MAJOR_UINT, rec->timestamp);
+  cborPutInt(&w, rec->leftCounts);
+  cborPutInt(&w, rec->rightCounts);
+  return w.overflow ? 0 : w.pos;
+}
+
+int cbor_encode_reflectance(uint8_t *buf, int bufSize, const struct CBOR_REFLECTANCE_RECORD *rec)
+{
+  struct CBOR_WRITER w = {buf, bufSize, 0, false};
+  cborPutHead(&w, CBOR_MAJOR_ARRAY, 6);
+  cborPutHead(&w, CBOR_MAJOR_UINT, CBOR_RECORD_REFLECTANCE);
+  cborPutHead(&w, CBOR_MAJOR_UINT, rec->timestamp);
+  cborPutInt(&w, cborScaleAdc(rec->left));
+  cborPutInt(&w, cborScaleAdc(rec->middle));
+  cborPutInt(&w, cborScaleAdc(rec->right));
+  cborPutInt(&w, rec->lineStatus);
+  return w.overflow ? 0 : w.pos;
+}
+
+int cbor_encode_pose(uint8_t *buf, int bufSize, const struct CBOR_POSE_RECORD *rec)
+{
+  struct CBOR_WRITER w = {buf, bufSize, 0, false};
+  cborPutHead(&w, CBOR_MAJOR_ARRAY, 5);
+  cborPutHead(&w, CBOR_MAJOR_UINT, CBOR_RECORD_POSE);
+  cborPutHead(&w, CBOR_MAJOR_UINT, rec->timestamp);
+  cborPutInt(&w, cborScale(rec->x, CBOR_SCALE_MM));
+  cborPutInt(&w, cborScale(rec->y, CBOR_SCALE_MM));
+  cborPutInt(&w, cborScale(rec->heading, CBOR_SCALE_CENTI));
+  return w.overflow ? 0 : w.pos;
+}
+
+enum CBOR_RECORD_TYPE cbor_decode(const uint8_t *buf, int length, CBOR_RECORD *rec)
+{
+  int32_t item[CBOR_MAX_RECORD_ITEMS];
+  uint32_t numItems, value;
+  uint8_t major;
+  int pos = 0;
+
+  rec->type = CBOR_RECORD_NONE;
+
+  // every record is a definite length array of integers
+  if(!cborGetHead(buf, length, &pos, &major, &numItems) || (major != CBOR_MAJOR_ARRAY))
+  {
+    return CBOR_RECORD_NONE;
+  }
+  if((numItems < 2) || (numItems > CBOR_MAX_RECORD_ITEMS))
+  {
+    return CBOR_RECORD_NONE;
+  }
+  for(uint32_t i = 0; i < numItems; i++)
+  {
+    if(!cborGetHead(buf, length, &pos, &major, &value))
+    {
+      return CBOR_RECORD_NONE;
+    }
+    switch(major)
+    {
+      case CBOR_MAJOR_UINT:
+        item[i] = (int32_t)value;
+        break;
+      case CBOR_MAJOR_NINT:
+        if(value > 0x7FFFFFFF) return CBOR_RECORD_NONE;
+        item[i] = -1 - (int32_t)value;
+        break;
+      default:
+        return CBOR_RECORD_NONE;
+    }
+  }
+
+  // item[0] selects the record schema, item[1] is always the timestamp
+  switch(item[0])
+  {
+    case CBOR_RECORD_IMU:
+      if(numItems != 4) return CBOR_RECORD_NONE;
+      rec->data.imu.timestamp = (uint32_t)item[1];
+      rec->data.imu.temperature = cborUnscale(item[2], CBOR_SCALE_CENTI);
+      rec->data.imu.heading = cborUnscale(item[3], CBOR_SCALE_CENTI);
+      break;
+    case CBOR_RECORD_ENCODER:
+      if(numItems != 4) return CBOR_RECORD_NONE;
+      rec->data.encoder.timestamp = (uint32_t)item[1];
+      rec->data.encoder.leftCounts = item[2];
+      rec->data.encoder.rightCounts = item[3];
+      break;
+    case CBOR_RECORD_REFLECTANCE:
+      if(numItems != 6) return CBOR_RECORD_NONE;
+      rec->data.reflectance.timestamp = (uint32_t)item[1];
+      rec->data.reflectance.left = cborUnscale(item[2], CBOR_SCALE_ADC);
+      rec->data.reflectance.middle = cborUnscale(item[3], CBOR_SCALE_ADC);
+      rec->data.reflectance.right = cborUnscale(item[4], CBOR_SCALE_ADC);
+      rec->data.reflectance.lineStatus = (int)item[5];
+      break;
+    case CBOR_RECORD_POSE:
+      if(numItems != 5) return CBOR_RECORD_NONE;
+      rec->data.pose.timestamp = (uint32_t)item[1];
+      rec->data.pose.x = cborUnscale(item[2], CBOR_SCALE_MM);
+      rec->data.pose.y = cborUnscale(item[3], CBOR_SCALE_MM);
+      rec->data.pose.heading = cborUnscale(item[4], CBOR_SCALE_CENTI);
+      break;
+    default:
+      return CBOR_RECORD_NONE;
+  }
+  rec->type = (enum CBOR_RECORD_TYPE)item[0];
+  return rec->type;
+}
+
+/*** Private Function Definitions *********************************************/
+
+void cborPutHead(struct CBOR_WRITER *w, uint8_t major, uint32_t value)
+{
+  uint8_t head[5];
+  int n;
+
+  // use the shortest argument encoding that holds the value
+  if(value < 24)
+  {
+    head[0] = (major << 5) | (uint8_t)value;
+    n = 1;
+  }
+  else if(value <= 0xFF)
+  {
+    head[0] = (major << 5) | 24;
+    head[1] = (uint8_t)value;
+    n = 2;
+  }
+  else if(value <= 0xFFFF)
+  {
+    head[0] = (major << 5) | 25;
+    head[1] = (uint8_t)(value >> 8);
+    head[2] = (uint8_t)value;
+    n = 3;
+  }
+  else
+  {
+    head[0] = (major << 5) | 26;
+    head[1] = (uint8_t)(value >> 24);
+    head[2] = (uint8_t)(value >> 16);
+    head[3] = (uint8_t)(value >> 8);
+    head[4] = (uint8_t)value;
+    n = 5;
+  }
+
+  if((w->pos + n) > w->size)
+  {
+    w->overflow = true;
+    return;
+  }
+  memcpy(&w->buf[w->pos], head, n);
+  w->pos += n;
+}
+
+void cborPutInt(struct CBOR_WRITER *w, int32_t value)
+{
+  if(value >= 0)
+  {
+    cborPutHead(w, CBOR_MAJOR_UINT, (uint32_t)value);
+  }
+  else
+  {
+    // negative integers are encoded as (-1 - value)
+    cborPutHead(w, CBOR_MAJOR_NINT, (uint32_t)(-1 - value));
+  }
+}
+
+int32_t cborScale(float value, float scale)
+{
+  // clamp before the conversion, a float outside the int32_t range is undefined behaviour
+  // (2147483647.0f rounds to 2^31, the largest float below it is 2147483520)
+  float scaled = value * scale;
+  if(isnan(scaled))
+  {
+    return 0;
+  }
+  if(scaled >= 2147483647.0f)
+  {
+    return INT32_MAX;
+  }
+  if(scaled <= -2147483648.0f)
+  {
+    return INT32_MIN;
+  }
+  return (int32_t)((scaled >= 0.0f) ? (scaled + 0.5f) : (scaled - 0.5f));
+}
+
+int32_t cborScaleAdc(float value)
+{
+  int32_t units = cborScale(value, CBOR_SCALE_ADC);
+  return constrain(units, 0, CBOR_ADC_MAX);
+}
+
+float cborUnscale(int32_t value, float scale)
+{
+  return (float)value / scale;
+}
+
+int cborGetHead(const uint8_t *buf, int length, int *pos, uint8_t *major, uint32_t *value)
+{
+  int p = *pos;
+  uint8_t info;
+  int n;
+
+  if(p >= length)
+  {
+    return 0;
+  }
+  *major = buf[p] >> 5;
+  info = buf[p] & 0x1F;
+  p++;
+
+  // argument follows in 0, 1, 2 or 4 bytes (64-bit arguments are not used by any record)
+  if(info < 24)
+  {
+    n = 0;
+    *value = info;
+  }
+  else if(info == 24)
+  {
+    n = 1;
+  }
+  else if(info == 25)
+  {
+    n = 2;
+  }
+  else if(info == 26)
+  {
+    n = 4;
+  }
+  else
+  {
+    return 0;
+  }
+
+  if((p + n) > length)
+  {
+    return 0;
+  }
+  if(n)
+  {
+    *value = 0;
+    for(int i = 0; i < n; i++)
+    {
+      *value = (*value << 8) | buf[p++];
+    }
+  }
+  *pos = p;
+  return 1;
+}
@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) 2026 dBm Signal Dynamics Inc.
+ *
+ * File:            cbor.h
+ * Project:
+ * Date:            Oct 19, 2026
+ * Framework:       Arduino w. Arduino-Pico Core Pkge by Earl Philhower
+ *                  (https://github.com/earlephilhower/arduino-pico)
+ *
+ * cetalib "cbor" compact binary telemetry record encoder/decoder
+ *
+ * Encodes fixed-layout sensor records as RFC 8949 CBOR arrays of integers:
+ *
+ *  IMU:          [1, timestamp, temperature (0.01 C), heading (0.01 deg)]
+ *  ENCODER:      [2, timestamp, left counts, right counts]
+ *  REFLECTANCE:  [3, timestamp, left, middle, right (12-bit ADC), line status]
+ *  POSE:         [4, timestamp, x (mm), y (mm), heading (0.01 deg)]
+ *
+ * Records are written directly into a caller supplied buffer (no heap use),
+ * and can be decoded by any standard CBOR library on the receiving side.
+ * Send encoded records with mqttc->send_binary().
+ *
+ * Hardware Configurations Supported:
+ *
+ * CETA IoT Robot (Schematic #14-00069A/B), based on RPI-Pico-WH
+ * (Select "Board = Raspberry Pi Pico W")
+ *
+ * Sparkfun XRP Robot Platform (#KIT-27644), based on the RPI RP2350B MCU
+ * (Select "Board = SparkFun XRP Controller")
+ *
+ * Sparkfun XRP (Beta) Robot Platform (#KIT-22230), based on the RPI Pico W
+ * (Select "Board = SparkFun XRP Controller (Beta)")
+ *
+ */
+
+#ifndef CBOR_H_
+#define CBOR_H_
+
+/*** Include Files ************************************************************/
+#include <Arduino.h>
+#include "cbor_interface.h"
+
+/*** Macros *******************************************************************/
+#define CBOR_MAX_RECORD_SIZE    32      // Largest encoded record (in bytes)
+#define CBOR_MAX_RECORD_ITEMS   8       // Largest number of array items in a record
+
+/*** Custom Data Types ********************************************************/
+
+/*** Public Function Prototypes ***********************************************/
+int cbor_encode_imu(uint8_t *buf, int bufSize, const struct CBOR_IMU_RECORD *rec);                  // Encode an IMU record
+int cbor_encode_encoder(uint8_t *buf, int bufSize, const struct CBOR_ENCODER_RECORD *rec);          // Encode an ENCODER record
+int cbor_encode_reflectance(uint8_t *buf, int bufSize, const struct CBOR_REFLECTANCE_RECORD *rec);  // Encode a REFLECTANCE record
+int cbor_encode_pose(uint8_t *buf, int bufSize, const struct CBOR_POSE_RECORD *rec);                // Encode a POSE record
+enum CBOR_RECORD_TYPE cbor_decode(const uint8_t *buf, int length, CBOR_RECORD *rec);               // Decode any record
+
+#endif /* CBOR_H_ */
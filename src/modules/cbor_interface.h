@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2026 dBm Signal Dynamics Inc.
+ *
+ * File:            cbor_interface.h
+ * Project:
+ * Date:            Oct 19, 2026
+ * Framework:       Arduino w. Arduino-Pico Core Pkge by Earl Philhower
+ *                  (https://github.com/earlephilhower/arduino-pico)
+ *
+ * "cbor" driver interface file - defines "CBOR_INTERFACE" structure
+ *
+ * Hardware Configurations Supported:
+ *
+ * CETA IoT Robot (Schematic #14-00069A/B), based on RPI-Pico-WH
+ * (Select "Board = Raspberry Pi Pico W")
+ *
+ * Sparkfun XRP Robot Platform (#KIT-27644), based on the RPI RP2350B MCU
+ * (Select "Board = SparkFun XRP Controller")
+ *
+ * Sparkfun XRP (Beta) Robot Platform (#KIT-22230), based on the RPI Pico W
+ * (Select "Board = SparkFun XRP Controller (Beta)")
+ *
+ */
+
+#ifndef CBOR_INTERFACE_H_
+#define CBOR_INTERFACE_H_
+
+/*** Include Files ************************************************************/
+#include <Arduino.h>
+#include <stdint.h>
+
+/*** Macros *******************************************************************/
+
+// Records are received with mqttc receive_binary(): payloads larger than 127
+// bytes (the mqttc receive buffer) are rejected, not truncated
+
+/*** Custom Data Types ********************************************************/
+
+// Record type identifiers (first element of every encoded record)
+enum CBOR_RECORD_TYPE {CBOR_RECORD_NONE=0, CBOR_RECORD_IMU, CBOR_RECORD_ENCODER, CBOR_RECORD_REFLECTANCE, CBOR_RECORD_POSE};
+
+struct CBOR_IMU_RECORD
+{
+  uint32_t timestamp;       // sample time (in mS)
+  float temperature;        // degrees celcius (sent as 0.01 C units)
+  float heading;            // degrees (sent as 0.01 deg units)
+};
+
+struct CBOR_ENCODER_RECORD
+{
+  uint32_t timestamp;       // sample time (in mS)
+  int32_t leftCounts;       // raw left encoder count
+  int32_t rightCounts;      // raw right encoder count
+};
+
+struct CBOR_REFLECTANCE_RECORD
+{
+  uint32_t timestamp;       // sample time (in mS)
+  float left;               // left sensor reading (0.0-1.0, sent as 12-bit ADC units)
+  float middle;             // middle sensor reading (0.0-1.0, sent as 12-bit ADC units)
+  float right;              // right sensor reading (0.0-1.0, sent as 12-bit ADC units)
+  int lineStatus;           // line detection status (0-7)
+};
+
+struct CBOR_POSE_RECORD
+{
+  uint32_t timestamp;       // sample time (in mS)
+  float x;                  // x position in cm (sent as mm units)
+  float y;                  // y position in cm (sent as mm units)
+  float heading;            // degrees (sent as 0.01 deg units)
+};
+
+typedef struct
+{
+  enum CBOR_RECORD_TYPE type;           // identifies which member of "data" is valid
+  union
+  {
+    struct CBOR_IMU_RECORD imu;
+    struct CBOR_ENCODER_RECORD encoder;
+    struct CBOR_REFLECTANCE_RECORD reflectance;
+    struct CBOR_POSE_RECORD pose;
+  } data;
+} CBOR_RECORD;
+
+struct CBOR_INTERFACE
+{
+  int (*encode_imu)(uint8_t *buf, int bufSize, const struct CBOR_IMU_RECORD *rec);                  // Encode an IMU record, returns encoded length (0 if buf too small)
+  int (*encode_encoder)(uint8_t *buf, int bufSize, const struct CBOR_ENCODER_RECORD *rec);          // Encode an ENCODER record, returns encoded length (0 if buf too small)
+  int (*encode_reflectance)(uint8_t *buf, int bufSize, const struct CBOR_REFLECTANCE_RECORD *rec);  // Encode a REFLECTANCE record, returns encoded length (0 if buf too small)
+  int (*encode_pose)(uint8_t *buf, int bufSize, const struct CBOR_POSE_RECORD *rec);                // Encode a POSE record, returns encoded length (0 if buf too small)
+  enum CBOR_RECORD_TYPE (*decode)(const uint8_t *buf, int length, CBOR_RECORD *rec);               // Decode any record, returns record type (CBOR_RECORD_NONE on error)
+};
+
+/*** Public Function Prototypes ***********************************************/
+
+
+#endif /* CBOR_INTERFACE_H_ */
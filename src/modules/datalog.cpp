@@ -0,0 +1,408 @@
+/*
+ * Copyright (C) 2026 dBm Signal Dynamics Inc.
+ *
+ * File:            datalog.cpp
+ * Project:
+ * Date:            Oct 19, 2026
+ * Framework:       Arduino w. Arduino-Pico Core Pkge by Earl Philhower
+ *                  (https://github.com/earlephilhower/arduino-pico)
+ *
+ * cetalib "datalog" high-rate data logger
+ *
+ * Records up to 16 channels (motor efforts, encoder counts, heading, sensor
+ * values...) at the control loop rate into a binary log file on the flash
+ * file system (LittleFS). Samples are encoded into one of two 512 byte RAM
+ * buffers while the other one is written to flash by tasks(), one block per
+ * call, so sample() never waits for the flash.
+ *
+ * Each sample is a row: the time since the previous row (in uS) followed by
+ * the change of each channel since the previous row, scaled to an integer and
+ * stored as a variable-length integer (1 byte for small changes). The first
+ * row of each block holds absolute values, so every block can be decoded on
+ * its own.
+ *
+ * The log file is circular: after DATALOG_MAX_BLOCKS blocks, the oldest block
+ * is overwritten, so the flash space used is fixed. The blocks are decoded
+ * and sorted by the "cetalib-datalog-decode.py" utility.
+ *
+ * Hardware Configurations Supported:
+ *
+ * CETA IoT Robot (Schematic #14-00069A/B), based on RPI-Pico-WH
+ * (Select "Board = Raspberry Pi Pico W")
+ *
+ * Sparkfun XRP Robot Platform (#KIT-27644), based on the RPI RP2350B MCU
+ * (Select "Board = SparkFun XRP Controller")
+ *
+ * Sparkfun XRP (Beta) Robot Platform (#KIT-22230), based on the RPI Pico W
+ * (Select "Board = SparkFun XRP Controller (Beta)")
+ *
+ */
+
+/** Include Files *************************************************************/
+#include <Arduino.h>                // Required for Arduino functions
+#include <LittleFS.h>               // Required for flash file system functions
+#include <string.h>                 // needed for "strncpy()" and "memset()" functions
+#include <math.h>                   // needed for "lroundf()" function
+#include "logger.h"                 // "logger" functions
+#include "datalog.h"                // "datalog" API declarations
+#include "trace.h"                  // "trace" event macros
+
+/*** Symbolic Constants used in this module ***********************************/
+#define SERIAL_PORT Serial  // Default to Serial
+#if defined(NO_USB)
+    #undef SERIAL_PORT
+    #define SERIAL_PORT Serial1     // Use Serial1 if USB is disabled
+#endif
+
+/*** Global Variable Declarations *********************************************/
+
+// define the function interface
+extern const struct DATALOG_INTERFACE DATALOG = {
+    .add_channel            = &datalog_add_channel,
+    .update                 = &datalog_update,
+    .start                  = &datalog_start,
+    .sample                 = &datalog_sample,
+    .stop                   = &datalog_stop,
+    .tasks                  = &datalog_tasks,
+    .is_running             = &datalog_is_running,
+    .get_stats              = &datalog_get_stats,
+    .clear_channels         = &datalog_clear_channels,
+    .dump                   = &datalog_dump
+};
+
+static struct DATALOG_CHANNEL datalogChannels[DATALOG_MAX_CHANNELS];
+static int datalogNumChannels = 0;
+static DATALOG_STATS datalogStats;
+static File datalogFile;
+static volatile bool datalogRunning = false;
+
+// RAM double buffer: sample() fills one buffer while tasks() writes the other
+static uint8_t datalogBuffer[2][DATALOG_BLOCK_SIZE];
+static volatile bool datalogPending[2];         // buffer is full, waiting to be written
+static int datalogFillIndex;                    // buffer being filled by sample()
+static int datalogWriteIndex;                   // next buffer to write (buffers are written in turn)
+static int datalogLength;                       // bytes used in the buffer being filled
+static int datalogRows;                         // rows in the buffer being filled
+static uint32_t datalogSequence;                // sequence number of the buffer being filled
+static uint32_t datalogPrevTime;                // time of the previous row (in uS)
+static int32_t datalogPrevValue[DATALOG_MAX_CHANNELS];  // values of the previous row
+
+/*** Type Declarations ********************************************************/
+
+/*** Private Function Prototypes **********************************************/
+static void datalogStartBlock(void);                                // Start a new block in the fill buffer
+static void datalogCloseBlock(void);                                // Mark the fill buffer as ready to write
+static void datalogWriteBlock(void);                                // Write the next pending buffer to the file
+static void datalogPutVarint(uint32_t value);                       // Append a variable-length integer to the fill buffer
+static int32_t datalogScale(float value, float scale);              // Scale a value to a recorded integer
+
+/*** Public Function Definitions **********************************************/
+
+int datalog_add_channel(const char *name, float scale, float (*source)(void))
+{
+  if(datalogRunning || (datalogNumChannels >= DATALOG_MAX_CHANNELS))
+  {
+    CETALIB_LOG_ERROR("datalog: cannot add channel \"%s\"", name);
+    return -1;
+  }
+  struct DATALOG_CHANNEL *channel = &datalogChannels[datalogNumChannels];
+  strncpy(channel->name, name, DATALOG_NAME_SIZE - 1);
+  channel->name[DATALOG_NAME_SIZE - 1] = '\0';
+  channel->scale = (scale > 0.0) ? scale : 1.0;
+  channel->source = source;
+  channel->value = 0.0;
+  return datalogNumChannels++;
+}
+
+void datalog_update(int channel, float value)
+{
+  if((channel >= 0) && (channel < datalogNumChannels))
+  {
+    datalogChannels[channel].value = value;
+  }
+}
+
+bool datalog_start(const char *fileName)
+{
+  if(datalogRunning || (datalogNumChannels == 0))
+  {
+    return false;
+  }
+  // the file system size is selected in the Arduino IDE "Tools > Flash Size" menu
+  if(!LittleFS.begin())
+  {
+    CETALIB_LOG_ERROR("datalog: no flash file system");
+    return false;
+  }
+  datalogFile = LittleFS.open(fileName, "w");
+  if(!datalogFile)
+  {
+    CETALIB_LOG_ERROR("datalog: cannot create \"%s\"", fileName);
+    return false;
+  }
+
+  // the file header fills the first block, data blocks follow
+  struct DATALOG_FILE_HEADER header;
+  memset(&header, 0, sizeof(header));
+  header.magic = DATALOG_FILE_MAGIC;
+  header.version = DATALOG_VERSION;
+  header.numChannels = datalogNumChannels;
+  header.blockSize = DATALOG_BLOCK_SIZE;
+  header.maxBlocks = DATALOG_MAX_BLOCKS;
+  header.startTime = millis();
+  for(int i = 0; i < datalogNumChannels; i++)
+  {
+    memcpy(header.channels[i].name, datalogChannels[i].name, DATALOG_NAME_SIZE);
+    header.channels[i].scale = datalogChannels[i].scale;
+  }
+  memset(datalogBuffer[0], 0, DATALOG_BLOCK_SIZE);
+  memcpy(datalogBuffer[0], &header, sizeof(header));
+  if(datalogFile.write(datalogBuffer[0], DATALOG_BLOCK_SIZE) != DATALOG_BLOCK_SIZE)
+  {
+    CETALIB_LOG_ERROR("datalog: cannot write \"%s\"", fileName);
+    datalogFile.close();
+    return false;
+  }
+
+  memset(&datalogStats, 0, sizeof(datalogStats));
+  datalogPending[0] = false;
+  datalogPending[1] = false;
+  datalogFillIndex = 0;
+  datalogWriteIndex = 0;
+  datalogSequence = 0;
+  datalogStartBlock();
+  datalogRunning = true;
+  CETALIB_LOG_INFO("datalog: logging %d channels to \"%s\"", datalogNumChannels, fileName);
+  return true;
+}
+
+void datalog_sample(void)
+{
+  if(!datalogRunning)
+  {
+    return;
+  }
+  if(datalogPending[datalogFillIndex])
+  {
+    // the fill buffer is full, switch to the other one once it is written
+    if(datalogPending[datalogFillIndex ^ 1])
+    {
+      datalogStats.samplesDropped++;
+      return;
+    }
+    datalogFillIndex ^= 1;
+    datalogStartBlock();
+  }
+
+  uint32_t now = micros();
+  int startLength = datalogLength;
+  datalogPutVarint(now - datalogPrevTime);
+  datalogPrevTime = now;
+  for(int i = 0; i < datalogNumChannels; i++)
+  {
+    struct DATALOG_CHANNEL *channel = &datalogChannels[i];
+    int32_t value = datalogScale(channel->source ? channel->source() : channel->value, channel->scale);
+    // zigzag-encode the change, so small negative changes are small integers too
+    int32_t delta = (int32_t)((uint32_t)value - (uint32_t)datalogPrevValue[i]);
+    datalogPutVarint(((uint32_t)delta << 1) ^ (uint32_t)(delta >> 31));
+    datalogPrevValue[i] = value;
+  }
+  datalogRows++;
+  datalogStats.samples++;
+  datalogStats.encodedBytes += (datalogLength - startLength);
+
+  if((DATALOG_BLOCK_SIZE - datalogLength) < DATALOG_MAX_ROW_SIZE)
+  {
+    datalogCloseBlock();
+  }
+}
+
+void datalog_stop(void)
+{
+  if(!datalogRunning)
+  {
+    return;
+  }
+  datalogRunning = false;
+  if(!datalogPending[datalogFillIndex] && (datalogRows > 0))
+  {
+    datalogCloseBlock();
+  }
+  while(datalogPending[datalogWriteIndex])
+  {
+    datalogWriteBlock();
+  }
+  datalogFile.close();
+  CETALIB_LOG_INFO("datalog: stopped, %lu samples (%lu dropped) in %lu blocks",
+                   datalogStats.samples, datalogStats.samplesDropped, datalogStats.blocksWritten);
+}
+
+void datalog_tasks(void)
+{
+  if(!datalogPending[datalogWriteIndex])
+  {
+    return;                     // no full buffer (or not logging)
+  }
+
+  // one block per call, so the other background tasks are not held up
+  CETALIB_TRACE_BEGIN("datalog", "tasks", datalogPending[datalogWriteIndex]);
+  if(datalogPending[datalogWriteIndex])
+  {
+    datalogWriteBlock();
+  }
+  CETALIB_TRACE_END("datalog", "tasks", 0);
+}
+
+bool datalog_is_running(void)
+{
+  return datalogRunning;
+}
+
+DATALOG_STATS* datalog_get_stats(void)
+{
+  return &datalogStats;
+}
+
+void datalog_clear_channels(void)
+{
+  if(datalogRunning)
+  {
+    CETALIB_LOG_ERROR("datalog: cannot clear channels while logging");
+    return;
+  }
+  datalogNumChannels = 0;
+}
+
+bool datalog_dump(const char *fileName)
+{
+  if(datalogRunning || !LittleFS.begin())
+  {
+    return false;
+  }
+  File file = LittleFS.open(fileName, "r");
+  if(!file)
+  {
+    CETALIB_LOG_ERROR("datalog: cannot open \"%s\"", fileName);
+    return false;
+  }
+  // hex text survives any serial terminal, "cetalib-datalog-decode.py" reads
+  // the lines between the BEGIN and END markers
+  static const char hexDigits[] = "0123456789abcdef";
+  uint8_t data[DATALOG_DUMP_LINE_SIZE];
+  char line[(DATALOG_DUMP_LINE_SIZE * 2) + 1];
+  SERIAL_PORT.print("DATALOG BEGIN ");
+  SERIAL_PORT.print(fileName);
+  SERIAL_PORT.print(" ");
+  SERIAL_PORT.println((unsigned long)file.size());
+  int count;
+  while((count = file.read(data, DATALOG_DUMP_LINE_SIZE)) > 0)
+  {
+    for(int i = 0; i < count; i++)
+    {
+      line[i * 2] = hexDigits[data[i] >> 4];
+      line[(i * 2) + 1] = hexDigits[data[i] & 0x0F];
+    }
+    line[count * 2] = '\0';
+    SERIAL_PORT.println(line);
+  }
+  SERIAL_PORT.println("DATALOG END");
+  file.close();
+  return true;
+}
+
+/*** Private Function Definitions *********************************************/
+
+static void datalogStartBlock(void)
+{
+  datalogLength = sizeof(struct DATALOG_BLOCK_HEADER);
+  datalogRows = 0;
+  // the first row holds absolute values
+  datalogPrevTime = 0;
+  memset(datalogPrevValue, 0, sizeof(datalogPrevValue));
+}
+
+static void datalogCloseBlock(void)
+{
+  uint8_t *buffer = datalogBuffer[datalogFillIndex];
+  struct DATALOG_BLOCK_HEADER header;
+  header.magic = DATALOG_BLOCK_MAGIC;
+  header.length = datalogLength;
+  header.sequence = datalogSequence++;
+  header.rows = datalogRows;
+  header.reserved = 0;
+  memcpy(buffer, &header, sizeof(header));
+  memset(buffer + datalogLength, 0, DATALOG_BLOCK_SIZE - datalogLength);
+  datalogPending[datalogFillIndex] = true;
+  if(!datalogPending[datalogFillIndex ^ 1])
+  {
+    datalogFillIndex ^= 1;
+    datalogStartBlock();
+  }
+}
+
+static void datalogWriteBlock(void)
+{
+  uint8_t *buffer = datalogBuffer[datalogWriteIndex];
+  struct DATALOG_BLOCK_HEADER header;
+  memcpy(&header, buffer, sizeof(header));
+  uint32_t block = header.sequence % DATALOG_MAX_BLOCKS;
+  if((block == 0) && (header.sequence > 0))
+  {
+    datalogStats.wraps++;
+  }
+
+  unsigned long startTime = micros();
+  CETALIB_TRACE_BEGIN("datalog", "flashWrite", DATALOG_BLOCK_SIZE);
+  bool written = datalogFile.seek((block + 1) * DATALOG_BLOCK_SIZE) &&
+                 (datalogFile.write(buffer, DATALOG_BLOCK_SIZE) == DATALOG_BLOCK_SIZE);
+  datalogStats.blocksWritten++;
+  if((datalogStats.blocksWritten % DATALOG_SYNC_BLOCKS) == 0)
+  {
+    // save the file size and metadata, so a reset loses at most a few blocks
+    datalogFile.flush();
+  }
+  CETALIB_TRACE_END("datalog", "flashWrite", written);
+  unsigned long writeTime = micros() - startTime;
+
+  datalogStats.lastWriteTime = writeTime;
+  if(writeTime > datalogStats.maxWriteTime)
+  {
+    datalogStats.maxWriteTime = writeTime;
+  }
+  if(!written)
+  {
+    CETALIB_LOG_ERROR("datalog: flash write failed (block %lu)", (unsigned long)header.sequence);
+  }
+  datalogPending[datalogWriteIndex] = false;
+  datalogWriteIndex ^= 1;
+}
+
+static void datalogPutVarint(uint32_t value)
+{
+  // 7 bits per byte, least significant first, bit 7 set if more bytes follow
+  uint8_t *buffer = datalogBuffer[datalogFillIndex];
+  while(value >= 0x80)
+  {
+    buffer[datalogLength++] = (uint8_t)(value | 0x80);
+    value >>= 7;
+  }
+  buffer[datalogLength++] = (uint8_t)value;
+}
+
+static int32_t datalogScale(float value, float scale)
+{
+  float scaled = value * scale;
+  if(isnan(scaled))
+  {
+    return 0;
+  }
+  if(scaled >= 2147483520.0)
+  {
+    return INT32_MAX;
+  }
+  if(scaled <= -2147483520.0)
+  {
+    return INT32_MIN;
+  }
+  return (int32_t)lroundf(scaled);
+}
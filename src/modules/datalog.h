@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2026 dBm Signal Dynamics Inc.
+ *
+ * File:            datalog.h
+ * Project:
+ * Date:            Oct 19, 2026
+ * Framework:       Arduino w. Arduino-Pico Core Pkge by Earl Philhower
+ *                  (https://github.com/earlephilhower/arduino-pico)
+ *
+ * cetalib "datalog" high-rate data logger
+ *
+ * Hardware Configurations Supported:
+ *
+ * CETA IoT Robot (Schematic #14-00069A/B), based on RPI-Pico-WH
+ * (Select "Board = Raspberry Pi Pico W")
+ *
+ * Sparkfun XRP Robot Platform (#KIT-27644), based on the RPI RP2350B MCU
+ * (Select "Board = SparkFun XRP Controller")
+ *
+ * Sparkfun XRP (Beta) Robot Platform (#KIT-22230), based on the RPI Pico W
+ * (Select "Board = SparkFun XRP Controller (Beta)")
+ *
+ */
+
+#ifndef DATALOG_H_
+#define DATALOG_H_
+
+/*** Include Files ************************************************************/
+#include <Arduino.h>
+#include "datalog_interface.h"
+
+/*** Macros *******************************************************************/
+#define DATALOG_MAX_CHANNELS        16          // Max number of channels
+#define DATALOG_NAME_SIZE           12          // Max length of a channel name (including '\0')
+#define DATALOG_BLOCK_SIZE          512         // Size of a RAM buffer and of a log file block (in bytes)
+#define DATALOG_MAX_BLOCKS          256         // Number of blocks in the circular log (128 KB)
+#define DATALOG_SYNC_BLOCKS         8           // Blocks written between file system syncs
+#define DATALOG_FILE_MAGIC          0x474C4443  // "CDLG"
+#define DATALOG_BLOCK_MAGIC         0xB10C      // Start of a valid block
+#define DATALOG_VERSION             1           // File format version, change when the format changes
+#define DATALOG_DUMP_LINE_SIZE      32          // File bytes per line sent by dump()
+#define DATALOG_MAX_ROW_SIZE        (5 + (DATALOG_MAX_CHANNELS * 5))  // Largest encoded sample (in bytes)
+
+/*** Custom Data Types ********************************************************/
+
+// First block of the log file
+struct DATALOG_FILE_HEADER
+{
+  uint32_t magic;                   // DATALOG_FILE_MAGIC
+  uint8_t version;                  // DATALOG_VERSION
+  uint8_t numChannels;              // number of channels in each sample
+  uint16_t blockSize;               // DATALOG_BLOCK_SIZE
+  uint16_t maxBlocks;               // number of blocks in the circular log (after this header)
+  uint16_t reserved;
+  uint32_t startTime;               // time logging started (in mS since reset)
+  struct
+  {
+    char name[DATALOG_NAME_SIZE];   // channel name
+    float scale;                    // recorded integer = value x scale
+  } channels[DATALOG_MAX_CHANNELS];
+};
+
+// Start of each data block
+struct DATALOG_BLOCK_HEADER
+{
+  uint16_t magic;                   // DATALOG_BLOCK_MAGIC
+  uint16_t length;                  // bytes used in the block (including this header)
+  uint32_t sequence;                // block number since start() (the oldest block has the lowest number)
+  uint16_t rows;                    // number of samples in the block
+  uint16_t reserved;
+};
+
+struct DATALOG_CHANNEL
+{
+  char name[DATALOG_NAME_SIZE];     // channel name (CSV column heading)
+  float scale;                      // recorded integer = value x scale
+  float (*source)(void);            // returns the value at each sample (NULL = value set by datalog_update())
+  float value;                      // most recent value passed to datalog_update()
+};
+
+/*** Public Function Prototypes ***********************************************/
+int datalog_add_channel(const char *name, float scale, float (*source)(void)); // Define a channel
+void datalog_update(int channel, float value);              // Pass a new value to a channel without a source
+bool datalog_start(const char *fileName);                   // Create the log file and start logging
+void datalog_sample(void);                                  // Record the current value of all channels
+void datalog_stop(void);                                    // Write the buffered samples and close the log file
+void datalog_tasks(void);                                   // Write a full RAM buffer to flash
+bool datalog_is_running(void);                              // Returns true while logging
+DATALOG_STATS* datalog_get_stats(void);                     // Returns a pointer to the logging counters
+void datalog_clear_channels(void);                          // Remove all channels
+bool datalog_dump(const char *fileName);                    // Send a log file to the serial terminal (as hex text)
+
+#endif /* DATALOG_H_ */
@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2026 dBm Signal Dynamics Inc.
+ *
+ * File:            datalog_interface.h
+ * Project:
+ * Date:            Oct 19, 2026
+ * Framework:       Arduino w. Arduino-Pico Core Pkge by Earl Philhower
+ *                  (https://github.com/earlephilhower/arduino-pico)
+ *
+ * "datalog" driver interface file - defines "DATALOG_INTERFACE" structure
+ *
+ * Hardware Configurations Supported:
+ *
+ * CETA IoT Robot (Schematic #14-00069A/B), based on RPI-Pico-WH
+ * (Select "Board = Raspberry Pi Pico W")
+ *
+ * Sparkfun XRP Robot Platform (#KIT-27644), based on the RPI RP2350B MCU
+ * (Select "Board = SparkFun XRP Controller")
+ *
+ * Sparkfun XRP (Beta) Robot Platform (#KIT-22230), based on the RPI Pico W
+ * (Select "Board = SparkFun XRP Controller (Beta)")
+ *
+ */
+
+#ifndef DATALOG_INTERFACE_H_
+#define DATALOG_INTERFACE_H_
+
+/*** Include Files ************************************************************/
+#include <Arduino.h>
+
+/*** Macros *******************************************************************/
+
+/*** Custom Data Types ********************************************************/
+
+typedef struct
+{
+  unsigned long samples;            // number of samples recorded since start()
+  unsigned long samplesDropped;     // number of samples dropped (both RAM buffers waiting to be written)
+  unsigned long encodedBytes;       // size of the recorded samples (in bytes, after encoding)
+  unsigned long blocksWritten;      // number of blocks written to flash since start()
+  unsigned long wraps;              // number of times the circular log wrapped to its first block
+  unsigned long lastWriteTime;      // duration of the most recent block write (in uS)
+  unsigned long maxWriteTime;       // longest block write since start() (in uS)
+} DATALOG_STATS;
+
+struct DATALOG_INTERFACE
+{
+  int (*add_channel)(const char *name, float scale, float (*source)(void)); // Define a channel, returns channel number (-1 if full or logging)
+  void (*update)(int channel, float value);                 // Pass a new value to a channel without a source
+  bool (*start)(const char *fileName);                      // Create the log file and start logging, returns false if it failed
+  void (*sample)(void);                                     // Record the current value of all channels
+  void (*stop)(void);                                       // Write the buffered samples and close the log file
+  void (*tasks)(void);                                      // Write a full RAM buffer to flash (called by board tasks())
+  bool (*is_running)(void);                                 // Returns true while logging
+  DATALOG_STATS* (*get_stats)(void);                        // Returns a pointer to the logging counters
+  void (*clear_channels)(void);                             // Remove all channels
+  bool (*dump)(const char *fileName);                       // Send a log file to the serial terminal (as hex text)
+};
+
+/*** Public Function Prototypes ***********************************************/
+
+
+#endif /* DATALOG_INTERFACE_H_ */
@@ -24,12 +24,13 @@
 
 /** Include Files *************************************************************/
 #include <Arduino.h>            // Required for Arduino functions
-#include <EEPROM.h>             // Required for EEPROM emulation functions
+#include "calstore.h"           // "calstore" functions
 #include <math.h>               // Required for standard C math library routines
 #include "motor.h"              // "motor" functions
 #include "imu.h"                // "imu" functions
 #include "board.h"              // "board" functions
 #include "diffDrive.h"          // "diffDrive" functions
+#include "logger.h"             // "logger" functions
 
 /*** Symbolic Constants used in this module ***********************************/
 #define SERIAL_PORT Serial  // Default to Serial
@@ -75,22 +76,13 @@ void diffDrive_init(bool left_flip_dir, bool right_flip_dir)
     motor_init(left_flip_dir, right_flip_dir);
     
     #if defined(ARDUINO_RASPBERRY_PI_PICO_W)
-    // Update left_right_compensation variable with default or saved value
-    EEPROM.begin(1024);
-    uint32_t testRead = 0;
-    if(EEPROM.get(DIFFDRIVE_CAL_EEPROM_ADDRESS_START, testRead) == 0xFFFFFFFF)
+    // Update left_right_compensation variable with saved or default value
+    // (the default is not saved, no flash write at boot)
+    if(!calstore_read(CALSTORE_RECORD_DIFFDRIVE, &left_right_compensation, sizeof(left_right_compensation)))
     {
         left_right_compensation = LEFT_RIGHT_COMPENSATION_DEFAULT;
-        EEPROM.put(DIFFDRIVE_CAL_EEPROM_ADDRESS_START, left_right_compensation);
     }
-    else
-    {
-        EEPROM.get(DIFFDRIVE_CAL_EEPROM_ADDRESS_START, left_right_compensation);
-    }
-    EEPROM.end();
-    SERIAL_PORT.print("\"diffDrive_straight()\" Left Right Compensation: ");
-    SERIAL_PORT.println(left_right_compensation);
-    SERIAL_PORT.println();
+    CETALIB_LOG_INFO("\"diffDrive_straight()\" Left Right Compensation: %.2f", left_right_compensation);
     #endif
 }
 
@@ -148,12 +140,9 @@ void diffDrive_turn(float turnDegrees, float turnEffort)
 #if defined(ARDUINO_RASPBERRY_PI_PICO_W)
 void diffDrive_clear_calibration(void)
 {
-    EEPROM.begin(1024);
-    // Erase EEPROM memory to trigger calibration routines during initialization
-    for (int i = DIFFDRIVE_CAL_EEPROM_ADDRESS_START; i <= DIFFDRIVE_CAL_EEPROM_ADDRESS_END; i++) {
-      EEPROM.write(i, 255);
-    }
-    EEPROM.end();
+    // Delete the calibration record (the default value is used after initialization)
+    // (saved when a new value is saved, or by the board "tasks()" function)
+    calstore_clear(CALSTORE_RECORD_DIFFDRIVE);
 }
 #endif
 
@@ -162,9 +151,8 @@ void diffDrive_save_straight_compensation(float leftRightComp)
 {
     // update the compensation value
     left_right_compensation = leftRightComp;
-    EEPROM.begin(1024);
-    EEPROM.put(DIFFDRIVE_CAL_EEPROM_ADDRESS_START, leftRightComp);
-    EEPROM.end();
+    calstore_write(CALSTORE_RECORD_DIFFDRIVE, &leftRightComp, sizeof(leftRightComp));
+    calstore_commit();
 }
 #endif
 
@@ -33,8 +33,6 @@
 
 #if defined(ARDUINO_RASPBERRY_PI_PICO_W)
   #define LEFT_RIGHT_COMPENSATION_DEFAULT 1.0f
-  #define DIFFDRIVE_CAL_EEPROM_ADDRESS_START 385   // EEPROM Start address for calibration data
-  #define DIFFDRIVE_CAL_EEPROM_ADDRESS_END   511   // EEPROM End address for calibration data
 #endif
 
 /*** Custom Data Types ********************************************************/
@@ -51,8 +49,8 @@ void diffDrive_set_efforts(float leftEffort, float rightEffort);    // Set both
 void diffDrive_stop(void);                                          // Stop both motors
 void diffDrive_straight(float straightEffort);                      // Set identical motor efforts and apply compensation for straight motion
 void diffDrive_turn(float turnDegrees, float turnEffort);           // Point-Turn the robot some relative heading, then exit when the heading is reached
-void diffDrive_clear_calibration(void);                             // Delete EEPROM calibration data
-void diffDrive_save_straight_compensation(float leftRightComp);     // Save straight speed calibration value in EEPROM
+void diffDrive_clear_calibration(void);                             // Delete calibration data
+void diffDrive_save_straight_compensation(float leftRightComp);     // Save straight speed calibration value in flash
 #elif defined(ARDUINO_SPARKFUN_XRP_CONTROLLER) || defined(ARDUINO_SPARKFUN_XRP_CONTROLLER_BETA)
 void diffDrive_init(bool left_flip_dir, bool right_flip_dir);       // Initiallize pins & state variables
 void diffDrive_set_efforts(float leftEffort, float rightEffort);    // Set both motor efforts
@@ -39,8 +39,8 @@ struct DIFFDRIVE_INTERFACE
   void (*stop)(void);                                           // Stop both motors
   void (*straight)(float straightEffort);                       // Set identical motor efforts and apply compensation for straight motion
   void (*turn)(float turnDegrees, float turnEffort);            // Point-Turn the robot some relative heading, then exit when the heading is reached
-  void (*clear_calibration)(void);                              // Delete EEPROM calibration data
-  void (*save_straight_compensation)(float leftRightComp);      // Save straight speed calibration value in EEPROM
+  void (*clear_calibration)(void);                              // Delete calibration data
+  void (*save_straight_compensation)(float leftRightComp);      // Save straight speed calibration value in flash
 };
 #elif defined(ARDUINO_SPARKFUN_XRP_CONTROLLER) || defined(ARDUINO_SPARKFUN_XRP_CONTROLLER_BETA)
 struct DIFFDRIVE_INTERFACE
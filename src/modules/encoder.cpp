@@ -29,6 +29,7 @@
 #include <Arduino.h>                // Required for Arduino functions
 #include <pio_encoder.h>            // "PioEncoder" object
 #include "encoder.h"
+#include "replay.h"                 // "replay" functions
 
 /*** Symbolic Constants used in this module ***********************************/
 
@@ -55,10 +56,16 @@ extern const struct ENCODER_INTERFACE ENCODER = {
   .get_left_position_counts   = &encoder_get_left_position_counts,
   .get_right_position_counts  = &encoder_get_right_position_counts,
   .reset_left_position        = &encoder_reset_left_position,
-  .reset_right_position       = &encoder_reset_right_position
+  .reset_right_position       = &encoder_reset_right_position,
+  .get_left_position_q16      = &encoder_get_left_position_q16,
+  .get_right_position_q16     = &encoder_get_right_position_q16
 };
 
 /*** Private Function Prototypes **********************************************/
+#if defined(ARDUINO_SPARKFUN_XRP_CONTROLLER) || defined(ARDUINO_SPARKFUN_XRP_CONTROLLER_BETA)
+static int encoderReadCount(PioEncoder &encoder, enum REPLAY_SOURCE source);   // Read a count (recorded or replayed)
+static q16_t encoderCountsToQ16(int count);                                     // Convert a count to revolutions (Q16.16)
+#endif
 
 /*** Public Function Definitions **********************************************/
 
@@ -75,7 +82,7 @@ int encoder_get_left_position_counts(void)
     #if defined(ARDUINO_RASPBERRY_PI_PICO_W)
         return 0;
     #elif defined(ARDUINO_SPARKFUN_XRP_CONTROLLER) || defined(ARDUINO_SPARKFUN_XRP_CONTROLLER_BETA)
-        return leftEncoder.getCount();
+        return encoderReadCount(leftEncoder, REPLAY_SOURCE_ENCODER_LEFT);
     #endif
 }
 
@@ -84,7 +91,7 @@ int encoder_get_right_position_counts(void)
     #if defined(ARDUINO_RASPBERRY_PI_PICO_W)
         return 0;
     #elif defined(ARDUINO_SPARKFUN_XRP_CONTROLLER) || defined(ARDUINO_SPARKFUN_XRP_CONTROLLER_BETA)
-        return rightEncoder.getCount();
+        return encoderReadCount(rightEncoder, REPLAY_SOURCE_ENCODER_RIGHT);
     #endif
 }
 
@@ -103,20 +110,58 @@ void encoder_reset_right_position(void)
 }
 
 float encoder_get_left_position(void)
+{
+    return q16_to_float(encoder_get_left_position_q16());
+}
+
+float encoder_get_right_position(void)
+{
+    return q16_to_float(encoder_get_right_position_q16());
+}
+
+q16_t encoder_get_left_position_q16(void)
 {
     #if defined(ARDUINO_RASPBERRY_PI_PICO_W)
-        return 0.0;
+        return 0;
     #elif defined(ARDUINO_SPARKFUN_XRP_CONTROLLER) || defined(ARDUINO_SPARKFUN_XRP_CONTROLLER_BETA)
-        return encoder_get_left_position_counts() / RESOLUTION;
+        return encoderCountsToQ16(encoder_get_left_position_counts());
     #endif
 }
 
-float encoder_get_right_position(void)
+q16_t encoder_get_right_position_q16(void)
 {
     #if defined(ARDUINO_RASPBERRY_PI_PICO_W)
-        return 0.0;
+        return 0;
     #elif defined(ARDUINO_SPARKFUN_XRP_CONTROLLER) || defined(ARDUINO_SPARKFUN_XRP_CONTROLLER_BETA)
-        return encoder_get_right_position_counts() / RESOLUTION;
+        return encoderCountsToQ16(encoder_get_right_position_counts());
     #endif
 }
 
+/*** Private Function Definitions *********************************************/
+
+#if defined(ARDUINO_SPARKFUN_XRP_CONTROLLER) || defined(ARDUINO_SPARKFUN_XRP_CONTROLLER_BETA)
+static int encoderReadCount(PioEncoder &encoder, enum REPLAY_SOURCE source)
+{
+    int count = 0;
+    if(replay_is_playing())
+    {
+        replay_read(source, &count, sizeof(count));
+    }
+    else
+    {
+        count = encoder.getCount();
+        replay_input(source, &count, sizeof(count));
+    }
+    return count;
+}
+
+static q16_t encoderCountsToQ16(int count)
+{
+    // count * 65536 / RESOLUTION (rounded) in 32-bit integer divisions (SIO hardware
+    // divider on the RP2040): whole revolutions, then the fraction of a revolution
+    int revolutions = count / RESOLUTION_COUNTS;
+    int remainder = count % RESOLUTION_COUNTS;
+    int rounding = (remainder < 0) ? -(RESOLUTION_COUNTS / 2) : (RESOLUTION_COUNTS / 2);
+    return (q16_t)(revolutions * Q16_ONE + (remainder * Q16_ONE + rounding) / RESOLUTION_COUNTS);
+}
+#endif
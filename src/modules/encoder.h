@@ -40,10 +40,12 @@
 #define RIGHT_MOTOR_ENCODER_A_PIN 24
 #define RESOLUTION 585.0  // Number of counts per wheel rotation  
                           // (12 counts/motor shaft revolution) * (48.75:1 gear ratio)
+#define RESOLUTION_COUNTS 585  // RESOLUTION as an integer, for the Q16.16 positions
 #elif defined(ARDUINO_SPARKFUN_XRP_CONTROLLER_BETA)
 #define LEFT_MOTOR_ENCODER_A_PIN  4
 #define RIGHT_MOTOR_ENCODER_A_PIN 12
 #define RESOLUTION 585.0
+#define RESOLUTION_COUNTS 585
 #endif
  
 /*** Custom Data Types ********************************************************/
@@ -57,5 +59,7 @@ int   encoder_get_left_position_counts(void);   // Return the raw encoder count
 int   encoder_get_right_position_counts(void);  // Return the raw encoder count of the right encoder since last reset 
 void  encoder_reset_left_position(void);        // Reset left encoder count
 void  encoder_reset_right_position(void);       // Reset right encoder count
+q16_t encoder_get_left_position_q16(void);      // Return the position of the left encoded motor (in revolutions, Q16.16) since last reset
+q16_t encoder_get_right_position_q16(void);     // Return the position of the right encoded motor (in revolutions, Q16.16) since last reset
 
 #endif /* ENCODER_H_ */
\ No newline at end of file
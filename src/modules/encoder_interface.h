@@ -24,6 +24,7 @@
  
  /*** Include Files ************************************************************/
  #include <Arduino.h>
+ #include "fixedpoint.h"
  
  /*** Macros *******************************************************************/
  
@@ -37,6 +38,8 @@
    int    (*get_right_position_counts)(void); // Return the raw encoder count of the right encoder since last reset
    void   (*reset_left_position)(void);       // Reset left encoder count
    void   (*reset_right_position)(void);      // Reset right encoder count
+   q16_t  (*get_left_position_q16)(void);     // Return the position of the left encoded motor (in revolutions, Q16.16) since last reset
+   q16_t  (*get_right_position_q16)(void);    // Return the position of the right encoded motor (in revolutions, Q16.16) since last reset
  };
  
  /*** Public Function Prototypes ***********************************************/
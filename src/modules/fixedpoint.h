@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2026 dBm Signal Dynamics Inc.
+ *
+ * File:            fixedpoint.h
+ * Project:
+ * Date:            Oct 19, 2026
+ * Framework:       Arduino w. Arduino-Pico Core Pkge by Earl Philhower
+ *                  (https://github.com/earlephilhower/arduino-pico)
+ *
+ * Fixed-point types and conversion helpers shared by the "_q15" and "_q16"
+ * functions of the "motor", "reflectance", "encoder" and "joystick" modules.
+ *
+ * The RP2040 (Cortex-M0+) has no FPU, so every float operation is a software
+ * library call. The fixed-point functions keep the hot paths in integer math;
+ * the float functions of each module are thin wrappers around them.
+ *
+ *   q15_t: signed 1.15 format, value = q15 / 32768
+ *          efforts (-1.0 to 1.0) and normalized sensor readings (0.0 to 1.0)
+ *          full scale is clamped to +/-32767 (+/-0.99997)
+ *
+ *   q16_t: signed 16.16 format, value = q16 / 65536
+ *          encoder positions in revolutions (+/-32768 revolutions)
+ */
+
+#ifndef FIXEDPOINT_H_
+#define FIXEDPOINT_H_
+
+/*** Include Files ************************************************************/
+#include <Arduino.h>
+
+/*** Macros *******************************************************************/
+#define Q15_SHIFT   15
+#define Q15_ONE     32767           // full scale (+0.99997)
+#define Q15_HALF    16384           // 0.5
+#define Q16_SHIFT   16
+#define Q16_ONE     65536           // 1.0
+
+/*** Custom Data Types ********************************************************/
+typedef int16_t q15_t;
+typedef int32_t q16_t;
+
+/*** Public Function Definitions **********************************************/
+
+// Clamp a 32-bit intermediate result to the q15 range (+/-32767)
+static inline q15_t q15_saturate(int32_t value)
+{
+  if (value > Q15_ONE)
+  {
+    return Q15_ONE;
+  }
+  if (value < -Q15_ONE)
+  {
+    return -Q15_ONE;
+  }
+  return (q15_t)value;
+}
+
+// Multiply two q15 values (rounded)
+static inline q15_t q15_mul(q15_t a, q15_t b)
+{
+  return q15_saturate(((int32_t)a * b + Q15_HALF) >> Q15_SHIFT);
+}
+
+// Scale a q15 value to an integer range, e.g. a PWM duty of 0 to "range" (rounded)
+static inline int32_t q15_scale(q15_t value, int32_t range)
+{
+  return (value * range + Q15_HALF) >> Q15_SHIFT;
+}
+
+static inline q15_t q15_from_float(float value)
+{
+  value = constrain(value, -1.0f, 1.0f);
+  return q15_saturate((int32_t)lroundf(value * 32768.0f));
+}
+
+static inline float q15_to_float(q15_t value)
+{
+  return (float)value * (1.0f / 32768.0f);
+}
+
+static inline q16_t q16_from_float(float value)
+{
+  return (q16_t)lroundf(value * 65536.0f);
+}
+
+static inline float q16_to_float(q16_t value)
+{
+  return (float)value * (1.0f / 65536.0f);
+}
+
+#endif /* FIXEDPOINT_H_ */
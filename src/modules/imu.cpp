@@ -28,11 +28,13 @@
 
 /** Include Files *************************************************************/
 #include <Arduino.h>                // Required for Arduino functions
-#include <stdio.h>                  // Required for sprintf()
-#include <EEPROM.h>                 // Required for EEPROM emulation functions
+#include "calstore.h"               // "calstore" functions
 #include <Arduino_LSM6DSOX.h>       // Required for Arduino LSM6DSOX access functions
 #include "imu.h"                    // "imu" API declarations
 #include "board.h"                  // "board" functions
+#include "logger.h"                 // "logger" functions
+#include "replay.h"                 // "replay" functions
+#include "trace.h"                  // "trace" event macros
 
 /*** Symbolic Constants used in this module ***********************************/
 #define SERIAL_PORT Serial  // Default to Serial
@@ -46,9 +48,6 @@ static float temperature, heading;
 static unsigned long imuTaskCurrentTime, imuTaskPrevTime;
 static const long imuTaskInterval = (long)IMU_SAMPLE_INTERVAL_MS;
 
-// define an output buffer for sprintf()/Serial.print()
-static char imuOutBuffer[256];
-
 // initiallize function pointers
 extern const struct CETA_IMU_INTERFACE CETA_IMU_IF = {
     .initialize             = &imu_init,
@@ -56,7 +55,11 @@ extern const struct CETA_IMU_INTERFACE CETA_IMU_IF = {
     .get_temperature        = &imu_get_temperature,
     .get_heading            = &imu_get_heading,
     .reset_heading          = &imu_reset_heading,
-    .clear_calibration      = &imu_clear_calibration
+    .clear_calibration      = &imu_clear_calibration,
+    .start_calibration      = &imu_start_calibration,
+    .is_calibrating         = &imu_is_calibrating,
+    .calibration_next       = &imu_calibration_next,
+    .cancel_calibration     = &imu_cancel_calibration
 };
 
 // calibration object with default values assigned
@@ -67,18 +70,24 @@ struct IMU_CAL imuCal = {
 
 enum IMU_CALIBRATION_STATE imuCalState = IMU_CAL_IDLE;
 
+// calibration routine variables
+static bool imuStarted = false;                 // "initialize()" succeeded
+static struct IMU_CAL imuNewCal;                // calibration being measured
+static bool imuCalNextRequest = false;          // calibration_next() called
+static float calYawAccumulator;
+static float calHeading;
+static int calSampleCounter;
+
 /*** Private Function Prototypes **********************************************/
+static bool imuReadGyroscope(float *x, float *y, float *z);     // Read the gyro rates (recorded or replayed)
+static void imuReadTemperature(void);                           // Read the temperature (recorded or replayed)
+static void imuCalNext(void);                                   // Advance the calibration routine (USER switch)
+static void imuCalSample(float z);                              // Add a gyro reading to the calibration
 
 /*** Public Function Definitions **********************************************/
 
 bool imu_init(void)
 {
-    // calibration variables
-    float calYawAccumulator = 0.0f;
-    float calHeading = 0.0f;
-    float x, y, z;
-    int sample_counter = 0;
-
     // initialize I2C connection to the IMU
     Wire1.setSDA(IMU_SDA_PIN);
     Wire1.setSCL(IMU_SCL_PIN);
@@ -87,128 +96,62 @@ bool imu_init(void)
     {
         return false;
     }
+    imuStarted = true;
     heading = 0.0f;
 
-    // Perform imu calibration if EEPROM calibration memory is blank
-    EEPROM.begin(1024);
-    uint32_t testRead = 0;
-    if(EEPROM.get(IMU_CAL_EEPROM_ADDRESS_START, testRead) == 0xFFFFFFFF)
+    // Perform imu calibration if there is no valid calibration record
+    if(!calstore_read(CALSTORE_RECORD_IMU, &imuCal, sizeof(imuCal)))
     {
-        SERIAL_PORT.println("IMU Calibration Routine Triggered");
-        // EEPROM is blank, perform calibration procedure
-        imuCalState = IMU_CAL_WAIT_BEGIN;
-        board_led_pattern(5);
-        while (imuCalState != IMU_CAL_IDLE)
+        // No calibration record, run the calibration routine until it is complete
+        imu_start_calibration();
+        while (imu_is_calibrating())
         {
             board_tasks();
-            switch(imuCalState)
-            {
-                case IMU_CAL_WAIT_BEGIN:
-                  if(board_is_button_pressed())
-                  {
-                    board_led_pattern(1);                               // indicate "calibrate yaw offset error" state
-                    imuCalState = IMU_CAL_HEADING_OFFSET_ERROR;         // compute the yaw offset error
-                    calYawAccumulator = 0.0f;
-                    sample_counter = 0;
-                  }
-                  break;
-                case IMU_CAL_HEADING_OFFSET_ERROR:
-                  if(board_is_button_pressed())
-                  {
-                    imuCal.yaw_offset_error = calYawAccumulator / sample_counter;
-                    //board_led_off();
-                    board_led_pattern(2);
-                    //imuCalState = IMU_CAL_IDLE;
-                    imuCalState = IMU_CAL_HEADING_GAIN;
-                    calHeading = 0.0f;
-                  }
-                  else
-                  {
-                    imuTaskCurrentTime = millis();
-                    if ((imuTaskCurrentTime - imuTaskPrevTime) >= imuTaskInterval)
-                    {
-                      imuTaskPrevTime = imuTaskCurrentTime;
-                      if(CETA_IMU.gyroscopeAvailable())
-                      {
-                        CETA_IMU.readGyroscope(x, y, z);
-                        calYawAccumulator += z;
-                        sample_counter++;
-                      }
-                    }    
-                  }
-                  break;
-                case IMU_CAL_HEADING_GAIN:
-                  if(board_is_button_pressed())
-                  {
-                    imuCal.yaw_gain_coefficient = 90.0 / calHeading;
-                    board_led_off();
-                    imuCalState = IMU_CAL_IDLE;
-                  }
-                  else
-                  {
-                    imuTaskCurrentTime = millis();
-                    if ((imuTaskCurrentTime - imuTaskPrevTime) >= imuTaskInterval)
-                    {
-                      imuTaskPrevTime = imuTaskCurrentTime;
-                      if(CETA_IMU.gyroscopeAvailable())
-                      {
-                        CETA_IMU.readGyroscope(x, y, z);
-                        z -= imuCal.yaw_offset_error;
-                        calHeading += (z*IMU_SAMPLE_INTERVAL_S);
-                      }
-                    }    
-                  }
-                  break;  
-                default:
-                  imuCalState = IMU_CAL_IDLE;
-                  board_led_off();
-                  break;
-            }
+            imu_tasks();        // runs the calibration routine
         }
-        // Save calibration values to EEPROM memory
-        EEPROM.put(IMU_CAL_EEPROM_ADDRESS_START, imuCal);
-        sprintf(imuOutBuffer, "\r\nIMU Heading Offset Error: %f\tIMU Heading Gain Error: %f\r\n\r\n", imuCal.yaw_offset_error, imuCal.yaw_gain_coefficient);
-        SERIAL_PORT.print(imuOutBuffer);
     }
     else
     {
-      // EEPROM is programmed with calibration values, so use them
-        EEPROM.get(IMU_CAL_EEPROM_ADDRESS_START, imuCal);
-        sprintf(imuOutBuffer, "\r\nIMU Heading Offset Error: %f\tIMU Heading Gain Error: %f\r\n\r\n", imuCal.yaw_offset_error, imuCal.yaw_gain_coefficient);
-        SERIAL_PORT.print(imuOutBuffer);
+      // Calibration record is valid, so use it
+        CETALIB_LOG_INFO("IMU Heading Offset Error: %f\tIMU Heading Gain Error: %f", imuCal.yaw_offset_error, imuCal.yaw_gain_coefficient);
     }
 
-    // Write any changes to EEPROM and close interface.
-    EEPROM.end();
-
     return true;
 }
 
 void imu_tasks(void)
 {
   float x, y, z;
+
+  // the USER switch (or "calibration_next()") advances the calibration routine
+  if(imuCalState != IMU_CAL_IDLE)
+  {
+    imuCalNext();
+  }
+
   imuTaskCurrentTime = millis();
   if ((imuTaskCurrentTime - imuTaskPrevTime) >= imuTaskInterval)
   {
     imuTaskPrevTime = imuTaskCurrentTime;
+    CETALIB_TRACE_BEGIN("imu", "tasks", 0);
     
-    if(CETA_IMU.temperatureAvailable())
-    {
-      CETA_IMU.readTemperatureFloat(temperature);
-    }
+    imuReadTemperature();
     
-    if(CETA_IMU.gyroscopeAvailable())
+    if(imuReadGyroscope(&x, &y, &z))
     {
-      CETA_IMU.readGyroscope(x, y, z);
+      if(imuCalState != IMU_CAL_IDLE)
+      {
+        imuCalSample(z);
+      }
       z -= imuCal.yaw_offset_error;
       if(fabsf(z) > (imuCal.yaw_offset_error*10))
       {
         heading += (z*IMU_SAMPLE_INTERVAL_S);
       }
-      //sprintf(imuOutBuffer, "pitch: %f\troll: %f\tyaw: %f\r\n", x, y, z);
-      //SERIAL_PORT.print(imuOutBuffer);
+      //CETALIB_LOG_DEBUG("pitch: %f\troll: %f\tyaw: %f", x, y, z);
     }
 
+    CETALIB_TRACE_END("imu", "tasks", 0);
   }
 
 }
@@ -230,10 +173,161 @@ void imu_reset_heading(void)
 
 void imu_clear_calibration(void)
 {
-    EEPROM.begin(1024);
-    // Erase EEPROM memory to trigger calibration routines during initialization
-    for (int i = IMU_CAL_EEPROM_ADDRESS_START; i <= IMU_CAL_EEPROM_ADDRESS_END; i++) {
-      EEPROM.write(i, 255);
+    // Delete the calibration record to trigger calibration routines during initialization
+    // (saved when the module is re-calibrated, or by the board "tasks()" function)
+    calstore_clear(CALSTORE_RECORD_IMU);
+}
+
+bool imu_start_calibration(void)
+{
+    if(!imuStarted)
+    {
+        CETALIB_LOG_ERROR("imu: initialize() must succeed before calibration");
+        return false;
+    }
+    if(imuCalState != IMU_CAL_IDLE)
+    {
+        CETALIB_LOG_ERROR("imu: calibration already running");
+        return false;
+    }
+    CETALIB_LOG_INFO("IMU Calibration Routine Triggered. Place the robot on a flat surface and press button to begin.");
+    imuNewCal = imuCal;
+    imuCalNextRequest = false;
+    imuCalState = IMU_CAL_WAIT_BEGIN;
+    board_led_pattern(5);
+    return true;
+}
+
+bool imu_is_calibrating(void)
+{
+    return (imuCalState != IMU_CAL_IDLE);
+}
+
+void imu_calibration_next(void)
+{
+    imuCalNextRequest = true;
+}
+
+void imu_cancel_calibration(void)
+{
+    if(imuCalState == IMU_CAL_IDLE)
+    {
+        return;
+    }
+    imuCalState = IMU_CAL_IDLE;
+    board_led_off();
+    CETALIB_LOG_WARN("imu: calibration cancelled, previous calibration kept");
+}
+
+/*** Private Function Definitions *********************************************/
+
+static void imuCalNext(void)
+{
+    bool next = board_is_button_pressed() || imuCalNextRequest;
+    imuCalNextRequest = false;
+    if(!next)
+    {
+        return;
+    }
+    switch(imuCalState)
+    {
+        case IMU_CAL_WAIT_BEGIN:
+          board_led_pattern(1);                               // indicate "calibrate yaw offset error" state
+          imuCalState = IMU_CAL_HEADING_OFFSET_ERROR;         // compute the yaw offset error
+          calYawAccumulator = 0.0f;
+          calSampleCounter = 0;
+          CETALIB_LOG_INFO("imu: keep the robot still for a few seconds, then press button");
+          break;
+        case IMU_CAL_HEADING_OFFSET_ERROR:
+          if(calSampleCounter == 0)
+          {
+            break;                                            // wait for the first sample
+          }
+          imuNewCal.yaw_offset_error = calYawAccumulator / calSampleCounter;
+          board_led_pattern(2);
+          imuCalState = IMU_CAL_HEADING_GAIN;
+          calHeading = 0.0f;
+          CETALIB_LOG_INFO("imu: turn the robot exactly 90 degrees to the left, then press button");
+          break;
+        case IMU_CAL_HEADING_GAIN:
+          board_led_off();
+          imuCalState = IMU_CAL_IDLE;
+          if(fabsf(calHeading) < IMU_CAL_MIN_TURN)
+          {
+            CETALIB_LOG_ERROR("imu: calibration failed, turn of %.1f degrees measured, previous calibration kept", calHeading);
+            break;
+          }
+          imuNewCal.yaw_gain_coefficient = 90.0 / calHeading;
+          // Save calibration values to flash memory (the whole record, in one commit)
+          imuCal = imuNewCal;
+          calstore_write(CALSTORE_RECORD_IMU, &imuCal, sizeof(imuCal));
+          calstore_commit();
+          CETALIB_LOG_INFO("IMU Heading Offset Error: %f\tIMU Heading Gain Error: %f", imuCal.yaw_offset_error, imuCal.yaw_gain_coefficient);
+          break;
+        default:
+          imuCalState = IMU_CAL_IDLE;
+          board_led_off();
+          break;
+    }
+}
+
+static void imuCalSample(float z)
+{
+    if(imuCalState == IMU_CAL_HEADING_OFFSET_ERROR)
+    {
+        calYawAccumulator += z;
+        calSampleCounter++;
+    }
+    else if(imuCalState == IMU_CAL_HEADING_GAIN)
+    {
+        z -= imuNewCal.yaw_offset_error;
+        calHeading += (z*IMU_SAMPLE_INTERVAL_S);
+    }
+}
+
+
+static bool imuReadGyroscope(float *x, float *y, float *z)
+{
+    float rates[3];
+    if(replay_is_playing())
+    {
+        if(replay_read(REPLAY_SOURCE_IMU_GYRO, rates, sizeof(rates)) != sizeof(rates))
+        {
+            return false;
+        }
+    }
+    else
+    {
+        CETALIB_TRACE_BEGIN("imu", "i2cReadGyro", 0);
+        if(!CETA_IMU.gyroscopeAvailable())
+        {
+            CETALIB_TRACE_END("imu", "i2cReadGyro", 0);
+            return false;
+        }
+        CETA_IMU.readGyroscope(rates[0], rates[1], rates[2]);
+        CETALIB_TRACE_END("imu", "i2cReadGyro", 1);
+        replay_input(REPLAY_SOURCE_IMU_GYRO, rates, sizeof(rates));
+    }
+    *x = rates[0];
+    *y = rates[1];
+    *z = rates[2];
+    return true;
+}
+
+static void imuReadTemperature(void)
+{
+    if(replay_is_playing())
+    {
+        replay_read(REPLAY_SOURCE_IMU_TEMPERATURE, &temperature, sizeof(temperature));
     }
-    EEPROM.end();
-}
\ No newline at end of file
+    else
+    {
+        CETALIB_TRACE_BEGIN("imu", "i2cReadTemp", 0);
+        if(CETA_IMU.temperatureAvailable())
+        {
+            CETA_IMU.readTemperatureFloat(temperature);
+            replay_input(REPLAY_SOURCE_IMU_TEMPERATURE, &temperature, sizeof(temperature));
+        }
+        CETALIB_TRACE_END("imu", "i2cReadTemp", 0);
+    }
+}
@@ -38,12 +38,11 @@
 #define IMU_SDA_PIN 18
 #define IMU_I2C_ADDRESS 0x6A
 #define IMU_I2C_BAUD 400000
-#define IMU_CAL_EEPROM_ADDRESS_START 256    // EEPROM Start address for calibration data
-#define IMU_CAL_EEPROM_ADDRESS_END   383    // EEPROM End address for calibration data
 #define IMU_SAMPLE_INTERVAL_MS  50          // Sensor sample interval (in mSec)
 #define IMU_SAMPLE_INTERVAL_S   0.05f       // Sensor sample interval (in Seconds)
 #define IMU_YAW_OFFSET_ERROR_DEFAULT  0.02f // Default yaw reading offset error
 #define IMU_YAW_GAIN_COEFFICIENT_DEFAULT 1.125f // Default yaw gain coefficient
+#define IMU_CAL_MIN_TURN 45.0f              // Calibration: smallest measured turn accepted for the 90 degree turn
 
 /*** Custom Data Types ********************************************************/
 
@@ -62,5 +61,9 @@ float imu_get_temperature(void);
 float imu_get_heading(void);
 void  imu_reset_heading(void);
 void  imu_clear_calibration(void);
+bool  imu_start_calibration(void);
+bool  imu_is_calibrating(void);
+void  imu_calibration_next(void);
+void  imu_cancel_calibration(void);
 
 #endif /* IMU_H_ */
\ No newline at end of file
@@ -34,6 +34,10 @@ struct CETA_IMU_INTERFACE
   float (*get_heading)(void);             // Return the current robot heading ("yaw") (0-360 degrees)
   void (*reset_heading)(void);            // Reset the heading value
   void (*clear_calibration)(void);        // Delete calibration data
+  bool (*start_calibration)(void);        // Start the calibration routine (does not wait, advanced by tasks())
+  bool (*is_calibrating)(void);           // true while the calibration routine runs
+  void (*calibration_next)(void);         // Continue the calibration routine (same as pressing the USER switch)
+  void (*cancel_calibration)(void);       // Stop the calibration routine, keep the previous calibration
 };
 
 /*** Public Function Prototypes ***********************************************/
@@ -40,7 +40,15 @@
 #include <WiFiUdp.h>                // Required for UDP server interface
 #include <stdio.h>                  // Required for sprintf()
 #include <string>                   // Required for strcpy(); function
+#include <string.h>                 // Required for memcpy()
+#include <math.h>                   // Required for fabsf(), lroundf()
+#include <pico/time.h>              // Required for the failsafe repeating timer
+#include <hardware/sync.h>          // Required for the button edge spin lock
 #include "joystick.h"
+#include "motor.h"                  // "motor" functions (failsafe ramp down)
+#include "logger.h"                 // "logger" functions
+#include "replay.h"                 // "replay" functions
+#include "trace.h"                  // "trace" event macros
 
 /*** Symbolic Constants used in this module ***********************************/
 #define SERIAL_PORT Serial  // Default to Serial
@@ -49,6 +57,12 @@
     #define SERIAL_PORT Serial1     // Use Serial1 if USB is disabled
 #endif
 
+#define JOYSTICK_SPINLOCK_ID    PICO_SPINLOCK_ID_STRIPED_FIRST  // SDK shared spin lock, held only to update/read the button edges
+
+#if (JOYSTICK_V2_MAX_PACKET_SIZE > REPLAY_MAX_VALUE_SIZE)
+    #error REPLAY_MAX_VALUE_SIZE must hold the largest joystick packet
+#endif
+
 /*** Global Variable Declarations *********************************************/
 
 // Access Point Settings
@@ -57,6 +71,7 @@ char apPassphrase[64];
 IPAddress apIP(192, 168, 42, 1);                // WiFi network AP IP address
 IPAddress gateway(192, 168, 42, 1);             // WiFi network Gateway IP Address
 IPAddress subnet(255, 255, 255, 0);             // WiFi network Subnet Mask
+IPAddress fleetGroupIP(239, 42, 0, 1);          // Fleet mode multicast group (shared by every robot)
 int wifiChannel;                                // WiFi network radio channel to use (1, 6 or 11)
 byte macAddr[6];                                // WiFi radio IEEE MAC address used to generate unique SSID and passphrase
                                                 // SSID: "XRPBeta_abcd", where "abcd" are the last 2 mac address hex bytes
@@ -67,13 +82,53 @@ unsigned int localPort = 8888;                  // local port to listen on
 char packetBuffer[UDP_TX_PACKET_MAX_SIZE + 1];  // buffer to hold incoming packet
 WiFiUDP Udp;
 static int joystickIsActive = 0;                // used to detect a joystick update 
+static uint8_t joystickRobotId = JOYSTICK_ROBOT_ID_ANY;   // protocol v2 robot ID accepted by this robot
 
 // local gamepad data structure
 GAMEPAD joystick_local;
+static IPAddress joystickClientIPAddress;       // client address last formatted into joystick_local.clientIP
+
+// button edges accumulated since the last get_buttons_pressed()/get_buttons_released() call
+static volatile uint16_t joystickButtonsPressed;
+static volatile uint16_t joystickButtonsReleased;
+static uint16_t joystickEdgeButtons;            // button word the edges were last computed from
+
+// D-Pad hat value (0 = North, clockwise in 45 degree steps, 8 = neutral) to button bits
+static const uint16_t joystickDPadTable[16] = {
+  JOYSTICK_BUTTON_DPAD_N, 0, JOYSTICK_BUTTON_DPAD_E, 0,
+  JOYSTICK_BUTTON_DPAD_S, 0, JOYSTICK_BUTTON_DPAD_W, 0,
+  0, 0, 0, 0, 0, 0, 0, 0
+};
+
+// newest gamepad report found while draining the UDP receive queue
+static uint8_t newestReport[JOYSTICK_REPORT_SIZE];
+
+// link statistics (protocol v2 sequence/timestamp tracking)
+static JOYSTICK_STATS joystickStats;
+static bool joystickSeqValid = false;           // a v2 packet has been received
+static uint16_t joystickLastSeq;                // sequence number of the newest v2 packet
+static unsigned long joystickLastSeqTime;       // arrival time of the newest v2 packet (in mS)
+static int32_t joystickMinOffset;               // smallest (receive time - send time) seen (in mS)
+
+// drive mixing: stick byte to shaped effort (JOYSTICK_MIX_ONE = 1.0), built when a curve is set
+static int16_t joystickThrottleTable[256];      // stick Y axes: up is positive
+static int16_t joystickTurnTable[256];          // stick X axes: right is positive
+static enum JOYSTICK_DRIVE_MODE joystickDriveMode = JOYSTICK_DRIVE_ARCADE;
+
+// link-loss failsafe
+static const uint8_t joystickNeutralReport[JOYSTICK_REPORT_SIZE] = {128, 128, 128, 128, 8, 0, 0, 0};
+static repeating_timer_t joystickFailsafeTimer;
+static bool joystickFailsafeRunning = false;
+static volatile unsigned long joystickFailsafeTimeout = JOYSTICK_FAILSAFE_TIMEOUT_DEFAULT;
+static volatile unsigned long joystickLastReportTime;   // arrival time of the newest gamepad report (in mS)
+static volatile enum JOYSTICK_LINK_STATE joystickLinkState = JOYSTICK_LINK_WAITING;
+static volatile bool joystickFailsafeTripped = false;   // set by the failsafe timer, neutral data set by joystick_tasks()
+static bool joystickMotorRampActive = false;            // motors are being ramped down after a link loss (failsafe timer only)
 
 // define the function interface
 extern const struct JOYSTICK_INTERFACE JOYSTICK = {
     .initialize                 = &joystick_init,
+    .initialize_fleet           = &joystick_init_fleet,
     .tasks                      = &joystick_tasks,
     .is_active                  = &joystick_is_active,
     .get_data                   = &joystick_get_data,
@@ -81,6 +136,21 @@ extern const struct JOYSTICK_INTERFACE JOYSTICK = {
     .get_right_tank_effort      = &joystick_get_right_tank_effort,
     .get_arcade_throttle_effort = &joystick_get_left_arcade_effort,
     .get_arcade_turn_effort     = &joystick_get_right_arcade_effort,
+    .get_stats                  = &joystick_get_stats,
+    .set_failsafe_timeout       = &joystick_set_failsafe_timeout,
+    .get_link_state             = &joystick_get_link_state,
+    .get_buttons                = &joystick_get_buttons,
+    .get_buttons_pressed        = &joystick_get_buttons_pressed,
+    .get_buttons_released       = &joystick_get_buttons_released,
+    .set_drive_mode             = &joystick_set_drive_mode,
+    .set_throttle_curve         = &joystick_set_throttle_curve,
+    .set_turn_curve             = &joystick_set_turn_curve,
+    .get_drive_efforts          = &joystick_get_drive_efforts,
+    .get_left_tank_effort_q15   = &joystick_get_left_tank_effort_q15,
+    .get_right_tank_effort_q15  = &joystick_get_right_tank_effort_q15,
+    .get_arcade_throttle_effort_q15 = &joystick_get_left_arcade_effort_q15,
+    .get_arcade_turn_effort_q15 = &joystick_get_right_arcade_effort_q15,
+    .get_drive_efforts_q15      = &joystick_get_drive_efforts_q15,
 };
 
 /*** Private Function Prototypes **********************************************/
@@ -90,6 +160,20 @@ extern const struct JOYSTICK_INTERFACE JOYSTICK = {
 // then pick the "quietest" one.
 static int selectBestClassroomChannel(void);
 
+static int joystickReadPacket(void);                                           // Read the next datagram (recorded or replayed), returns its size
+static const uint8_t* joystickParsePacket(const uint8_t *packet, int length);  // Validate a datagram, returns its gamepad report
+static void joystickDecodeReport(const uint8_t *report);                       // Update the local gamepad data structure
+static uint16_t joystickPackButtons(const uint8_t *report);                    // Pack the buttons of a report into a button word
+static void joystickTrackButtons(uint16_t buttons);                            // Accumulate pressed/released edges
+static void joystickResetData(void);                                           // Neutral gamepad data, default drive curves
+static void joystickStartService(void);                                        // Reset statistics, start the failsafe and status LED
+static bool joystickFailsafeCallback(repeating_timer_t *rt);                   // Link-loss check (timer interrupt)
+static void joystickFailsafeTasks(void);                                       // Neutral gamepad data after a link loss
+static q15_t joystickRampToZero(q15_t effort);                                 // Move an effort one ramp step towards 0
+static void joystickBuildAxisTable(int16_t *table, bool invert, float deadzone, float expo, float rate);  // Precompute an axis curve
+static int32_t joystickClampEffort(int32_t effort);                            // Limit a fixed-point effort to +/-1.0
+static q15_t joystickStickEffort(uint8_t raw, bool invert);                    // Stick byte to a Q15 effort with the effort deadzone
+
 /*** Public Function Definitions **********************************************/
 
 bool joystick_init(void)
@@ -97,7 +181,7 @@ bool joystick_init(void)
   // check if WiFi already in use by "mqttc" module
   if(WiFi.status() == WL_CONNECTED)
   {
-      SERIAL_PORT.println("WiFi already in use. Cannot start AP");
+      CETALIB_LOG_ERROR("WiFi already in use. Cannot start AP");
       return false;
   }
 
@@ -109,31 +193,7 @@ bool joystick_init(void)
   #endif
 
   // initialize local joystick data structure
-  strcpy(joystick_local.clientIP, "0.0.0.0");
-  joystick_local.clientPort = 0;
-  for (int i=0; i<8; i++)
-  {
-    joystick_local.gamepadRaw[i] = 0;
-  }
-  joystick_local.leftStickX = 0;
-  joystick_local.leftStickY = 0;
-  joystick_local.rightStickX = 0;
-  joystick_local.rightStickY = 0;
-  joystick_local.dPad.isNeutral = true;
-  joystick_local.dPad.isNorthPressed = false;
-  joystick_local.dPad.isEastPressed = false;
-  joystick_local.dPad.isSouthPressed = false;
-  joystick_local.dPad.isWestPressed = false;
-  joystick_local.actionButtons.isAPressed = false;
-  joystick_local.actionButtons.isBPressed = false;
-  joystick_local.actionButtons.isXPressed = false;
-  joystick_local.actionButtons.isYPressed = false;
-  joystick_local.triggerButtons.isLeftTriggerPressed = false;
-  joystick_local.triggerButtons.isRightTriggerPressed = false;
-  joystick_local.bumperButtons.isLeftBumperPressed = false;
-  joystick_local.bumperButtons.isRightBumperPressed = false;
-  joystick_local.isBackPressed = false;
-  joystick_local.isStartPressed = false;
+  joystickResetData();
 
   // Tell the WiFi stack we want AP mode
   WiFi.mode(WIFI_AP);
@@ -162,183 +222,135 @@ bool joystick_init(void)
   #endif
   
   // --- Now start the Access Point ---
-  SERIAL_PORT.printf("Starting AP \"%s\"\n", apSSID);
+  CETALIB_LOG_INFO("Starting AP \"%s\"", apSSID);
   if (WiFi.beginAP(apSSID, apPassphrase, wifiChannel) == WL_CONNECTED)
   {
-    SERIAL_PORT.print("AP started! IP: ");
-    SERIAL_PORT.print(WiFi.softAPIP());
-    SERIAL_PORT.print(" WiFi Channel: ");
-    SERIAL_PORT.println(wifiChannel);
+    CETALIB_LOG_INFO("AP started! IP: %s WiFi Channel: %d", WiFi.softAPIP().toString().c_str(), wifiChannel);
   } 
   else 
   {
-    SERIAL_PORT.println("AP failed to start!.");
+    CETALIB_LOG_ERROR("AP failed to start!.");
     return false;
   }
   
-  // Start the UDP Server
-  SERIAL_PORT.printf("UDP server started on port %d\n", localPort);
+  // Start the UDP Server (the robot owns the network, so it accepts every robot ID)
+  CETALIB_LOG_INFO("UDP server started on port %d", localPort);
   Udp.begin(localPort);
-  
-  // update Joystick status LED
-  #if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_SPARKFUN_XRP_CONTROLLER)
-  // if you get here, you are connected and ready to go!
-  digitalWrite(JOYSTICK_STAT_LED_PIN, 1);
-  #endif
+  joystickRobotId = JOYSTICK_ROBOT_ID_ANY;
+  joystickStartService();
 
   return true;
 
 }
 
-void joystick_tasks(void)
+bool joystick_init_fleet(const char *ssid, const char *pass, uint8_t robotId)
 {
-  // if there's joystick data available, read/process a packet
-  int packetSize = Udp.parsePacket();
-  if (packetSize)
+  // robot ID 0 would accept the packets of every gamepad in the fleet
+  if(robotId == JOYSTICK_ROBOT_ID_ANY)
   {
-    // signal that we've received a joystick update
-    joystickIsActive = 1;
-
-    // save the remote client IP and port
-    sprintf(joystick_local.clientIP, "%s", Udp.remoteIP().toString().c_str());
-    joystick_local.clientPort = Udp.remotePort();
-    
-    // read the packet into packetBufffer
-    int n = Udp.read(packetBuffer, UDP_TX_PACKET_MAX_SIZE);
-    packetBuffer[n] = 0;
-    
-    // update the local joystick data structure
-
-    // gamepad raw bytes
-    joystick_local.gamepadRaw[0] = packetBuffer[0];
-    joystick_local.gamepadRaw[1] = packetBuffer[1];
-    joystick_local.gamepadRaw[2] = packetBuffer[2];
-    joystick_local.gamepadRaw[3] = packetBuffer[3];
-    joystick_local.gamepadRaw[4] = packetBuffer[4];
-    joystick_local.gamepadRaw[5] = packetBuffer[5];
-    joystick_local.gamepadRaw[6] = packetBuffer[6];
-    joystick_local.gamepadRaw[7] = packetBuffer[7];
-    
-    // update joysticks
-    joystick_local.leftStickX = packetBuffer[0];
-    joystick_local.leftStickY = packetBuffer[1];
-    joystick_local.rightStickX = packetBuffer[2];
-    joystick_local.rightStickY = packetBuffer[3];
-    
-    // update dPad buttons
-    if(packetBuffer[4] == 8){
-      joystick_local.dPad.isNeutral = true;
-    }
-    else{
-      joystick_local.dPad.isNeutral = false;
-    }
-    
-    if(packetBuffer[4] == 0){
-      joystick_local.dPad.isNorthPressed = true;
-    }
-    else{
-      joystick_local.dPad.isNorthPressed = false;
-    }
-    
-    if(packetBuffer[4] == 2){
-      joystick_local.dPad.isEastPressed = true;
-    }
-    else{
-      joystick_local.dPad.isEastPressed = false;
-    }
-
-    if(packetBuffer[4] == 4){
-      joystick_local.dPad.isSouthPressed = true;
-    }
-    else{
-      joystick_local.dPad.isSouthPressed = false;
-    }
-
-    if(packetBuffer[4] == 6){
-      joystick_local.dPad.isWestPressed = true;
-    }
-    else{
-      joystick_local.dPad.isWestPressed = false;
-    }
+      CETALIB_LOG_ERROR("Fleet robot ID must be 1-255");
+      return false;
+  }
 
-    // update actionbuttons
+  // check if WiFi already in use by "mqttc" module
+  if(WiFi.status() == WL_CONNECTED)
+  {
+      CETALIB_LOG_ERROR("WiFi already in use. Cannot start STA");
+      return false;
+  }
 
-    if(packetBuffer[4] & 32){
-      joystick_local.actionButtons.isAPressed = true;
-    }
-    else{
-      joystick_local.actionButtons.isAPressed = false;
-    }
+  #if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_SPARKFUN_XRP_CONTROLLER)
+  pinMode(JOYSTICK_STAT_LED_PIN, OUTPUT);
+  digitalWrite(JOYSTICK_STAT_LED_PIN, 0);
+  #endif
 
-    if(packetBuffer[4] & 64){
-      joystick_local.actionButtons.isBPressed = true;
-    }
-    else{
-      joystick_local.actionButtons.isBPressed = false;
-    }
+  joystickResetData();
 
-    if(packetBuffer[4] & 16){
-      joystick_local.actionButtons.isXPressed = true;
-    }
-    else{
-      joystick_local.actionButtons.isXPressed = false;
+  // join the shared classroom network as a station
+  WiFi.mode(WIFI_STA);
+  CETALIB_LOG_INFO("Attempting to connect to WPA SSID: %s", ssid);
+  int attempts = 0;
+  CETALIB_TRACE_BEGIN("joystick", "wifiConnect", 0);
+  while (WiFi.begin(ssid, pass) != WL_CONNECTED)
+  {
+    if (++attempts >= JOYSTICK_FLEET_CONNECT_ATTEMPTS)
+    {
+      CETALIB_TRACE_END("joystick", "wifiConnect", attempts);
+      CETALIB_LOG_ERROR("Failed to connect to %s", ssid);
+      return false;
     }
+    CETALIB_LOG_DEBUG("WiFi connection failed, retrying");
+    logger_tasks();
+    delay(1000);
+  }
+  CETALIB_TRACE_END("joystick", "wifiConnect", attempts);
 
-    if(packetBuffer[4] & 128){
-      joystick_local.actionButtons.isYPressed = true;
-    }
-    else{
-      joystick_local.actionButtons.isYPressed = false;
-    }
+  // listen for packets sent directly to this robot and to the fleet multicast group
+  Udp.beginMulticast(fleetGroupIP, localPort);
+  joystickRobotId = robotId;
+  CETALIB_LOG_INFO("Fleet robot ID %d, IP: %s, UDP port %d (group %s)", robotId,
+                   WiFi.localIP().toString().c_str(), localPort, fleetGroupIP.toString().c_str());
+  joystickStartService();
 
-    // update trigger buttons
+  return true;
+}
 
-    if(packetBuffer[5] & 4){
-      joystick_local.triggerButtons.isLeftTriggerPressed = true;
-    }
-    else{
-      joystick_local.triggerButtons.isLeftTriggerPressed = false;
-    }
+void joystick_tasks(void)
+{
+  const uint8_t *report = NULL;
+  CETALIB_TRACE_BEGIN("joystick", "tasks", 0);
 
-     if(packetBuffer[5] & 8){
-      joystick_local.triggerButtons.isRightTriggerPressed = true;
+  // drain every pending datagram, keeping only the newest valid gamepad report
+  int n;
+  while ((n = joystickReadPacket()) > 0)
+  {
+    CETALIB_TRACE_INSTANT("joystick", "packet", n);
+    const uint8_t *payload = joystickParsePacket((const uint8_t *)packetBuffer, n);
+    if (payload == NULL)
+    {
+      continue;
     }
-    else{
-      joystick_local.triggerButtons.isRightTriggerPressed = false;
+    if (report != NULL)
+    {
+      joystickStats.packetsSuperseded++;    // a newer report arrived in the same call
     }
+    memcpy(newestReport, payload, JOYSTICK_REPORT_SIZE);
+    report = newestReport;
 
-    // update bumper buttons
+    // keep the button edges of every report, not only the newest one
+    joystickTrackButtons(joystickPackButtons(payload));
 
-    if(packetBuffer[5] & 1){
-      joystick_local.bumperButtons.isLeftBumperPressed = true;
-    }
-    else{
-      joystick_local.bumperButtons.isLeftBumperPressed = false;
-    }
+    // save the remote client address and port (clientIP is formatted by get_data())
+    joystick_local.clientAddress = Udp.remoteIP();
+    joystick_local.clientPort = Udp.remotePort();
+  }
 
-    if(packetBuffer[5] & 2){
-      joystick_local.bumperButtons.isRightBumperPressed = true;
-    }
-    else{
-      joystick_local.bumperButtons.isRightBumperPressed = false;
-    }
+  if (report != NULL)
+  {
+    // signal that we've received a joystick update
+    joystickIsActive = 1;
+    joystickDecodeReport(report);
+    joystickLastReportTime = millis();
+    joystickLinkState = JOYSTICK_LINK_UP;
+    joystickFailsafeTripped = false;
+  }
+  joystickFailsafeTasks();
+  CETALIB_TRACE_END("joystick", "tasks", (report != NULL));
+}
 
-    // update back and start buttons
+JOYSTICK_STATS* joystick_get_stats(void)
+{
+  return &joystickStats;
+}
 
-    if(packetBuffer[5] & 16){
-      joystick_local.isBackPressed = true;
-    }
-    else{
-      joystick_local.isBackPressed = false;
-    }
+void joystick_set_failsafe_timeout(unsigned long timeout)
+{
+  joystickFailsafeTimeout = timeout;
+}
 
-    if(packetBuffer[5] & 32){
-      joystick_local.isStartPressed = true;
-    }
-    else{
-      joystick_local.isStartPressed = false;
-    }
-  }
+enum JOYSTICK_LINK_STATE joystick_get_link_state(void)
+{
+  return joystickLinkState;
 }
 
 int joystick_is_active(void)
@@ -356,85 +368,494 @@ int joystick_is_active(void)
 
 GAMEPAD* joystick_get_data(void)
 {
+  // format the client IP string only when the client address has changed
+  if (joystick_local.clientAddress != joystickClientIPAddress)
+  {
+    joystickClientIPAddress = joystick_local.clientAddress;
+    sprintf(joystick_local.clientIP, "%u.%u.%u.%u", joystickClientIPAddress[0], joystickClientIPAddress[1],
+            joystickClientIPAddress[2], joystickClientIPAddress[3]);
+  }
   return &joystick_local;
 }
 
+uint16_t joystick_get_buttons(void)
+{
+  return joystick_local.buttons;
+}
+
+uint16_t joystick_get_buttons_pressed(void)
+{
+  // read and clear in one step (the sketch may run on the other core)
+  spin_lock_t *lock = spin_lock_instance(JOYSTICK_SPINLOCK_ID);
+  uint32_t irqState = spin_lock_blocking(lock);
+  uint16_t pressed = joystickButtonsPressed;
+  joystickButtonsPressed = 0;
+  spin_unlock(lock, irqState);
+  return pressed;
+}
+
+uint16_t joystick_get_buttons_released(void)
+{
+  spin_lock_t *lock = spin_lock_instance(JOYSTICK_SPINLOCK_ID);
+  uint32_t irqState = spin_lock_blocking(lock);
+  uint16_t released = joystickButtonsReleased;
+  joystickButtonsReleased = 0;
+  spin_unlock(lock, irqState);
+  return released;
+}
+
 float joystick_get_left_tank_effort(void)
 {
-  // Left Stick Y (gamepadRaw[1]) controls effort on Left Motor
-  float leftDrive = (128.0 - (float)joystick_local.gamepadRaw[1]) / 128.0;
-  
-  // Add a small "deadzone to prevent "drifting"
-  if (abs(leftDrive) < 0.05) leftDrive = 0.0;
-  
-  return leftDrive;
+  return q15_to_float(joystick_get_left_tank_effort_q15());
 }
 
 float joystick_get_right_tank_effort(void)
 {
-  // Right Stick Y (gamepadRaw[3]) controls effort on Right Motor
-  float rightDrive = (128.0 - (float)joystick_local.gamepadRaw[3]) / 128.0;
-  
-  // Add a small "deadzone to prevent "drifting"
-  if (abs(rightDrive) < 0.05) rightDrive = 0.0;
-  
-  return rightDrive;
+  return q15_to_float(joystick_get_right_tank_effort_q15());
 }
 
 float joystick_get_left_arcade_effort(void)
 {
-  // Use the Joystick to implement a FRC "Split-Stick Arcade Drive" motor scheme
-  // Left Stick Y (gamepadRaw[1]) controls effort/throttle on both motors
-  // Right Stick X (gamepadRaw[2]) controls steering only
-    
-  // 1. Convert Raw Bytes to Normalized Floats (-1.0 to 1.0)
-  // We subtract from 128 so that 'Up' and 'Right' are positive numbers
-  float throttle = (128.0 - (float)joystick_local.gamepadRaw[1]) / 128.0; 
-  float turn     = ((float)joystick_local.gamepadRaw[2] - 128.0) / 128.0;
+  return q15_to_float(joystick_get_left_arcade_effort_q15());
+}
 
-  // 2. Apply a Deadzone (Prevents the robot from humming at rest)
-  if (abs(throttle) < 0.05) throttle = 0;
-  if (abs(turn) < 0.05)     turn = 0;
+float joystick_get_right_arcade_effort(void)
+{
+  return q15_to_float(joystick_get_right_arcade_effort_q15());
+}
+
+q15_t joystick_get_left_tank_effort_q15(void)
+{
+  // Left Stick Y (gamepadRaw[1]) controls effort on Left Motor
+  return joystickStickEffort(joystick_local.gamepadRaw[1], true);
+}
 
-  // 3. Arcade Drive Mixing Math
-  float leftPower  = throttle + turn;
-  float rightPower = throttle - turn;
+q15_t joystick_get_right_tank_effort_q15(void)
+{
+  // Right Stick Y (gamepadRaw[3]) controls effort on Right Motor
+  return joystickStickEffort(joystick_local.gamepadRaw[3], true);
+}
 
-  // 4. Constrain values to -1.0 to 1.0 (prevents over-driving)
-  leftPower  = constrain(leftPower, -1.0, 1.0);
-  rightPower = constrain(rightPower, -1.0, 1.0);
+q15_t joystick_get_left_arcade_effort_q15(void)
+{
+  // Use the Joystick to implement a FRC "Split-Stick Arcade Drive" motor scheme
+  // Left Stick Y (gamepadRaw[1]) controls effort/throttle on both motors
+  // Right Stick X (gamepadRaw[2]) controls steering only
+  int32_t throttle = joystickStickEffort(joystick_local.gamepadRaw[1], true);
+  int32_t turn     = joystickStickEffort(joystick_local.gamepadRaw[2], false);
 
-  return leftPower;
+  // Arcade Drive Mixing Math, constrained to -1.0 to 1.0 (prevents over-driving)
+  return q15_saturate(throttle + turn);
 }
 
-float joystick_get_right_arcade_effort(void)
+q15_t joystick_get_right_arcade_effort_q15(void)
 {
   // Use the Joystick to implement a FRC "Split-Stick Arcade Drive" motor scheme
   // Left Stick Y (gamepadRaw[1]) controls effort/throttle on both motors
   // Right Stick X (gamepadRaw[2]) controls steering only
-    
-  // 1. Convert Raw Bytes to Normalized Floats (-1.0 to 1.0)
-  // We subtract from 128 so that 'Up' and 'Right' are positive numbers
-  float throttle = (128.0 - (float)joystick_local.gamepadRaw[1]) / 128.0; 
-  float turn     = ((float)joystick_local.gamepadRaw[2] - 128.0) / 128.0;
+  int32_t throttle = joystickStickEffort(joystick_local.gamepadRaw[1], true);
+  int32_t turn     = joystickStickEffort(joystick_local.gamepadRaw[2], false);
 
-  // 2. Apply a Deadzone (Prevents the robot from humming at rest)
-  if (abs(throttle) < 0.05) throttle = 0;
-  if (abs(turn) < 0.05)     turn = 0;
+  // Arcade Drive Mixing Math, constrained to -1.0 to 1.0 (prevents over-driving)
+  return q15_saturate(throttle - turn);
+}
 
-  // 3. Arcade Drive Mixing Math
-  float leftPower  = throttle + turn;
-  float rightPower = throttle - turn;
+void joystick_set_drive_mode(enum JOYSTICK_DRIVE_MODE mode)
+{
+  joystickDriveMode = mode;
+}
 
-  // 4. Constrain values to -1.0 to 1.0 (prevents over-driving)
-  leftPower  = constrain(leftPower, -1.0, 1.0);
-  rightPower = constrain(rightPower, -1.0, 1.0);
+void joystick_set_throttle_curve(float deadzone, float expo, float rate)
+{
+  joystickBuildAxisTable(joystickThrottleTable, true, deadzone, expo, rate);
+}
 
-  return rightPower;
+void joystick_set_turn_curve(float deadzone, float expo, float rate)
+{
+  joystickBuildAxisTable(joystickTurnTable, false, deadzone, expo, rate);
+}
+
+void joystick_get_drive_efforts(float *leftEffort, float *rightEffort)
+{
+  q15_t left, right;
+  joystick_get_drive_efforts_q15(&left, &right);
+  *leftEffort = q15_to_float(left);
+  *rightEffort = q15_to_float(right);
+}
+
+void joystick_get_drive_efforts_q15(q15_t *leftEffort, q15_t *rightEffort)
+{
+  // the stick curves are precomputed, so the mix is table lookups and integer math
+  int32_t left, right;
+  switch (joystickDriveMode)
+  {
+    case JOYSTICK_DRIVE_TANK:
+      left = joystickThrottleTable[joystick_local.gamepadRaw[1]];
+      right = joystickThrottleTable[joystick_local.gamepadRaw[3]];
+      break;
+
+    case JOYSTICK_DRIVE_CURVATURE:
+    {
+      int32_t throttle = joystickThrottleTable[joystick_local.gamepadRaw[1]];
+      int32_t turn = joystickTurnTable[joystick_local.gamepadRaw[2]];
+      if (throttle != 0)
+      {
+        // turn rate follows speed, so the turn radius stays constant at any throttle
+        turn = (turn * abs(throttle)) >> JOYSTICK_MIX_SHIFT;
+      }
+      // else: "quick turn", spin in place with the turn stick alone
+      left = throttle + turn;
+      right = throttle - turn;
+      break;
+    }
+
+    case JOYSTICK_DRIVE_ARCADE:
+    default:
+    {
+      int32_t throttle = joystickThrottleTable[joystick_local.gamepadRaw[1]];
+      int32_t turn = joystickTurnTable[joystick_local.gamepadRaw[2]];
+      left = throttle + turn;
+      right = throttle - turn;
+      break;
+    }
+  }
+  // JOYSTICK_MIX_ONE is 1.0 in Q14, doubling makes it Q15
+  *leftEffort = q15_saturate(joystickClampEffort(left) * 2);
+  *rightEffort = q15_saturate(joystickClampEffort(right) * 2);
 }
 
 /*** Private Function Definitions *********************************************/
 
+// Neutral gamepad data, no client, no pending button edges
+static void joystickResetData(void)
+{
+  joystick_local.clientAddress = IPAddress(0, 0, 0, 0);
+  joystick_local.clientPort = 0;
+  strcpy(joystick_local.clientIP, "0.0.0.0");
+  joystickClientIPAddress = joystick_local.clientAddress;
+  joystick_local.buttons = 0;
+  joystickEdgeButtons = 0;
+  joystickDecodeReport(joystickNeutralReport);      // sticks centered, no buttons pressed
+  spin_lock_t *lock = spin_lock_instance(JOYSTICK_SPINLOCK_ID);
+  uint32_t irqState = spin_lock_blocking(lock);
+  joystickButtonsPressed = 0;
+  joystickButtonsReleased = 0;
+  spin_unlock(lock, irqState);
+
+  // default drive curves: small deadzone, linear response
+  joystick_set_throttle_curve(JOYSTICK_DEFAULT_DEADZONE, 0.0f, 1.0f);
+  joystick_set_turn_curve(JOYSTICK_DEFAULT_DEADZONE, 0.0f, 1.0f);
+}
+
+// Reset the link statistics, start the failsafe and turn on the status LED
+// (called once the UDP server is listening)
+static void joystickStartService(void)
+{
+  // Start a fresh set of link statistics
+  memset(&joystickStats, 0, sizeof(joystickStats));
+  joystickSeqValid = false;
+
+  // Start the link-loss failsafe (checked from a hardware timer, so it also stops the robot when the loop is blocked)
+  joystickLinkState = JOYSTICK_LINK_WAITING;
+  joystickFailsafeTripped = false;
+  if (!joystickFailsafeRunning)
+  {
+    joystickFailsafeRunning = add_repeating_timer_ms(-JOYSTICK_FAILSAFE_CHECK_INTERVAL, joystickFailsafeCallback, NULL, &joystickFailsafeTimer);
+  }
+
+  // update Joystick status LED
+  #if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_SPARKFUN_XRP_CONTROLLER)
+  // if you get here, you are connected and ready to go!
+  digitalWrite(JOYSTICK_STAT_LED_PIN, 1);
+  #endif
+}
+
+// Precompute the shaped effort for every stick byte value:
+// deadzone (rescaled so the output starts at 0), then expo (blend of linear
+// and cubic response), then rate (output scale), limited to +/-1.0
+static void joystickBuildAxisTable(int16_t *table, bool invert, float deadzone, float expo, float rate)
+{
+  deadzone = constrain(deadzone, 0.0f, 0.95f);
+  expo = constrain(expo, 0.0f, 1.0f);
+  for (int raw = 0; raw < 256; raw++)
+  {
+    float x = invert ? (128.0f - raw) / 128.0f : (raw - 128.0f) / 128.0f;
+    float magnitude = fabsf(x);
+    float y = 0.0f;
+    if (magnitude >= deadzone)
+    {
+      magnitude = (magnitude - deadzone) / (1.0f - deadzone);
+      y = ((1.0f - expo) * magnitude + expo * magnitude * magnitude * magnitude) * rate;
+      y = constrain(y, 0.0f, 1.0f);
+      if (x < 0.0f)
+      {
+        y = -y;
+      }
+    }
+    table[raw] = (int16_t)lroundf(y * JOYSTICK_MIX_ONE);
+  }
+}
+
+// Stick byte to a Q15 effort (-1.0 to 1.0), inverted for the Y axes so that
+// 'Up' and 'Right' are positive, with the tank/arcade effort deadzone
+// (prevents the robot from "drifting" or humming at rest)
+static q15_t joystickStickEffort(uint8_t raw, bool invert)
+{
+  int32_t effort = invert ? ((128 - raw) * 256) : ((raw - 128) * 256);
+  if (abs(effort) < JOYSTICK_EFFORT_DEADZONE)
+  {
+    return 0;
+  }
+  return q15_saturate(effort);
+}
+
+static int32_t joystickClampEffort(int32_t effort)
+{
+  if (effort > JOYSTICK_MIX_ONE)
+  {
+    return JOYSTICK_MIX_ONE;
+  }
+  if (effort < -JOYSTICK_MIX_ONE)
+  {
+    return -JOYSTICK_MIX_ONE;
+  }
+  return effort;
+}
+
+// Runs every JOYSTICK_FAILSAFE_CHECK_INTERVAL mS from a hardware alarm, so the
+// robot stops even if the sketch loop is blocked. The motor effort functions
+// only disable interrupts and write the PWM registers (the slew timer uses the
+// same path), so the ramp down is done here. The gamepad data is not
+// protected, joystickFailsafeTasks() resets it from joystick_tasks().
+static bool joystickFailsafeCallback(repeating_timer_t *rt)
+{
+  if ((joystickLinkState == JOYSTICK_LINK_UP) && joystickFailsafeTimeout &&
+      ((millis() - joystickLastReportTime) >= joystickFailsafeTimeout))
+  {
+    joystickLinkState = JOYSTICK_LINK_LOST;
+    joystickFailsafeTripped = true;
+    joystickMotorRampActive = true;
+    joystickStats.failsafeTrips++;
+  }
+
+  if (joystickMotorRampActive)
+  {
+    q15_t leftEffort = motor_get_left_effort_q15();
+    q15_t rightEffort = motor_get_right_effort_q15();
+    if ((joystickLinkState != JOYSTICK_LINK_LOST) || ((leftEffort == 0) && (rightEffort == 0)))
+    {
+      joystickMotorRampActive = false;    // stopped (or link restored), leave the motors to the sketch
+    }
+    else
+    {
+      motor_set_efforts_q15(joystickRampToZero(leftEffort), joystickRampToZero(rightEffort));
+    }
+  }
+  return true;
+}
+
+// Called by joystick_tasks(): center the sticks/release the buttons after a
+// link loss, so every effort getter returns 0.0
+static void joystickFailsafeTasks(void)
+{
+  if (joystickFailsafeTripped)
+  {
+    joystickFailsafeTripped = false;
+    if (joystickLinkState == JOYSTICK_LINK_LOST)
+    {
+      joystickDecodeReport(joystickNeutralReport);
+    }
+  }
+}
+
+static q15_t joystickRampToZero(q15_t effort)
+{
+  if (effort > JOYSTICK_FAILSAFE_RAMP_STEP)
+  {
+    return effort - JOYSTICK_FAILSAFE_RAMP_STEP;
+  }
+  if (effort < -JOYSTICK_FAILSAFE_RAMP_STEP)
+  {
+    return effort + JOYSTICK_FAILSAFE_RAMP_STEP;
+  }
+  return 0;
+}
+
+// Read the next datagram into packetBuffer, returns its size (0 if none).
+// While replaying, the recorded datagrams are returned at their recorded arrival time.
+static int joystickReadPacket(void)
+{
+  if (replay_is_playing())
+  {
+    return replay_read(REPLAY_SOURCE_JOYSTICK_PACKET, packetBuffer, UDP_TX_PACKET_MAX_SIZE);
+  }
+  if (Udp.parsePacket() <= 0)
+  {
+    return 0;
+  }
+  int n = Udp.read(packetBuffer, UDP_TX_PACKET_MAX_SIZE);
+  if (n > 0)
+  {
+    replay_input(REPLAY_SOURCE_JOYSTICK_PACKET, packetBuffer, n);
+  }
+  return n;
+}
+
+// Validate a datagram, update the link statistics, and return a pointer to its
+// 8-byte gamepad report (NULL if the datagram is malformed, stale or a duplicate).
+// Button changes carried by the redundant reports of lost packets are recovered here.
+static const uint8_t* joystickParsePacket(const uint8_t *packet, int length)
+{
+  // protocol v1: raw 8-byte HID report, accepted in arrival order.
+  // It carries no robot ID, so fleet robots ignore it (any gamepad would drive every robot).
+  if (length == JOYSTICK_REPORT_SIZE)
+  {
+    if (joystickRobotId != JOYSTICK_ROBOT_ID_ANY)
+    {
+      joystickStats.packetsFiltered++;
+      return NULL;
+    }
+    joystickStats.packetsReceived++;
+    joystickStats.protocolVersion = 1;
+    return packet;
+  }
+
+  // protocol v2: 'C','J', version, robot ID, sequence, timestamp, report,
+  // then up to JOYSTICK_V2_MAX_REDUNDANT older reports (sequence - 1, sequence - 2, ...)
+  int redundant = (length - JOYSTICK_V2_PACKET_SIZE) / JOYSTICK_REPORT_SIZE;
+  if ((length < JOYSTICK_V2_PACKET_SIZE) || ((length - JOYSTICK_V2_PACKET_SIZE) % JOYSTICK_REPORT_SIZE) ||
+      (redundant > JOYSTICK_V2_MAX_REDUNDANT) || (packet[0] != JOYSTICK_V2_MAGIC0) ||
+      (packet[1] != JOYSTICK_V2_MAGIC1) || (packet[2] != JOYSTICK_V2_VERSION))
+  {
+    joystickStats.packetsInvalid++;
+    return NULL;
+  }
+  if ((joystickRobotId != JOYSTICK_ROBOT_ID_ANY) && (packet[3] != joystickRobotId))
+  {
+    joystickStats.packetsFiltered++;        // fleet mode: addressed to another robot (or to any robot)
+    return NULL;
+  }
+  joystickStats.packetsReceived++;
+  joystickStats.protocolVersion = 2;
+
+  uint16_t sequence = (uint16_t)packet[4] | ((uint16_t)packet[5] << 8);
+  uint32_t timestamp = (uint32_t)packet[6] | ((uint32_t)packet[7] << 8) |
+                       ((uint32_t)packet[8] << 16) | ((uint32_t)packet[9] << 24);
+  unsigned long now = millis();
+  int32_t offset = (int32_t)(now - timestamp);
+
+  // after a long silence any sequence number starts a new session (e.g. the client restarted)
+  if ((now - joystickLastSeqTime) >= JOYSTICK_SESSION_TIMEOUT)
+  {
+    joystickSeqValid = false;
+  }
+
+  if (joystickSeqValid)
+  {
+    int16_t seqDelta = (int16_t)(sequence - joystickLastSeq);
+    if ((seqDelta <= 0) && (seqDelta > -JOYSTICK_SEQ_RESTART_WINDOW))
+    {
+      joystickStats.packetsReordered++;     // older than (or same as) the newest report: stale
+      return NULL;
+    }
+    if (seqDelta > 1)
+    {
+      joystickStats.packetsLost += (seqDelta - 1);
+
+      // replay the button changes of the missed packets that this packet repeats, oldest first
+      int missed = min((int)(seqDelta - 1), redundant);
+      for (int i = missed; i > 0; i--)
+      {
+        joystickTrackButtons(joystickPackButtons(&packet[JOYSTICK_V2_PACKET_SIZE + ((i - 1) * JOYSTICK_REPORT_SIZE)]));
+      }
+      joystickStats.packetsRecovered += missed;
+    }
+    if (seqDelta <= -JOYSTICK_SEQ_RESTART_WINDOW)
+    {
+      joystickMinOffset = offset;           // client restarted, start a new session
+    }
+  }
+  else
+  {
+    joystickMinOffset = offset;
+  }
+  joystickSeqValid = true;
+  joystickLastSeq = sequence;
+  joystickLastSeqTime = now;
+
+  // one-way latency relative to the fastest packet seen (clocks are not synchronized)
+  if (offset < joystickMinOffset)
+  {
+    joystickMinOffset = offset;
+  }
+  uint32_t latency = (uint32_t)(offset - joystickMinOffset);
+  joystickStats.lastLatency = latency;
+  if (latency > joystickStats.maxLatency)
+  {
+    joystickStats.maxLatency = latency;
+  }
+  joystickStats.avgLatency += ((float)latency - joystickStats.avgLatency) * JOYSTICK_LATENCY_AVG_WEIGHT;
+
+  return &packet[JOYSTICK_V2_HEADER_SIZE];
+}
+
+// Update the local gamepad data structure from an 8-byte HID report
+static void joystickDecodeReport(const uint8_t *report)
+{
+  // gamepad raw bytes
+  memcpy(joystick_local.gamepadRaw, report, JOYSTICK_REPORT_SIZE);
+
+  // update joysticks
+  joystick_local.leftStickX = report[0];
+  joystick_local.leftStickY = report[1];
+  joystick_local.rightStickX = report[2];
+  joystick_local.rightStickY = report[3];
+
+  uint16_t buttons = joystickPackButtons(report);
+  joystickTrackButtons(buttons);
+  joystick_local.buttons = buttons;
+
+  // update the individual button flags
+  joystick_local.dPad.isNeutral = ((report[4] & 0x0F) == 8);
+  joystick_local.dPad.isNorthPressed = (buttons & JOYSTICK_BUTTON_DPAD_N) != 0;
+  joystick_local.dPad.isEastPressed = (buttons & JOYSTICK_BUTTON_DPAD_E) != 0;
+  joystick_local.dPad.isSouthPressed = (buttons & JOYSTICK_BUTTON_DPAD_S) != 0;
+  joystick_local.dPad.isWestPressed = (buttons & JOYSTICK_BUTTON_DPAD_W) != 0;
+  joystick_local.actionButtons.isAPressed = (buttons & JOYSTICK_BUTTON_A) != 0;
+  joystick_local.actionButtons.isBPressed = (buttons & JOYSTICK_BUTTON_B) != 0;
+  joystick_local.actionButtons.isXPressed = (buttons & JOYSTICK_BUTTON_X) != 0;
+  joystick_local.actionButtons.isYPressed = (buttons & JOYSTICK_BUTTON_Y) != 0;
+  joystick_local.triggerButtons.isLeftTriggerPressed = (buttons & JOYSTICK_BUTTON_LT) != 0;
+  joystick_local.triggerButtons.isRightTriggerPressed = (buttons & JOYSTICK_BUTTON_RT) != 0;
+  joystick_local.bumperButtons.isLeftBumperPressed = (buttons & JOYSTICK_BUTTON_LB) != 0;
+  joystick_local.bumperButtons.isRightBumperPressed = (buttons & JOYSTICK_BUTTON_RB) != 0;
+  joystick_local.isBackPressed = (buttons & JOYSTICK_BUTTON_BACK) != 0;
+  joystick_local.isStartPressed = (buttons & JOYSTICK_BUTTON_START) != 0;
+}
+
+// Pack the buttons: X/A/B/Y are bits 4-7 of byte 4, bumpers/triggers/back/start
+// are bits 0-5 of byte 5, and the D-Pad hat value (byte 4, bits 0-3) is looked up
+static uint16_t joystickPackButtons(const uint8_t *report)
+{
+  return (uint16_t)(report[4] >> 4) |
+         ((uint16_t)(report[5] & 0x3F) << 4) |
+         joystickDPadTable[report[4] & 0x0F];
+}
+
+// Accumulate edges until they are read. The read-modify-write is done under the
+// spin lock, so an edge is not lost when get_buttons_pressed()/released() clears
+// the masks at the same time (from the other core or an interrupt).
+static void joystickTrackButtons(uint16_t buttons)
+{
+  uint16_t changed = buttons ^ joystickEdgeButtons;
+  spin_lock_t *lock = spin_lock_instance(JOYSTICK_SPINLOCK_ID);
+  uint32_t irqState = spin_lock_blocking(lock);
+  joystickButtonsPressed |= changed & buttons;
+  joystickButtonsReleased |= changed & ~buttons;
+  spin_unlock(lock, irqState);
+  joystickEdgeButtons = buttons;
+}
+
 int selectBestClassroomChannel() {
   int scanResult = WiFi.scanNetworks();
   long rssi1 = -100, rssi6 = -100, rssi11 = -100;
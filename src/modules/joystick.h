@@ -52,11 +52,36 @@
 
 #endif
 
+#define JOYSTICK_REPORT_SIZE        8     // F310 (D-Mode) HID report size (protocol v1 packet size)
+#define JOYSTICK_V2_MAGIC0          'C'   // Protocol v2 packet identifier (byte 0)
+#define JOYSTICK_V2_MAGIC1          'J'   // Protocol v2 packet identifier (byte 1)
+#define JOYSTICK_V2_VERSION         2     // Protocol v2 version number (byte 2)
+#define JOYSTICK_V2_HEADER_SIZE     10    // magic(2), version(1), robot ID(1), sequence(2), timestamp(4)
+#define JOYSTICK_V2_PACKET_SIZE     (JOYSTICK_V2_HEADER_SIZE + JOYSTICK_REPORT_SIZE)
+#define JOYSTICK_V2_MAX_REDUNDANT   3     // Older reports a v2 packet may carry after the newest one
+#define JOYSTICK_V2_MAX_PACKET_SIZE (JOYSTICK_V2_PACKET_SIZE + (JOYSTICK_V2_MAX_REDUNDANT * JOYSTICK_REPORT_SIZE))
+#define JOYSTICK_SEQ_RESTART_WINDOW 1000  // Sequence numbers this far behind the newest indicate a client restart
+#define JOYSTICK_SESSION_TIMEOUT    1000  // Silence (in mS) after which any sequence number is accepted
+#define JOYSTICK_LATENCY_AVG_WEIGHT 0.05f // Weight of each new sample in the average latency
+
+#define JOYSTICK_FAILSAFE_TIMEOUT_DEFAULT 500   // Default link-loss timeout (in mS)
+#define JOYSTICK_FAILSAFE_CHECK_INTERVAL  20    // Failsafe timer period (in mS)
+#define JOYSTICK_FAILSAFE_RAMP_STEP       3277  // Effort reduction per check period (0.1 in Q15, full effort to stop in 200 mS)
+
+#define JOYSTICK_FLEET_CONNECT_ATTEMPTS 10  // WiFi connection attempts before initialize_fleet() gives up
+#define JOYSTICK_ROBOT_ID_ANY       0     // Protocol v2 robot ID accepted by every robot (except in fleet mode)
+
+#define JOYSTICK_MIX_ONE            16384 // Drive mixing fixed-point full scale (1.0 effort)
+#define JOYSTICK_MIX_SHIFT          14    // log2(JOYSTICK_MIX_ONE)
+#define JOYSTICK_DEFAULT_DEADZONE   0.05f // Default stick deadzone (matches the tank/arcade effort functions)
+#define JOYSTICK_EFFORT_DEADZONE    1639  // Tank/arcade effort deadzone (0.05 in Q15, smaller efforts are 0)
+
 /*** Custom Data Types ********************************************************/
 
 /*** Public Function Prototypes ***********************************************/
 
 bool		joystick_init(void);			                  // Initialize/Start joystick AP and UDP server if WiFi is available
+bool    joystick_init_fleet(const char *ssid, const char *pass, uint8_t robotId);   // Join a shared AP, start the UDP server
 void 		joystick_tasks(void);				                // Listen/capture incoming joystick packets
 int 		joystick_is_active(void);			              // Has a joystick packet been received
 GAMEPAD* 	joystick_get_data(void);				          // Returns a pointer to the latest raw gamepad switch data
@@ -64,5 +89,20 @@ float		joystick_get_left_tank_effort(void);		    // Get left "tank drive" effort
 float   joystick_get_right_tank_effort(void);		    // Get right "tank drive" effort setting from Right Stick Y
 float 	joystick_get_left_arcade_effort(void);	    // Get left effort "arcade drive" effort setting motor from LeftStickY, RightStickX
 float		joystick_get_right_arcade_effort(void);		  // Get right effort "arcade drive" effort setting motor from LeftStickY, RightStickX
+JOYSTICK_STATS* joystick_get_stats(void);           // Returns a pointer to the link statistics
+void    joystick_set_failsafe_timeout(unsigned long timeout);   // Set the link-loss timeout (in mS, 0 = disabled)
+enum JOYSTICK_LINK_STATE joystick_get_link_state(void);         // Get the joystick link state
+uint16_t joystick_get_buttons(void);                // Get the packed button word
+uint16_t joystick_get_buttons_pressed(void);        // Get the buttons pressed since the last call
+uint16_t joystick_get_buttons_released(void);       // Get the buttons released since the last call
+void    joystick_set_drive_mode(enum JOYSTICK_DRIVE_MODE mode);                 // Select the drive mixing mode
+void    joystick_set_throttle_curve(float deadzone, float expo, float rate);    // Rebuild the throttle axis table
+void    joystick_set_turn_curve(float deadzone, float expo, float rate);        // Rebuild the turn axis table
+void    joystick_get_drive_efforts(float *leftEffort, float *rightEffort);      // Get both motor efforts
+q15_t   joystick_get_left_tank_effort_q15(void);        // Get left "tank drive" effort setting from Left Stick Y (Q15)
+q15_t   joystick_get_right_tank_effort_q15(void);       // Get right "tank drive" effort setting from Right Stick Y (Q15)
+q15_t   joystick_get_left_arcade_effort_q15(void);      // Get left "arcade drive" effort setting from LeftStickY, RightStickX (Q15)
+q15_t   joystick_get_right_arcade_effort_q15(void);     // Get right "arcade drive" effort setting from LeftStickY, RightStickX (Q15)
+void    joystick_get_drive_efforts_q15(q15_t *leftEffort, q15_t *rightEffort);  // Get both motor efforts (Q15)
 
 #endif /* JOYSTICK_H_ */
\ No newline at end of file
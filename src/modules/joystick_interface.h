@@ -27,9 +27,26 @@
  
  /*** Include Files ************************************************************/
  #include <Arduino.h>
+ #include "fixedpoint.h"
  //#include "joystick.h"
  
  /*** Macros *******************************************************************/
+
+// Button bits of the packed button word (see "get_buttons()")
+#define JOYSTICK_BUTTON_X           0x0001
+#define JOYSTICK_BUTTON_A           0x0002
+#define JOYSTICK_BUTTON_B           0x0004
+#define JOYSTICK_BUTTON_Y           0x0008
+#define JOYSTICK_BUTTON_LB          0x0010    // Left Bumper
+#define JOYSTICK_BUTTON_RB          0x0020    // Right Bumper
+#define JOYSTICK_BUTTON_LT          0x0040    // Left Trigger
+#define JOYSTICK_BUTTON_RT          0x0080    // Right Trigger
+#define JOYSTICK_BUTTON_BACK        0x0100
+#define JOYSTICK_BUTTON_START       0x0200
+#define JOYSTICK_BUTTON_DPAD_N      0x0400
+#define JOYSTICK_BUTTON_DPAD_E      0x0800
+#define JOYSTICK_BUTTON_DPAD_S      0x1000
+#define JOYSTICK_BUTTON_DPAD_W      0x2000
  
  /*** Custom Data Types ********************************************************/
  
@@ -37,6 +54,8 @@ typedef struct
 {
   char    clientIP[32];
   int     clientPort;
+  IPAddress clientAddress;
+  uint16_t buttons;
   uint8_t gamepadRaw[8];
   uint8_t leftStickX;
   uint8_t leftStickY;
@@ -71,9 +90,37 @@ typedef struct
   bool isStartPressed;
 } GAMEPAD; 
 
+typedef struct
+{
+  unsigned long packetsReceived;    // valid packets received (v1 and v2)
+  unsigned long packetsLost;        // v2 sequence numbers never received
+  unsigned long packetsReordered;   // v2 packets discarded because a newer packet was already used
+  unsigned long packetsSuperseded;  // packets discarded because a newer packet was queued behind them
+  unsigned long packetsInvalid;     // datagrams that are not a v1 or v2 joystick packet
+  unsigned long lastLatency;        // v2 one-way latency of the newest packet, above the best seen (in mS)
+  unsigned long maxLatency;         // v2 largest one-way latency above the best seen (in mS)
+  float avgLatency;                 // v2 average one-way latency above the best seen (in mS)
+  int protocolVersion;              // protocol version of the newest packet (1 = raw 8-byte report, 2 = sequenced)
+  unsigned long failsafeTrips;      // number of times the link-loss failsafe has stopped the robot
+  unsigned long packetsFiltered;    // fleet mode: v1 packets and v2 packets not addressed to this robot
+  unsigned long packetsRecovered;   // lost v2 packets whose button changes were recovered from redundant copies
+} JOYSTICK_STATS;
+
+// Joystick link state (see "set_failsafe_timeout()")
+enum JOYSTICK_LINK_STATE {JOYSTICK_LINK_WAITING=0, JOYSTICK_LINK_UP, JOYSTICK_LINK_LOST};
+
+// Drive mixing modes (see "get_drive_efforts()")
+enum JOYSTICK_DRIVE_MODE
+{
+  JOYSTICK_DRIVE_ARCADE=0,      // Left Stick Y: throttle, Right Stick X: turn
+  JOYSTICK_DRIVE_TANK,          // Left Stick Y: left motor, Right Stick Y: right motor
+  JOYSTICK_DRIVE_CURVATURE      // Left Stick Y: throttle, Right Stick X: turn rate scaled by throttle
+};
+
  struct JOYSTICK_INTERFACE
  {
   bool (*initialize)(void);                   // Initialize/Start joystick AP and UDP server
+  bool (*initialize_fleet)(const char *ssid, const char *pass, uint8_t robotId);  // Join a shared WiFi network and start the UDP server
   void (*tasks)(void);                        // Listen/capture incoming joystick packets
   int (*is_active)(void);			                // Has a joystick packet been received
   GAMEPAD* (*get_data)(void);				          // Returns a pointer to the latest raw gamepad switch data
@@ -81,6 +128,21 @@ typedef struct
   float (*get_right_tank_effort)(void);		    // Get right "tank drive" effort setting from Right Stick Y
   float (*get_arcade_throttle_effort)(void);	// Get "throttle" effort for Split-Stick Arcade motor drive from LeftStickY
   float	(*get_arcade_turn_effort)(void);		  // Get "turn" effort for Split-Stick Arcade motor drive from RightStickX 
+  JOYSTICK_STATS* (*get_stats)(void);         // Returns a pointer to the link statistics (loss, reorder, latency)
+  void (*set_failsafe_timeout)(unsigned long timeout);  // Set the link-loss failsafe timeout (in mS, 0 = disabled)
+  enum JOYSTICK_LINK_STATE (*get_link_state)(void);     // Get the joystick link state (waiting, up, lost)
+  uint16_t (*get_buttons)(void);              // Get the packed button word (JOYSTICK_BUTTON_xxx bits)
+  uint16_t (*get_buttons_pressed)(void);      // Get the buttons pressed since the last call
+  uint16_t (*get_buttons_released)(void);     // Get the buttons released since the last call
+  void (*set_drive_mode)(enum JOYSTICK_DRIVE_MODE mode);                  // Select arcade, tank or curvature drive mixing
+  void (*set_throttle_curve)(float deadzone, float expo, float rate);     // Shape the throttle (stick Y) axes
+  void (*set_turn_curve)(float deadzone, float expo, float rate);         // Shape the turn (stick X) axes
+  void (*get_drive_efforts)(float *leftEffort, float *rightEffort);       // Get both motor efforts from the selected drive mode
+  q15_t (*get_left_tank_effort_q15)(void);          // Get left "tank drive" effort setting from Left Stick Y (Q15)
+  q15_t (*get_right_tank_effort_q15)(void);         // Get right "tank drive" effort setting from Right Stick Y (Q15)
+  q15_t (*get_arcade_throttle_effort_q15)(void);    // Get "throttle" effort for Split-Stick Arcade motor drive (Q15)
+  q15_t (*get_arcade_turn_effort_q15)(void);        // Get "turn" effort for Split-Stick Arcade motor drive (Q15)
+  void (*get_drive_efforts_q15)(q15_t *leftEffort, q15_t *rightEffort);   // Get both motor efforts from the selected drive mode (Q15)
  };
 
  #endif /* JOYSTICK_INTERFACE_H_ */
\ No newline at end of file
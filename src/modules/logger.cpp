@@ -0,0 +1,181 @@
+/*
+ * Copyright (C) 2026 dBm Signal Dynamics Inc.
+ *
+ * File:            logger.cpp
+ * Project:
+ * Date:            Oct 19, 2026
+ * Framework:       Arduino w. Arduino-Pico Core Pkge by Earl Philhower
+ *                  (https://github.com/earlephilhower/arduino-pico)
+ *
+ * cetalib "logger" non-blocking serial logging
+ *
+ * Library modules (and sketches) log through the CETALIB_LOG_ERROR/WARN/INFO/DEBUG
+ * macros. Messages above CETALIB_LOG_LEVEL are removed at compile time. Enabled
+ * messages are formatted into a fixed ring of message slots and sent to the serial
+ * port by logger_tasks() (called from board_tasks()) only as fast as the port
+ * can accept them, so logging never waits on the serial port. When the ring is
+ * full new messages are discarded and counted.
+ *
+ * Hardware Configurations Supported:
+ *
+ * CETA IoT Robot (Schematic #14-00069A/B), based on RPI-Pico-WH
+ * (Select "Board = Raspberry Pi Pico W")
+ *
+ * Sparkfun XRP Robot Platform (#KIT-27644), based on the RPI RP2350B MCU
+ * (Select "Board = SparkFun XRP Controller")
+ *
+ * Sparkfun XRP (Beta) Robot Platform (#KIT-22230), based on the RPI Pico W
+ * (Select "Board = SparkFun XRP Controller (Beta)")
+ *
+ */
+
+/** Include Files *************************************************************/
+#include <Arduino.h>                // Required for Arduino functions
+#include <stdarg.h>                 // needed for variable argument lists
+#include <stdio.h>                  // needed for "vsnprintf()" function
+#include <string.h>                 // needed for "strlen()" function
+#include <hardware/sync.h>          // needed for hardware spin locks and memory barriers
+#include "logger.h"                 // "logger" API declarations
+#include "trace.h"                  // "trace" event macros
+
+/*** Symbolic Constants used in this module ***********************************/
+#define SERIAL_PORT Serial  // Default to Serial
+#if defined(NO_USB)
+    #undef SERIAL_PORT
+    #define SERIAL_PORT Serial1     // Use Serial1 if USB is disabled
+#endif
+
+#define LOGGER_SPINLOCK_ID      PICO_SPINLOCK_ID_STRIPED_FIRST  // SDK shared spin lock, held only to claim a slot
+#define LOGGER_FLUSH_TIMEOUT    1000    // Max time logger_flush() waits without progress (in mS)
+
+/*** Global Variable Declarations *********************************************/
+
+// define the function interface
+extern const struct LOGGER_INTERFACE LOGGER = {
+    .tasks                  = &logger_tasks,
+    .flush                  = &logger_flush,
+    .get_dropped            = &logger_get_dropped
+};
+
+static struct LOGGER_SLOT loggerSlots[LOGGER_NUM_SLOTS];
+static volatile uint32_t loggerHead = 0;            // total slots claimed by logger_write()
+static volatile uint32_t loggerTail = 0;            // total slots sent by logger_tasks()
+static uint16_t loggerSendOffset = 0;               // bytes of the oldest slot already sent
+static volatile bool loggerSending = false;         // a logger_tasks() call owns the consumer side
+static volatile unsigned long loggerDropped = 0;    // messages discarded (ring full)
+static const char loggerLevelTags[] = {'-', 'E', 'W', 'I', 'D'};
+
+/*** Type Declarations ********************************************************/
+
+/*** Private Function Prototypes **********************************************/
+
+/*** Public Function Definitions **********************************************/
+
+void logger_write(int level, const char *format, ...)
+{
+  // claim a slot (safe from either core and from interrupt handlers)
+  spin_lock_t *lock = spin_lock_instance(LOGGER_SPINLOCK_ID);
+  uint32_t irqState = spin_lock_blocking(lock);
+  if((loggerHead - loggerTail) >= LOGGER_NUM_SLOTS)
+  {
+    loggerDropped++;
+    spin_unlock(lock, irqState);
+    return;
+  }
+  uint32_t index = loggerHead++;
+  spin_unlock(lock, irqState);
+
+  // format the message into the claimed slot, outside of the lock
+  struct LOGGER_SLOT *slot = &loggerSlots[index & (LOGGER_NUM_SLOTS - 1)];
+  int length = snprintf(slot->text, LOGGER_SLOT_SIZE, "[%lu] %c: ", millis(),
+                        loggerLevelTags[constrain(level, CETALIB_LOG_LEVEL_NONE, CETALIB_LOG_LEVEL_DEBUG)]);
+  va_list args;
+  va_start(args, format);
+  vsnprintf(&slot->text[length], LOGGER_SLOT_SIZE - length - 2, format, args);
+  va_end(args);
+  length = strlen(slot->text);
+  while((length > 0) && ((slot->text[length - 1] == '\n') || (slot->text[length - 1] == '\r')))
+  {
+    length--;
+  }
+  slot->text[length++] = '\r';
+  slot->text[length++] = '\n';
+  slot->text[length] = '\0';
+  slot->length = length;
+  __dmb();                          // message must be complete before it is marked ready
+  slot->ready = true;
+}
+
+void logger_tasks(void)
+{
+  if(loggerTail == loggerHead)
+  {
+    return;                         // nothing queued (or the logger is not used)
+  }
+
+  // only one caller (core or blocking loop) may send at a time: the tail and the
+  // send offset are not protected otherwise. A second caller returns immediately.
+  spin_lock_t *lock = spin_lock_instance(LOGGER_SPINLOCK_ID);
+  uint32_t irqState = spin_lock_blocking(lock);
+  if(loggerSending)
+  {
+    spin_unlock(lock, irqState);
+    return;
+  }
+  loggerSending = true;
+  spin_unlock(lock, irqState);
+
+  // send only what the serial port can accept without blocking
+  int budget = SERIAL_PORT.availableForWrite();
+  int sent = 0;
+  CETALIB_TRACE_BEGIN("logger", "tasks", budget);
+  while((loggerTail != loggerHead) && (budget > 0))
+  {
+    struct LOGGER_SLOT *slot = &loggerSlots[loggerTail & (LOGGER_NUM_SLOTS - 1)];
+    if(!slot->ready)
+    {
+      break;                        // oldest message is still being formatted
+    }
+    int chunk = min(slot->length - loggerSendOffset, budget);
+    SERIAL_PORT.write((const uint8_t *)&slot->text[loggerSendOffset], chunk);
+    budget -= chunk;
+    sent += chunk;
+    loggerSendOffset += chunk;
+    if(loggerSendOffset >= slot->length)
+    {
+      slot->ready = false;
+      loggerSendOffset = 0;
+      __dmb();                      // slot must be released before it can be claimed again
+      loggerTail++;
+    }
+  }
+  CETALIB_TRACE_END("logger", "tasks", sent);
+  __dmb();                          // tail and offset must be updated before the next sender runs
+  loggerSending = false;
+}
+
+void logger_flush(void)
+{
+  uint32_t prevTail = loggerTail;
+  unsigned long progressTime = millis();
+  while(loggerTail != loggerHead)
+  {
+    logger_tasks();
+    if(loggerTail != prevTail)
+    {
+      prevTail = loggerTail;
+      progressTime = millis();
+    }
+    else if((millis() - progressTime) >= LOGGER_FLUSH_TIMEOUT)
+    {
+      break;                        // serial port is not being read
+    }
+  }
+}
+
+unsigned long logger_get_dropped(void)
+{
+  return loggerDropped;
+}
+
+/*** Private Function Definitions *********************************************/
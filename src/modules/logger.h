@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2026 dBm Signal Dynamics Inc.
+ *
+ * File:            logger.h
+ * Project:
+ * Date:            Oct 19, 2026
+ * Framework:       Arduino w. Arduino-Pico Core Pkge by Earl Philhower
+ *                  (https://github.com/earlephilhower/arduino-pico)
+ *
+ * cetalib "logger" non-blocking serial logging
+ *
+ * Library modules (and sketches) log through the CETALIB_LOG_ERROR/WARN/INFO/DEBUG
+ * macros. Messages above CETALIB_LOG_LEVEL are removed at compile time. Enabled
+ * messages are formatted into a fixed ring of message slots and sent to the serial
+ * port by logger_tasks() (called from board_tasks()) only as fast as the port
+ * can accept them, so logging never waits on the serial port. When the ring is
+ * full new messages are discarded and counted.
+ *
+ * Hardware Configurations Supported:
+ *
+ * CETA IoT Robot (Schematic #14-00069A/B), based on RPI-Pico-WH
+ * (Select "Board = Raspberry Pi Pico W")
+ *
+ * Sparkfun XRP Robot Platform (#KIT-27644), based on the RPI RP2350B MCU
+ * (Select "Board = SparkFun XRP Controller")
+ *
+ * Sparkfun XRP (Beta) Robot Platform (#KIT-22230), based on the RPI Pico W
+ * (Select "Board = SparkFun XRP Controller (Beta)")
+ *
+ */
+
+#ifndef LOGGER_H_
+#define LOGGER_H_
+
+/*** Include Files ************************************************************/
+#include <Arduino.h>
+#include "logger_interface.h"
+
+/*** Macros *******************************************************************/
+#define LOGGER_NUM_SLOTS        16      // Number of queued messages (must be a power of 2)
+#define LOGGER_SLOT_SIZE        96      // Max length of a message, including prefix and line ending
+
+/*** Custom Data Types ********************************************************/
+
+struct LOGGER_SLOT
+{
+  volatile bool ready;                  // message is formatted and can be sent
+  uint16_t length;                      // message length (in bytes)
+  char text[LOGGER_SLOT_SIZE];          // formatted message
+};
+
+/*** Public Function Prototypes ***********************************************/
+void logger_tasks(void);                // Send queued log messages to the serial port (never blocks)
+void logger_flush(void);                // Send all queued log messages (blocks until done)
+unsigned long logger_get_dropped(void); // Returns the number of discarded messages
+
+#endif /* LOGGER_H_ */
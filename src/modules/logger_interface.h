@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2026 dBm Signal Dynamics Inc.
+ *
+ * File:            logger_interface.h
+ * Project:
+ * Date:            Oct 19, 2026
+ * Framework:       Arduino w. Arduino-Pico Core Pkge by Earl Philhower
+ *                  (https://github.com/earlephilhower/arduino-pico)
+ *
+ * "logger" driver interface file - defines "LOGGER_INTERFACE" structure
+ * and the CETALIB_LOG_xxx() logging macros
+ *
+ * Hardware Configurations Supported:
+ *
+ * CETA IoT Robot (Schematic #14-00069A/B), based on RPI-Pico-WH
+ * (Select "Board = Raspberry Pi Pico W")
+ *
+ * Sparkfun XRP Robot Platform (#KIT-27644), based on the RPI RP2350B MCU
+ * (Select "Board = SparkFun XRP Controller")
+ *
+ * Sparkfun XRP (Beta) Robot Platform (#KIT-22230), based on the RPI Pico W
+ * (Select "Board = SparkFun XRP Controller (Beta)")
+ *
+ */
+
+#ifndef LOGGER_INTERFACE_H_
+#define LOGGER_INTERFACE_H_
+
+/*** Include Files ************************************************************/
+#include <Arduino.h>
+
+/*** Macros *******************************************************************/
+
+// Log levels
+#define CETALIB_LOG_LEVEL_NONE      0
+#define CETALIB_LOG_LEVEL_ERROR     1
+#define CETALIB_LOG_LEVEL_WARN      2
+#define CETALIB_LOG_LEVEL_INFO      3
+#define CETALIB_LOG_LEVEL_DEBUG     4
+
+// Compile-time log level. Messages above this level are removed by the
+// pre-processor (no code, no format strings in flash, arguments not evaluated).
+// Override with a build flag, e.g. "-DCETALIB_LOG_LEVEL=CETALIB_LOG_LEVEL_WARN"
+#ifndef CETALIB_LOG_LEVEL
+#define CETALIB_LOG_LEVEL           CETALIB_LOG_LEVEL_INFO
+#endif
+
+#if CETALIB_LOG_LEVEL >= CETALIB_LOG_LEVEL_ERROR
+#define CETALIB_LOG_ERROR(...)      logger_write(CETALIB_LOG_LEVEL_ERROR, __VA_ARGS__)
+#else
+#define CETALIB_LOG_ERROR(...)      do {} while(0)
+#endif
+
+#if CETALIB_LOG_LEVEL >= CETALIB_LOG_LEVEL_WARN
+#define CETALIB_LOG_WARN(...)       logger_write(CETALIB_LOG_LEVEL_WARN, __VA_ARGS__)
+#else
+#define CETALIB_LOG_WARN(...)       do {} while(0)
+#endif
+
+#if CETALIB_LOG_LEVEL >= CETALIB_LOG_LEVEL_INFO
+#define CETALIB_LOG_INFO(...)       logger_write(CETALIB_LOG_LEVEL_INFO, __VA_ARGS__)
+#else
+#define CETALIB_LOG_INFO(...)       do {} while(0)
+#endif
+
+#if CETALIB_LOG_LEVEL >= CETALIB_LOG_LEVEL_DEBUG
+#define CETALIB_LOG_DEBUG(...)      logger_write(CETALIB_LOG_LEVEL_DEBUG, __VA_ARGS__)
+#else
+#define CETALIB_LOG_DEBUG(...)      do {} while(0)
+#endif
+
+/*** Custom Data Types ********************************************************/
+
+struct LOGGER_INTERFACE
+{
+  void (*tasks)(void);                      // Send queued log messages to the serial port (never blocks)
+  void (*flush)(void);                      // Send all queued log messages (blocks until done)
+  unsigned long (*get_dropped)(void);       // Returns the number of messages discarded because the queue was full
+};
+
+/*** Public Function Prototypes ***********************************************/
+
+// Queue a formatted message (used by the CETALIB_LOG_xxx() macros)
+void logger_write(int level, const char *format, ...) __attribute__((format(printf, 2, 3)));
+
+#endif /* LOGGER_INTERFACE_H_ */
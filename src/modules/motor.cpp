@@ -13,6 +13,11 @@
  * 
  * CETA IoT Robot (Schematic #14-00069A/B), based on RPI-Pico-WH
  * (Select Board: "Raspberry Pi Pico W")
+ * Both motor controller (ESC) inputs are the two channels of PWM slice 2,
+ * driven with 50 Hz servo pulses. The pulse widths are set in PWM counter
+ * clocks (about 0.3 uS at 125 MHz), from a calibrated neutral, deadband and
+ * full effort pulse width per motor, instead of the 1-degree (about 10 uS)
+ * steps of the Servo library.
  * 
  * Sparkfun XRP Robot Platform (#KIT-27644), based on the RPI RP2350B MCU
  * (Select Board: "SparkFun XRP Controller")
@@ -24,46 +29,160 @@
  * Left Motor connected to "MotorL" connector
  * Right Motor connected to "MotorR" connector
  *
+ * Slew-rate limiting: the effort set by the sketch is the target, and the
+ * applied effort moves toward it by at most one step per slew timer tick, so
+ * wheel slip, H-bridge current spikes and battery brownouts are avoided on
+ * sudden effort changes. Only speeding up is limited: slowing down (toward
+ * zero) is applied at once, and a direction reversal stops the motor first.
+ * The timer runs only while a slew rate is set. The step can be scaled down
+ * with the battery voltage (read by tasks()) as the battery sags.
+ *
  */
 
 /** Include Files *************************************************************/
 #include <Arduino.h>            // Required for Arduino functions
-#include <Servo.h>              // Required for Servo functions
+#include <hardware/pwm.h>       // Required for direct PWM slice control
+#include <hardware/gpio.h>      // Required for gpio_set_function()
+#include <hardware/clocks.h>    // Required for clock_get_hz()
+#include <hardware/sync.h>      // Required for save_and_disable_interrupts()
+#include <pico/time.h>          // Required for the slew repeating timer
+#if defined(ARDUINO_RASPBERRY_PI_PICO_W)
+#include <pico/cyw43_arch.h>    // Required for cyw43_thread_enter() (battery reads share GPIO29 with the WiFi chip)
+#endif
 #include "motor.h"              // "motor" API declarations
+#include "logger.h"             // "logger" functions
+#include "trace.h"              // "trace" event macros
+#include "calstore.h"           // "calstore" functions
+#include "board.h"              // "board" functions
 
 /*** Symbolic Constants used in this module ***********************************/
+#define SERIAL_PORT Serial  // Default to Serial
+#if defined(NO_USB)
+    #undef SERIAL_PORT
+    #define SERIAL_PORT Serial1     // Use Serial1 if USB is disabled
+#endif
 
 /*** Global Variable Declarations *********************************************/
-Servo lServo;             // LEFT motor servo object
-Servo rServo;             // RIGHT motor servo object
 static int leftMotorDir, leftMotorDirFwd, rightMotorDir, rightMotorDirFwd;
+static volatile q15_t leftMotorEffortSetting = 0;      // most recent left effort (Q15, -1.0 to 1.0), the slew target
+static volatile q15_t rightMotorEffortSetting = 0;     // most recent right effort (Q15, -1.0 to 1.0), the slew target
+static volatile q15_t leftMotorEffortApplied = 0;      // left effort at the motor output (Q15)
+static volatile q15_t rightMotorEffortApplied = 0;     // right effort at the motor output (Q15)
+
+static volatile int32_t leftMotorSlewStep = MOTOR_SLEW_UNLIMITED;    // largest effort increase per slew tick (Q15)
+static volatile int32_t rightMotorSlewStep = MOTOR_SLEW_UNLIMITED;
+static volatile q15_t motorSlewScale = Q15_ONE;        // slew step scale from the battery voltage (Q15)
+static repeating_timer_t motorSlewTimer;
+static bool motorSlewRunning = false;
+static bool motorRampActive[2] = {false, false};       // applied effort not at the target yet ([0] = left, [1] = right)
+static unsigned long motorRampStart[2];
+
+static float motorBatteryNominal = 0.0f;               // battery voltage of full slew rates (0 = battery scaling off)
+static float motorBatteryBrownout = 0.0f;              // battery voltage of the smallest slew rates
+static bool motorBrownoutActive = false;               // battery below the brownout voltage (waiting for recovery)
+static unsigned long motorBatteryReadTime = 0;
+static MOTOR_STATS motorStats = {.slewScale = 1.0f};
+
+static uint leftMotorSlice, rightMotorSlice;            // PWM slice driving each motor
+static uint32_t motorPwmPeriod = 0;                     // PWM counts per period (TOP + 1, the "always high" level)
+static uint32_t motorPwmClock = 0;                      // PWM counter clock (in Hz)
+static uint32_t motorPwmWrapGuard = 0;                  // MOTOR_PWM_WRAP_GUARD (in PWM counts)
+static unsigned long motorPwmFrequency = 0;             // actual PWM frequency (in Hz)
+
+#if defined(ARDUINO_RASPBERRY_PI_PICO_W)
+static uint leftMotorChannel, rightMotorChannel;        // PWM channel of each ESC input
+
+// calibration object with default values assigned
+static struct MOTOR_CAL motorCal = {
+    .neutral_pulse  = {MOTOR_ESC_NEUTRAL_PULSE, MOTOR_ESC_NEUTRAL_PULSE},
+    .deadband       = {MOTOR_ESC_DEADBAND, MOTOR_ESC_DEADBAND},
+    .min_pulse      = {MOTOR_ESC_MIN_PULSE, MOTOR_ESC_MIN_PULSE},
+    .max_pulse      = {MOTOR_ESC_MAX_PULSE, MOTOR_ESC_MAX_PULSE}
+};
+static enum MOTOR_CALIBRATION_STATE motorCalState = MOTOR_CAL_IDLE;
+static struct MOTOR_CAL motorNewCal;                    // pulse widths accepted so far (calibration routine)
+static float motorCalPulse;                             // pulse width set by the POT (calibration routine, in uS)
+static bool motorCalNextRequest = false;                // calibration_next() called
+
+// calibration converted to PWM counts ([0] = left, [1] = right)
+static uint16_t motorNeutralLevel[2];                   // stop
+static uint16_t motorDeadbandLevel[2];                  // offset from neutral of the smallest effort
+static uint16_t motorShortSpan[2], motorLongSpan[2];    // smallest to full effort, each direction
+
+#elif defined(ARDUINO_SPARKFUN_XRP_CONTROLLER) || defined(ARDUINO_SPARKFUN_XRP_CONTROLLER_BETA)
+// Both pins of a motor are the two channels of one PWM slice, so one compare
+// register write updates the direction and the duty of a motor together
+static bool leftMotorSwapped, rightMotorSwapped;        // first motor pin (IN1/DIR) is on channel B
+#endif
 
 /*** Type Declarations ********************************************************/
 extern const struct MOTOR_INTERFACE MOTOR = {
     .initialize             = &motor_init,
     .set_left_effort        = &motor_set_left_effort,
     .set_right_effort       = &motor_set_right_effort,
-    .set_efforts            = &motor_set_efforts
+    .set_efforts            = &motor_set_efforts,
+    .get_left_effort        = &motor_get_left_effort,
+    .get_right_effort       = &motor_get_right_effort,
+    .set_left_effort_q15    = &motor_set_left_effort_q15,
+    .set_right_effort_q15   = &motor_set_right_effort_q15,
+    .set_efforts_q15        = &motor_set_efforts_q15,
+    .get_left_effort_q15    = &motor_get_left_effort_q15,
+    .get_right_effort_q15   = &motor_get_right_effort_q15,
+    .set_pwm_frequency      = &motor_set_pwm_frequency,
+    .get_pwm_frequency      = &motor_get_pwm_frequency,
+    .set_slew_rates         = &motor_set_slew_rates,
+    .set_battery_scaling    = &motor_set_battery_scaling,
+    .tasks                  = &motor_tasks,
+    .get_stats              = &motor_get_stats,
+    .get_effort_steps       = &motor_get_effort_steps,
+#if defined(ARDUINO_RASPBERRY_PI_PICO_W)
+    .calibrate              = &motor_calibrate,
+    .clear_calibration      = &motor_clear_calibration,
+    .start_calibration      = &motor_start_calibration,
+    .is_calibrating         = &motor_is_calibrating,
+    .calibration_next       = &motor_calibration_next,
+    .cancel_calibration     = &motor_cancel_calibration
+#endif
 };
 
 /*** Private Function Prototypes **********************************************/
+static int motorDirection(q15_t effort, int dirFwd);                              // Motor direction for an effort
+static void motorPwmConfigure(unsigned long frequency);                           // Program both motor slices
+static void motorOutputLeft(q15_t effort);                                        // Drive the left motor
+static void motorOutputRight(q15_t effort);                                       // Drive the right motor
+static void motorOutputBoth(q15_t leftEffort, q15_t rightEffort);                 // Drive both motors together
+static int32_t motorSlewRateStep(float rate);                                     // Slew step per tick for a rate
+static int32_t motorSlewLimit(int32_t step, bool timerTick);                      // Slew step allowed now
+static q15_t motorSlewStep(q15_t applied, q15_t target, int32_t step);            // Next applied effort
+static void motorTrackRamps(void);                                                // Ramp start/end timing
+#if defined(MOTOR_BATTERY_PIN)
+static float motorReadBattery(void);                                              // Battery voltage (in V)
+#endif
+static bool motorSlewCallback(repeating_timer_t *rt);                             // Ramp the applied efforts (timer interrupt)
+#if defined(ARDUINO_RASPBERRY_PI_PICO_W)
+static uint16_t motorPulseTicks(float pulseWidth);                                // PWM counts of a pulse width (in uS)
+static void motorPulseUpdateLevels(void);                                         // Convert the calibration to PWM counts
+static uint16_t motorPulseLevel(int wheel, q15_t effort, int dir);                // ESC pulse level for an effort
+static float motorCalPotPulse(float lowPulse, float highPulse);                   // Calibration pulse width from the POT
+static void motorCalPulseWrite(int wheel, float pulseWidth);                      // Send a calibration pulse width
+static void motorCalTasks(void);                                                  // Advance the calibration routine
+static void motorCalSave(void);                                                   // Use and save the calibration
+#elif defined(ARDUINO_SPARKFUN_XRP_CONTROLLER) || defined(ARDUINO_SPARKFUN_XRP_CONTROLLER_BETA)
+static void motorPwmLevels(q15_t effort, int dir, uint16_t *pin1Level, uint16_t *pin2Level);   // Compare levels for an effort
+static void motorPwmWrite(uint slice, bool swapped, uint16_t pin1Level, uint16_t pin2Level);   // Update both channels of a slice
+#endif
 
 /*** Public Function Definitions **********************************************/
 
 void motor_init(bool left_flip_dir, bool right_flip_dir)
 {
     #if defined(ARDUINO_RASPBERRY_PI_PICO_W)
-    // Initialize servo output signals
-    // Servo Angle parameter vs Motor Torque/Direction:
+    // ESC pulse width vs Motor Torque/Direction:
     //
-    //  0   = full speed in one direction,
-    //  90  = no movement
-    //  180 = full speed in the other direction
-    lServo.attach(LEFT_MOTOR_PWM_PIN);                  // Initialize LEFT MOTOR PWM Digital Control Output
-    lServo.write(90);                                   // Motor state = STOP
-    rServo.attach(RIGHT_MOTOR_PWM_PIN);                 // Initialize RIGHT MOTOR PWM Digital Control Output
-    rServo.write(90);                                   // Motor state = STOP
-    
+    //  min_pulse     = full speed in one direction,
+    //  neutral_pulse = no movement
+    //  max_pulse     = full speed in the other direction
+
     // Initiallize Left Motor "forward" direction
     if(left_flip_dir == false)
     {
@@ -73,6 +192,7 @@ void motor_init(bool left_flip_dir, bool right_flip_dir)
     {
         leftMotorDir = 1;
     }
+    leftMotorDirFwd = leftMotorDir;
 
     // Initiallize Right Motor "forward" direction
     if(right_flip_dir == false)
@@ -84,14 +204,27 @@ void motor_init(bool left_flip_dir, bool right_flip_dir)
         rightMotorDir = 1;
     }
     rightMotorDirFwd = rightMotorDir;
-    
+
+    // Use the calibrated pulse widths, or the defaults until calibrate() is run
+    if(!calstore_read(CALSTORE_RECORD_MOTOR, &motorCal, sizeof(motorCal)))
+    {
+        CETALIB_LOG_INFO("motor: no ESC calibration, using the default pulse widths");
+    }
+
+    // Initiallize the PWM slice (both ESC inputs share slice 2) with the motors stopped
+    leftMotorSlice = pwm_gpio_to_slice_num(LEFT_MOTOR_PWM_PIN);
+    leftMotorChannel = pwm_gpio_to_channel(LEFT_MOTOR_PWM_PIN);
+    rightMotorSlice = pwm_gpio_to_slice_num(RIGHT_MOTOR_PWM_PIN);
+    rightMotorChannel = pwm_gpio_to_channel(RIGHT_MOTOR_PWM_PIN);
+    motorPwmConfigure(SERVO_PWM_FREQ);
+    motorPulseUpdateLevels();
+    motorOutputBoth(0, 0);
+    gpio_set_function(LEFT_MOTOR_PWM_PIN, GPIO_FUNC_PWM);
+    gpio_set_function(RIGHT_MOTOR_PWM_PIN, GPIO_FUNC_PWM);
+
     #elif defined(ARDUINO_SPARKFUN_XRP_CONTROLLER)
     
-    // Initiallize Left Motor PWM Pins and "forward" direction
-    digitalWrite(LEFT_MOTOR_IN1_PIN, LOW);
-    digitalWrite(LEFT_MOTOR_IN2_PIN, LOW);
-    pinMode(LEFT_MOTOR_IN1_PIN, OUTPUT);
-    pinMode(LEFT_MOTOR_IN2_PIN, OUTPUT);
+    // Initiallize Left Motor "forward" direction
     if(left_flip_dir == false)
     {
         leftMotorDir = 0;   // default motor direction setting
@@ -102,11 +235,7 @@ void motor_init(bool left_flip_dir, bool right_flip_dir)
     }
     leftMotorDirFwd = leftMotorDir;
 
-    // Initiallize Right Motor PWM Pins and "forward" direction
-    digitalWrite(RIGHT_MOTOR_IN1_PIN, LOW);
-    digitalWrite(RIGHT_MOTOR_IN2_PIN, LOW);
-    pinMode(RIGHT_MOTOR_IN1_PIN, OUTPUT);
-    pinMode(RIGHT_MOTOR_IN2_PIN, OUTPUT);
+    // Initiallize Right Motor "forward" direction
     if(right_flip_dir == false)
     {
         rightMotorDir = 0;   // default motor direction setting
@@ -117,15 +246,20 @@ void motor_init(bool left_flip_dir, bool right_flip_dir)
     }
     rightMotorDirFwd = rightMotorDir;
     
-    // Initiallize PWM functionalty
-    analogWriteFreq(PWM_FREQ);
-    analogWriteRange(PWM_RESOLUTION);
+    // Initiallize the PWM slices (IN1 and IN2 of each motor share a slice)
+    leftMotorSlice = pwm_gpio_to_slice_num(LEFT_MOTOR_IN1_PIN);
+    leftMotorSwapped = (pwm_gpio_to_channel(LEFT_MOTOR_IN1_PIN) == PWM_CHAN_B);
+    rightMotorSlice = pwm_gpio_to_slice_num(RIGHT_MOTOR_IN1_PIN);
+    rightMotorSwapped = (pwm_gpio_to_channel(RIGHT_MOTOR_IN1_PIN) == PWM_CHAN_B);
+    motorPwmConfigure(PWM_FREQ);
+    gpio_set_function(LEFT_MOTOR_IN1_PIN, GPIO_FUNC_PWM);
+    gpio_set_function(LEFT_MOTOR_IN2_PIN, GPIO_FUNC_PWM);
+    gpio_set_function(RIGHT_MOTOR_IN1_PIN, GPIO_FUNC_PWM);
+    gpio_set_function(RIGHT_MOTOR_IN2_PIN, GPIO_FUNC_PWM);
 
     #elif defined(ARDUINO_SPARKFUN_XRP_CONTROLLER_BETA)
 
-    // Initiallize Left Motor PWM Pins and "forward" direction
-    digitalWrite(LEFT_MOTOR_SPEED_PIN, LOW);
-    pinMode(LEFT_MOTOR_SPEED_PIN, OUTPUT);
+    // Initiallize Left Motor "forward" direction
     if(left_flip_dir == false)
     {
         leftMotorDir = 1;   // default motor direction setting
@@ -135,12 +269,8 @@ void motor_init(bool left_flip_dir, bool right_flip_dir)
         leftMotorDir = 0;
     }
     leftMotorDirFwd = leftMotorDir;
-    digitalWrite(LEFT_MOTOR_DIR_PIN, leftMotorDir);
-    pinMode(LEFT_MOTOR_DIR_PIN, OUTPUT);
 
-    // Initiallize Right Motor PWM Pins and "forward" direction
-    digitalWrite(RIGHT_MOTOR_SPEED_PIN, LOW);
-    pinMode(RIGHT_MOTOR_SPEED_PIN, OUTPUT);
+    // Initiallize Right Motor "forward" direction
     if(right_flip_dir == false)
     {
         rightMotorDir = 0;   // default motor direction setting
@@ -150,12 +280,18 @@ void motor_init(bool left_flip_dir, bool right_flip_dir)
         rightMotorDir = 1;
     }
     rightMotorDirFwd = rightMotorDir;
-    digitalWrite(RIGHT_MOTOR_DIR_PIN, rightMotorDir);
-    pinMode(RIGHT_MOTOR_DIR_PIN, OUTPUT);
     
-    // Initiallize PWM functionalty
-    analogWriteFreq(PWM_FREQ);
-    analogWriteRange(PWM_RESOLUTION);
+    // Initiallize the PWM slices (DIR and SPEED of each motor share a slice,
+    // DIR is driven as an "always low" or "always high" PWM output)
+    leftMotorSlice = pwm_gpio_to_slice_num(LEFT_MOTOR_DIR_PIN);
+    leftMotorSwapped = (pwm_gpio_to_channel(LEFT_MOTOR_DIR_PIN) == PWM_CHAN_B);
+    rightMotorSlice = pwm_gpio_to_slice_num(RIGHT_MOTOR_DIR_PIN);
+    rightMotorSwapped = (pwm_gpio_to_channel(RIGHT_MOTOR_DIR_PIN) == PWM_CHAN_B);
+    motorPwmConfigure(PWM_FREQ);
+    gpio_set_function(LEFT_MOTOR_DIR_PIN, GPIO_FUNC_PWM);
+    gpio_set_function(LEFT_MOTOR_SPEED_PIN, GPIO_FUNC_PWM);
+    gpio_set_function(RIGHT_MOTOR_DIR_PIN, GPIO_FUNC_PWM);
+    gpio_set_function(RIGHT_MOTOR_SPEED_PIN, GPIO_FUNC_PWM);
 
     #else
         #error Unsupported board selection
@@ -164,135 +300,729 @@ void motor_init(bool left_flip_dir, bool right_flip_dir)
 
 void motor_set_left_effort(float leftMotorEffort)
 {
-    int reverse = 0;
+    motor_set_left_effort_q15(q15_from_float(leftMotorEffort));
+}
+
+void motor_set_right_effort(float rightMotorEffort)
+{
+    motor_set_right_effort_q15(q15_from_float(rightMotorEffort));
+}
+
+void motor_set_efforts(float leftMotorEffort, float rightMotorEffort)
+{
+    motor_set_efforts_q15(q15_from_float(leftMotorEffort), q15_from_float(rightMotorEffort));
+}
+
+float motor_get_left_effort(void)
+{
+    return q15_to_float(leftMotorEffortSetting);
+}
 
-    if(leftMotorEffort < 0)
+float motor_get_right_effort(void)
+{
+    return q15_to_float(rightMotorEffortSetting);
+}
+
+void motor_set_left_effort_q15(q15_t leftMotorEffort)
+{
+    uint32_t irqState = save_and_disable_interrupts();     // the slew timer also updates the outputs
+    leftMotorEffortSetting = q15_saturate(leftMotorEffort);    // -32768 is clamped to full scale
+    leftMotorEffortApplied = motorSlewStep(leftMotorEffortApplied, leftMotorEffortSetting, motorSlewLimit(leftMotorSlewStep, false));
+    motorOutputLeft(leftMotorEffortApplied);
+    motorTrackRamps();
+    restore_interrupts(irqState);
+}
+
+void motor_set_right_effort_q15(q15_t rightMotorEffort)
+{
+    uint32_t irqState = save_and_disable_interrupts();     // the slew timer also updates the outputs
+    rightMotorEffortSetting = q15_saturate(rightMotorEffort);  // -32768 is clamped to full scale
+    rightMotorEffortApplied = motorSlewStep(rightMotorEffortApplied, rightMotorEffortSetting, motorSlewLimit(rightMotorSlewStep, false));
+    motorOutputRight(rightMotorEffortApplied);
+    motorTrackRamps();
+    restore_interrupts(irqState);
+}
+
+void motor_set_efforts_q15(q15_t leftMotorEffort, q15_t rightMotorEffort)
+{
+    uint32_t irqState = save_and_disable_interrupts();     // the slew timer also updates the outputs
+    leftMotorEffortSetting = q15_saturate(leftMotorEffort);
+    rightMotorEffortSetting = q15_saturate(rightMotorEffort);
+    leftMotorEffortApplied = motorSlewStep(leftMotorEffortApplied, leftMotorEffortSetting, motorSlewLimit(leftMotorSlewStep, false));
+    rightMotorEffortApplied = motorSlewStep(rightMotorEffortApplied, rightMotorEffortSetting, motorSlewLimit(rightMotorSlewStep, false));
+    motorOutputBoth(leftMotorEffortApplied, rightMotorEffortApplied);
+    motorTrackRamps();
+    restore_interrupts(irqState);
+}
+
+q15_t motor_get_left_effort_q15(void)
+{
+    return leftMotorEffortSetting;
+}
+
+q15_t motor_get_right_effort_q15(void)
+{
+    return rightMotorEffortSetting;
+}
+
+bool motor_set_pwm_frequency(unsigned long frequency)
+{
+    #if defined(ARDUINO_RASPBERRY_PI_PICO_W)
+    CETALIB_LOG_ERROR("motor: PWM frequency is fixed by the servo signal (%d Hz)", SERVO_PWM_FREQ);
+    return false;
+
+    #elif defined(ARDUINO_SPARKFUN_XRP_CONTROLLER) || defined(ARDUINO_SPARKFUN_XRP_CONTROLLER_BETA)
+    if((frequency < MOTOR_PWM_FREQ_MIN) || (frequency > MOTOR_PWM_FREQ_MAX))
     {
-        leftMotorEffort = -leftMotorEffort;   // make effort a positive quantity
-        reverse = 1;        // preserve the direction
+        CETALIB_LOG_ERROR("motor: PWM frequency %lu Hz out of range (%d to %d Hz)", frequency, MOTOR_PWM_FREQ_MIN, MOTOR_PWM_FREQ_MAX);
+        return false;
     }
+    motorPwmConfigure(frequency);
+    uint32_t irqState = save_and_disable_interrupts();
+    motorOutputBoth(leftMotorEffortApplied, rightMotorEffortApplied);       // same efforts at the new period
+    restore_interrupts(irqState);
+    return true;
+
+    #else
+        #error Unsupported board selection
+    #endif
+}
+
+unsigned long motor_get_pwm_frequency(void)
+{
+    return motorPwmFrequency;
+}
+
+void motor_set_slew_rates(float leftRate, float rightRate)
+{
+    int32_t leftStep = motorSlewRateStep(leftRate);
+    int32_t rightStep = motorSlewRateStep(rightRate);
+    bool limited = (leftStep < MOTOR_SLEW_UNLIMITED) || (rightStep < MOTOR_SLEW_UNLIMITED);
 
-    if(leftMotorEffort > 1)
+    if(limited && !motorSlewRunning)
     {
-        leftMotorEffort = 1;         // clamp at maximum effort
+        motorSlewRunning = add_repeating_timer_ms(-MOTOR_SLEW_INTERVAL, motorSlewCallback, NULL, &motorSlewTimer);
+        if(!motorSlewRunning)
+        {
+            CETALIB_LOG_ERROR("motor: no timer available, slew rates not set");
+            return;
+        }
     }
-    
-    // Update motor direction
-    if(reverse == 0)
+    else if(!limited && motorSlewRunning)
     {
-        leftMotorDir = leftMotorDirFwd;
+        cancel_repeating_timer(&motorSlewTimer);
+        motorSlewRunning = false;
     }
-    else
+
+    // a wheel without a limit jumps to its target now
+    uint32_t irqState = save_and_disable_interrupts();
+    leftMotorSlewStep = leftStep;
+    rightMotorSlewStep = rightStep;
+    leftMotorEffortApplied = motorSlewStep(leftMotorEffortApplied, leftMotorEffortSetting, motorSlewLimit(leftStep, false));
+    rightMotorEffortApplied = motorSlewStep(rightMotorEffortApplied, rightMotorEffortSetting, motorSlewLimit(rightStep, false));
+    motorOutputBoth(leftMotorEffortApplied, rightMotorEffortApplied);
+    motorTrackRamps();
+    restore_interrupts(irqState);
+}
+
+bool motor_set_battery_scaling(float nominalVoltage, float brownoutVoltage)
+{
+    if(nominalVoltage <= 0.0f)
     {
-        leftMotorDir  = (leftMotorDirFwd ^ 1);
+        motorBatteryNominal = 0.0f;
+        motorSlewScale = Q15_ONE;
+        motorStats.slewScale = 1.0f;
+        return true;
     }
-    
+    if((brownoutVoltage <= 0.0f) || (brownoutVoltage >= nominalVoltage))
+    {
+        CETALIB_LOG_ERROR("motor: brownout voltage %.2f V must be between 0 and %.2f V", brownoutVoltage, nominalVoltage);
+        return false;
+    }
+    #if defined(MOTOR_BATTERY_PIN)
+    analogReadResolution(12);
+    motorBatteryBrownout = brownoutVoltage;
+    motorBatteryNominal = nominalVoltage;
+    motorBatteryReadTime = millis() - MOTOR_BATTERY_INTERVAL;   // read at the next tasks() call
+    return true;
+    #else
+    CETALIB_LOG_ERROR("motor: battery scaling is not supported on this board");
+    return false;
+    #endif
+}
+
+void motor_tasks(void)
+{
     #if defined(ARDUINO_RASPBERRY_PI_PICO_W)
-    switch (leftMotorDir)
+    if(motorCalState != MOTOR_CAL_IDLE)
     {
-      case 0:
-        lServo.write(90-(leftMotorEffort*SERVO_RESOLUTION));
-        break;
-      case 1:
-        lServo.write(90+(leftMotorEffort*SERVO_RESOLUTION));
-        break;
-      default:
-        break;
+        motorCalTasks();
     }
-    
-    #elif defined(ARDUINO_SPARKFUN_XRP_CONTROLLER)
-    // Perform DRV8411 "slow decay" PWM control  
-    switch (leftMotorDir)
-    {
-      case 0:
-        digitalWrite(LEFT_MOTOR_IN1_PIN, HIGH);
-        analogWrite(LEFT_MOTOR_IN2_PIN, int((1-leftMotorEffort)*PWM_RESOLUTION));
-        break;
-      case 1:
-        analogWrite(LEFT_MOTOR_IN1_PIN, int((1-leftMotorEffort)*PWM_RESOLUTION));
-        digitalWrite(LEFT_MOTOR_IN2_PIN, HIGH);
-        break;
-      default:
-        break;
+    #endif
+
+    #if defined(MOTOR_BATTERY_PIN)
+    // the ADC is read here rather than in the slew timer, so the reads never
+    // interrupt (and corrupt) an analogRead() of the sketch
+    if((motorBatteryNominal <= 0.0f) || ((millis() - motorBatteryReadTime) < MOTOR_BATTERY_INTERVAL))
+    {
+        return;
     }
-    
-    #elif defined(ARDUINO_SPARKFUN_XRP_CONTROLLER_BETA)
-    digitalWrite(LEFT_MOTOR_DIR_PIN, leftMotorDir);                         // set direction
-    analogWrite(LEFT_MOTOR_SPEED_PIN, (leftMotorEffort*PWM_RESOLUTION));    // set PWM duty value
+    CETALIB_TRACE_BEGIN("motor", "tasks", 0);
+    motorBatteryReadTime = millis();
+    float voltage = motorReadBattery();
+    motorStats.batteryVoltage = voltage;
+    if((motorStats.minBatteryVoltage == 0.0f) || (voltage < motorStats.minBatteryVoltage))
+    {
+        motorStats.minBatteryVoltage = voltage;
+    }
+
+    // count each drop below the brownout voltage once, until the battery recovers
+    if(!motorBrownoutActive && (voltage < motorBatteryBrownout))
+    {
+        motorBrownoutActive = true;
+        motorStats.brownouts++;
+        CETALIB_LOG_WARN("motor: battery brownout (%.2f V)", voltage);
+    }
+    else if(motorBrownoutActive && (voltage > (motorBatteryBrownout + MOTOR_BROWNOUT_HYSTERESIS)))
+    {
+        motorBrownoutActive = false;
+    }
+
+    // full slew rates at the nominal voltage, down to the smallest scale at the brownout voltage
+    float scale = (voltage - motorBatteryBrownout) / (motorBatteryNominal - motorBatteryBrownout);
+    scale = constrain(scale, MOTOR_SLEW_SCALE_MIN, 1.0f);
+    motorSlewScale = q15_from_float(scale);
+    motorStats.slewScale = scale;
+    CETALIB_TRACE_END("motor", "tasks", 0);
+    #endif
+}
+
+MOTOR_STATS* motor_get_stats(void)
+{
+    return &motorStats;
+}
 
+unsigned long motor_get_effort_steps(void)
+{
+    #if defined(ARDUINO_RASPBERRY_PI_PICO_W)
+    // the direction (and motor) with the fewest pulse width steps
+    uint16_t steps = min(min(motorShortSpan[0], motorLongSpan[0]), min(motorShortSpan[1], motorLongSpan[1]));
+    return steps;
+    #elif defined(ARDUINO_SPARKFUN_XRP_CONTROLLER) || defined(ARDUINO_SPARKFUN_XRP_CONTROLLER_BETA)
+    return motorPwmPeriod;
     #else
         #error Unsupported board selection
     #endif
 }
 
-void motor_set_right_effort(float rightMotorEffort)
+#if defined(ARDUINO_RASPBERRY_PI_PICO_W)
+bool motor_calibrate(void)
 {
-    int reverse = 0;
+    if(!motor_start_calibration())
+    {
+        return false;
+    }
+    while (motor_is_calibrating())
+    {
+        board_tasks();
+        motor_tasks();      // runs the calibration routine
+    }
+    return true;
+}
 
-    if(rightMotorEffort < 0)
+bool motor_start_calibration(void)
+{
+    if(motorPwmPeriod == 0)
+    {
+        CETALIB_LOG_ERROR("motor: initialize() must be called before calibrate()");
+        return false;
+    }
+    if(motorCalState != MOTOR_CAL_IDLE)
     {
-        rightMotorEffort = -rightMotorEffort;   // make effort a positive quantity
-        reverse = 1;        // preserve the direction
+        CETALIB_LOG_ERROR("motor: calibration already running");
+        return false;
     }
+    motor_set_efforts_q15(0, 0);
+    analogReadResolution(12);
+    motorNewCal = motorCal;
+    motorCalPulse = MOTOR_ESC_NEUTRAL_PULSE;
+    motorCalNextRequest = false;
+
+    SERIAL_PORT.println("Motor Calibration Routine Triggered. Place the robot on a stand, connect the POT to AN2 and press button to begin.");
+    motorCalState = MOTOR_CAL_WAIT_BEGIN;
+    board_led_pattern(5);
+    return true;
+}
+
+bool motor_is_calibrating(void)
+{
+    return (motorCalState != MOTOR_CAL_IDLE);
+}
 
-    if(rightMotorEffort > 1)
+void motor_calibration_next(void)
+{
+    motorCalNextRequest = true;
+}
+
+void motor_cancel_calibration(void)
+{
+    if(motorCalState == MOTOR_CAL_IDLE)
     {
-        rightMotorEffort = 1;         // clamp at maximum effort
+        return;
     }
-    
-    // Update motor direction
-    if(reverse == 0)
+    motorCalState = MOTOR_CAL_IDLE;
+    board_led_off();
+    // back to the previous pulse widths
+    uint32_t irqState = save_and_disable_interrupts();
+    motorOutputBoth(leftMotorEffortApplied, rightMotorEffortApplied);
+    restore_interrupts(irqState);
+    CETALIB_LOG_WARN("motor: calibration cancelled, previous pulse widths kept");
+}
+
+void motor_clear_calibration(void)
+{
+    // Delete the calibration record, the default pulse widths are used from now on
+    // (saved when the motors are re-calibrated, or by the board "tasks()" function)
+    calstore_clear(CALSTORE_RECORD_MOTOR);
+    for(int wheel = 0; wheel < 2; wheel++)
     {
-        rightMotorDir = rightMotorDirFwd;
+        motorCal.neutral_pulse[wheel] = MOTOR_ESC_NEUTRAL_PULSE;
+        motorCal.deadband[wheel] = MOTOR_ESC_DEADBAND;
+        motorCal.min_pulse[wheel] = MOTOR_ESC_MIN_PULSE;
+        motorCal.max_pulse[wheel] = MOTOR_ESC_MAX_PULSE;
     }
-    else
+    uint32_t irqState = save_and_disable_interrupts();
+    motorPulseUpdateLevels();
+    motorOutputBoth(leftMotorEffortApplied, rightMotorEffortApplied);
+    restore_interrupts(irqState);
+}
+#endif
+
+/*** Private Function Definitions *********************************************/
+
+static int motorDirection(q15_t effort, int dirFwd)
+{
+    if(effort < 0)
     {
-        rightMotorDir  = (rightMotorDirFwd ^ 1);
+        return (dirFwd ^ 1);    // reverse
     }
-    
+    return dirFwd;
+}
+
+// The caller disables interrupts, so the slew timer can not interleave its own update
+static void motorOutputLeft(q15_t effort)
+{
+    leftMotorDir = motorDirection(effort, leftMotorDirFwd);
+
     #if defined(ARDUINO_RASPBERRY_PI_PICO_W)
-    switch (rightMotorDir)
+    pwm_set_chan_level(leftMotorSlice, leftMotorChannel, motorPulseLevel(0, effort, leftMotorDir));
+
+    #elif defined(ARDUINO_SPARKFUN_XRP_CONTROLLER) || defined(ARDUINO_SPARKFUN_XRP_CONTROLLER_BETA)
+    uint16_t pin1Level, pin2Level;
+    motorPwmLevels(effort, leftMotorDir, &pin1Level, &pin2Level);
+    motorPwmWrite(leftMotorSlice, leftMotorSwapped, pin1Level, pin2Level);
+
+    #else
+        #error Unsupported board selection
+    #endif
+}
+
+static void motorOutputRight(q15_t effort)
+{
+    rightMotorDir = motorDirection(effort, rightMotorDirFwd);
+
+    #if defined(ARDUINO_RASPBERRY_PI_PICO_W)
+    pwm_set_chan_level(rightMotorSlice, rightMotorChannel, motorPulseLevel(1, effort, rightMotorDir));
+
+    #elif defined(ARDUINO_SPARKFUN_XRP_CONTROLLER) || defined(ARDUINO_SPARKFUN_XRP_CONTROLLER_BETA)
+    uint16_t pin1Level, pin2Level;
+    motorPwmLevels(effort, rightMotorDir, &pin1Level, &pin2Level);
+    motorPwmWrite(rightMotorSlice, rightMotorSwapped, pin1Level, pin2Level);
+
+    #else
+        #error Unsupported board selection
+    #endif
+}
+
+static void motorOutputBoth(q15_t leftEffort, q15_t rightEffort)
+{
+    #if defined(ARDUINO_RASPBERRY_PI_PICO_W)
+    leftMotorDir = motorDirection(leftEffort, leftMotorDirFwd);
+    rightMotorDir = motorDirection(rightEffort, rightMotorDirFwd);
+    uint16_t leftLevel = motorPulseLevel(0, leftEffort, leftMotorDir);
+    uint16_t rightLevel = motorPulseLevel(1, rightEffort, rightMotorDir);
+
+    // both ESC inputs are channels of the same slice: one write updates both pulses
+    if(leftMotorChannel == PWM_CHAN_A)
     {
-      case 0:
-        rServo.write(90-(rightMotorEffort*SERVO_RESOLUTION));
-        break;
-      case 1:
-        rServo.write(90+(rightMotorEffort*SERVO_RESOLUTION));
-        break;
-      default:
-        break;
+        pwm_set_both_levels(leftMotorSlice, leftLevel, rightLevel);
     }
-    
-    #elif defined(ARDUINO_SPARKFUN_XRP_CONTROLLER)
-    // Perform DRV8411 "slow decay" PWM direction control
-    switch (rightMotorDir)
+    else
     {
-      case 0:
-        digitalWrite(RIGHT_MOTOR_IN1_PIN, HIGH);
-        analogWrite(RIGHT_MOTOR_IN2_PIN, int((1-rightMotorEffort)*PWM_RESOLUTION));
-        break;
-      case 1:
-        analogWrite(RIGHT_MOTOR_IN1_PIN, int((1-rightMotorEffort)*PWM_RESOLUTION));
-        digitalWrite(RIGHT_MOTOR_IN2_PIN, HIGH);
-        break;
-      default:
-        break;
+        pwm_set_both_levels(leftMotorSlice, rightLevel, leftLevel);
     }
 
-    #elif defined(ARDUINO_SPARKFUN_XRP_CONTROLLER_BETA)
-    digitalWrite(RIGHT_MOTOR_DIR_PIN, rightMotorDir);                           // set direction
-    analogWrite(RIGHT_MOTOR_SPEED_PIN, (rightMotorEffort*PWM_RESOLUTION));      // set PWM duty value
-    
+    #elif defined(ARDUINO_SPARKFUN_XRP_CONTROLLER) || defined(ARDUINO_SPARKFUN_XRP_CONTROLLER_BETA)
+    uint16_t left1Level, left2Level, right1Level, right2Level;
+
+    leftMotorDir = motorDirection(leftEffort, leftMotorDirFwd);
+    rightMotorDir = motorDirection(rightEffort, rightMotorDirFwd);
+    motorPwmLevels(leftEffort, leftMotorDir, &left1Level, &left2Level);
+    motorPwmLevels(rightEffort, rightMotorDir, &right1Level, &right2Level);
+
+    // Both slices run in phase and latch new levels at the end of each period.
+    // Write them together, with interrupts off and not just before the counters
+    // wrap, so that both wheels change at the same period boundary.
+    uint32_t irqState = save_and_disable_interrupts();
+    while((motorPwmPeriod > motorPwmWrapGuard) && (pwm_get_counter(leftMotorSlice) >= (motorPwmPeriod - motorPwmWrapGuard)))
+    {
+        // wait for the wrap (at most MOTOR_PWM_WRAP_GUARD CPU clocks)
+    }
+    motorPwmWrite(leftMotorSlice, leftMotorSwapped, left1Level, left2Level);
+    motorPwmWrite(rightMotorSlice, rightMotorSwapped, right1Level, right2Level);
+    restore_interrupts(irqState);
+
     #else
         #error Unsupported board selection
     #endif
+}
 
+// Effort/second to a Q15 step per slew tick, a rate of 0 (or less) is no limit
+static int32_t motorSlewRateStep(float rate)
+{
+    if(rate <= 0.0f)
+    {
+        return MOTOR_SLEW_UNLIMITED;
+    }
+    float step = rate * (32768.0f * MOTOR_SLEW_INTERVAL / 1000.0f);
+    if(step >= MOTOR_SLEW_UNLIMITED)
+    {
+        return MOTOR_SLEW_UNLIMITED;
+    }
+    return (step < 1.0f) ? 1 : (int32_t)lroundf(step);
 }
 
-void motor_set_efforts(float leftMotorEffort, float rightMotorEffort)
+// Between timer ticks a limited wheel may only slow down (step 0); on a tick
+// the step is scaled with the battery voltage, keeping at least 1 LSB
+static int32_t motorSlewLimit(int32_t step, bool timerTick)
+{
+    if(step >= MOTOR_SLEW_UNLIMITED)
+    {
+        return MOTOR_SLEW_UNLIMITED;
+    }
+    if(!timerTick)
+    {
+        return 0;
+    }
+    step = (step * motorSlewScale + Q15_HALF) >> Q15_SHIFT;
+    return (step < 1) ? 1 : step;
+}
+
+static q15_t motorSlewStep(q15_t applied, q15_t target, int32_t step)
+{
+    if((applied > 0 && target < 0) || (applied < 0 && target > 0))
+    {
+        return (step >= MOTOR_SLEW_UNLIMITED) ? target : 0;   // reversal: stop first
+    }
+    if(abs(target) <= abs(applied))
+    {
+        return target;                                         // slowing down is not limited
+    }
+    if(target > applied)
+    {
+        return (target - applied > step) ? (q15_t)(applied + step) : target;
+    }
+    return (applied - target > step) ? (q15_t)(applied - step) : target;
+}
+
+// A ramp starts when the applied effort of a wheel leaves its target, and ends
+// when it reaches the (possibly updated) target
+static void motorTrackRamps(void)
+{
+    bool atTarget[2] = {leftMotorEffortApplied == leftMotorEffortSetting, rightMotorEffortApplied == rightMotorEffortSetting};
+    for(int wheel = 0; wheel < 2; wheel++)
+    {
+        if(!atTarget[wheel] && !motorRampActive[wheel])
+        {
+            motorRampActive[wheel] = true;
+            motorRampStart[wheel] = millis();
+        }
+        else if(atTarget[wheel] && motorRampActive[wheel])
+        {
+            unsigned long rampTime = millis() - motorRampStart[wheel];
+            motorRampActive[wheel] = false;
+            motorStats.ramps[wheel]++;
+            motorStats.lastRampTime[wheel] = rampTime;
+            if(rampTime > motorStats.maxRampTime[wheel])
+            {
+                motorStats.maxRampTime[wheel] = rampTime;
+            }
+        }
+    }
+}
+
+#if defined(MOTOR_BATTERY_PIN)
+static float motorReadBattery(void)
+{
+    #if defined(ARDUINO_RASPBERRY_PI_PICO_W)
+    // GPIO29 is also the clock of the WiFi chip SPI bus. Like the SDK's VSYS
+    // reading, hold the CYW43 driver lock (no WiFi transfer can start) and wake
+    // the chip first. The WiFi driver restores the pin function on its next
+    // transfer. The first conversion after the pin switch reads low, discard it.
+    cyw43_thread_enter();
+    cyw43_arch_gpio_get(CYW43_WL_GPIO_VBUS_PIN);
+    analogRead(MOTOR_BATTERY_PIN);
+    int reading = analogRead(MOTOR_BATTERY_PIN);
+    cyw43_thread_exit();
+    #else
+    int reading = analogRead(MOTOR_BATTERY_PIN);
+    #endif
+    return reading * (MOTOR_BATTERY_DIVIDER * 3.3f / 4096.0f);
+}
+#endif
+
+static bool motorSlewCallback(repeating_timer_t *rt)
 {
-    motor_set_left_effort(leftMotorEffort);
-    motor_set_right_effort(rightMotorEffort);
+    q15_t leftEffort = motorSlewStep(leftMotorEffortApplied, leftMotorEffortSetting, motorSlewLimit(leftMotorSlewStep, true));
+    q15_t rightEffort = motorSlewStep(rightMotorEffortApplied, rightMotorEffortSetting, motorSlewLimit(rightMotorSlewStep, true));
+    if((leftEffort != leftMotorEffortApplied) || (rightEffort != rightMotorEffortApplied))
+    {
+        leftMotorEffortApplied = leftEffort;
+        rightMotorEffortApplied = rightEffort;
+        motorOutputBoth(leftEffort, rightEffort);
+    }
+    motorTrackRamps();
+    return true;
 }
 
+// Program both motor slices for "frequency" with the finest resolution (the
+// smallest integer clock divider that fits the period in the 16-bit counter),
+// then start both counters together so that the slices stay in phase.
+// The motors coast (both outputs low, no ESC pulses on the CETA) until the
+// next effort update.
+static void motorPwmConfigure(unsigned long frequency)
+{
+    uint32_t sysClock = clock_get_hz(clk_sys);
+    uint32_t divider = (sysClock / frequency + MOTOR_PWM_MAX_PERIOD - 1) / MOTOR_PWM_MAX_PERIOD;
+    if(divider < 1)
+    {
+        divider = 1;
+    }
+    uint32_t period = sysClock / (divider * frequency);
+
+    pwm_config config = pwm_get_default_config();
+    pwm_config_set_clkdiv_int(&config, divider);
+    pwm_config_set_wrap(&config, period - 1);
+
+    uint32_t irqState = save_and_disable_interrupts();
+    pwm_init(leftMotorSlice, &config, false);           // stops the slice, counter and levels = 0
+    pwm_init(rightMotorSlice, &config, false);
+    motorPwmPeriod = period;
+    motorPwmClock = sysClock / divider;
+    motorPwmWrapGuard = (MOTOR_PWM_WRAP_GUARD + divider - 1) / divider;
+    motorPwmFrequency = motorPwmClock / period;
+    pwm_set_mask_enabled(pwm_hw->en | (1u << leftMotorSlice) | (1u << rightMotorSlice));
+    restore_interrupts(irqState);
+}
+
+#if defined(ARDUINO_RASPBERRY_PI_PICO_W)
+static uint16_t motorPulseTicks(float pulseWidth)
+{
+    float ticks = pulseWidth * (motorPwmClock / 1000000.0f);
+    return (uint16_t)constrain(lroundf(ticks), 0L, (long)motorPwmPeriod);
+}
+
+// Called with interrupts disabled (or before the slew timer is started)
+static void motorPulseUpdateLevels(void)
+{
+    for(int wheel = 0; wheel < 2; wheel++)
+    {
+        int32_t neutral = motorPulseTicks(motorCal.neutral_pulse[wheel]);
+        int32_t deadband = motorPulseTicks(motorCal.deadband[wheel]);
+        int32_t shortSpan = neutral - deadband - motorPulseTicks(motorCal.min_pulse[wheel]);
+        int32_t longSpan = motorPulseTicks(motorCal.max_pulse[wheel]) - neutral - deadband;
+        motorNeutralLevel[wheel] = neutral;
+        motorDeadbandLevel[wheel] = deadband;
+        motorShortSpan[wheel] = (shortSpan > 0) ? shortSpan : 0;
+        motorLongSpan[wheel] = (longSpan > 0) ? longSpan : 0;
+    }
+}
 
+// Zero effort is the neutral pulse, the smallest effort starts at the edge of
+// the deadband: direction 0 shortens the pulse, direction 1 lengthens it
+static uint16_t motorPulseLevel(int wheel, q15_t effort, int dir)
+{
+    if(effort == 0)
+    {
+        return motorNeutralLevel[wheel];
+    }
+    if(effort < 0)
+    {
+        effort = -effort;   // make effort a positive quantity
+    }
+    if(dir == 0)
+    {
+        return motorNeutralLevel[wheel] - motorDeadbandLevel[wheel] - q15_scale(effort, motorShortSpan[wheel]);
+    }
+    return motorNeutralLevel[wheel] + motorDeadbandLevel[wheel] + q15_scale(effort, motorLongSpan[wheel]);
+}
+
+static void motorCalTasks(void)
+{
+    bool next = board_is_button_pressed() || motorCalNextRequest;
+    motorCalNextRequest = false;
+    switch(motorCalState)
+    {
+        case MOTOR_CAL_WAIT_BEGIN:
+            if(next)
+            {
+                board_led_pattern(1);                       // indicate "MOTOR_CAL_LEFT_NEUTRAL" state
+                motorCalState = MOTOR_CAL_LEFT_NEUTRAL;     // set the left "neutral" pulse
+                SERIAL_PORT.println("Rotate POT until the LEFT wheel stops. Press button when done.");
+            }
+            break;
+        case MOTOR_CAL_LEFT_NEUTRAL:
+            if(next)
+            {
+                motorNewCal.neutral_pulse[0] = motorCalPulse;   // save current setting as "neutral"
+                board_led_pattern(2);                       // indicate "MOTOR_CAL_LEFT_DEADBAND" state
+                motorCalState = MOTOR_CAL_LEFT_DEADBAND;    // set the left deadband
+                SERIAL_PORT.println("Rotate POT from the left end until the LEFT wheel just starts to turn. Press button when done.");
+            }
+            else
+            {
+                motorCalPulse = motorCalPotPulse(MOTOR_ESC_NEUTRAL_PULSE - MOTOR_CAL_NEUTRAL_RANGE, MOTOR_ESC_NEUTRAL_PULSE + MOTOR_CAL_NEUTRAL_RANGE);
+                motorCalPulseWrite(0, motorCalPulse);
+            }
+            break;
+        case MOTOR_CAL_LEFT_DEADBAND:
+            if(next)
+            {
+                motorNewCal.deadband[0] = motorCalPulse - motorNewCal.neutral_pulse[0];
+                motorCalPulseWrite(0, motorNewCal.neutral_pulse[0]);
+                board_led_pattern(3);                       // indicate "MOTOR_CAL_RIGHT_NEUTRAL" state
+                motorCalState = MOTOR_CAL_RIGHT_NEUTRAL;    // set the right "neutral" pulse
+                SERIAL_PORT.println("Rotate POT until the RIGHT wheel stops. Press button when done.");
+            }
+            else
+            {
+                motorCalPulse = motorCalPotPulse(motorNewCal.neutral_pulse[0], motorNewCal.neutral_pulse[0] + MOTOR_CAL_DEADBAND_RANGE);
+                motorCalPulseWrite(0, motorCalPulse);
+            }
+            break;
+        case MOTOR_CAL_RIGHT_NEUTRAL:
+            if(next)
+            {
+                motorNewCal.neutral_pulse[1] = motorCalPulse;   // save current setting as "neutral"
+                board_led_pattern(4);                       // indicate "MOTOR_CAL_RIGHT_DEADBAND" state
+                motorCalState = MOTOR_CAL_RIGHT_DEADBAND;   // set the right deadband
+                SERIAL_PORT.println("Rotate POT from the left end until the RIGHT wheel just starts to turn. Press button when done.");
+            }
+            else
+            {
+                motorCalPulse = motorCalPotPulse(MOTOR_ESC_NEUTRAL_PULSE - MOTOR_CAL_NEUTRAL_RANGE, MOTOR_ESC_NEUTRAL_PULSE + MOTOR_CAL_NEUTRAL_RANGE);
+                motorCalPulseWrite(1, motorCalPulse);
+            }
+            break;
+        case MOTOR_CAL_RIGHT_DEADBAND:
+            if(next)
+            {
+                motorNewCal.deadband[1] = motorCalPulse - motorNewCal.neutral_pulse[1];
+                board_led_off();                            // turn off the led
+                motorCalState = MOTOR_CAL_IDLE;             // terminate calibration
+                SERIAL_PORT.println("Motor Calibration Routine Completed.");
+                motorCalSave();
+            }
+            else
+            {
+                motorCalPulse = motorCalPotPulse(motorNewCal.neutral_pulse[1], motorNewCal.neutral_pulse[1] + MOTOR_CAL_DEADBAND_RANGE);
+                motorCalPulseWrite(1, motorCalPulse);
+            }
+            break;
+        default:
+            motorCalState = MOTOR_CAL_IDLE;
+            board_led_off();
+            break;
+    }
+}
+
+static void motorCalSave(void)
+{
+    // Use and save the new pulse widths (the full effort pulse widths are kept),
+    // the whole record in one commit
+    motorCal = motorNewCal;
+    uint32_t irqState = save_and_disable_interrupts();
+    motorPulseUpdateLevels();
+    motorOutputBoth(leftMotorEffortApplied, rightMotorEffortApplied);
+    restore_interrupts(irqState);
+    calstore_write(CALSTORE_RECORD_MOTOR, &motorCal, sizeof(motorCal));
+    calstore_commit();
+    SERIAL_PORT.printf("Motor Neutral (uS): %.1f/%.1f Deadband (uS): %.1f/%.1f Effort steps: %lu\r\n",
+                       motorCal.neutral_pulse[0], motorCal.neutral_pulse[1], motorCal.deadband[0], motorCal.deadband[1],
+                       motor_get_effort_steps());
+}
+
+static float motorCalPotPulse(float lowPulse, float highPulse)
+{
+    return lowPulse + (highPulse - lowPulse) * board_get_potentiometer() / 4095.0f;
+}
+
+static void motorCalPulseWrite(int wheel, float pulseWidth)
+{
+    uint16_t level = motorPulseTicks(pulseWidth);
+    uint32_t irqState = save_and_disable_interrupts();     // the slew timer also updates the outputs
+    if(wheel == 0)
+    {
+        pwm_set_chan_level(leftMotorSlice, leftMotorChannel, level);
+    }
+    else
+    {
+        pwm_set_chan_level(rightMotorSlice, rightMotorChannel, level);
+    }
+    restore_interrupts(irqState);
+}
+
+#elif defined(ARDUINO_SPARKFUN_XRP_CONTROLLER) || defined(ARDUINO_SPARKFUN_XRP_CONTROLLER_BETA)
+// Compare levels of the two motor pins (IN1/IN2 or DIR/SPEED) for an effort:
+// a level of "motorPwmPeriod" is always high, 0 is always low
+static void motorPwmLevels(q15_t effort, int dir, uint16_t *pin1Level, uint16_t *pin2Level)
+{
+    if(effort < 0)
+    {
+        effort = -effort;   // make effort a positive quantity
+    }
+    uint16_t duty = q15_scale(effort, motorPwmPeriod);
+
+    #if defined(ARDUINO_SPARKFUN_XRP_CONTROLLER)
+    // DRV8411 "slow decay" PWM control: one input high, PWM (low = drive) on the other
+    uint16_t drive = motorPwmPeriod - duty;
+    if(dir == 0)
+    {
+        *pin1Level = motorPwmPeriod;
+        *pin2Level = drive;
+    }
+    else
+    {
+        *pin1Level = drive;
+        *pin2Level = motorPwmPeriod;
+    }
+    #else
+    // DIR pin always low or always high, PWM duty on the SPEED pin
+    *pin1Level = dir ? motorPwmPeriod : 0;
+    *pin2Level = duty;
+    #endif
+}
+
+// One register write sets both channel levels of a slice
+static void motorPwmWrite(uint slice, bool swapped, uint16_t pin1Level, uint16_t pin2Level)
+{
+    if(swapped)
+    {
+        pwm_set_both_levels(slice, pin2Level, pin1Level);
+    }
+    else
+    {
+        pwm_set_both_levels(slice, pin1Level, pin2Level);
+    }
+}
+#endif
@@ -13,6 +13,7 @@
  * 
  * CETA IoT Robot (Schematic #14-00069A/B), based on RPI-Pico-WH
  * (Select Board: "Raspberry Pi Pico W")
+ * Motor controller (ESC) driven with servo pulses from PWM slice 2
  * 
  * Sparkfun XRP Robot Platform (#KIT-27644), based on the RPI RP2350B MCU
  * (Select Board: "SparkFun XRP Controller")
@@ -37,32 +38,83 @@
 #if defined(ARDUINO_RASPBERRY_PI_PICO_W)
   #define LEFT_MOTOR_PWM_PIN 4          // OUTPUT - connected to motor controller "S2" input ("Left" Motor)
   #define RIGHT_MOTOR_PWM_PIN 5         // OUTPUT - connected to motor controller "S1" input ("Right" Motor)
-  #define SERVO_RESOLUTION  90          // 90 possible adjustment steps in servo control signal
+  #define SERVO_PWM_FREQ    50          // Servo control signal frame rate (20 mS)
+  #define MOTOR_ESC_NEUTRAL_PULSE   1500.0f   // Default ESC "stop" pulse width (in uS)
+  #define MOTOR_ESC_DEADBAND        0.0f      // Default pulse width change from neutral before a wheel turns (in uS)
+  #define MOTOR_ESC_MIN_PULSE       1000.0f   // Default full effort pulse width, short pulse direction (in uS)
+  #define MOTOR_ESC_MAX_PULSE       2000.0f   // Default full effort pulse width, long pulse direction (in uS)
+  #define MOTOR_CAL_NEUTRAL_RANGE   150.0f    // Calibration: POT sets neutral to the default +/- this (in uS)
+  #define MOTOR_CAL_DEADBAND_RANGE  150.0f    // Calibration: POT sets the deadband from 0 to this (in uS)
+  #define MOTOR_BATTERY_PIN     A3      // VSYS/3 (ADC3, GPIO29 is also the WiFi chip SPI clock on the Pico W)
+  #define MOTOR_BATTERY_DIVIDER 3.0f    // VSYS = ADC voltage x 3
 #elif defined(ARDUINO_SPARKFUN_XRP_CONTROLLER)
   #define LEFT_MOTOR_IN1_PIN        35      // Left Motor IN1 Pin:    Motor_L_AIN1
   #define LEFT_MOTOR_IN2_PIN        34      // Left Motor IN2 Pin:    Motor_L_AIN2
   #define RIGHT_MOTOR_IN1_PIN       32      // Right Motor IN1 Pin:   Motor_R_BIN1
   #define RIGHT_MOTOR_IN2_PIN       33      // Right Motor IN2 Pin:   Motor_R_BIN2 
-  #define PWM_FREQ        500           // 500 Hz
-  #define PWM_RESOLUTION  1000          // 1000 steps
+  #define PWM_FREQ        500           // Default PWM frequency: 500 Hz
+  // No MOTOR_BATTERY_PIN: the VIN divider is not documented, battery scaling is not supported
 #elif defined(ARDUINO_SPARKFUN_XRP_CONTROLLER_BETA)
   #define LEFT_MOTOR_DIR_PIN      6
   #define LEFT_MOTOR_SPEED_PIN    7
   #define RIGHT_MOTOR_DIR_PIN     14
   #define RIGHT_MOTOR_SPEED_PIN   15 
-  #define PWM_FREQ        500           // 500 Hz
-  #define PWM_RESOLUTION  1000          // 1000 steps
+  #define PWM_FREQ        500           // Default PWM frequency: 500 Hz
+  // No MOTOR_BATTERY_PIN: the VIN divider is not documented, battery scaling is not supported
 #else
   #error Unsupported board selection
 #endif
 
+#define MOTOR_PWM_FREQ_MIN      100       // Lowest PWM frequency (in Hz)
+#define MOTOR_PWM_FREQ_MAX      100000    // Highest PWM frequency (in Hz), at least 1250 PWM steps
+#define MOTOR_PWM_MAX_PERIOD    65535     // Longest PWM period (in PWM counter clocks, 16-bit counter)
+#define MOTOR_PWM_WRAP_GUARD    256       // Time before a counter wrap in which both motor slices are not written (in CPU clocks)
+
+#define MOTOR_SLEW_INTERVAL     5         // Slew timer period (in mS)
+#define MOTOR_SLEW_UNLIMITED    65536     // Slew step with no limit (larger than any Q15 effort change)
+#define MOTOR_SLEW_SCALE_MIN    0.25f     // Smallest battery scale of the slew rates (at the brownout voltage)
+#define MOTOR_BATTERY_INTERVAL  50        // Battery voltage read interval (in mS)
+#define MOTOR_BROWNOUT_HYSTERESIS 0.2f    // Battery recovery above the brownout voltage before the next brownout is counted (in V)
+
 /*** Custom Data Types ********************************************************/
 
+enum MOTOR_CALIBRATION_STATE {MOTOR_CAL_WAIT_BEGIN=0, MOTOR_CAL_LEFT_NEUTRAL, MOTOR_CAL_LEFT_DEADBAND, MOTOR_CAL_RIGHT_NEUTRAL, MOTOR_CAL_RIGHT_DEADBAND, MOTOR_CAL_IDLE};
+
+// ESC pulse widths of each motor ([0] = left, [1] = right, in uS)
+struct MOTOR_CAL
+{
+  float neutral_pulse[2];       // pulse width that stops the motor
+  float deadband[2];            // pulse width change from neutral before the wheel turns
+  float min_pulse[2];           // full effort, short pulse direction
+  float max_pulse[2];           // full effort, long pulse direction
+};
 
 /*** Public Function Prototypes ***********************************************/
 void motor_init(bool left_flip_dir, bool right_flip_dir);  // Initiallize pins & state variables
 void motor_set_left_effort(float leftMotorEffort);
 void motor_set_right_effort(float rightMotorEffort);
 void motor_set_efforts(float leftMotorEffort, float rightMotorEffort);
+float motor_get_left_effort(void);
+float motor_get_right_effort(void);
+void motor_set_left_effort_q15(q15_t leftMotorEffort);
+void motor_set_right_effort_q15(q15_t rightMotorEffort);
+void motor_set_efforts_q15(q15_t leftMotorEffort, q15_t rightMotorEffort);
+q15_t motor_get_left_effort_q15(void);
+q15_t motor_get_right_effort_q15(void);
+bool motor_set_pwm_frequency(unsigned long frequency);
+unsigned long motor_get_pwm_frequency(void);
+void motor_set_slew_rates(float leftRate, float rightRate);
+bool motor_set_battery_scaling(float nominalVoltage, float brownoutVoltage);
+void motor_tasks(void);
+MOTOR_STATS* motor_get_stats(void);
+unsigned long motor_get_effort_steps(void);
+#if defined(ARDUINO_RASPBERRY_PI_PICO_W)
+bool motor_calibrate(void);
+void motor_clear_calibration(void);
+bool motor_start_calibration(void);
+bool motor_is_calibrating(void);
+void motor_calibration_next(void);
+void motor_cancel_calibration(void);
+#endif
 
 #endif /* MOTOR_H_ */
\ No newline at end of file
@@ -30,16 +30,50 @@
 
 /*** Include Files ************************************************************/
 #include <Arduino.h>
+#include "fixedpoint.h"
 
 /*** Macros *******************************************************************/
 
 /*** Custom Data Types ********************************************************/
+typedef struct
+{
+  unsigned long ramps[2];           // number of completed slew ramps ([0] = left, [1] = right)
+  unsigned long lastRampTime[2];    // duration of the most recent ramp (in mS)
+  unsigned long maxRampTime[2];     // longest ramp since boot (in mS)
+  float batteryVoltage;             // most recent battery reading (in V, 0.0 until battery scaling is enabled)
+  float minBatteryVoltage;          // lowest battery reading since boot (in V)
+  unsigned long brownouts;          // number of times the battery dropped below the brownout voltage
+  float slewScale;                  // acceleration limit scale from the battery reading (0.25 to 1.0)
+} MOTOR_STATS;
+
 struct MOTOR_INTERFACE
 {
   void (*initialize)(bool left_flip_dir, bool right_flip_dir);        // Initiallize pins & state variables
   void (*set_left_effort)(float leftMotorEffort);                     // Set left motor effort
   void (*set_right_effort)(float rightMotorEffort);                   // Set right motor effort
   void (*set_efforts)(float leftMotorEffort, float rightMotorEffort);  // Set both motor efforts
+  float (*get_left_effort)(void);                                     // Get the most recent left motor effort
+  float (*get_right_effort)(void);                                    // Get the most recent right motor effort
+  void (*set_left_effort_q15)(q15_t leftMotorEffort);                 // Set left motor effort (Q15)
+  void (*set_right_effort_q15)(q15_t rightMotorEffort);               // Set right motor effort (Q15)
+  void (*set_efforts_q15)(q15_t leftMotorEffort, q15_t rightMotorEffort);  // Set both motor efforts (Q15)
+  q15_t (*get_left_effort_q15)(void);                                 // Get the most recent left motor effort (Q15)
+  q15_t (*get_right_effort_q15)(void);                                // Get the most recent right motor effort (Q15)
+  bool (*set_pwm_frequency)(unsigned long frequency);                 // Set the motor PWM frequency (in Hz, XRP Robots)
+  unsigned long (*get_pwm_frequency)(void);                           // Get the actual motor PWM frequency (in Hz)
+  void (*set_slew_rates)(float leftRate, float rightRate);            // Limit effort increases (effort/second, 0 = no limit)
+  bool (*set_battery_scaling)(float nominalVoltage, float brownoutVoltage);  // Scale the slew rates with the battery voltage (0 = off, CETA only)
+  void (*tasks)(void);                                                // Read the battery voltage, run the ESC calibration (call from the sketch loop)
+  MOTOR_STATS* (*get_stats)(void);                                    // Returns a pointer to the ramp/battery counters
+  unsigned long (*get_effort_steps)(void);                            // Number of output steps from zero to full effort
+#if defined(ARDUINO_RASPBERRY_PI_PICO_W)
+  bool (*calibrate)(void);                                            // Run the ESC pulse width calibration routine (waits until done)
+  void (*clear_calibration)(void);                                    // Delete calibration data (default pulse widths are used)
+  bool (*start_calibration)(void);                                    // Start the ESC calibration routine (does not wait)
+  bool (*is_calibrating)(void);                                       // true while the calibration routine runs
+  void (*calibration_next)(void);                                     // Continue the calibration routine (same as pressing the USER switch)
+  void (*cancel_calibration)(void);                                   // Stop the calibration routine, keep the previous pulse widths
+#endif
 };
 
 /*** Public Function Prototypes ***********************************************/
@@ -40,6 +40,8 @@
 #include <time.h>                   // Required for BearSSL APIs
 #include "mqttc_certs.h"            // broker root CA certificate
 #include "mqttc.h"                  // "mqttc" API declarations
+#include "logger.h"                 // "logger" functions
+#include "trace.h"                  // "trace" event macros
 
 /*** Symbolic Constants used in this module ***********************************/
 #define SERIAL_PORT Serial  // Default to Serial
@@ -49,8 +51,6 @@
 #endif
 /*** Global Variable Declarations *********************************************/
 
-static char mqttcOutBuffer[256];
-
 // mqttc paramters
 
 // WiFi Parameters
@@ -89,11 +89,21 @@ extern const struct MQTTC_INTERFACE MQTTC = {
     .send_message           = &mqttc_send_message,
     .is_message_available   = &mqttc_is_message_available,
     .receive_message        = &mqttc_receive_message,
+    .send_binary            = &mqttc_send_binary,
+    .receive_binary         = &mqttc_receive_binary,
+    .set_qos                = &mqttc_set_qos,
+    .set_ca_cert            = &mqttc_set_ca_cert,
+    .get_stats              = &mqttc_get_stats,
+    .begin                  = &mqttc_begin,
+    .is_connected           = &mqttc_is_connected
 };
 
 // create a structure for reception of messages (topic & payload)
 static struct MQTTC_RECEIVE_MSG mqttcRxMessage;
 
+// message and connection statistics (reset by "connect()")
+static MQTTC_STATS mqttcStats;
+
 // Initialize Socket classes - MQTT Client (for unsecure connections)
 WiFiClient wifiClient;                            // Used for TCP Socket connection
 MqttClient mqttClient(wifiClient);                // Instantiate an MQTT client having WiFiClient methods
@@ -105,12 +115,19 @@ BearSSL::X509List aiocert(adafruitio_root_CA_cert);
 BearSSL::X509List hivemqcert(hivemq_root_CA_cert);
 BearSSL::X509List mosquittocert(mosquitto_root_CA_cert);
 BearSSL::X509List emqxcert(emqx_root_CA_cert);
+BearSSL::X509List *customcert = nullptr;          // Optional root CA supplied via "set_ca_cert()" (e.g. a local test broker)
+static bool useCustomCert = false;
 
 
 // WiFi & TCP Connection Monitoring Variables ("connectionTasks()" function)
 static unsigned long connStatusCurrentSampleTime, connStatusPrevSampleTime;
 static const long connStatusSampleInterval = CONN_STATUS_SAMPLE_INTERVAL;    // Network Connection testing interval
 
+// Non-blocking connection state machine variables ("begin()" function)
+static enum MQTTC_CONNECT_STATE mqttcConnectState = MQTTC_CONNECT_IDLE;
+static unsigned long mqttcConnectStartTime;            // time "begin()" was called (in mS)
+static unsigned long mqttcAttemptTime;                 // time of the most recent WiFi/broker connection attempt (in mS)
+
 /*** Private Function Prototypes **********************************************/
 static void wifiConnect(void);                          // Connect to WiFi access network
 static void mqttClientConnect(void);                    // Connect to the MQTT broker using an unsecure (TCP) connection
@@ -122,6 +139,13 @@ static void mqttsClientOnMessage(int messageSize);      // Call-back function, p
 static void connectionTasks(void);                      // Monitor WiFi and TCP connection and reconnect if required (unsecure connection)
 static void connectionTasksSecure(void);                // Monitor WiFi and TCP connection and reconnect if required (secure connection)
 static void setClock(void);                             // Set time via NTP, as required for x.509 certificate validation
+static bool mqttcSaveConfig(const char *MySSID, const char *MyPass, const char *MQbroker, int MQport,
+                            const char *MQusername, const char *MQpassword, const char *subTopicIDs[],
+                            int size_subTopicIDs);      // Save the connection parameters and subscription topic list
+static void mqttcClientSetup(void);                     // Set the ClientID, Username/Password and receive callback
+static void mqttcSubscribe(void);                       // Subscribe to the topicID for all defined IN messages
+static void mqttsSetTrustAnchors(void);                 // Select the server root CA certificate for the TLS connection
+static void mqttcConnectTasks(void);                    // Run the non-blocking connection state machine
 
 /*** Public Function Definitions **********************************************/
 
@@ -129,94 +153,18 @@ bool mqttc_connect(const char *MySSID, const char *MyPass, const char *MQbroker,
                     const char *MQusername, const char *MQpassword, const char *subTopicIDs[],
                     int size_subTopicIDs)
 {
-  
-  // check if WiFi already in use by "joystick" module
-  if(WiFi.status() == WL_CONNECTED)
-  {
-      SERIAL_PORT.println("WiFi already in use. Cannot start STA");
-      return false;
-  }
-  
-  // Save SSID & Passphrase
-  strcpy(ssid, MySSID);
-  strcpy(passPhrase, MyPass);
-
-  // Save the MQTT broker URL, port, MQTT Username and MQTT Password
-  strcpy(broker, MQbroker);
-  port = MQport;
-  strcpy(userName, MQusername);
-  strcpy(userPass, MQpassword);
+  unsigned long connectStartTime = millis();
 
-  // Enable/Disable TLS connection based on port selection
-  switch(port)
+  if(!mqttcSaveConfig(MySSID, MyPass, MQbroker, MQport, MQusername, MQpassword, subTopicIDs, size_subTopicIDs))
   {
-    case 1883:
-      useTLS = false;
-      break;
-    case 8883:
-      useTLS = true;
-      break;
-    default:
-      useTLS = true;
-      break;
+    return false;
   }
-  
-  #if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_SPARKFUN_XRP_CONTROLLER)
-  // Initialize MQTTC CONNECTION STATUS LED
-  pinMode(MQTTC_STAT_LED_PIN, OUTPUT);     // set digital pin as output
-  digitalWrite(MQTTC_STAT_LED_PIN, 0);     // initialize LED state
-  #endif
 
   // Attempt to connect to Wifi network (blocking code):
   wifiConnect();
 
-  // Create a unique ClientID/Topic Prefix
-  sprintf(clientID, "cetaiotrobot-%02x%02x%02x%02x%02x%02x", macAddr[5], macAddr[4], macAddr[3], macAddr[2], macAddr[1], macAddr[0]);
-  sprintf(mqttcOutBuffer, "clientID: %s\r\n", clientID);
-  SERIAL_PORT.print(mqttcOutBuffer);
-  
-  // Create/Save the subscription topic list if supplied
-  if(!strcmp(subTopicIDs[0], ""))
-  {
-    // NULL string detected, no subscription topics
-    subTopicSize = 0;
-  }
-  else
-  {
-    if(size_subTopicIDs > MAX_SUBSCRIBE_TOPIC_IDS)
-    {
-      SERIAL_PORT.println("Subscription topic list exceeds the limit");
-      return false;
-    }
-    subTopicSize = size_subTopicIDs;
-    for(int i=0; i<subTopicSize; i++)
-    {
-      sprintf(subTopic[i], "%s", subTopicIDs[i]);
-    }
-  }
-  
-  // Set the ClientID
-  if(useTLS)
-  {
-    mqttsClient.setId(clientID);
-  }
-  else
-  {
-    mqttClient.setId(clientID);
-  }
-  
-  // Set the MQTT Username & Password if defined
-  if((userName[0] != '\0') && (userPass[0] != '\0'))
-  {
-    if(useTLS)
-    {
-      mqttsClient.setUsernamePassword(userName, userPass);
-    }
-    else
-    {
-      mqttClient.setUsernamePassword(userName, userPass);
-    }
-  }
+  // Set the ClientID, Username/Password and receive callback
+  mqttcClientSetup();
 
   // Attempt to connect to Broker (blocking code)
   if(useTLS)
@@ -228,36 +176,8 @@ bool mqttc_connect(const char *MySSID, const char *MyPass, const char *MQbroker,
     mqttClientConnect();
   }
 
-  // Set the MQTT subscription receive callback
-  if(useTLS)
-  {
-    mqttsClient.onMessage(mqttsClientOnMessage);
-  }
-  else
-  {
-    mqttClient.onMessage(mqttClientOnMessage);
-  }
-
   // Subscribe to the topicID for all defined IN messages
-  if(subTopicSize)
-  {
-    for(int i=0; i < subTopicSize; i++)
-    {
-      SERIAL_PORT.print("Subscribing to topic: ");
-      SERIAL_PORT.println(subTopic[i]);
-      if(useTLS)
-      {
-        mqttsClient.subscribe(subTopic[i], subQoS);
-      }
-      else
-      {
-        mqttClient.subscribe(subTopic[i], subQoS);
-      }
-      SERIAL_PORT.print("Waiting for messages on topic: ");
-      SERIAL_PORT.println(subTopic[i]);
-      SERIAL_PORT.println();
-    }
-  }
+  mqttcSubscribe();
 
   #if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_SPARKFUN_XRP_CONTROLLER)
   // if you get here, you are connected and ready to go!
@@ -267,12 +187,44 @@ bool mqttc_connect(const char *MySSID, const char *MyPass, const char *MQbroker,
   // Initialize timeout for connectTasks()
   connStatusPrevSampleTime = 0;
 
+  // Start a fresh set of statistics for this connection
+  memset(&mqttcStats, 0, sizeof(mqttcStats));
+  mqttcStats.lastConnectTime = millis() - connectStartTime;
+  mqttcConnectState = MQTTC_CONNECT_CONNECTED;
+
+  return true;
+
+}
+
+bool mqttc_begin(const char *MySSID, const char *MyPass, const char *MQbroker, int MQport,
+                 const char *MQusername, const char *MQpassword, const char *subTopicIDs[],
+                 int size_subTopicIDs)
+{
+  mqttcConnectStartTime = millis();
+
+  if(!mqttcSaveConfig(MySSID, MyPass, MQbroker, MQport, MQusername, MQpassword, subTopicIDs, size_subTopicIDs))
+  {
+    return false;
+  }
+
+  // Start the WiFi association, "tasks()" completes the connection
+  CETALIB_LOG_INFO("Attempting to connect to WPA SSID: %s", ssid);
+  WiFi.beginNoBlock(ssid, passPhrase);
+  mqttcAttemptTime = millis();
+  mqttcConnectState = MQTTC_CONNECT_WIFI;
   return true;
+}
 
+bool mqttc_is_connected(void)
+{
+  return (mqttcConnectState == MQTTC_CONNECT_CONNECTED);
 }
 
 void mqttc_disconnect(void)
 {
+  // an explicit disconnect is final: tasks() does not reconnect from IDLE,
+  // call begin() (or connect()) again to reconnect
+  mqttcConnectState = MQTTC_CONNECT_IDLE;
   if(useTLS)
   {
     mqttsClientDisconnect();
@@ -285,6 +237,15 @@ void mqttc_disconnect(void)
 
 void mqttc_tasks(void)
 {
+  // Complete a connection started by "begin()"
+  CETALIB_TRACE_BEGIN("mqttc", "tasks", mqttcConnectState);
+  if(mqttcConnectState != MQTTC_CONNECT_CONNECTED)
+  {
+    mqttcConnectTasks();
+    CETALIB_TRACE_END("mqttc", "tasks", 0);
+    return;
+  }
+
   // Check WiFi & TCP connection status and reconnect if neccesary
   if(useTLS)
   {
@@ -297,6 +258,7 @@ void mqttc_tasks(void)
 
   // Call poll() regularly to allow the MqttClientLibrary to receive MQTT messages
   // and sens MQTT keep alive messages which avoids being disconnected by the broker
+  CETALIB_TRACE_BEGIN("mqttc", "poll", 0);
   if(useTLS)
   {
     mqttsClient.poll();
@@ -305,26 +267,29 @@ void mqttc_tasks(void)
   {
     mqttClient.poll();
   }
+  CETALIB_TRACE_END("mqttc", "poll", 0);
+  CETALIB_TRACE_END("mqttc", "tasks", 0);
 }
 
 void mqttc_send_message(const char *pubTopic, char *jsonPubPayload)
 {
+  CETALIB_TRACE_BEGIN("mqttc", "publish", strlen(jsonPubPayload));
   if(useTLS)
   {
     mqttsClient.beginMessage(pubTopic, strlen(jsonPubPayload), retained, pubQoS, dup);
     mqttsClient.print(jsonPubPayload);
     mqttsClient.endMessage();
-    //sprintf(mqttcOutBuffer, "pub topic: %s\tpayload: %s\r\n", outTopic, jsonPubPayload);
-    //SERIAL_PORT.print(mqttcOutBuffer);
   }
   else
   {
     mqttClient.beginMessage(pubTopic, strlen(jsonPubPayload), retained, pubQoS, dup);
     mqttClient.print(jsonPubPayload);
     mqttClient.endMessage();
-    //sprintf(mqttcOutBuffer, "pub topic: %s\tpayload: %s\r\n", outTopic, jsonPubPayload);
-    //SERIAL_PORT.print(mqttcOutBuffer);
   }
+  CETALIB_TRACE_END("mqttc", "publish", pubQoS);
+  mqttcStats.messagesSent++;
+  mqttcStats.bytesSent += strlen(jsonPubPayload);
+  CETALIB_LOG_DEBUG("pub topic: %s\tpayload: %s", pubTopic, jsonPubPayload);
 }
 
 int mqttc_is_message_available(const char *subTopic)
@@ -345,9 +310,76 @@ char* mqttc_receive_message(void)
   strcpy(temp, mqttcRxMessage.inPayload);
   memset(mqttcRxMessage.inTopic, '\0', sizeof(mqttcRxMessage.inTopic));
   memset(mqttcRxMessage.inPayload, '\0', sizeof(mqttcRxMessage.inPayload));
+  mqttcRxMessage.inPayloadLength = 0;
   return temp;
 }
 
+void mqttc_send_binary(const char *pubTopic, const uint8_t *payload, int length)
+{
+  // payload length is supplied by the caller, binary payloads may contain '\0' bytes
+  CETALIB_TRACE_BEGIN("mqttc", "publish", length);
+  if(useTLS)
+  {
+    mqttsClient.beginMessage(pubTopic, length, retained, pubQoS, dup);
+    mqttsClient.write(payload, length);
+    mqttsClient.endMessage();
+  }
+  else
+  {
+    mqttClient.beginMessage(pubTopic, length, retained, pubQoS, dup);
+    mqttClient.write(payload, length);
+    mqttClient.endMessage();
+  }
+  CETALIB_TRACE_END("mqttc", "publish", pubQoS);
+  mqttcStats.messagesSent++;
+  mqttcStats.bytesSent += length;
+}
+
+int mqttc_receive_binary(uint8_t *buf, int bufSize)
+{
+  // a binary payload cut short (e.g. a cbor record) can not be decoded: reject it
+  int length = mqttcRxMessage.inPayloadLength;
+  if(mqttcRxMessage.inPayloadTruncated || (length > bufSize))
+  {
+    CETALIB_LOG_ERROR("mqttc: binary payload larger than %d bytes rejected",
+                      mqttcRxMessage.inPayloadTruncated ? (int)(sizeof(mqttcRxMessage.inPayload) - 1) : bufSize);
+    length = 0;
+  }
+  memcpy(buf, mqttcRxMessage.inPayload, length);
+  memset(mqttcRxMessage.inTopic, '\0', sizeof(mqttcRxMessage.inTopic));
+  memset(mqttcRxMessage.inPayload, '\0', sizeof(mqttcRxMessage.inPayload));
+  mqttcRxMessage.inPayloadLength = 0;
+  mqttcRxMessage.inPayloadTruncated = false;
+  return length;
+}
+
+void mqttc_set_qos(int publishQoS, int subscribeQoS)
+{
+  // only QoS levels 0 (at most once) and 1 (at least once) are supported
+  pubQoS = constrain(publishQoS, 0, 1);
+  subQoS = constrain(subscribeQoS, 0, 1);
+}
+
+void mqttc_set_ca_cert(const char *rootCACert)
+{
+  // takes priority over the built-in broker certificates on the next secure connection.
+  // The list is rebuilt on each call, so reconfiguring the broker replaces the previous
+  // certificate instead of appending to it (X509List cannot be cleared). NULL removes it.
+  delete customcert;
+  customcert = nullptr;
+  useCustomCert = false;
+  if(rootCACert != NULL)
+  {
+    customcert = new BearSSL::X509List(rootCACert);
+    useCustomCert = true;
+  }
+}
+
+MQTTC_STATS* mqttc_get_stats(void)
+{
+  return &mqttcStats;
+}
+
 /*** Private Function Definitions *********************************************/
 
 void wifiConnect(void){
@@ -355,11 +387,12 @@ void wifiConnect(void){
     #if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_SPARKFUN_XRP_CONTROLLER)
     digitalWrite(MQTTC_STAT_LED_PIN, 0);
     #endif
-    SERIAL_PORT.print("\nAttempting to connect to WPA SSID: ");
-    SERIAL_PORT.println(ssid);
+    CETALIB_LOG_INFO("Attempting to connect to WPA SSID: %s", ssid);
+    CETALIB_TRACE_BEGIN("mqttc", "wifiConnect", 0);
     while (WiFi.begin(ssid, passPhrase) != WL_CONNECTED) {
         // failed, retry
-        SERIAL_PORT.print(".");
+        CETALIB_LOG_DEBUG("WiFi connection failed, retrying");
+        logger_tasks();
         delay(1000);
         #if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_SPARKFUN_XRP_CONTROLLER)
         digitalWrite(MQTTC_STAT_LED_PIN, 1);
@@ -369,9 +402,11 @@ void wifiConnect(void){
         #endif
     }
 
+    CETALIB_TRACE_END("mqttc", "wifiConnect", 0);
+
     // once you are connected :
     WiFi.macAddress(macAddr);     // read/save the mac address of the radio
-    SERIAL_PORT.println("You're connected to the network");
+    CETALIB_LOG_INFO("You're connected to the network");
 }
 
 void mqttClientConnect(void){
@@ -379,11 +414,12 @@ void mqttClientConnect(void){
     #if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_SPARKFUN_XRP_CONTROLLER)
     digitalWrite(MQTTC_STAT_LED_PIN, 0);
     #endif
-    SERIAL_PORT.print("\nAttempting to connect to the MQTT broker: ");
-    SERIAL_PORT.println(broker);
+    CETALIB_LOG_INFO("Attempting to connect to the MQTT broker: %s", broker);
+    CETALIB_TRACE_BEGIN("mqttc", "brokerConnect", port);
     while(!mqttClient.connect(broker, port)){
         // failed, retry
-        SERIAL_PORT.print(".");
+        CETALIB_LOG_DEBUG("Broker connection failed, retrying");
+        logger_tasks();
         delay(500);
         #if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_SPARKFUN_XRP_CONTROLLER)
         digitalWrite(MQTTC_STAT_LED_PIN, 1);
@@ -396,10 +432,10 @@ void mqttClientConnect(void){
         delay(100);
         #endif
     }
+    CETALIB_TRACE_END("mqttc", "brokerConnect", 1);
 
     // once you are connected :
-    SERIAL_PORT.println("You're connected to the MQTT broker!");
-    SERIAL_PORT.println();
+    CETALIB_LOG_INFO("You're connected to the MQTT broker!");
 
 }
 
@@ -421,31 +457,15 @@ void mqttsClientConnect(void){
     #if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_SPARKFUN_XRP_CONTROLLER)
     digitalWrite(MQTTC_STAT_LED_PIN, 0);
     #endif
-    SERIAL_PORT.print("\nAttempting to connect to the MQTT broker: ");
-    SERIAL_PORT.println(broker);
+    CETALIB_LOG_INFO("Attempting to connect to the MQTT broker: %s", broker);
     // Select the correct server root CA certificate to use for the TLS connection
-    if(strstr(broker, "adafruit"))
-    {
-      secureWifiClient.setTrustAnchors(&aiocert);
-    }
-    else if(strstr(broker, "hivemq"))
-    {
-      secureWifiClient.setTrustAnchors(&hivemqcert);
-    }
-    else if(strstr(broker, "emqx"))
-    {
-      secureWifiClient.setTrustAnchors(&emqxcert);
-    }
-    else
-    {
-      // unsupported broker, use mosquitto certificate (connection will fail)
-      secureWifiClient.setTrustAnchors(&mosquittocert);
-    }
-    //secureWifiClient.setTrustAnchors(&cert);
+    mqttsSetTrustAnchors();
     setClock();
+    CETALIB_TRACE_BEGIN("mqttc", "brokerConnect", port);
     while(!mqttsClient.connect(broker, port)){
         // failed, retry
-        SERIAL_PORT.print(".");
+        CETALIB_LOG_DEBUG("Broker connection failed, retrying");
+        logger_tasks();
         delay(500);
         #if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_SPARKFUN_XRP_CONTROLLER)
         digitalWrite(MQTTC_STAT_LED_PIN, 1);
@@ -458,10 +478,10 @@ void mqttsClientConnect(void){
         delay(100);
         #endif
     }
+    CETALIB_TRACE_END("mqttc", "brokerConnect", 1);
 
     // once you are connected :
-    SERIAL_PORT.println("You're connected to the MQTT broker!");
-    SERIAL_PORT.println();
+    CETALIB_LOG_INFO("You're connected to the MQTT broker!");
 
 }
 
@@ -481,16 +501,16 @@ void mqttsClientDisconnect(void)
 // Set time via NTP, as required for x.509 validation
 void setClock() {
   NTP.begin("pool.ntp.org", "time.nist.gov");
-  SERIAL_PORT.print("Waiting for NTP time sync: ");
+  CETALIB_LOG_INFO("Waiting for NTP time sync");
+  CETALIB_TRACE_BEGIN("mqttc", "ntpWait", 0);
   NTP.waitSet([]() {
-    SERIAL_PORT.print(".");
+    logger_tasks();
   });
-  SERIAL_PORT.println("");
+  CETALIB_TRACE_END("mqttc", "ntpWait", 0);
   time_t now = time(nullptr);
   struct tm timeinfo;
   gmtime_r(&now, &timeinfo);
-  SERIAL_PORT.print("Current time: ");
-  SERIAL_PORT.print(asctime(&timeinfo));
+  CETALIB_LOG_INFO("Current time: %s", asctime(&timeinfo));
 }
 
 void mqttClientOnMessage(int messageSize) {
@@ -502,14 +522,27 @@ void mqttClientOnMessage(int messageSize) {
     inTopic.toCharArray(mqttcRxMessage.inTopic, sizeof(mqttcRxMessage.inTopic));
     
     // use the Stream interface to save the contents to a char buffer
+    // (leave room for the '\0' terminator used by receive_message())
     i = 0;
+    mqttcRxMessage.inPayloadTruncated = false;
     while (mqttClient.available()) {
-        mqttcRxMessage.inPayload[i++] = (char)mqttClient.read();
+        if(i < (int)(sizeof(mqttcRxMessage.inPayload) - 1))
+        {
+            mqttcRxMessage.inPayload[i++] = (char)mqttClient.read();
+        }
+        else
+        {
+            mqttClient.read();     // discard bytes that do not fit
+            mqttcRxMessage.inPayloadTruncated = true;
+        }
     }
     mqttcRxMessage.inPayload[i] = '\0';
+    mqttcRxMessage.inPayloadLength = i;
+    mqttcStats.messagesReceived++;
+    mqttcStats.bytesReceived += messageSize;
+    CETALIB_TRACE_INSTANT("mqttc", "message", messageSize);
 
-    //sprintf(mqttcOutBuffer, "sub topic: %s\tpayload: %s\r\n", mqttcRxMessage.inTopic, mqttcRxMessage.inPayload);
-    //SERIAL_PORT.print(mqttcOutBuffer);
+    CETALIB_LOG_DEBUG("sub topic: %s\tpayload length: %d", mqttcRxMessage.inTopic, messageSize);
 }
 
 void mqttsClientOnMessage(int messageSize) {
@@ -521,14 +554,27 @@ void mqttsClientOnMessage(int messageSize) {
     inTopic.toCharArray(mqttcRxMessage.inTopic, sizeof(mqttcRxMessage.inTopic));
     
     // use the Stream interface to save the contents to a char buffer
+    // (leave room for the '\0' terminator used by receive_message())
     i = 0;
+    mqttcRxMessage.inPayloadTruncated = false;
     while (mqttsClient.available()) {
-        mqttcRxMessage.inPayload[i++] = (char)mqttsClient.read();
+        if(i < (int)(sizeof(mqttcRxMessage.inPayload) - 1))
+        {
+            mqttcRxMessage.inPayload[i++] = (char)mqttsClient.read();
+        }
+        else
+        {
+            mqttsClient.read();     // discard bytes that do not fit
+            mqttcRxMessage.inPayloadTruncated = true;
+        }
     }
     mqttcRxMessage.inPayload[i] = '\0';
+    mqttcRxMessage.inPayloadLength = i;
+    mqttcStats.messagesReceived++;
+    mqttcStats.bytesReceived += messageSize;
+    CETALIB_TRACE_INSTANT("mqttc", "message", messageSize);
 
-    //sprintf(mqttcOutBuffer, "sub topic: %s\tpayload: %s\r\n", mqttcRxMessage.inTopic, mqttcRxMessage.inPayload);
-    //SERIAL_PORT.print(mqttcOutBuffer);
+    CETALIB_LOG_DEBUG("sub topic: %s\tpayload length: %d", mqttcRxMessage.inTopic, messageSize);
 }
 
 void connectionTasks(void)
@@ -538,9 +584,10 @@ void connectionTasks(void)
   if ((connStatusCurrentSampleTime - connStatusPrevSampleTime) >= connStatusSampleInterval)
   {
     connStatusPrevSampleTime = connStatusCurrentSampleTime;
+    unsigned long reconnectStartTime = millis();
     if(WiFi.status() == WL_CONNECTED)
     {
-      SERIAL_PORT.println("WiFi Status: connected");
+      CETALIB_LOG_DEBUG("WiFi Status: connected");
       if(!mqttClient.connected())
       {
         #if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_SPARKFUN_XRP_CONTROLLER)
@@ -548,7 +595,7 @@ void connectionTasks(void)
         #endif
         mqttClient.flush();
         mqttClient.stop();
-        SERIAL_PORT.println("TCP Status: disconnected..attempting to reconnect");
+        CETALIB_LOG_WARN("TCP Status: disconnected..attempting to reconnect");
         // reconnect to the broker, using the same MQTT Client initialization as in mqttc_connect()..
         mqttClient.setId(clientID);
         mqttClientConnect();
@@ -558,15 +605,13 @@ void connectionTasks(void)
         {
           for(int i=0; i < subTopicSize; i++)
           {
-            SERIAL_PORT.print("Subscribing to topic: ");
-            SERIAL_PORT.println(subTopic[i]);
+            CETALIB_LOG_INFO("Subscribing to topic: %s", subTopic[i]);
             mqttClient.subscribe(subTopic[i], subQoS);
-            SERIAL_PORT.print("Waiting for messages on topic: ");
-            SERIAL_PORT.println(subTopic[i]);
-            SERIAL_PORT.println();
           }
         }
         
+        mqttcStats.reconnects++;
+        mqttcStats.lastConnectTime = millis() - reconnectStartTime;
         connStatusPrevSampleTime = 0;
         #if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_SPARKFUN_XRP_CONTROLLER)
         digitalWrite(MQTTC_STAT_LED_PIN, 1);       // turn on CONNECT status LED
@@ -574,12 +619,12 @@ void connectionTasks(void)
       }
       else
       {
-        SERIAL_PORT.println("TCP Status: connected");
+        CETALIB_LOG_DEBUG("TCP Status: connected");
       }
     }
     else
     {
-      SERIAL_PORT.println("WiFi Status: disconnected..attempting to reconnect WiFi annd TCP");
+      CETALIB_LOG_WARN("WiFi Status: disconnected..attempting to reconnect WiFi and TCP");
       mqttClient.flush();
       mqttClient.stop();
       wifiConnect();
@@ -590,15 +635,13 @@ void connectionTasks(void)
       {
         for(int i=0; i < subTopicSize; i++)
         {
-          SERIAL_PORT.print("Subscribing to topic: ");
-          SERIAL_PORT.println(subTopic[i]);
+          CETALIB_LOG_INFO("Subscribing to topic: %s", subTopic[i]);
           mqttClient.subscribe(subTopic[i], subQoS);
-          SERIAL_PORT.print("Waiting for messages on topic: ");
-          SERIAL_PORT.println(subTopic[i]);
-          SERIAL_PORT.println();
         }
       }
       
+      mqttcStats.reconnects++;
+      mqttcStats.lastConnectTime = millis() - reconnectStartTime;
       connStatusPrevSampleTime = 0;
       #if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_SPARKFUN_XRP_CONTROLLER)
       digitalWrite(MQTTC_STAT_LED_PIN, 1);
@@ -614,9 +657,10 @@ void connectionTasksSecure(void)
   if ((connStatusCurrentSampleTime - connStatusPrevSampleTime) >= connStatusSampleInterval)
   {
     connStatusPrevSampleTime = connStatusCurrentSampleTime;
+    unsigned long reconnectStartTime = millis();
     if(WiFi.status() == WL_CONNECTED)
     {
-      SERIAL_PORT.println("WiFi Status: connected");
+      CETALIB_LOG_DEBUG("WiFi Status: connected");
       if(!mqttsClient.connected())
       {
         #if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_SPARKFUN_XRP_CONTROLLER)
@@ -624,7 +668,7 @@ void connectionTasksSecure(void)
         #endif
         mqttsClient.flush();
         mqttsClient.stop();
-        SERIAL_PORT.println("TCP Status: disconnected..attempting to reconnect");
+        CETALIB_LOG_WARN("TCP Status: disconnected..attempting to reconnect");
         // reconnect to the broker, using the same MQTT Client initialization as in mqttc_connect()..
         mqttsClient.setId(clientID);
         mqttsClientConnect();
@@ -634,15 +678,13 @@ void connectionTasksSecure(void)
         {
           for(int i=0; i < subTopicSize; i++)
           {
-            SERIAL_PORT.print("Subscribing to topic: ");
-            SERIAL_PORT.println(subTopic[i]);
+            CETALIB_LOG_INFO("Subscribing to topic: %s", subTopic[i]);
             mqttsClient.subscribe(subTopic[i], subQoS);
-            SERIAL_PORT.print("Waiting for messages on topic: ");
-            SERIAL_PORT.println(subTopic[i]);
-            SERIAL_PORT.println();
           }
         }
         
+        mqttcStats.reconnects++;
+        mqttcStats.lastConnectTime = millis() - reconnectStartTime;
         connStatusPrevSampleTime = 0;
         #if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_SPARKFUN_XRP_CONTROLLER)
         digitalWrite(MQTTC_STAT_LED_PIN, 1);       // turn on CONNECT status LED
@@ -650,12 +692,12 @@ void connectionTasksSecure(void)
       }
       else
       {
-        SERIAL_PORT.println("TCP Status: connected");
+        CETALIB_LOG_DEBUG("TCP Status: connected");
       }
     }
     else
     {
-      SERIAL_PORT.println("WiFi Status: disconnected..attempting to reconnect WiFi annd TCP");
+      CETALIB_LOG_WARN("WiFi Status: disconnected..attempting to reconnect WiFi and TCP");
       mqttsClient.flush();
       mqttsClient.stop();
       wifiConnect();
@@ -666,19 +708,237 @@ void connectionTasksSecure(void)
       {
         for(int i=0; i < subTopicSize; i++)
         {
-          SERIAL_PORT.print("Subscribing to topic: ");
-          SERIAL_PORT.println(subTopic[i]);
+          CETALIB_LOG_INFO("Subscribing to topic: %s", subTopic[i]);
           mqttsClient.subscribe(subTopic[i], subQoS);
-          SERIAL_PORT.print("Waiting for messages on topic: ");
-          SERIAL_PORT.println(subTopic[i]);
-          SERIAL_PORT.println();
         }
       }
       
+      mqttcStats.reconnects++;
+      mqttcStats.lastConnectTime = millis() - reconnectStartTime;
       connStatusPrevSampleTime = 0;
       #if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_SPARKFUN_XRP_CONTROLLER)
       digitalWrite(MQTTC_STAT_LED_PIN, 1);
       #endif
     }
   }
-}
\ No newline at end of file
+}
+
+static bool mqttcSaveConfig(const char *MySSID, const char *MyPass, const char *MQbroker, int MQport,
+                            const char *MQusername, const char *MQpassword, const char *subTopicIDs[],
+                            int size_subTopicIDs)
+{
+  // check if WiFi already in use by "joystick" module
+  if(WiFi.status() == WL_CONNECTED)
+  {
+      CETALIB_LOG_ERROR("WiFi already in use. Cannot start STA");
+      return false;
+  }
+  
+  // Save SSID & Passphrase
+  strcpy(ssid, MySSID);
+  strcpy(passPhrase, MyPass);
+
+  // Save the MQTT broker URL, port, MQTT Username and MQTT Password
+  strcpy(broker, MQbroker);
+  port = MQport;
+  strcpy(userName, MQusername);
+  strcpy(userPass, MQpassword);
+
+  // Enable/Disable TLS connection based on port selection
+  switch(port)
+  {
+    case 1883:
+      useTLS = false;
+      break;
+    case 8883:
+      useTLS = true;
+      break;
+    default:
+      useTLS = true;
+      break;
+  }
+
+  // Create/Save the subscription topic list if supplied
+  if(!strcmp(subTopicIDs[0], ""))
+  {
+    // NULL string detected, no subscription topics
+    subTopicSize = 0;
+  }
+  else
+  {
+    if(size_subTopicIDs > MAX_SUBSCRIBE_TOPIC_IDS)
+    {
+      CETALIB_LOG_ERROR("Subscription topic list exceeds the limit");
+      return false;
+    }
+    subTopicSize = size_subTopicIDs;
+    for(int i=0; i<subTopicSize; i++)
+    {
+      sprintf(subTopic[i], "%s", subTopicIDs[i]);
+    }
+  }
+  
+  #if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_SPARKFUN_XRP_CONTROLLER)
+  // Initialize MQTTC CONNECTION STATUS LED
+  pinMode(MQTTC_STAT_LED_PIN, OUTPUT);     // set digital pin as output
+  digitalWrite(MQTTC_STAT_LED_PIN, 0);     // initialize LED state
+  #endif
+
+  return true;
+}
+
+static void mqttcClientSetup(void)
+{
+  // Create a unique ClientID/Topic Prefix
+  sprintf(clientID, "cetaiotrobot-%02x%02x%02x%02x%02x%02x", macAddr[5], macAddr[4], macAddr[3], macAddr[2], macAddr[1], macAddr[0]);
+  CETALIB_LOG_INFO("clientID: %s", clientID);
+
+  // Set the ClientID
+  if(useTLS)
+  {
+    mqttsClient.setId(clientID);
+  }
+  else
+  {
+    mqttClient.setId(clientID);
+  }
+  
+  // Set the MQTT Username & Password if defined
+  if((userName[0] != '\0') && (userPass[0] != '\0'))
+  {
+    if(useTLS)
+    {
+      mqttsClient.setUsernamePassword(userName, userPass);
+    }
+    else
+    {
+      mqttClient.setUsernamePassword(userName, userPass);
+    }
+  }
+
+  // Set the MQTT subscription receive callback
+  if(useTLS)
+  {
+    mqttsClient.onMessage(mqttsClientOnMessage);
+  }
+  else
+  {
+    mqttClient.onMessage(mqttClientOnMessage);
+  }
+}
+
+static void mqttcSubscribe(void)
+{
+  if(subTopicSize)
+  {
+    for(int i=0; i < subTopicSize; i++)
+    {
+      CETALIB_LOG_INFO("Subscribing to topic: %s", subTopic[i]);
+      if(useTLS)
+      {
+        mqttsClient.subscribe(subTopic[i], subQoS);
+      }
+      else
+      {
+        mqttClient.subscribe(subTopic[i], subQoS);
+      }
+    }
+  }
+}
+
+static void mqttsSetTrustAnchors(void)
+{
+  if(useCustomCert)
+  {
+    secureWifiClient.setTrustAnchors(customcert);
+  }
+  else if(strstr(broker, "adafruit"))
+  {
+    secureWifiClient.setTrustAnchors(&aiocert);
+  }
+  else if(strstr(broker, "hivemq"))
+  {
+    secureWifiClient.setTrustAnchors(&hivemqcert);
+  }
+  else if(strstr(broker, "emqx"))
+  {
+    secureWifiClient.setTrustAnchors(&emqxcert);
+  }
+  else
+  {
+    // unsupported broker, use mosquitto certificate (connection will fail)
+    secureWifiClient.setTrustAnchors(&mosquittocert);
+  }
+}
+
+static void mqttcConnectTasks(void)
+{
+  unsigned long now = millis();
+  switch(mqttcConnectState)
+  {
+    case MQTTC_CONNECT_WIFI:
+      if(WiFi.status() == WL_CONNECTED)
+      {
+        WiFi.macAddress(macAddr);     // read/save the mac address of the radio
+        CETALIB_LOG_INFO("You're connected to the network");
+        mqttcClientSetup();
+        if(useTLS)
+        {
+          // x.509 certificate validation needs the time, start NTP and wait for it below
+          mqttsSetTrustAnchors();
+          NTP.begin("pool.ntp.org", "time.nist.gov");
+          CETALIB_LOG_INFO("Waiting for NTP time sync");
+          mqttcConnectState = MQTTC_CONNECT_NTP;
+        }
+        else
+        {
+          mqttcConnectState = MQTTC_CONNECT_BROKER;
+        }
+        mqttcAttemptTime = now - MQTTC_BROKER_RETRY_INTERVAL;
+        CETALIB_LOG_INFO("Attempting to connect to the MQTT broker: %s", broker);
+      }
+      else if((now - mqttcAttemptTime) >= MQTTC_WIFI_RETRY_INTERVAL)
+      {
+        // association timed out, retry
+        CETALIB_LOG_DEBUG("WiFi connection failed, retrying");
+        WiFi.beginNoBlock(ssid, passPhrase);
+        mqttcAttemptTime = now;
+      }
+      break;
+
+    case MQTTC_CONNECT_NTP:
+      if(time(nullptr) >= MQTTC_NTP_VALID_TIME)
+      {
+        mqttcConnectState = MQTTC_CONNECT_BROKER;
+      }
+      break;
+
+    case MQTTC_CONNECT_BROKER:
+      if((now - mqttcAttemptTime) >= MQTTC_BROKER_RETRY_INTERVAL)
+      {
+        mqttcAttemptTime = now;
+        // the TCP (and TLS) connection itself is blocking, bounded by the client connection timeout
+        CETALIB_TRACE_BEGIN("mqttc", "brokerConnect", port);
+        bool connected = useTLS ? mqttsClient.connect(broker, port) : mqttClient.connect(broker, port);
+        CETALIB_TRACE_END("mqttc", "brokerConnect", connected);
+        if(!connected)
+        {
+          CETALIB_LOG_DEBUG("Broker connection failed, retrying");
+          break;
+        }
+        CETALIB_LOG_INFO("You're connected to the MQTT broker!");
+        mqttcSubscribe();
+        #if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_SPARKFUN_XRP_CONTROLLER)
+        digitalWrite(MQTTC_STAT_LED_PIN, 1);
+        #endif
+        connStatusPrevSampleTime = 0;
+        memset(&mqttcStats, 0, sizeof(mqttcStats));
+        mqttcStats.lastConnectTime = millis() - mqttcConnectStartTime;
+        mqttcConnectState = MQTTC_CONNECT_CONNECTED;
+      }
+      break;
+
+    default:
+      break;
+  }
+}
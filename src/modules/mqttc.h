@@ -46,13 +46,20 @@
 #endif
                                   #define MAX_SUBSCRIBE_TOPIC_IDS 10 // Max number of subscribe topics to be defined
 #define CONN_STATUS_SAMPLE_INTERVAL 30000 // Connection status sampling nterval (in mS)
+#define MQTTC_WIFI_RETRY_INTERVAL   10000 // WiFi association timeout before "begin()" retries (in mS)
+#define MQTTC_BROKER_RETRY_INTERVAL 1000  // Time between broker connection attempts after "begin()" (in mS)
+#define MQTTC_NTP_VALID_TIME        (8 * 3600 * 2)  // Time of day is valid once NTP has set it past this value (in S)
 
 /*** Custom Data Types ********************************************************/
 
+enum MQTTC_CONNECT_STATE {MQTTC_CONNECT_IDLE=0, MQTTC_CONNECT_WIFI, MQTTC_CONNECT_NTP, MQTTC_CONNECT_BROKER, MQTTC_CONNECT_CONNECTED};
+
 struct MQTTC_RECEIVE_MSG
 {
   char inTopic[128];   // topic ID for most recently received subscription message
   char inPayload[128]; // message payload for most recently received subscription message
+  int inPayloadLength; // number of payload bytes received (payload may be binary)
+  bool inPayloadTruncated; // payload was larger than inPayload (receive_binary() rejects it)
 };
 
 
@@ -60,10 +67,19 @@ struct MQTTC_RECEIVE_MSG
 bool  mqttc_connect(const char *MySSID, const char *MyPass, const char *MQbroker, int MQport,
                     const char *MQusername, const char *MQpassword, const char *subTopicIDs[],
                     int size_subTopicIDs);   // Connect to WiFi AP & Broker.
-void  mqttc_disconnect(void);                                           // Disconnect from the Broker & AP
+void  mqttc_disconnect(void);                                           // Disconnect from the Broker & AP (begin() again to reconnect)
 void  mqttc_tasks(void);                                                // Run mqttc background tasks
 void  mqttc_send_message(const char *pubTopic, char *jsonPubPayload);   // Publish serialized JSON payload to a topic
 int   mqttc_is_message_available(const char *subTopic);                 // Check if JSON message has been received for a specific subscription topic        
 char* mqttc_receive_message(void);                                      // Retrieve JSON payload for deserialization
+void  mqttc_send_binary(const char *pubTopic, const uint8_t *payload, int length);  // Publish a binary payload to a topic
+int   mqttc_receive_binary(uint8_t *buf, int bufSize);                  // Retrieve binary payload, returns payload length
+void  mqttc_set_qos(int publishQoS, int subscribeQoS);                  // Set publish/subscribe QoS levels (0 or 1)
+void  mqttc_set_ca_cert(const char *rootCACert);                        // Use a custom broker root CA certificate (PEM) for TLS
+MQTTC_STATS* mqttc_get_stats(void);                                     // Returns a pointer to the message/connection statistics
+bool  mqttc_begin(const char *MySSID, const char *MyPass, const char *MQbroker, int MQport,
+                  const char *MQusername, const char *MQpassword, const char *subTopicIDs[],
+                  int size_subTopicIDs);     // Start connecting to WiFi AP & Broker, "tasks()" completes the connection
+bool  mqttc_is_connected(void);                                         // Check if the connection started by "begin()" is complete
 
 #endif /* MQTTC_H_ */
\ No newline at end of file
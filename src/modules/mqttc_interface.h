@@ -27,23 +27,42 @@
 
 /*** Include Files ************************************************************/
 #include <Arduino.h>
-#include "mqttc.h"
 
 /*** Macros *******************************************************************/
 
 /*** Custom Data Types ********************************************************/
 
+typedef struct
+{
+  unsigned long messagesSent;       // number of messages published since connect()
+  unsigned long bytesSent;          // number of payload bytes published since connect()
+  unsigned long messagesReceived;   // number of subscription messages received since connect()
+  unsigned long bytesReceived;      // number of subscription payload bytes received since connect()
+  unsigned long reconnects;         // number of broker reconnections performed by tasks()
+  unsigned long lastConnectTime;    // duration of the most recent (re)connection (in mS)
+} MQTTC_STATS;
+
 struct MQTTC_INTERFACE
 {
   // Connect to the broker and subscribe for all notifications
   bool (*connect)(const char *MySSID, const char *MyPass, const char *MQbroker, int MQport,
                   const char *MQusername, const char *MQpassword, const char *subTopicIDs[],
                   int size_subTopicIDs);    // Connect to WiFi AP & Broker.
-  void (*disconnect)(void);                                         // Disconnect from the Broker & AP
+  void (*disconnect)(void);                                         // Disconnect from the Broker & AP (begin() again to reconnect)
   void (*tasks)(void);                                              // Run mqttc background tasks
   void (*send_message)(const char *pubTopic, char *jsonPubPayload); // Publish serialized JSON payload to a topic
   int (*is_message_available)(const char *subTopic);                // Check if JSON message has been received for a specific subscription topic        
   char* (*receive_message)(void);                                   // Retrieve JSON payload for deserialization
+  void (*send_binary)(const char *pubTopic, const uint8_t *payload, int length);  // Publish a binary payload (e.g. "cbor" record) to a topic
+  int (*receive_binary)(uint8_t *buf, int bufSize);                 // Retrieve binary payload, returns payload length (0 if larger than 127 bytes or bufSize)
+  void (*set_qos)(int publishQoS, int subscribeQoS);                // Set publish/subscribe QoS levels (0 or 1), call before connect()
+  void (*set_ca_cert)(const char *rootCACert);                      // Use a custom broker root CA certificate (PEM) for TLS, call before connect()
+  MQTTC_STATS* (*get_stats)(void);                                  // Returns a pointer to the message/connection statistics
+  // Start connecting to the broker without waiting, "tasks()" completes the connection
+  bool (*begin)(const char *MySSID, const char *MyPass, const char *MQbroker, int MQport,
+                const char *MQusername, const char *MQpassword, const char *subTopicIDs[],
+                int size_subTopicIDs);
+  bool (*is_connected)(void);                                       // Check if the connection started by begin() is complete
 };
 
 /*** Public Function Prototypes ***********************************************/
@@ -11,18 +11,22 @@
  *
  * Tested using Adafruit SSD1306-based 128x64 OLED display (#938)
  * 
- * Dependencies:
+ * The display contents are drawn into a 1 KB framebuffer (8 pages x 128
+ * columns). Each page tracks the range of columns changed since it was last
+ * sent, and "oled_tasks()" (called by board tasks()) sends the changed
+ * columns to the display in small I2C transfers, so a display update never
+ * holds up the sketch for more than one transfer.
+ * 
+ * Widgets (numeric fields, bar gauges and sparklines) are placed on the text
+ * grid and redrawn by "oled_tasks()" at a capped frame rate, from a data
+ * source function or from the last value passed to "oled_set_value()".
  * 
- * Adafruit_BusIO Library:   https://github.com/adafruit/Adafruit_BusIO 
- * Adafruit_SSD1306 Library: https://github.com/adafruit/Adafruit_SSD1306 
- * Adafruit-GFX Library:     https://github.com/adafruit/Adafruit-GFX-Library
- * SSD1306Ascii Library:     https://github.com/greiman/SSD1306Ascii
  * "Cool-MCU.com" Bitmap generated using this website: https://javl.github.io/image2cpp
  * 
  * OLED initialized with the following settings:
  *  - Configured for Adafruit 128x64 OLED (#938)
- *  - Default Font is used (5x7 pixel)
- *  - 7 row x 21 col (147 characters)
+ *  - 5x7 pixel font (oled_font.h)
+ *  - 8 row x 21 col (168 characters)
  *  - Auto-scrolling enabled
  * 
  * Hardware Configurations Supported:
@@ -43,30 +47,20 @@
 
 /** Include Files *************************************************************/
 #include <Arduino.h>                // Required for Arduino functions
-#include <Adafruit_GFX.h>           // Required to display splash screen logo
-#include <Adafruit_SSD1306.h>       // Required to display splash screen logo
-#include "SSD1306Ascii.h"           // Text display driver
-#include "SSD1306AsciiWire.h"       // Text display driver classes using I2C  
+#include <Wire.h>                   // Required for I2C functions
+#include <string.h>                 // Required for "memset()" function
+#include <math.h>                   // Required for "lroundf()" function
 #include "oled.h"                   // "oled" API declarations
+#include "oled_font.h"              // 5x7 pixel font
+#include "trace.h"                  // "trace" event macros
 
 /*** Symbolic Constants used in this module ***********************************/
+#define OLED_CONTROL_COMMAND  0x00  // I2C control byte: command stream follows
+#define OLED_CONTROL_DATA     0x40  // I2C control byte: display data stream follows
+#define OLED_CLEAN            OLED_SCREEN_WIDTH   // dirty start column of a page with no changes
 
 /*** Global Variable Declarations *********************************************/
 
-#if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_SPARKFUN_XRP_CONTROLLER_BETA)
-// Declare an Adafruit SSD1306 object
-Adafruit_SSD1306 ADA_OLED(OLED_SCREEN_WIDTH, OLED_SCREEN_HEIGHT, &Wire1, -1);
-// Declare an SSD1306Ascii object
-SSD1306AsciiWire SSD1306_OLED(Wire1);
-#elif defined(ARDUINO_SPARKFUN_XRP_CONTROLLER)
-// Declare an Adafruit SSD1306 object
-Adafruit_SSD1306 ADA_OLED(OLED_SCREEN_WIDTH, OLED_SCREEN_HEIGHT, &Wire, -1);
-// Declare an SSD1306Ascii object
-SSD1306AsciiWire SSD1306_OLED(Wire);
-#else
-  #error Unsupported board selection
-#endif
-
 // Cool-MCU.com logo, 128x64
 static const unsigned char epd_bitmap_logo_White [] PROGMEM = {
 	0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
@@ -135,74 +129,697 @@ static const unsigned char epd_bitmap_logo_White [] PROGMEM = {
 	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
 };
 
+// SSD1306 initialization commands for the Adafruit 128x64 OLED (#938)
+static const uint8_t oledInitCommands[] = {
+  0xAE,           // display off
+  0xD5, 0x80,     // clock divide ratio / oscillator frequency
+  0xA8, 0x3F,     // multiplex ratio (64 rows)
+  0xD3, 0x00,     // display offset
+  0x40,           // display start line 0
+  0x8D, 0x14,     // charge pump on (internal VCC)
+  0x20, 0x00,     // horizontal addressing mode
+  0xA1,           // segment remap (column 127 is SEG0)
+  0xC8,           // COM scan direction remapped
+  0xDA, 0x12,     // COM pins configuration
+  0x81, 0xCF,     // contrast
+  0xD9, 0xF1,     // pre-charge period
+  0xDB, 0x40,     // VCOMH deselect level
+  0xA4,           // display follows RAM contents
+  0xA6,           // normal (not inverted) display
+  0x2E,           // scrolling off
+  0xAF            // display on
+};
+
 // initiallize function pointers
 extern const struct OLED_INTERFACE OLED = {
     .initialize             = &oled_init,
     .print                  = &oled_print,
     .println                = &oled_println,
     .clear                  = &oled_clear,
-    .home                   = &oled_home
+    .home                   = &oled_home,
+    .tasks                  = &oled_tasks,
+    .add_field              = &oled_add_field,
+    .add_bar                = &oled_add_bar,
+    .add_sparkline          = &oled_add_sparkline,
+    .set_value              = &oled_set_value,
+    .set_frame_rate         = &oled_set_frame_rate,
+    .clear_widgets          = &oled_clear_widgets
 };
 
+static uint8_t oledFrame[OLED_NUM_PAGES][OLED_SCREEN_WIDTH];  // framebuffer, indexed by display page
+static uint8_t oledDirtyStart[OLED_NUM_PAGES];  // first changed column of each page (OLED_CLEAN if none)
+static uint8_t oledDirtyEnd[OLED_NUM_PAGES];    // last changed column of each page + 1
+static int oledFlushPage = 0;                   // next page checked by oled_tasks()
+static int oledTopPage = 0;                     // display page shown on the top text row (auto-scrolling)
+static bool oledStartLinePending = false;       // display start line changed, not sent yet
+static uint8_t oledBlankPages = 0;              // scrolled-in pages to blank on the display before the start line is sent
+static int oledBlankPage = 0;                   // page being blanked
+static int oledBlankCol = 0;                    // next column to blank in oledBlankPage (0: pick the next page)
+static const uint8_t oledZeros[OLED_FLUSH_CHUNK] = {0};
+static int oledRow = 0;                         // cursor text row
+static int oledCol = 0;                         // cursor text column
+static bool oledReady = false;                  // display initialized
+static bool oledSplashActive = false;           // splash screen displayed, text output not started yet
+static bool oledBackgroundFlush = false;        // oled_tasks() is called, changes are sent in the background
+static struct OLED_WIDGET oledWidgets[OLED_MAX_WIDGETS];
+static int oledNumWidgets = 0;
+static unsigned long oledFrameInterval = 1000 / OLED_FRAME_RATE;  // time between widget refreshes (in mS)
+static unsigned long oledFramePrevTime = 0;     // time of the last widget refresh (in mS)
+static const long oledPow10[OLED_MAX_DECIMALS + 1] = {1, 10, 100, 1000};
+
 /*** Private Function Prototypes **********************************************/
+static bool oledWriteCommands(const uint8_t *commands, int length); // Send a command stream to the display
+static void oledMarkDirty(int page, int start, int end);    // Add columns to the changed region of a page
+static void oledFlushChunk(int page);           // Send the next changed columns of a page to the display
+static void oledWriteData(int page, int start, const uint8_t *data, int length);  // Send display data to a column window
+static bool oledFlushScroll(void);              // Send the next scroll step, false if no scroll is pending
+static void oledFlushAll(void);                 // Send all changes to the display (blocking)
+static void oledFlushIfForeground(void);        // Send all changes if oled_tasks() is not being called
+static void oledEndSplash(void);                // Clear the splash screen and start text output
+static void oledWriteString(char *s);           // Draw a string at the cursor position
+static void oledWriteChar(char c);              // Draw a character at the cursor position
+static void oledScroll(void);                   // Scroll the text up by one row
+static void oledSetColumn(int page, int x, uint8_t bits);   // Change one framebuffer column, marking it if it changed
+static void oledDrawGlyph(int page, int x, char c);         // Draw a character at a pixel column of a page
+static int oledAddWidget(enum OLED_WIDGET_TYPE type, int row, int col, int width, int height, float (*source)(void)); // Reserve a widget
+static void oledDrawWidget(struct OLED_WIDGET *w);          // Redraw a widget if its value changed
+static void oledDrawField(struct OLED_WIDGET *w);           // Draw a numeric field
+static void oledDrawBar(struct OLED_WIDGET *w);             // Draw a bar gauge
+static void oledDrawSparkline(struct OLED_WIDGET *w);       // Scroll a sparkline and draw the newest value
+static int oledScale(struct OLED_WIDGET *w, int pixels);    // Map the widget value to 0..pixels
 
 /*** Public Function Definitions **********************************************/
 
 bool oled_init(void)
 {
-	#if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_SPARKFUN_XRP_CONTROLLER_BETA)
-	// Setup Wire1 as interface (I2C1) 
-  Wire1.setSDA(OLED_SDA_PIN);
-  Wire1.setSCL(OLED_SCL_PIN);
-  Wire1.setClock(OLED_I2C_BAUD);
-  Wire1.begin();
-	#elif defined(ARDUINO_SPARKFUN_XRP_CONTROLLER)
-	// Setup Wire as interface (I2C0) 
-  Wire.setSDA(OLED_SDA_PIN);
-  Wire.setSCL(OLED_SCL_PIN);
-  Wire.setClock(OLED_I2C_BAUD);
-  Wire.begin();
-	#else
-  #error Unsupported board selection
-	#endif
-
-  // Display the Cool-MCU.com logo bitmap
-  if (!ADA_OLED.begin(SSD1306_SWITCHCAPVCC, OLED_I2C_ADDRESS))
+  OLED_WIRE.setSDA(OLED_SDA_PIN);
+  OLED_WIRE.setSCL(OLED_SCL_PIN);
+  OLED_WIRE.setClock(OLED_I2C_BAUD);
+  OLED_WIRE.begin();
+
+  oledReady = false;
+  if (!oledWriteCommands(oledInitCommands, sizeof(oledInitCommands)))
   {
     return false;
   }
-  ADA_OLED.clearDisplay(); // Make sure the display is cleared
-  ADA_OLED.drawBitmap(0, 16, epd_bitmap_logo_White, 128, 64, WHITE);
-  ADA_OLED.display();
-  delay(5000);
-  ADA_OLED.clearDisplay();
-  ADA_OLED.display();
-
-  // Enable line-mode output from now on
-  SSD1306_OLED.begin(&Adafruit128x64, OLED_I2C_ADDRESS);
-  SSD1306_OLED.setFont(System5x7);
-  SSD1306_OLED.setScrollMode(SCROLL_MODE_AUTO);
-  SSD1306_OLED.clear();
-  SSD1306_OLED.home();
+
+  // Draw the Cool-MCU.com logo bitmap 16 pixels down from the top of the screen
+  memset(oledFrame, 0, sizeof(oledFrame));
+  for (int y = 0; y < (OLED_SCREEN_HEIGHT - 16); y++)
+  {
+    for (int x = 0; x < OLED_SCREEN_WIDTH; x++)
+    {
+      if (epd_bitmap_logo_White[(y * (OLED_SCREEN_WIDTH / 8)) + (x / 8)] & (0x80 >> (x & 7)))
+      {
+        oledFrame[(y + 16) / 8][x] |= (1 << ((y + 16) & 7));
+      }
+    }
+  }
+  for (int page = 0; page < OLED_NUM_PAGES; page++)
+  {
+    oledDirtyStart[page] = OLED_CLEAN;
+    oledMarkDirty(page, 0, OLED_SCREEN_WIDTH);
+  }
+  oledTopPage = 0;
+  oledStartLinePending = false;
+  oledBlankPages = 0;
+  oledBlankCol = 0;
+  oledRow = 0;
+  oledCol = 0;
+  oledReady = true;
+  oledFlushAll();
+
+  // The splash screen stays on until the first print/println/clear/home call,
+  // other modules keep initializing in the meantime
+  oledSplashActive = true;
   return true;
 }
 
 void oled_print(char *s)
 {
-  SSD1306_OLED.print(s);
+  oledEndSplash();
+  oledWriteString(s);
+  oledFlushIfForeground();
 }
 
 void oled_println(char *s)
 {
-  SSD1306_OLED.println(s);
+  oledEndSplash();
+  oledWriteString(s);
+  oledWriteChar('\r');
+  oledWriteChar('\n');
+  oledFlushIfForeground();
 }
 
 void oled_clear(void)
 {
-  SSD1306_OLED.clear();
+  oledEndSplash();
+  for (int page = 0; page < OLED_NUM_PAGES; page++)
+  {
+    for (int x = 0; x < OLED_SCREEN_WIDTH; x++)
+    {
+      if (oledFrame[page][x])
+      {
+        oledFrame[page][x] = 0;
+        oledMarkDirty(page, x, x + 1);
+      }
+    }
+  }
+  if (oledTopPage != 0)
+  {
+    oledTopPage = 0;
+    oledStartLinePending = true;
+  }
+  oledRow = 0;
+  oledCol = 0;
+  for (int i = 0; i < oledNumWidgets; i++)
+  {
+    oledWidgets[i].hasDrawn = false;
+  }
+  oledFlushIfForeground();
 }
 
 void oled_home(void)
 {
-  SSD1306_OLED.home();
-}
\ No newline at end of file
+  oledEndSplash();
+  oledRow = 0;
+  oledCol = 0;
+}
+
+void oled_tasks(void)
+{
+  oledBackgroundFlush = true;
+  if (!oledReady)
+  {
+    return;
+  }
+  CETALIB_TRACE_BEGIN("oled", "tasks", oledNumWidgets);
+
+  // Redraw the widgets (in the framebuffer) at the frame rate
+  if (oledNumWidgets && !oledSplashActive && ((millis() - oledFramePrevTime) >= oledFrameInterval))
+  {
+    oledFramePrevTime = millis();
+    for (int i = 0; i < oledNumWidgets; i++)
+    {
+      oledDrawWidget(&oledWidgets[i]);
+    }
+  }
+
+  // One I2C transfer per call: the scroll first, then the next changed page
+  if (oledFlushScroll())
+  {
+    CETALIB_TRACE_END("oled", "tasks", 0);
+    return;
+  }
+  for (int i = 0; i < OLED_NUM_PAGES; i++)
+  {
+    int page = (oledFlushPage + i) % OLED_NUM_PAGES;
+    if (oledDirtyStart[page] != OLED_CLEAN)
+    {
+      oledFlushChunk(page);
+      oledFlushPage = page;
+      CETALIB_TRACE_END("oled", "tasks", 0);
+      return;
+    }
+  }
+  CETALIB_TRACE_END("oled", "tasks", 0);
+}
+
+int oled_add_field(int row, int col, const char *label, int width, int decimals, float (*source)(void))
+{
+  int labelLength = (label != NULL) ? strlen(label) : 0;
+  if ((width < 1) || (decimals < 0) || (decimals > OLED_MAX_DECIMALS))
+  {
+    return -1;
+  }
+  int widget = oledAddWidget(OLED_WIDGET_FIELD, row, col, labelLength + width, 1, source);
+  if (widget >= 0)
+  {
+    oledWidgets[widget].label = label;
+    oledWidgets[widget].width = width;
+    oledWidgets[widget].decimals = decimals;
+  }
+  return widget;
+}
+
+int oled_add_bar(int row, int col, int width, float min, float max, float (*source)(void))
+{
+  int widget = oledAddWidget(OLED_WIDGET_BAR, row, col, width, 1, source);
+  if (widget >= 0)
+  {
+    oledWidgets[widget].min = min;
+    oledWidgets[widget].max = max;
+  }
+  return widget;
+}
+
+int oled_add_sparkline(int row, int col, int width, int height, float min, float max, float (*source)(void))
+{
+  int widget = oledAddWidget(OLED_WIDGET_SPARKLINE, row, col, width, height, source);
+  if (widget >= 0)
+  {
+    oledWidgets[widget].min = min;
+    oledWidgets[widget].max = max;
+  }
+  return widget;
+}
+
+void oled_set_value(int widget, float value)
+{
+  if ((widget < 0) || (widget >= oledNumWidgets))
+  {
+    return;
+  }
+  oledWidgets[widget].value = value;
+}
+
+void oled_set_frame_rate(int fps)
+{
+  if (fps < 1)
+  {
+    fps = 1;
+  }
+  else if (fps > OLED_MAX_FRAME_RATE)
+  {
+    fps = OLED_MAX_FRAME_RATE;
+  }
+  oledFrameInterval = 1000 / fps;
+}
+
+void oled_clear_widgets(void)
+{
+  oledNumWidgets = 0;
+}
+
+/*** Private Function Definitions *********************************************/
+
+static bool oledWriteCommands(const uint8_t *commands, int length)
+{
+  CETALIB_TRACE_BEGIN("oled", "i2cWrite", length);
+  OLED_WIRE.beginTransmission(OLED_I2C_ADDRESS);
+  OLED_WIRE.write(OLED_CONTROL_COMMAND);
+  OLED_WIRE.write(commands, length);
+  bool acked = (OLED_WIRE.endTransmission() == 0);
+  CETALIB_TRACE_END("oled", "i2cWrite", length);
+  return acked;
+}
+
+static void oledMarkDirty(int page, int start, int end)
+{
+  if (oledDirtyStart[page] == OLED_CLEAN)
+  {
+    oledDirtyStart[page] = start;
+    oledDirtyEnd[page] = end;
+    return;
+  }
+  if (start < oledDirtyStart[page])
+  {
+    oledDirtyStart[page] = start;
+  }
+  if (end > oledDirtyEnd[page])
+  {
+    oledDirtyEnd[page] = end;
+  }
+}
+
+static void oledFlushChunk(int page)
+{
+  int start = oledDirtyStart[page];
+  int length = oledDirtyEnd[page] - start;
+  if (length > OLED_FLUSH_CHUNK)
+  {
+    length = OLED_FLUSH_CHUNK;
+  }
+
+  oledWriteData(page, start, &oledFrame[page][start], length);
+  if ((start + length) >= oledDirtyEnd[page])
+  {
+    oledDirtyStart[page] = OLED_CLEAN;
+  }
+  else
+  {
+    oledDirtyStart[page] = start + length;
+  }
+}
+
+static void oledWriteData(int page, int start, const uint8_t *data, int length)
+{
+  // Set the column and page address window, then send the display data
+  uint8_t window[] = {0x21, (uint8_t)start, (uint8_t)(start + length - 1), 0x22, (uint8_t)page, (uint8_t)page};
+  oledWriteCommands(window, sizeof(window));
+  CETALIB_TRACE_BEGIN("oled", "i2cWrite", length);
+  OLED_WIRE.beginTransmission(OLED_I2C_ADDRESS);
+  OLED_WIRE.write(OLED_CONTROL_DATA);
+  OLED_WIRE.write(data, length);
+  OLED_WIRE.endTransmission();
+  CETALIB_TRACE_END("oled", "i2cWrite", length);
+}
+
+static bool oledFlushScroll(void)
+{
+  if (!oledStartLinePending)
+  {
+    return false;
+  }
+  // Blank the scrolled-in pages first: they still show the old top row, which
+  // would otherwise flash on the new bottom row when the start line moves
+  if (oledBlankPages)
+  {
+    if (oledBlankCol == 0)
+    {
+      oledBlankPage = __builtin_ctz(oledBlankPages);
+    }
+    int page = oledBlankPage;
+    int length = min(OLED_FLUSH_CHUNK, OLED_SCREEN_WIDTH - oledBlankCol);
+    oledWriteData(page, oledBlankCol, oledZeros, length);
+    oledBlankCol += length;
+    if (oledBlankCol >= OLED_SCREEN_WIDTH)
+    {
+      oledBlankCol = 0;
+      oledBlankPages &= ~(1 << page);
+    }
+    return true;
+  }
+  uint8_t command = 0x40 | (oledTopPage * 8);
+  oledStartLinePending = false;
+  oledWriteCommands(&command, 1);
+  return true;
+}
+
+static void oledFlushAll(void)
+{
+  if (!oledReady)
+  {
+    return;
+  }
+  while (oledFlushScroll())
+  {
+  }
+  for (int page = 0; page < OLED_NUM_PAGES; page++)
+  {
+    while (oledDirtyStart[page] != OLED_CLEAN)
+    {
+      oledFlushChunk(page);
+    }
+  }
+}
+
+static void oledFlushIfForeground(void)
+{
+  // Sketches that never call board tasks() get the display updated right away
+  if (!oledBackgroundFlush)
+  {
+    oledFlushAll();
+  }
+}
+
+static void oledEndSplash(void)
+{
+  if (!oledSplashActive)
+  {
+    return;
+  }
+  oledSplashActive = false;
+  for (int page = 0; page < OLED_NUM_PAGES; page++)
+  {
+    memset(oledFrame[page], 0, OLED_SCREEN_WIDTH);
+    oledMarkDirty(page, 0, OLED_SCREEN_WIDTH);
+  }
+  oledRow = 0;
+  oledCol = 0;
+}
+
+static void oledWriteString(char *s)
+{
+  if (!oledReady)
+  {
+    return;
+  }
+  while (*s)
+  {
+    oledWriteChar(*s++);
+  }
+}
+
+static void oledWriteChar(char c)
+{
+  if (c == '\r')
+  {
+    oledCol = 0;
+    return;
+  }
+  if (c == '\n')
+  {
+    oledCol = 0;
+    oledRow++;
+    return;
+  }
+  if (oledCol >= OLED_NUM_COLS)
+  {
+    return;     // truncate the rest of the line
+  }
+  // Scroll only when text is written below the last row, so all 8 rows are used
+  while (oledRow >= OLED_NUM_ROWS)
+  {
+    oledScroll();
+    oledRow--;
+  }
+
+  oledDrawGlyph((oledTopPage + oledRow) % OLED_NUM_PAGES, oledCol * OLED_CHAR_WIDTH, c);
+  oledCol++;
+}
+
+static void oledScroll(void)
+{
+  // Reuse the old top page as the new bottom row: clear it first, and have it
+  // blanked on the display before the start line moves down one page (no
+  // framebuffer copy). Text drawn in it afterwards is sent after the blanking.
+  int page = oledTopPage;
+  for (int x = 0; x < OLED_SCREEN_WIDTH; x++)
+  {
+    if (oledFrame[page][x])
+    {
+      oledFrame[page][x] = 0;
+      oledMarkDirty(page, x, x + 1);
+    }
+  }
+  oledBlankPages |= (1 << page);
+  oledTopPage = (oledTopPage + 1) % OLED_NUM_PAGES;
+  oledStartLinePending = true;
+
+  // Widgets stay on their screen rows: redraw them all at their new pages at
+  // the next frame (the copy that scrolled up stays until it is overwritten)
+  for (int i = 0; i < oledNumWidgets; i++)
+  {
+    oledWidgets[i].hasDrawn = false;
+  }
+}
+
+static void oledSetColumn(int page, int x, uint8_t bits)
+{
+  // Only the columns that actually change are marked for sending
+  if (oledFrame[page][x] != bits)
+  {
+    oledFrame[page][x] = bits;
+    oledMarkDirty(page, x, x + 1);
+  }
+}
+
+static void oledDrawGlyph(int page, int x, char c)
+{
+  if ((c < OLED_FONT_FIRST_CHAR) || (c > OLED_FONT_LAST_CHAR))
+  {
+    c = '?';
+  }
+  for (int i = 0; i < OLED_CHAR_WIDTH; i++)
+  {
+    oledSetColumn(page, x + i, (i < OLED_FONT_WIDTH) ? oledFont5x7[c - OLED_FONT_FIRST_CHAR][i] : 0);
+  }
+}
+
+static int oledAddWidget(enum OLED_WIDGET_TYPE type, int row, int col, int width, int height, float (*source)(void))
+{
+  if ((oledNumWidgets >= OLED_MAX_WIDGETS) || !oledReady || (width < 1) || (height < 1) ||
+      (row < 0) || (col < 0) || ((row + height) > OLED_NUM_ROWS) || ((col + width) > OLED_NUM_COLS))
+  {
+    return -1;
+  }
+  oledEndSplash();
+  struct OLED_WIDGET *w = &oledWidgets[oledNumWidgets];
+  memset(w, 0, sizeof(struct OLED_WIDGET));
+  w->type = type;
+  w->row = row;
+  w->col = col;
+  w->width = width;
+  w->height = height;
+  w->source = source;
+  return oledNumWidgets++;
+}
+
+static void oledDrawWidget(struct OLED_WIDGET *w)
+{
+  if (w->source != NULL)
+  {
+    w->value = w->source();
+  }
+  switch (w->type)
+  {
+    case OLED_WIDGET_FIELD:
+      oledDrawField(w);
+      break;
+    case OLED_WIDGET_BAR:
+      oledDrawBar(w);
+      break;
+    case OLED_WIDGET_SPARKLINE:
+      oledDrawSparkline(w);
+      break;
+  }
+  w->hasDrawn = true;
+}
+
+static void oledDrawField(struct OLED_WIDGET *w)
+{
+  int page = (oledTopPage + w->row) % OLED_NUM_PAGES;
+  int x = w->col * OLED_CHAR_WIDTH;
+  if (!w->hasDrawn && (w->label != NULL))
+  {
+    for (const char *s = w->label; *s; s++)
+    {
+      oledDrawGlyph(page, x, *s);
+      x += OLED_CHAR_WIDTH;
+    }
+  }
+  else if (w->label != NULL)
+  {
+    x += strlen(w->label) * OLED_CHAR_WIDTH;
+  }
+
+  // Integer formatting (no printf): the value is scaled to an integer with the decimal places
+  long scaled = lroundf(w->value * oledPow10[w->decimals]);
+  if (w->hasDrawn && (scaled == w->drawn))
+  {
+    return;
+  }
+  w->drawn = scaled;
+  char text[OLED_NUM_COLS];
+  if ((w->width < 1) || (w->width > OLED_NUM_COLS))
+  {
+    return;
+  }
+  int pos = w->width;
+  bool negative = (scaled < 0);
+  unsigned long digits = negative ? -scaled : scaled;
+  int i = 0;
+  do
+  {
+    // Digits from the right, with the decimal point and at least one integer digit
+    text[--pos] = '0' + (digits % 10);
+    digits /= 10;
+    i++;
+    if ((i == w->decimals) && (pos > 0))
+    {
+      text[--pos] = '.';
+    }
+  } while ((pos > 0) && ((digits > 0) || (i <= w->decimals)));
+  if ((digits > 0) || (i <= w->decimals) || (negative && (pos == 0)))
+  {
+    // Does not fit in the field
+    for (pos = 0; pos < w->width; pos++)
+    {
+      text[pos] = '#';
+    }
+    pos = 0;
+  }
+  else if (negative)
+  {
+    text[--pos] = '-';
+  }
+  while (pos > 0)
+  {
+    text[--pos] = ' ';
+  }
+  for (i = 0; i < w->width; i++)
+  {
+    oledDrawGlyph(page, x + (i * OLED_CHAR_WIDTH), text[i]);
+  }
+}
+
+static void oledDrawBar(struct OLED_WIDGET *w)
+{
+  int page = (oledTopPage + w->row) % OLED_NUM_PAGES;
+  int x = w->col * OLED_CHAR_WIDTH;
+  int pixels = (w->width * OLED_CHAR_WIDTH) - 2;
+  int filled = oledScale(w, pixels);
+  if (w->hasDrawn && (filled == w->drawn))
+  {
+    return;
+  }
+  w->drawn = filled;
+
+  // Outlined box (6 pixels tall), filled from the left
+  oledSetColumn(page, x, 0x7E);
+  for (int i = 0; i < pixels; i++)
+  {
+    oledSetColumn(page, x + 1 + i, (i < filled) ? 0x7E : 0x42);
+  }
+  oledSetColumn(page, x + 1 + pixels, 0x7E);
+}
+
+static void oledDrawSparkline(struct OLED_WIDGET *w)
+{
+  int page = (oledTopPage + w->row) % OLED_NUM_PAGES;
+  int x = w->col * OLED_CHAR_WIDTH;
+  int width = w->width * OLED_CHAR_WIDTH;
+  int y = (w->height * 8) - 1 - oledScale(w, (w->height * 8) - 1);
+
+  // Scroll the sparkline left by one pixel (the framebuffer holds the history)
+  for (int r = 0; r < w->height; r++)
+  {
+    int p = (page + r) % OLED_NUM_PAGES;
+    for (int i = 0; i < (width - 1); i++)
+    {
+      oledSetColumn(p, x + i, w->hasDrawn ? oledFrame[p][x + i + 1] : 0);
+    }
+  }
+
+  // Draw the newest value, joined to the previous one with a vertical line
+  int top = y;
+  int bottom = y;
+  if (w->hasDrawn)
+  {
+    top = (w->drawn < y) ? w->drawn : y;
+    bottom = (w->drawn > y) ? w->drawn : y;
+  }
+  for (int r = 0; r < w->height; r++)
+  {
+    uint8_t bits = 0;
+    for (int bit = 0; bit < 8; bit++)
+    {
+      int pixelRow = (r * 8) + bit;
+      if ((pixelRow >= top) && (pixelRow <= bottom))
+      {
+        bits |= (1 << bit);
+      }
+    }
+    oledSetColumn((page + r) % OLED_NUM_PAGES, x + width - 1, bits);
+  }
+  w->drawn = y;
+}
+
+static int oledScale(struct OLED_WIDGET *w, int pixels)
+{
+  if (w->max == w->min)
+  {
+    return 0;
+  }
+  long scaled = lroundf(((w->value - w->min) * pixels) / (w->max - w->min));
+  if (scaled < 0)
+  {
+    return 0;
+  }
+  if (scaled > pixels)
+  {
+    return pixels;
+  }
+  return scaled;
+}
@@ -11,18 +11,17 @@
  *
  * Tested using Adafruit SSD1306-based 128x64 OLED display (#938)
  * 
- * Dependencies:
+ * The display contents are drawn into a 1 KB framebuffer. Only the changed
+ * columns of each page are sent to the display, in small I2C transfers made by
+ * "oled_tasks()" (called by board tasks()), so display updates do not stall
+ * the main loop.
  * 
- * Adafruit_BusIO Library:   https://github.com/adafruit/Adafruit_BusIO 
- * Adafruit_SSD1306 Library: https://github.com/adafruit/Adafruit_SSD1306 
- * Adafruit-GFX Library:     https://github.com/adafruit/Adafruit-GFX-Library
- * SSD1306Ascii Library:     https://github.com/greiman/SSD1306Ascii
  * "Cool-MCU.com" Bitmap generated using this website: https://javl.github.io/image2cpp
  * 
  * OLED initialized with the following settings:
  *  - Configured for Adafruit 128x64 OLED (#938)
- *  - Default Font is used (5x7 pixel)
- *  - 7 row x 21 col (147 characters)
+ *  - 5x7 pixel font (oled_font.h)
+ *  - 8 row x 21 col (168 characters)
  *  - Auto-scrolling enabled
  * 
  * Hardware Configurations Supported:
@@ -53,9 +52,11 @@
  #if defined(ARDUINO_RASPBERRY_PI_PICO_W) || defined(ARDUINO_SPARKFUN_XRP_CONTROLLER_BETA)
    #define OLED_SCL_PIN 19
    #define OLED_SDA_PIN 18
+   #define OLED_WIRE Wire1
  #elif defined(ARDUINO_SPARKFUN_XRP_CONTROLLER)
    #define OLED_SCL_PIN 5
    #define OLED_SDA_PIN 4
+   #define OLED_WIRE Wire
  #else
    #error Unsupported board selection
  #endif
@@ -64,14 +65,49 @@
  #define OLED_I2C_BAUD 400000
  #define OLED_SCREEN_WIDTH 128
  #define OLED_SCREEN_HEIGHT 64
+ #define OLED_NUM_PAGES (OLED_SCREEN_HEIGHT / 8)    // 8 pixel rows per display page
+ #define OLED_CHAR_WIDTH 6                          // 5 pixel font + 1 pixel spacing
+ #define OLED_NUM_ROWS OLED_NUM_PAGES               // one text row per page
+ #define OLED_NUM_COLS (OLED_SCREEN_WIDTH / OLED_CHAR_WIDTH)
+ #define OLED_FLUSH_CHUNK 32                        // max display bytes sent per oled_tasks() call
+ #define OLED_MAX_WIDGETS 8                         // max number of widgets
+ #define OLED_FRAME_RATE 10                         // default widget refresh rate (in frames per second)
+ #define OLED_MAX_FRAME_RATE 50                     // max widget refresh rate (in frames per second)
+ #define OLED_MAX_DECIMALS 3                        // max decimal places of a numeric field
  
  /*** Custom Data Types ********************************************************/
  
+ enum OLED_WIDGET_TYPE {OLED_WIDGET_FIELD=0, OLED_WIDGET_BAR, OLED_WIDGET_SPARKLINE};
+ 
+ struct OLED_WIDGET
+ {
+   enum OLED_WIDGET_TYPE type;     // field, bar gauge or sparkline
+   int row;                        // top text row (0-7)
+   int col;                        // left text column (0-20)
+   int width;                      // width of the value/bar/sparkline (in characters)
+   int height;                     // height of a sparkline (in text rows)
+   const char *label;              // text drawn before a field value (NULL = none)
+   int decimals;                   // decimal places of a field value
+   float min;                      // bar/sparkline value at the left/bottom
+   float max;                      // bar/sparkline value at the right/top
+   float (*source)(void);          // returns the value at each frame (NULL = value set by oled_set_value())
+   float value;                    // most recent value
+   long drawn;                     // value as drawn (field: scaled integer, bar: filled pixels, sparkline: last pixel row)
+   bool hasDrawn;                  // widget has been drawn since it was added or the screen was cleared
+ };
+ 
  /*** Public Function Prototypes ***********************************************/
- bool oled_init(void);		    // initialize I2C, display splash screen for 5 seconds, cursor in home position
+ bool oled_init(void);		    // initialize I2C, display splash screen until the first output
  void oled_print(char *s);	  // print up to 21 characters on the current line (auto-truncated)
  void oled_println(char *s);	// print up to 21 characters on the current line with CR/LF (auto-truncated)
  void oled_clear(void);		  // clear the screen
  void oled_home(void);		    // place the cursor in the home position
+ void oled_tasks(void);		    // send the next changed part of the framebuffer to the display
+ int oled_add_field(int row, int col, const char *label, int width, int decimals, float (*source)(void)); // define a numeric field
+ int oled_add_bar(int row, int col, int width, float min, float max, float (*source)(void)); // define a bar gauge
+ int oled_add_sparkline(int row, int col, int width, int height, float min, float max, float (*source)(void)); // define a scrolling sparkline
+ void oled_set_value(int widget, float value);  // pass a new value to a widget without a source
+ void oled_set_frame_rate(int fps);             // set the widget refresh rate (frames per second)
+ void oled_clear_widgets(void);                 // remove all widgets
  
  #endif /* OLED_H_ */
\ No newline at end of file
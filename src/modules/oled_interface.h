@@ -38,11 +38,18 @@
  /*** Custom Data Types ********************************************************/
  struct OLED_INTERFACE
  {
-   bool (*initialize)(void);               // initialize I2C, display splash screen for 5 seconds, cursor in home position
+   bool (*initialize)(void);               // initialize I2C, display splash screen until the first output
    void (*print)(char *s);                 // print up to 21 characters on the current line (auto-truncated)
    void (*println)(char *s);               // print up to 21 characters on the current line with CR/LF (auto-truncated)
    void (*clear)(void);                    // clear the screen
    void (*home)(void);                     // place the cursor in the home position
+   void (*tasks)(void);                    // send the next changed part of the framebuffer to the display
+   int (*add_field)(int row, int col, const char *label, int width, int decimals, float (*source)(void)); // define a numeric field, returns widget number (-1 if full)
+   int (*add_bar)(int row, int col, int width, float min, float max, float (*source)(void)); // define a bar gauge, returns widget number (-1 if full)
+   int (*add_sparkline)(int row, int col, int width, int height, float min, float max, float (*source)(void)); // define a scrolling sparkline, returns widget number (-1 if full)
+   void (*set_value)(int widget, float value); // pass a new value to a widget without a source
+   void (*set_frame_rate)(int fps);        // set the widget refresh rate (frames per second)
+   void (*clear_widgets)(void);            // remove all widgets
  };
  
  /*** Public Function Prototypes ***********************************************/
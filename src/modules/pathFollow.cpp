@@ -0,0 +1,466 @@
+/*
+ * Copyright (C) 2026 dBm Signal Dynamics Inc.
+ *
+ * File:            pathFollow.cpp
+ * Project:
+ * Date:            Oct 19, 2026
+ * Framework:       Arduino w. Arduino-Pico Core Pkge by Earl Philhower
+ *                  (https://github.com/earlephilhower/arduino-pico)
+ *
+ * cetalib "pathFollow" path follower
+ *
+ * Follows a path of waypoints (straight lines) or a smooth curve (a
+ * Catmull-Rom spline through the points) without blocking the sketch.
+ * tasks() runs every PATHFOLLOW_INTERVAL mS:
+ *
+ *   - odometry: the robot pose (x, y, heading) is updated from the encoder
+ *     counts (differential drive model)
+ *   - pure pursuit: the robot steers on the arc that reaches the path point
+ *     one lookahead distance ahead of the closest path point
+ *   - speed: the speed is reduced in tight curves (lateral acceleration
+ *     limit) and toward the end of the path (deceleration limit)
+ *   - wheel speeds: the arc sets the left and right wheel speeds, each held
+ *     by a feed-forward + PI controller on the measured wheel speed, and the
+ *     efforts are sent to "diffDrive"
+ *
+ * The pose errors of wheel odometry grow with the distance travelled (wheel
+ * slip, track width error), but unlike timed efforts and blocking turns they
+ * do not add up at each step of the path.
+ *
+ * The encoders are read in tasks() rather than in a timer interrupt, so the
+ * reads are recorded/replayed by the "replay" module in sketch order.
+ *
+ * Hardware Configurations Supported:
+ *
+ * Sparkfun XRP Robot Platform (#KIT-27644), based on the RPI RP2350B MCU
+ * (Select "Board = SparkFun XRP Controller")
+ *
+ * Sparkfun XRP (Beta) Robot Platform (#KIT-22230), based on the RPI Pico W
+ * (Select "Board = SparkFun XRP Controller (Beta)")
+ *
+ */
+
+/** Include Files *************************************************************/
+#include <Arduino.h>                // Required for Arduino functions
+#include <math.h>                   // needed for "sqrtf()", "sinf()" and "cosf()" functions
+#include <string.h>                 // needed for "memset()" function
+#include "pathFollow.h"             // "pathFollow" API declarations
+#include "encoder.h"                // "encoder" functions
+#include "diffDrive.h"              // "diffDrive" functions
+#include "logger.h"                 // "logger" functions
+#include "trace.h"                  // "trace" event macros
+
+#if defined(ARDUINO_SPARKFUN_XRP_CONTROLLER) || defined(ARDUINO_SPARKFUN_XRP_CONTROLLER_BETA)
+
+/*** Symbolic Constants used in this module ***********************************/
+#define PATHFOLLOW_CM_PER_COUNT     ((float)M_PI * PATHFOLLOW_WHEEL_DIAMETER / PATHFOLLOW_COUNTS_PER_REV)
+#define PATHFOLLOW_SEARCH_DISTANCE  (2.0f * pathLookahead)    // how far ahead the closest point is searched (in cm)
+
+/*** Global Variable Declarations *********************************************/
+
+// define the function interface
+extern const struct PATHFOLLOW_INTERFACE PATHFOLLOW = {
+    .initialize             = &pathFollow_init,
+    .set_waypoints          = &pathFollow_set_waypoints,
+    .set_spline             = &pathFollow_set_spline,
+    .set_lookahead          = &pathFollow_set_lookahead,
+    .start                  = &pathFollow_start,
+    .stop                   = &pathFollow_stop,
+    .tasks                  = &pathFollow_tasks,
+    .is_complete            = &pathFollow_is_complete,
+    .get_cross_track_error  = &pathFollow_get_cross_track_error,
+    .get_progress           = &pathFollow_get_progress,
+    .get_pose               = &pathFollow_get_pose,
+    .set_pose               = &pathFollow_set_pose,
+    .get_stats              = &pathFollow_get_stats
+};
+
+// path
+static PATHFOLLOW_POINT pathPoints[PATHFOLLOW_MAX_POINTS];
+static float pathDistance[PATHFOLLOW_MAX_POINTS];   // path length from the first point to each point (in cm)
+static int pathCount = 0;
+static float pathLookahead = PATHFOLLOW_LOOKAHEAD_DEFAULT;
+
+// follower state
+static bool pathRunning = false;
+static bool pathComplete = false;
+static float pathSpeed;                             // cruise speed (in cm/s)
+static int pathSegment;                             // closest segment (from point "pathSegment" to the next)
+static float pathAlong;                             // path length to the closest point (in cm)
+static float pathCrossTrack;                        // signed distance from the closest point (in cm, > 0 left)
+static float leftSpeedIntegral, rightSpeedIntegral; // wheel speed PI integrators (effort)
+static float crossTrackSquares;                     // sum of the squared cross-track errors
+static unsigned long pathStartTime;
+static PATHFOLLOW_STATS pathStats;
+
+// odometry
+static float poseX = 0.0f, poseY = 0.0f;            // position (in cm)
+static float poseHeading = 0.0f;                    // heading (in radians, -PI to PI, counter-clockwise)
+static int prevLeftCount, prevRightCount;
+static unsigned long pathPrevUpdate, pathNextUpdate;
+
+/*** Type Declarations ********************************************************/
+
+/*** Private Function Prototypes **********************************************/
+static bool pathFollowLoad(const PATHFOLLOW_POINT *points, int count);        // Store a path, skipping repeated points
+static void pathFollowOdometry(float dt, float *leftSpeed, float *rightSpeed); // Update the pose from the encoders
+static void pathFollowControl(float dt, float leftSpeed, float rightSpeed);    // Pure pursuit and wheel speed control
+static void pathFollowClosest(void);                                           // Closest path point and cross-track error
+static void pathFollowLookaheadPoint(float *x, float *y);                      // Path point one lookahead ahead
+static float pathFollowWheelEffort(float target, float measured, float *integral, float dt);  // Wheel speed PI
+static void pathFollowEnd(void);                                               // Stop at the end of the path
+static float pathFollowWrapAngle(float angle);                                 // Angle to -PI..PI
+
+/*** Public Function Definitions **********************************************/
+
+void pathFollow_init(void)
+{
+  pathFollow_stop();
+  encoder_reset_left_position();
+  encoder_reset_right_position();
+  prevLeftCount = 0;
+  prevRightCount = 0;
+  pathFollow_set_pose(0.0f, 0.0f, 0.0f);
+  pathPrevUpdate = millis();
+  pathNextUpdate = pathPrevUpdate;
+}
+
+bool pathFollow_set_waypoints(const PATHFOLLOW_POINT *points, int count)
+{
+  if((count < 2) || (count > PATHFOLLOW_MAX_POINTS))
+  {
+    CETALIB_LOG_ERROR("pathFollow: %d waypoints (2 to %d)", count, PATHFOLLOW_MAX_POINTS);
+    return false;
+  }
+  return pathFollowLoad(points, count);
+}
+
+bool pathFollow_set_spline(const PATHFOLLOW_POINT *points, int count)
+{
+  static PATHFOLLOW_POINT samples[PATHFOLLOW_MAX_POINTS];
+  int maxPoints = (PATHFOLLOW_MAX_POINTS - 1) / PATHFOLLOW_SPLINE_STEPS + 1;
+
+  if((count < 2) || (count > maxPoints))
+  {
+    CETALIB_LOG_ERROR("pathFollow: %d spline points (2 to %d)", count, maxPoints);
+    return false;
+  }
+
+  // uniform Catmull-Rom spline: passes through every point, the end points
+  // are repeated so the curve starts and ends on them
+  int numSamples = 0;
+  for(int i = 0; i < count - 1; i++)
+  {
+    const PATHFOLLOW_POINT &p0 = points[(i > 0) ? (i - 1) : 0];
+    const PATHFOLLOW_POINT &p1 = points[i];
+    const PATHFOLLOW_POINT &p2 = points[i + 1];
+    const PATHFOLLOW_POINT &p3 = points[(i + 2 < count) ? (i + 2) : (count - 1)];
+    for(int step = 0; step < PATHFOLLOW_SPLINE_STEPS; step++)
+    {
+      float t = (float)step / PATHFOLLOW_SPLINE_STEPS;
+      float t2 = t * t;
+      float t3 = t2 * t;
+      samples[numSamples].x = 0.5f * ((2.0f * p1.x) + (p2.x - p0.x) * t + (2.0f * p0.x - 5.0f * p1.x + 4.0f * p2.x - p3.x) * t2 + (3.0f * p1.x - p0.x - 3.0f * p2.x + p3.x) * t3);
+      samples[numSamples].y = 0.5f * ((2.0f * p1.y) + (p2.y - p0.y) * t + (2.0f * p0.y - 5.0f * p1.y + 4.0f * p2.y - p3.y) * t2 + (3.0f * p1.y - p0.y - 3.0f * p2.y + p3.y) * t3);
+      numSamples++;
+    }
+  }
+  samples[numSamples++] = points[count - 1];
+  return pathFollowLoad(samples, numSamples);
+}
+
+void pathFollow_set_lookahead(float distance)
+{
+  pathLookahead = (distance < PATHFOLLOW_LOOKAHEAD_MIN) ? PATHFOLLOW_LOOKAHEAD_MIN : distance;
+}
+
+bool pathFollow_start(float speed)
+{
+  if(pathCount < 2)
+  {
+    CETALIB_LOG_ERROR("pathFollow: no path, call set_waypoints() or set_spline() first");
+    return false;
+  }
+  if(speed <= 0.0f)
+  {
+    CETALIB_LOG_ERROR("pathFollow: speed %.1f cm/s must be > 0", speed);
+    return false;
+  }
+  pathSpeed = speed;
+  pathSegment = 0;
+  pathAlong = 0.0f;
+  pathCrossTrack = 0.0f;
+  leftSpeedIntegral = 0.0f;
+  rightSpeedIntegral = 0.0f;
+  crossTrackSquares = 0.0f;
+  memset(&pathStats, 0, sizeof(pathStats));
+  pathStartTime = millis();
+  pathComplete = false;
+  pathRunning = true;
+  return true;
+}
+
+void pathFollow_stop(void)
+{
+  if(pathRunning)
+  {
+    pathRunning = false;
+    diffDrive_stop();
+  }
+}
+
+void pathFollow_tasks(void)
+{
+  unsigned long now = millis();
+  if((long)(now - pathNextUpdate) < 0)
+  {
+    return;
+  }
+  CETALIB_TRACE_BEGIN("pathFollow", "tasks", pathSegment);
+
+  // fixed rate updates; when tasks() was called too late, restart the schedule from now
+  if((now - pathNextUpdate) >= PATHFOLLOW_INTERVAL)
+  {
+    if(pathRunning)
+    {
+      pathStats.lateUpdates++;
+    }
+    pathNextUpdate = now;
+  }
+  pathNextUpdate += PATHFOLLOW_INTERVAL;
+  float dt = (now - pathPrevUpdate) / 1000.0f;
+  pathPrevUpdate = now;
+
+  float leftSpeed, rightSpeed;
+  pathFollowOdometry(dt, &leftSpeed, &rightSpeed);
+  if(pathRunning && (dt > 0.0f))
+  {
+    pathFollowControl(dt, leftSpeed, rightSpeed);
+  }
+  CETALIB_TRACE_END("pathFollow", "tasks", pathRunning);
+}
+
+bool pathFollow_is_complete(void)
+{
+  return pathComplete;
+}
+
+float pathFollow_get_cross_track_error(void)
+{
+  return pathCrossTrack;
+}
+
+float pathFollow_get_progress(void)
+{
+  if(pathCount < 2)
+  {
+    return 0.0f;
+  }
+  return pathComplete ? 1.0f : (pathAlong / pathDistance[pathCount - 1]);
+}
+
+void pathFollow_get_pose(float *x, float *y, float *heading)
+{
+  *x = poseX;
+  *y = poseY;
+  float degrees = poseHeading * (180.0f / (float)M_PI);
+  *heading = (degrees < 0.0f) ? (degrees + 360.0f) : degrees;
+}
+
+void pathFollow_set_pose(float x, float y, float heading)
+{
+  poseX = x;
+  poseY = y;
+  poseHeading = pathFollowWrapAngle(heading * ((float)M_PI / 180.0f));
+}
+
+PATHFOLLOW_STATS* pathFollow_get_stats(void)
+{
+  return &pathStats;
+}
+
+/*** Private Function Definitions *********************************************/
+
+static bool pathFollowLoad(const PATHFOLLOW_POINT *points, int count)
+{
+  if(pathRunning)
+  {
+    CETALIB_LOG_ERROR("pathFollow: stop() before changing the path");
+    return false;
+  }
+  pathCount = 0;
+  for(int i = 0; i < count; i++)
+  {
+    float length = 0.0f;
+    if(pathCount > 0)
+    {
+      length = hypotf(points[i].x - pathPoints[pathCount - 1].x, points[i].y - pathPoints[pathCount - 1].y);
+      if(length < 0.01f)
+      {
+        continue;   // repeated point, no segment
+      }
+      length += pathDistance[pathCount - 1];
+    }
+    pathPoints[pathCount] = points[i];
+    pathDistance[pathCount] = length;
+    pathCount++;
+  }
+  if(pathCount < 2)
+  {
+    CETALIB_LOG_ERROR("pathFollow: path has no length");
+    return false;
+  }
+  pathComplete = false;
+  return true;
+}
+
+static void pathFollowOdometry(float dt, float *leftSpeed, float *rightSpeed)
+{
+  int leftCount = encoder_get_left_position_counts();
+  int rightCount = encoder_get_right_position_counts();
+  float left = (leftCount - prevLeftCount) * PATHFOLLOW_CM_PER_COUNT;
+  float right = (rightCount - prevRightCount) * PATHFOLLOW_CM_PER_COUNT;
+  prevLeftCount = leftCount;
+  prevRightCount = rightCount;
+
+  // move along the arc, approximated by a straight line at the mid-arc heading
+  float distance = 0.5f * (left + right);
+  float turn = (right - left) / PATHFOLLOW_TRACK_WIDTH;
+  float midHeading = poseHeading + 0.5f * turn;
+  poseX += distance * cosf(midHeading);
+  poseY += distance * sinf(midHeading);
+  poseHeading = pathFollowWrapAngle(poseHeading + turn);
+
+  *leftSpeed = (dt > 0.0f) ? (left / dt) : 0.0f;
+  *rightSpeed = (dt > 0.0f) ? (right / dt) : 0.0f;
+}
+
+static void pathFollowControl(float dt, float leftSpeed, float rightSpeed)
+{
+  pathFollowClosest();
+  float crossTrack = fabsf(pathCrossTrack);
+  pathStats.updates++;
+  crossTrackSquares += crossTrack * crossTrack;
+  pathStats.rmsCrossTrackError = sqrtf(crossTrackSquares / pathStats.updates);
+  if(crossTrack > pathStats.maxCrossTrackError)
+  {
+    pathStats.maxCrossTrackError = crossTrack;
+  }
+
+  // the end is reached within the tolerance of the last point (on the last
+  // lookahead of the path, so a closed path does not end at its start), or
+  // when the closest point is past the last point
+  const PATHFOLLOW_POINT &last = pathPoints[pathCount - 1];
+  float remaining = pathDistance[pathCount - 1] - pathAlong;
+  if(((remaining < pathLookahead) && (hypotf(last.x - poseX, last.y - poseY) < PATHFOLLOW_GOAL_TOLERANCE)) || (remaining <= 0.0f))
+  {
+    pathFollowEnd();
+    return;
+  }
+
+  // pure pursuit: curvature of the arc from the robot to the lookahead point
+  float targetX, targetY;
+  pathFollowLookaheadPoint(&targetX, &targetY);
+  float dx = targetX - poseX;
+  float dy = targetY - poseY;
+  float localY = cosf(poseHeading) * dy - sinf(poseHeading) * dx;
+  float distanceSquared = dx * dx + dy * dy;
+  float curvature = (distanceSquared > 0.01f) ? (2.0f * localY / distanceSquared) : 0.0f;
+
+  // speed limits: lateral acceleration in curves, deceleration to stop at the end
+  float speed = pathSpeed;
+  if(fabsf(curvature) > 0.0001f)
+  {
+    speed = min(speed, sqrtf(PATHFOLLOW_MAX_LATERAL_ACCEL / fabsf(curvature)));
+  }
+  speed = min(speed, sqrtf(2.0f * PATHFOLLOW_MAX_DECEL * remaining));
+  speed = max(speed, min(PATHFOLLOW_MIN_SPEED, pathSpeed));
+
+  // wheel speeds on the arc
+  float leftTarget = speed * (1.0f - 0.5f * curvature * PATHFOLLOW_TRACK_WIDTH);
+  float rightTarget = speed * (1.0f + 0.5f * curvature * PATHFOLLOW_TRACK_WIDTH);
+  float leftEffort = pathFollowWheelEffort(leftTarget, leftSpeed, &leftSpeedIntegral, dt);
+  float rightEffort = pathFollowWheelEffort(rightTarget, rightSpeed, &rightSpeedIntegral, dt);
+  diffDrive_set_efforts(leftEffort, rightEffort);
+}
+
+// Searches forward from the previous closest segment only (up to
+// PATHFOLLOW_SEARCH_DISTANCE), so a path that crosses itself is followed in order
+static void pathFollowClosest(void)
+{
+  float bestDistance = -1.0f;
+  for(int i = pathSegment; i < pathCount - 1; i++)
+  {
+    if((i > pathSegment) && (pathDistance[i] > pathAlong + PATHFOLLOW_SEARCH_DISTANCE))
+    {
+      break;
+    }
+    const PATHFOLLOW_POINT &a = pathPoints[i];
+    const PATHFOLLOW_POINT &b = pathPoints[i + 1];
+    float length = pathDistance[i + 1] - pathDistance[i];
+    float ux = (b.x - a.x) / length;
+    float uy = (b.y - a.y) / length;
+    float along = (poseX - a.x) * ux + (poseY - a.y) * uy;
+    float side = (poseY - a.y) * ux - (poseX - a.x) * uy;
+    float clamped = constrain(along, 0.0f, length);
+    float distance = hypotf(along - clamped, side);
+    if((bestDistance < 0.0f) || (distance < bestDistance))
+    {
+      bestDistance = distance;
+      pathSegment = i;
+      // past the end of the last segment counts as the end of the path
+      pathAlong = pathDistance[i] + ((i == pathCount - 2) ? along : clamped);
+      pathCrossTrack = (side < 0.0f) ? -distance : distance;
+    }
+  }
+}
+
+// Beyond the last point, the lookahead point continues on the line of the
+// last segment, so the robot does not turn toward the end point when it gets close
+static void pathFollowLookaheadPoint(float *x, float *y)
+{
+  float target = pathAlong + pathLookahead;
+  int i = pathSegment;
+  while((i < pathCount - 2) && (pathDistance[i + 1] < target))
+  {
+    i++;
+  }
+  const PATHFOLLOW_POINT &a = pathPoints[i];
+  const PATHFOLLOW_POINT &b = pathPoints[i + 1];
+  float length = pathDistance[i + 1] - pathDistance[i];
+  float fraction = (target - pathDistance[i]) / length;
+  *x = a.x + (b.x - a.x) * fraction;
+  *y = a.y + (b.y - a.y) * fraction;
+}
+
+static float pathFollowWheelEffort(float target, float measured, float *integral, float dt)
+{
+  float error = target - measured;
+  *integral = constrain(*integral + PATHFOLLOW_SPEED_KI * error * dt, -PATHFOLLOW_SPEED_I_LIMIT, PATHFOLLOW_SPEED_I_LIMIT);
+  float effort = target / PATHFOLLOW_MAX_WHEEL_SPEED + PATHFOLLOW_SPEED_KP * error + *integral;
+  return constrain(effort, -1.0f, 1.0f);
+}
+
+static void pathFollowEnd(void)
+{
+  pathFollow_stop();
+  pathComplete = true;
+  pathAlong = pathDistance[pathCount - 1];
+  pathStats.pathTime = millis() - pathStartTime;
+  CETALIB_TRACE_INSTANT("pathFollow", "complete", pathStats.pathTime);
+}
+
+static float pathFollowWrapAngle(float angle)
+{
+  while(angle >= (float)M_PI)
+  {
+    angle -= 2.0f * (float)M_PI;
+  }
+  while(angle < -(float)M_PI)
+  {
+    angle += 2.0f * (float)M_PI;
+  }
+  return angle;
+}
+
+#endif
@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2026 dBm Signal Dynamics Inc.
+ *
+ * File:            pathFollow.h
+ * Project:
+ * Date:            Oct 19, 2026
+ * Framework:       Arduino w. Arduino-Pico Core Pkge by Earl Philhower
+ *                  (https://github.com/earlephilhower/arduino-pico)
+ *
+ * cetalib "pathFollow" path follower (pure pursuit on wheel odometry)
+ *
+ * Hardware Configurations Supported:
+ *
+ * Sparkfun XRP Robot Platform (#KIT-27644), based on the RPI RP2350B MCU
+ * (Select "Board = SparkFun XRP Controller")
+ *
+ * Sparkfun XRP (Beta) Robot Platform (#KIT-22230), based on the RPI Pico W
+ * (Select "Board = SparkFun XRP Controller (Beta)")
+ *
+ */
+
+#ifndef PATHFOLLOW_H_
+#define PATHFOLLOW_H_
+
+/*** Include Files ************************************************************/
+#include <Arduino.h>
+#include "pathFollow_interface.h"
+
+/*** Macros *******************************************************************/
+
+// Robot geometry (XRP)
+#define PATHFOLLOW_WHEEL_DIAMETER       6.0f      // Wheel diameter (in cm)
+#define PATHFOLLOW_TRACK_WIDTH          15.5f     // Distance between the wheel contact points (in cm)
+#define PATHFOLLOW_COUNTS_PER_REV       585       // Encoder counts per wheel revolution
+
+// Controller
+#define PATHFOLLOW_INTERVAL             20        // Control update period (in mS)
+#define PATHFOLLOW_LOOKAHEAD_DEFAULT    12.0f     // Default lookahead distance (in cm)
+#define PATHFOLLOW_LOOKAHEAD_MIN        3.0f      // Shortest lookahead distance (in cm)
+#define PATHFOLLOW_MAX_LATERAL_ACCEL    40.0f     // Speed limit in curves: v^2 x curvature (in cm/s^2)
+#define PATHFOLLOW_MAX_DECEL            40.0f     // Deceleration at the end of the path (in cm/s^2)
+#define PATHFOLLOW_MIN_SPEED            4.0f      // Slowest speed before the end of the path (in cm/s)
+#define PATHFOLLOW_GOAL_TOLERANCE       1.5f      // Distance from the last point that completes the path (in cm)
+
+// Wheel speed control: effort = speed / max speed + PI correction
+#define PATHFOLLOW_MAX_WHEEL_SPEED      50.0f     // Wheel speed at full effort (in cm/s, measure and adjust)
+#define PATHFOLLOW_SPEED_KP             0.01f     // Effort per cm/s of wheel speed error
+#define PATHFOLLOW_SPEED_KI             0.05f     // Effort per cm of accumulated wheel speed error
+#define PATHFOLLOW_SPEED_I_LIMIT        0.3f      // Largest integral correction (effort)
+
+// Path storage
+#define PATHFOLLOW_MAX_POINTS           128       // Max number of path points (waypoints or spline samples)
+#define PATHFOLLOW_SPLINE_STEPS         8         // Samples per spline segment (max 16 spline points)
+
+/*** Custom Data Types ********************************************************/
+
+/*** Public Function Prototypes ***********************************************/
+#if defined(ARDUINO_SPARKFUN_XRP_CONTROLLER) || defined(ARDUINO_SPARKFUN_XRP_CONTROLLER_BETA)
+void pathFollow_init(void);                                             // Reset the pose (0, 0, 0) and the encoders
+bool pathFollow_set_waypoints(const PATHFOLLOW_POINT *points, int count);  // Follow straight lines through the points
+bool pathFollow_set_spline(const PATHFOLLOW_POINT *points, int count);     // Follow a smooth curve through the points
+void pathFollow_set_lookahead(float distance);                          // Set the lookahead distance (in cm)
+bool pathFollow_start(float speed);                                     // Start following the path at "speed" (in cm/s)
+void pathFollow_stop(void);                                             // Stop following the path (and the motors)
+void pathFollow_tasks(void);                                            // Update the pose and the wheel efforts
+bool pathFollow_is_complete(void);                                      // true when the end of the path is reached
+float pathFollow_get_cross_track_error(void);                           // Distance from the path (in cm, > 0 left of the path)
+float pathFollow_get_progress(void);                                    // Fraction of the path length completed
+void pathFollow_get_pose(float *x, float *y, float *heading);           // Robot position (in cm) and heading (in degrees)
+void pathFollow_set_pose(float x, float y, float heading);              // Set the robot position and heading
+PATHFOLLOW_STATS* pathFollow_get_stats(void);                           // Returns a pointer to the tracking counters
+#endif
+
+#endif /* PATHFOLLOW_H_ */
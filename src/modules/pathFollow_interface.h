@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2026 dBm Signal Dynamics Inc.
+ *
+ * File:            pathFollow_interface.h
+ * Project:
+ * Date:            Oct 19, 2026
+ * Framework:       Arduino w. Arduino-Pico Core Pkge by Earl Philhower
+ *                  (https://github.com/earlephilhower/arduino-pico)
+ *
+ * "pathFollow" driver interface file - defines "PATHFOLLOW_INTERFACE" structure
+ *
+ * Hardware Configurations Supported:
+ *
+ * Sparkfun XRP Robot Platform (#KIT-27644), based on the RPI RP2350B MCU
+ * (Select "Board = SparkFun XRP Controller")
+ *
+ * Sparkfun XRP (Beta) Robot Platform (#KIT-22230), based on the RPI Pico W
+ * (Select "Board = SparkFun XRP Controller (Beta)")
+ *
+ */
+
+#ifndef PATHFOLLOW_INTERFACE_H_
+#define PATHFOLLOW_INTERFACE_H_
+
+/*** Include Files ************************************************************/
+#include <Arduino.h>
+
+/*** Macros *******************************************************************/
+
+/*** Custom Data Types ********************************************************/
+
+// A point of the path, in the odometry frame (in cm): the robot starts at
+// (0, 0) facing the +x direction, +y is to its left
+typedef struct
+{
+  float x;
+  float y;
+} PATHFOLLOW_POINT;
+
+typedef struct
+{
+  unsigned long updates;            // number of control updates since start()
+  unsigned long lateUpdates;        // updates started more than one interval late (tasks() not called often enough)
+  float maxCrossTrackError;         // largest cross-track error since start() (in cm, absolute value)
+  float rmsCrossTrackError;         // RMS cross-track error since start() (in cm)
+  unsigned long pathTime;           // time from start() to the end of the path (in mS, 0 while following)
+} PATHFOLLOW_STATS;
+
+struct PATHFOLLOW_INTERFACE
+{
+  void (*initialize)(void);                                             // Reset the pose (0, 0, 0) and the encoders
+  bool (*set_waypoints)(const PATHFOLLOW_POINT *points, int count);     // Follow straight lines through the points
+  bool (*set_spline)(const PATHFOLLOW_POINT *points, int count);        // Follow a smooth curve through the points
+  void (*set_lookahead)(float distance);                                // Set the pure-pursuit lookahead distance (in cm)
+  bool (*start)(float speed);                                           // Start following the path at "speed" (in cm/s)
+  void (*stop)(void);                                                   // Stop following the path (and the motors)
+  void (*tasks)(void);                                                  // Update the pose and the wheel efforts (call often)
+  bool (*is_complete)(void);                                            // true when the end of the path is reached
+  float (*get_cross_track_error)(void);                                 // Distance from the path (in cm, > 0 left of the path)
+  float (*get_progress)(void);                                          // Fraction of the path length completed (0.0 to 1.0)
+  void (*get_pose)(float *x, float *y, float *heading);                 // Robot position (in cm) and heading (in degrees, 0-360)
+  void (*set_pose)(float x, float y, float heading);                    // Set the robot position (in cm) and heading (in degrees)
+  PATHFOLLOW_STATS* (*get_stats)(void);                                 // Returns a pointer to the tracking counters
+};
+
+/*** Public Function Prototypes ***********************************************/
+
+
+#endif /* PATHFOLLOW_INTERFACE_H_ */
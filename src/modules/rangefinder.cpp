@@ -28,6 +28,8 @@
 /** Include Files *************************************************************/
 #include <Arduino.h>                // Required for Arduino functions
 #include "rangefinder.h"            // "rangefinder" API declarations
+#include "replay.h"                 // "replay" functions
+#include "trace.h"                  // "trace" event macros
 
 /*** Symbolic Constants used in this module ***********************************/
 
@@ -43,6 +45,7 @@ static unsigned int timeoutUs, maxDistanceCm, maxTimeoutMicroSec;
 
 /*** Private Function Prototypes **********************************************/
 static float measureDistanceCm(float temperature);
+static unsigned long measureEchoMicroSec(float speedOfSoundInCmPerMicroSec);
 
 /*** Public Function Definitions **********************************************/
 
@@ -62,6 +65,27 @@ float rangefinder_get_distance(void)
 }
 
 static float measureDistanceCm(float temperature)
+{
+    float speedOfSoundInCmPerMicroSec = 0.03313 + 0.0000606 * temperature; // C (air) ≈ (331.3 + 0.606 ⋅ ϑ) m/s
+    unsigned long durationMicroSec = 0;
+
+    if (replay_is_playing()) {
+        // use the recorded echo instead of triggering the sensor
+        replay_read(REPLAY_SOURCE_RANGEFINDER_ECHO, &durationMicroSec, sizeof(durationMicroSec));
+    } else {
+        durationMicroSec = measureEchoMicroSec(speedOfSoundInCmPerMicroSec);
+        replay_input(REPLAY_SOURCE_RANGEFINDER_ECHO, &durationMicroSec, sizeof(durationMicroSec));
+    }
+
+    float distanceCm = durationMicroSec / 2.0 * speedOfSoundInCmPerMicroSec;
+    if (distanceCm == 0 || distanceCm > maxDistanceCm) {
+        return -1.0 ;
+    } else {
+        return distanceCm;
+    }
+}
+
+static unsigned long measureEchoMicroSec(float speedOfSoundInCmPerMicroSec)
 {
     unsigned long maxDistanceDurationMicroSec;
 
@@ -72,7 +96,6 @@ static float measureDistanceCm(float temperature)
     digitalWrite(HCSR04_TRIGGER_PIN, HIGH);
     delayMicroseconds(10);
     digitalWrite(HCSR04_TRIGGER_PIN, LOW);
-    float speedOfSoundInCmPerMicroSec = 0.03313 + 0.0000606 * temperature; // C (air) ≈ (331.3 + 0.606 ⋅ ϑ) m/s
 
     // Compute max delay based on max distance with 25% margin in microseconds
     maxDistanceDurationMicroSec = 2.5 * maxDistanceCm / speedOfSoundInCmPerMicroSec;
@@ -81,12 +104,8 @@ static float measureDistanceCm(float temperature)
     }
 
     // Measure the length of echo signal, which is equal to the time needed for sound to go there and back.
-    unsigned long durationMicroSec = pulseIn(HCSR04_ECHO_PIN, HIGH, maxDistanceDurationMicroSec); // can't measure beyond max distance
-
-    float distanceCm = durationMicroSec / 2.0 * speedOfSoundInCmPerMicroSec;
-    if (distanceCm == 0 || distanceCm > maxDistanceCm) {
-        return -1.0 ;
-    } else {
-        return distanceCm;
-    }
+    CETALIB_TRACE_BEGIN("rangefinder", "pulseIn", maxDistanceDurationMicroSec);
+    unsigned long echoMicroSec = pulseIn(HCSR04_ECHO_PIN, HIGH, maxDistanceDurationMicroSec); // can't measure beyond max distance
+    CETALIB_TRACE_END("rangefinder", "pulseIn", echoMicroSec);
+    return echoMicroSec;
 }
\ No newline at end of file
@@ -24,9 +24,12 @@
 
 /** Include Files *************************************************************/
 #include <Arduino.h>                // Required for Arduino functions
-#include <EEPROM.h>                 // EEPROM emulation routines
+#include "calstore.h"               // "calstore" functions
 #include "reflectance.h"            // "reflectance" API declarations
 #include "board.h"                  // "board" functions
+#include "replay.h"                 // "replay" functions
+#include "motor.h"                  // "motor" functions (auto calibration)
+#include "logger.h"                 // "logger" functions
 
 /*** Symbolic Constants used in this module ***********************************/
 #define SERIAL_PORT Serial  // Default to Serial
@@ -43,7 +46,16 @@ extern const struct REFLECTANCE_INTERFACE REFLECTANCE = {
     .get_middle_sensor      = &reflectance_get_middle_sensor,
     .get_right_sensor       = &reflectance_get_right_sensor,
     .get_line_status        = &reflectance_get_line_status,
-    .clear_calibration      = &reflectance_clear_calibration
+    .clear_calibration      = &reflectance_clear_calibration,
+    .get_left_sensor_q15    = &reflectance_get_left_sensor_q15,
+    .get_middle_sensor_q15  = &reflectance_get_middle_sensor_q15,
+    .get_right_sensor_q15   = &reflectance_get_right_sensor_q15,
+    .tasks                  = &reflectance_tasks,
+    .start_calibration      = &reflectance_start_calibration,
+    .start_auto_calibration = &reflectance_start_auto_calibration,
+    .is_calibrating         = &reflectance_is_calibrating,
+    .calibration_next       = &reflectance_calibration_next,
+    .cancel_calibration     = &reflectance_cancel_calibration
 };
 
 // calibration objects with default values assigned
@@ -53,167 +65,97 @@ static struct REFLECTANCE_CAL reflectanceCal = {
     .right_opto_trip = RIGHT_SENSOR_TRIP_DEFAULT
 };
 
+// trip thresholds in Q15, so "get_line_status()" compares integers
+// (a Q15 reading is above floor(trip*32768) exactly when the float reading is above the trip)
+static int32_t leftTripQ15 = (int32_t)(LEFT_SENSOR_TRIP_DEFAULT*32768.0f);
+static int32_t middleTripQ15 = (int32_t)(MIDDLE_SENSOR_TRIP_DEFAULT*32768.0f);
+static int32_t rightTripQ15 = (int32_t)(RIGHT_SENSOR_TRIP_DEFAULT*32768.0f);
+
 static enum REFLECTANCE_CALIBRATION_STATE calState = IDLE;
 
+// calibration routine variables ([0] = left, [1] = middle, [2] = right)
+static bool calNextRequest = false;                 // calibration_next() called
+static int sample_counter;
+static int opto_accumulator[3];
+static int opto_white[3];
+static int opto_min[3], opto_max[3];
+static unsigned long previousOptoSampleTime;
+static unsigned long sweepStartTime;
+static float sweepEffort;
+
 /*** Private Function Prototypes **********************************************/
+static int reflectanceReadAdc(int pin, enum REPLAY_SOURCE source);  // Read a sensor (recorded or replayed)
+static void reflectanceUpdateTrips(void);                           // Convert the trip thresholds to Q15
+static void reflectancePrintCalibration(void);                      // Print the trip thresholds
+static void reflectanceCalRestart(void);                            // Clear the calibration averages
+static void reflectanceCalSample(int *values);                      // Read all sensors (calibration)
+static void reflectanceCalAccumulate(const int *values);            // Add a reading to the averages
+static void reflectanceSweepComplete(void);                         // Check and save the auto calibration
+static void reflectanceCalSave(const int *tripLevels);              // Use and save new trip thresholds (ADC levels)
 
 /*** Public Function Definitions **********************************************/
 
 void reflectance_init(void)
 {
-    // calibration variables
-    int left_opto_accumulator, middle_opto_accumulator, right_opto_accumulator;
-    int left_opto_white, middle_opto_white, right_opto_white;
-    int left_opto_black, middle_opto_black, right_opto_black;
-    int sample_counter;
-    int num_samples = CALIBRATION_INTERVAL/SAMPLE_INTERVAL;
-    unsigned long currentOptoSampleTime;
-    unsigned long previousOptoSampleTime = 0;
-    sample_counter = 0;
-    left_opto_accumulator = 0;
-    middle_opto_accumulator = 0;
-    right_opto_accumulator = 0;
-
     // Left, Middle and Right sensor analog input pins already initialized
 
     // set ADC resolution to 12-bit
     analogReadResolution(12);
 
-    // Perform line detection calibration if EEPROM calibration memory is blank
-    EEPROM.begin(1024);
-    uint32_t testRead = 0;
-    if(EEPROM.get(REFLECTANCE_CAL_EEPROM_ADDRESS_START, testRead) == 0xFFFFFFFF)
+    // Perform line detection calibration if there is no valid calibration record
+    if(!calstore_read(CALSTORE_RECORD_REFLECTANCE, &reflectanceCal, sizeof(reflectanceCal)))
     {
+        // No calibration record, run the calibration routine until it is complete
         SERIAL_PORT.println("Reflectance Sensor Calibration Routine Triggered");
-        SERIAL_PORT.println("Position all sensors behind the starting Tee, then Press the USER Switch to begin");
-        // EEPROM is blank, perform calibration procedure
-        calState = WAIT_BEGIN_WHITE;
-        //board_init();
-        board_led_pattern(5);
-        while (calState != IDLE)
+        reflectance_start_calibration();
+        while (reflectance_is_calibrating())
         {
             board_tasks();
-            switch(calState)
-            {
-                case WAIT_BEGIN_WHITE:
-                    if(board_is_button_pressed())
-                    {
-                        board_led_pattern(1);   // indicate "CALIBRATE_WHITE" state
-                        calState = CALIBRATE_WHITE;
-                    }
-                    break;
-                case CALIBRATE_WHITE:
-                    if(sample_counter <= num_samples)
-                    {
-                        currentOptoSampleTime = millis();
-                        if((currentOptoSampleTime - previousOptoSampleTime) >= SAMPLE_INTERVAL)
-                        {
-		                    previousOptoSampleTime = currentOptoSampleTime;
-                            left_opto_accumulator += analogRead(LEFT_SENSOR_PIN);
-                            #if defined(ARDUINO_RASPBERRY_PI_PICO_W)
-                                middle_opto_accumulator += analogRead(MIDDLE_SENSOR_PIN);
-                            #endif
-                            right_opto_accumulator += analogRead(RIGHT_SENSOR_PIN);
-                            sample_counter++;     
-                        }
-                    }
-                    else
-                    {
-                        left_opto_white = left_opto_accumulator/num_samples;
-                        middle_opto_white = middle_opto_accumulator/num_samples;
-                        right_opto_white = right_opto_accumulator/num_samples;
-                        sample_counter = 0;
-                        left_opto_accumulator = 0;
-                        middle_opto_accumulator = 0;
-                        right_opto_accumulator = 0;
-                        board_led_pattern(5);   // signal next instruction
-                        SERIAL_PORT.println("Position all sensors over the starting Tee, then Press the USER Switch to continue");
-                        calState = WAIT_BEGIN_BLACK;
-                    }
-                    break;
-                case WAIT_BEGIN_BLACK:
-                    if(board_is_button_pressed())
-                    {
-                        board_led_pattern(2);   // indicate "CALIBRATE_BLACK" state
-                        calState = CALIBRATE_BLACK;
-                    }
-                    break;
-                case CALIBRATE_BLACK:
-                    if(sample_counter <= num_samples)
-                    {
-                        currentOptoSampleTime = millis();
-                        if((currentOptoSampleTime - previousOptoSampleTime) >= SAMPLE_INTERVAL)
-                        {
-		                    previousOptoSampleTime = currentOptoSampleTime;
-                            left_opto_accumulator += analogRead(LEFT_SENSOR_PIN);
-                            #if defined(ARDUINO_RASPBERRY_PI_PICO_W)
-                                middle_opto_accumulator += analogRead(MIDDLE_SENSOR_PIN);
-                            #endif
-                            right_opto_accumulator += analogRead(RIGHT_SENSOR_PIN);
-                            sample_counter++;     
-                        }
-                    }
-                    else
-                    {
-                        left_opto_black = left_opto_accumulator/num_samples;
-                        middle_opto_black = middle_opto_accumulator/num_samples;
-                        right_opto_black = right_opto_accumulator/num_samples;
-                        reflectanceCal.left_opto_trip = (float)((left_opto_white + left_opto_black)/2)/MAX_ADC_VALUE;
-                        reflectanceCal.middle_opto_trip = (float)((middle_opto_white + middle_opto_black)/2)/MAX_ADC_VALUE;
-                        reflectanceCal.right_opto_trip = (float)((right_opto_white + right_opto_black)/2)/MAX_ADC_VALUE;
-                        SERIAL_PORT.print("Left Opto Trip: ");
-                        SERIAL_PORT.print(reflectanceCal.left_opto_trip, 3);
-                        SERIAL_PORT.print(" Middle Opto Trip: ");
-                        SERIAL_PORT.print(reflectanceCal.middle_opto_trip, 3);
-                        SERIAL_PORT.print(" Right Opto Trip: ");
-                        SERIAL_PORT.println(reflectanceCal.right_opto_trip, 3);
-                        calState = IDLE;
-                        board_led_off();
-                    }
-                    break;
-                default:
-                    calState = IDLE;
-                    board_led_off();
-                    break;
-            }
+            reflectance_tasks();    // runs the calibration routine
         }
-        // Save calibration values to EEPROM memory
-        EEPROM.put(REFLECTANCE_CAL_EEPROM_ADDRESS_START, reflectanceCal);
     }
     else
     {
-        // EEPROM is programmed with calibration values, so use them
-        EEPROM.get(REFLECTANCE_CAL_EEPROM_ADDRESS_START, reflectanceCal);
-        SERIAL_PORT.print("Left Opto Trip: ");
-        SERIAL_PORT.print(reflectanceCal.left_opto_trip, 3);
-        SERIAL_PORT.print(" Middle Opto Trip: ");
-        SERIAL_PORT.print(reflectanceCal.middle_opto_trip, 3);
-        SERIAL_PORT.print(" Right Opto Trip: ");
-        SERIAL_PORT.println(reflectanceCal.right_opto_trip, 3);
+        // Calibration record is valid, so use it
+        reflectancePrintCalibration();
     }
-    // Write any changes to EEPROM and close interface.
-    EEPROM.end();
+    reflectanceUpdateTrips();
 }
 
 float reflectance_get_left_sensor(void)
 {
-    return (float)(analogRead(LEFT_SENSOR_PIN)/MAX_ADC_VALUE);
+    return q15_to_float(reflectance_get_left_sensor_q15());
 }
 
 float reflectance_get_middle_sensor(void)
+{
+    return q15_to_float(reflectance_get_middle_sensor_q15());
+}
+
+float reflectance_get_right_sensor(void)
+{
+    return q15_to_float(reflectance_get_right_sensor_q15());
+}
+
+q15_t reflectance_get_left_sensor_q15(void)
+{
+    return (q15_t)(reflectanceReadAdc(LEFT_SENSOR_PIN, REPLAY_SOURCE_REFLECTANCE_LEFT) << ADC_TO_Q15_SHIFT);
+}
+
+q15_t reflectance_get_middle_sensor_q15(void)
 {
     #if defined(ARDUINO_RASPBERRY_PI_PICO_W)
-        return (float)(analogRead(MIDDLE_SENSOR_PIN)/MAX_ADC_VALUE);
+        return (q15_t)(reflectanceReadAdc(MIDDLE_SENSOR_PIN, REPLAY_SOURCE_REFLECTANCE_MIDDLE) << ADC_TO_Q15_SHIFT);
     #elif defined(ARDUINO_SPARKFUN_XRP_CONTROLLER) || defined(ARDUINO_SPARKFUN_XRP_CONTROLLER_BETA)
-        return 0.0f;
+        return 0;
     #else
         #error Unsupported board selection
     #endif
 }
 
-float reflectance_get_right_sensor(void)
+q15_t reflectance_get_right_sensor_q15(void)
 {
-    return (float)(analogRead(RIGHT_SENSOR_PIN)/MAX_ADC_VALUE);
+    return (q15_t)(reflectanceReadAdc(RIGHT_SENSOR_PIN, REPLAY_SOURCE_REFLECTANCE_RIGHT) << ADC_TO_Q15_SHIFT);
 }
 
 /*******************************************************************************
@@ -247,25 +189,320 @@ int reflectance_get_line_status(void)
 {
     int temp = 0;
     // has a line been detected?
-    if(reflectance_get_left_sensor() > reflectanceCal.left_opto_trip){
+    if(reflectance_get_left_sensor_q15() > leftTripQ15){
         temp = temp | 4;
     }
-    if(reflectance_get_middle_sensor() > reflectanceCal.middle_opto_trip){
+    if(reflectance_get_middle_sensor_q15() > middleTripQ15){
         temp = temp | 2;
     }
-    if(reflectance_get_right_sensor() > reflectanceCal.right_opto_trip){
+    if(reflectance_get_right_sensor_q15() > rightTripQ15){
         temp = temp | 1;
     }
     return temp;
 }
 
+/*******************************************************************************
+ * Function:        void reflectance_tasks(void)
+ *
+ * Description:     Advance the calibration routine (call from the sketch loop)
+ *
+ * Overview:        USER switch routine: the sensors are averaged over the
+ *                  background ("white"), then over the line ("black"), for
+ *                  CALIBRATION_INTERVAL mS each. The trip thresholds are
+ *                  half-way between the two averages.
+ *
+ *                  Auto routine: the robot drives over the line and back,
+ *                  REFLECTANCE_SWEEP_TIME mS each way. The trip thresholds
+ *                  are half-way between the lowest and highest reading of
+ *                  each sensor.
+ *
+ *                  The previous trip thresholds are used until the routine
+ *                  completes, then the new ones are saved with one commit.
+ ******************************************************************************/
+
+void reflectance_tasks(void)
+{
+    int values[3];
+    int num_samples = CALIBRATION_INTERVAL/SAMPLE_INTERVAL;
+
+    if(calState == IDLE)
+    {
+        return;
+    }
+    bool next = board_is_button_pressed() || calNextRequest;
+    calNextRequest = false;
+    unsigned long currentOptoSampleTime = millis();
+    bool sampleDue = ((currentOptoSampleTime - previousOptoSampleTime) >= SAMPLE_INTERVAL);
+    if(sampleDue)
+    {
+        previousOptoSampleTime = currentOptoSampleTime;
+    }
+
+    switch(calState)
+    {
+        case WAIT_BEGIN_WHITE:
+            if(next)
+            {
+                board_led_pattern(1);   // indicate "CALIBRATE_WHITE" state
+                reflectanceCalRestart();
+                calState = CALIBRATE_WHITE;
+            }
+            break;
+        case CALIBRATE_WHITE:
+            if(sample_counter < num_samples)
+            {
+                if(sampleDue)
+                {
+                    reflectanceCalSample(values);
+                    reflectanceCalAccumulate(values);
+                }
+            }
+            else
+            {
+                for(int i = 0; i < 3; i++)
+                {
+                    opto_white[i] = opto_accumulator[i]/num_samples;
+                }
+                board_led_pattern(5);   // signal next instruction
+                SERIAL_PORT.println("Position all sensors over the starting Tee, then Press the USER Switch to continue");
+                calState = WAIT_BEGIN_BLACK;
+            }
+            break;
+        case WAIT_BEGIN_BLACK:
+            if(next)
+            {
+                board_led_pattern(2);   // indicate "CALIBRATE_BLACK" state
+                reflectanceCalRestart();
+                calState = CALIBRATE_BLACK;
+            }
+            break;
+        case CALIBRATE_BLACK:
+            if(sample_counter < num_samples)
+            {
+                if(sampleDue)
+                {
+                    reflectanceCalSample(values);
+                    reflectanceCalAccumulate(values);
+                }
+            }
+            else
+            {
+                for(int i = 0; i < 3; i++)
+                {
+                    values[i] = (opto_white[i] + opto_accumulator[i]/num_samples)/2;
+                }
+                calState = IDLE;
+                board_led_off();
+                reflectanceCalSave(values);
+            }
+            break;
+        case CALIBRATE_SWEEP_FORWARD:
+        case CALIBRATE_SWEEP_REVERSE:
+            if(sampleDue)
+            {
+                reflectanceCalSample(values);
+                for(int i = 0; i < 3; i++)
+                {
+                    opto_min[i] = min(opto_min[i], values[i]);
+                    opto_max[i] = max(opto_max[i], values[i]);
+                }
+            }
+            if((currentOptoSampleTime - sweepStartTime) >= REFLECTANCE_SWEEP_TIME)
+            {
+                if(calState == CALIBRATE_SWEEP_FORWARD)
+                {
+                    // back to the starting position
+                    motor_set_efforts(-sweepEffort, -sweepEffort);
+                    sweepStartTime = currentOptoSampleTime;
+                    calState = CALIBRATE_SWEEP_REVERSE;
+                }
+                else
+                {
+                    motor_set_efforts(0.0f, 0.0f);
+                    calState = IDLE;
+                    board_led_off();
+                    reflectanceSweepComplete();
+                }
+            }
+            break;
+        default:
+            calState = IDLE;
+            board_led_off();
+            break;
+    }
+}
+
+bool reflectance_start_calibration(void)
+{
+    if(calState != IDLE)
+    {
+        CETALIB_LOG_ERROR("reflectance: calibration already running");
+        return false;
+    }
+    analogReadResolution(12);
+    SERIAL_PORT.println("Position all sensors behind the starting Tee, then Press the USER Switch to begin");
+    calNextRequest = false;
+    calState = WAIT_BEGIN_WHITE;
+    board_led_pattern(5);
+    return true;
+}
+
+bool reflectance_start_auto_calibration(float effort)
+{
+    if(calState != IDLE)
+    {
+        CETALIB_LOG_ERROR("reflectance: calibration already running");
+        return false;
+    }
+    if((effort <= 0.0f) || (effort > 1.0f))
+    {
+        CETALIB_LOG_ERROR("reflectance: sweep effort %.2f must be > 0 and <= 1", effort);
+        return false;
+    }
+    analogReadResolution(12);
+    for(int i = 0; i < 3; i++)
+    {
+        opto_min[i] = (int)MAX_ADC_VALUE;
+        opto_max[i] = 0;
+    }
+    sweepEffort = effort;
+    sweepStartTime = millis();
+    previousOptoSampleTime = sweepStartTime;
+    calState = CALIBRATE_SWEEP_FORWARD;
+    board_led_pattern(3);       // indicate the sweep
+    motor_set_efforts(sweepEffort, sweepEffort);
+    return true;
+}
+
+bool reflectance_is_calibrating(void)
+{
+    return (calState != IDLE);
+}
+
+void reflectance_calibration_next(void)
+{
+    calNextRequest = true;
+}
+
+void reflectance_cancel_calibration(void)
+{
+    if(calState == IDLE)
+    {
+        return;
+    }
+    if((calState == CALIBRATE_SWEEP_FORWARD) || (calState == CALIBRATE_SWEEP_REVERSE))
+    {
+        motor_set_efforts(0.0f, 0.0f);
+    }
+    calState = IDLE;
+    board_led_off();
+    CETALIB_LOG_WARN("reflectance: calibration cancelled, previous trip thresholds kept");
+}
+
 void reflectance_clear_calibration(void)
 {
-    EEPROM.begin(1024);
-    // Erase EEPROM memory to trigger calibration routines during initialization
-    for (int i = REFLECTANCE_CAL_EEPROM_ADDRESS_START; i <= REFLECTANCE_CAL_EEPROM_ADDRESS_END; i++) {
-      EEPROM.write(i, 255);
+    // Delete the calibration record to trigger calibration routines during initialization
+    // (saved when the module is re-calibrated, or by the board "tasks()" function)
+    calstore_clear(CALSTORE_RECORD_REFLECTANCE);
+}
+
+/*** Private Function Definitions *********************************************/
+
+static int reflectanceReadAdc(int pin, enum REPLAY_SOURCE source)
+{
+    int value = 0;
+    if(replay_is_playing())
+    {
+        replay_read(source, &value, sizeof(value));
+    }
+    else
+    {
+        value = analogRead(pin);
+        replay_input(source, &value, sizeof(value));
+    }
+    return value;
+}
+
+static void reflectanceUpdateTrips(void)
+{
+    leftTripQ15 = (int32_t)floorf(reflectanceCal.left_opto_trip*32768.0f);
+    middleTripQ15 = (int32_t)floorf(reflectanceCal.middle_opto_trip*32768.0f);
+    rightTripQ15 = (int32_t)floorf(reflectanceCal.right_opto_trip*32768.0f);
+}
+
+static void reflectancePrintCalibration(void)
+{
+    SERIAL_PORT.print("Left Opto Trip: ");
+    SERIAL_PORT.print(reflectanceCal.left_opto_trip, 3);
+    SERIAL_PORT.print(" Middle Opto Trip: ");
+    SERIAL_PORT.print(reflectanceCal.middle_opto_trip, 3);
+    SERIAL_PORT.print(" Right Opto Trip: ");
+    SERIAL_PORT.println(reflectanceCal.right_opto_trip, 3);
+}
+
+static void reflectanceCalRestart(void)
+{
+    sample_counter = 0;
+    for(int i = 0; i < 3; i++)
+    {
+        opto_accumulator[i] = 0;
+    }
+}
+
+static void reflectanceCalSample(int *values)
+{
+    // raw readings (calibration is not recorded by the "replay" module)
+    values[0] = analogRead(LEFT_SENSOR_PIN);
+    #if defined(ARDUINO_RASPBERRY_PI_PICO_W)
+        values[1] = analogRead(MIDDLE_SENSOR_PIN);
+    #else
+        values[1] = 0;
+    #endif
+    values[2] = analogRead(RIGHT_SENSOR_PIN);
+}
+
+static void reflectanceCalAccumulate(const int *values)
+{
+    for(int i = 0; i < 3; i++)
+    {
+        opto_accumulator[i] += values[i];
+    }
+    sample_counter++;
+}
+
+static void reflectanceSweepComplete(void)
+{
+    int tripLevels[3];
+    int minContrast = (int)(REFLECTANCE_SWEEP_CONTRAST*MAX_ADC_VALUE);
+    for(int i = 0; i < 3; i++)
+    {
+        #if !defined(ARDUINO_RASPBERRY_PI_PICO_W)
+        if(i == 1)
+        {
+            tripLevels[i] = 0;      // no middle sensor
+            continue;
+        }
+        #endif
+        if((opto_max[i] - opto_min[i]) < minContrast)
+        {
+            CETALIB_LOG_ERROR("reflectance: auto calibration failed, sensor %d did not cross the line (%d to %d), previous trip thresholds kept",
+                              i, opto_min[i], opto_max[i]);
+            return;
+        }
+        tripLevels[i] = (opto_min[i] + opto_max[i])/2;
     }
-    EEPROM.end();
+    reflectanceCalSave(tripLevels);
 }
 
+static void reflectanceCalSave(const int *tripLevels)
+{
+    reflectanceCal.left_opto_trip = (float)tripLevels[0]/MAX_ADC_VALUE;
+    reflectanceCal.middle_opto_trip = (float)tripLevels[1]/MAX_ADC_VALUE;
+    reflectanceCal.right_opto_trip = (float)tripLevels[2]/MAX_ADC_VALUE;
+    reflectanceUpdateTrips();
+
+    // Save calibration values to flash memory (the whole record, in one commit)
+    calstore_write(CALSTORE_RECORD_REFLECTANCE, &reflectanceCal, sizeof(reflectanceCal));
+    calstore_commit();
+    reflectancePrintCalibration();
+}
@@ -46,18 +46,19 @@
 #endif
 
 #define MAX_ADC_VALUE               4096.0f   // 12-bit ADC max value
+#define ADC_TO_Q15_SHIFT            3         // 12-bit ADC reading to Q15 (reading/4096 == (reading<<3)/32768)
 #define LEFT_SENSOR_TRIP_DEFAULT    0.733f    // Default trip threshold
 #define MIDDLE_SENSOR_TRIP_DEFAULT  0.733f    // Default trip threshold
 #define RIGHT_SENSOR_TRIP_DEFAULT   0.733f    // Default trip threshold
-#define REFLECTANCE_CAL_EEPROM_ADDRESS_START  0  // EEPROM Start address for calibration data
-#define REFLECTANCE_CAL_EEPROM_ADDRESS_END  127  // EEPROM End address for calibration data
 #define CALIBRATION_INTERVAL        10000     // Average sensor readings over this interval during calibration (in mS)
 #define SAMPLE_INTERVAL             10        // Sensor sample interval during calibration (in mS)
+#define REFLECTANCE_SWEEP_TIME      1500      // Auto calibration: drive time over the line, each way (in mS)
+#define REFLECTANCE_SWEEP_CONTRAST  0.1f      // Auto calibration: smallest line/background difference of a sensor
 
 
 /*** Custom Data Types ********************************************************/
 
-enum REFLECTANCE_CALIBRATION_STATE {WAIT_BEGIN_WHITE=0, WAIT_BEGIN_BLACK, CALIBRATE_WHITE, CALIBRATE_BLACK, IDLE};
+enum REFLECTANCE_CALIBRATION_STATE {WAIT_BEGIN_WHITE=0, WAIT_BEGIN_BLACK, CALIBRATE_WHITE, CALIBRATE_BLACK, CALIBRATE_SWEEP_FORWARD, CALIBRATE_SWEEP_REVERSE, IDLE};
 
 struct REFLECTANCE_CAL
 {
@@ -73,5 +74,14 @@ float reflectance_get_middle_sensor(void);      // Sample middle sensor reading
 float reflectance_get_right_sensor(void);       // Sample right sensor reading
 int reflectance_get_line_status(void);          // Sample/Return current line detection status
 void reflectance_clear_calibration(void);       // Delete calibration data
+q15_t reflectance_get_left_sensor_q15(void);    // Sample left sensor reading (Q15)
+q15_t reflectance_get_middle_sensor_q15(void);  // Sample middle sensor reading (Q15)
+q15_t reflectance_get_right_sensor_q15(void);   // Sample right sensor reading (Q15)
+void reflectance_tasks(void);                   // Run the calibration routine (call from the sketch loop)
+bool reflectance_start_calibration(void);       // Start the USER switch calibration routine (does not wait)
+bool reflectance_start_auto_calibration(float effort);  // Start a calibration driving over the line (does not wait)
+bool reflectance_is_calibrating(void);          // true while a calibration routine runs
+void reflectance_calibration_next(void);        // Continue the calibration routine (same as the USER switch)
+void reflectance_cancel_calibration(void);      // Stop the calibration routine, keep the previous calibration
 
 #endif /* REFLECTANCE_H_ */
\ No newline at end of file
@@ -27,6 +27,7 @@
 
 /*** Include Files ************************************************************/
 #include <Arduino.h>
+#include "fixedpoint.h"
 
 /*** Macros *******************************************************************/
 
@@ -39,6 +40,15 @@ struct REFLECTANCE_INTERFACE
   float (*get_right_sensor)(void);            // Sample right opto reading
   int (*get_line_status)(void);               // Sample/Return current line detection status
   void (*clear_calibration)(void);            // Delete calibration data
+  q15_t (*get_left_sensor_q15)(void);         // Sample left opto reading (Q15)
+  q15_t (*get_middle_sensor_q15)(void);       // Sample middle opto reading (Q15, returns "0" for XRP Robot)
+  q15_t (*get_right_sensor_q15)(void);        // Sample right opto reading (Q15)
+  void (*tasks)(void);                        // Run the calibration routine (call from the sketch loop)
+  bool (*start_calibration)(void);            // Start the USER switch calibration routine (does not wait)
+  bool (*start_auto_calibration)(float effort);   // Start a calibration driving over the line at "effort" (does not wait)
+  bool (*is_calibrating)(void);               // true while a calibration routine runs
+  void (*calibration_next)(void);             // Continue the calibration routine (same as pressing the USER switch)
+  void (*cancel_calibration)(void);           // Stop the calibration routine, keep the previous calibration
 };
 
 /*** Public Function Prototypes ***********************************************/
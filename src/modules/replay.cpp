@@ -0,0 +1,456 @@
+/*
+ * Copyright (C) 2026 dBm Signal Dynamics Inc.
+ *
+ * File:            replay.cpp
+ * Project:
+ * Date:            Oct 19, 2026
+ * Framework:       Arduino w. Arduino-Pico Core Pkge by Earl Philhower
+ *                  (https://github.com/earlephilhower/arduino-pico)
+ *
+ * cetalib "replay" sensor input record/replay
+ *
+ * The imu, reflectance, rangefinder, encoder and joystick modules pass every
+ * raw value they read from the hardware (gyro rates, ADC readings, echo pulse
+ * widths, encoder counts, UDP packets) to replay_input(). While recording,
+ * the values are time-stamped and appended to a trace file on the flash file
+ * system, through two RAM buffers written by tasks().
+ *
+ * While playing, the modules call replay_read() instead of reading the
+ * hardware. Each read returns the next recorded value of that source, in
+ * recorded order, so the same sketch computes the same results (e.g. the
+ * same heading, bit for bit) without the robot moving. Values of the other
+ * sources read ahead from the trace wait in a small queue per source.
+ * Values that the hardware only has now and then (gyro samples, joystick
+ * packets) are delivered once the replay reaches their recorded time.
+ *
+ * Hardware Configurations Supported:
+ *
+ * CETA IoT Robot (Schematic #14-00069A/B), based on RPI-Pico-WH
+ * (Select "Board = Raspberry Pi Pico W")
+ *
+ * Sparkfun XRP Robot Platform (#KIT-27644), based on the RPI RP2350B MCU
+ * (Select "Board = SparkFun XRP Controller")
+ *
+ * Sparkfun XRP (Beta) Robot Platform (#KIT-22230), based on the RPI Pico W
+ * (Select "Board = SparkFun XRP Controller (Beta)")
+ *
+ */
+
+/** Include Files *************************************************************/
+#include <Arduino.h>                // Required for Arduino functions
+#include <LittleFS.h>               // Required for flash file system functions
+#include <string.h>                 // needed for "memcpy()" and "memmove()" functions
+#include <stddef.h>                 // needed for "offsetof()" macro
+#include "logger.h"                 // "logger" functions
+#include "replay.h"                 // "replay" API declarations
+#include "trace.h"                  // "trace" event macros
+
+/*** Symbolic Constants used in this module ***********************************/
+// sources only read when the hardware has a new value, the other sensors are read at every call
+#define REPLAY_ARRIVAL_MASK ((1 << REPLAY_SOURCE_IMU_GYRO) | (1 << REPLAY_SOURCE_IMU_TEMPERATURE) | (1 << REPLAY_SOURCE_JOYSTICK_PACKET))
+
+/*** Global Variable Declarations *********************************************/
+
+// define the function interface
+extern const struct REPLAY_INTERFACE REPLAY = {
+    .record                 = &replay_record,
+    .play                   = &replay_play,
+    .stop                   = &replay_stop,
+    .tasks                  = &replay_tasks,
+    .get_mode               = &replay_get_mode,
+    .is_finished            = &replay_is_finished,
+    .get_stats              = &replay_get_stats
+};
+
+static enum REPLAY_MODE replayMode = REPLAY_OFF;
+static REPLAY_STATS replayStats;
+static File replayFile;
+static uint16_t replaySourceMask;               // sources present in the trace
+static uint16_t replayReadMask;                 // playing: sources read by the sketch
+
+// recording: inputs fill one buffer while tasks() writes the other,
+// playing: both buffers hold the trace read ahead
+static uint8_t replayBuffer[2][REPLAY_BUFFER_SIZE];
+static int replayLength[2];                     // recording: bytes used in each buffer
+static bool replayPending[2];                   // recording: buffer is full, waiting to be written
+static int replayFillIndex;                     // recording: buffer being filled
+static int replayWriteIndex;                    // recording: next buffer to write
+static int replayReadPos;                       // playing: next unread byte in the buffers
+static int replayReadEnd;                       // playing: end of the data read from the file
+static bool replayEndOfFile;                    // playing: the whole file has been read
+
+// playing: values read ahead from the trace, per source
+static struct REPLAY_QUEUE_ENTRY replayQueue[REPLAY_NUM_SOURCES][REPLAY_QUEUE_SIZE];
+static uint8_t replayQueueHead[REPLAY_NUM_SOURCES];
+static uint8_t replayQueueCount[REPLAY_NUM_SOURCES];
+static uint32_t replayClock;                    // recorded time of the most recently replayed value
+static uint32_t replayClockTime;                // micros() when replayClock was set
+
+/*** Type Declarations ********************************************************/
+
+/*** Private Function Prototypes **********************************************/
+static void replayWriteBuffer(void);                                // Write the next pending buffer to the file
+static void replayReadFile(void);                                   // Move the unread bytes to the start of the buffers, then read more
+static const struct REPLAY_RECORD_HEADER* replayPeek(void);         // Returns the next record in the trace (NULL at the end)
+static void replayQueueNext(void);                                  // Move the next record to the queue of its source
+static int replayDequeue(enum REPLAY_SOURCE source, void *value, int size); // Take the oldest value of a source
+
+/*** Public Function Definitions **********************************************/
+
+bool replay_record(const char *fileName)
+{
+  if(replayMode != REPLAY_OFF)
+  {
+    return false;
+  }
+  if(!LittleFS.begin())
+  {
+    CETALIB_LOG_ERROR("replay: no flash file system");
+    return false;
+  }
+  replayFile = LittleFS.open(fileName, "w");
+  if(!replayFile)
+  {
+    CETALIB_LOG_ERROR("replay: cannot create \"%s\"", fileName);
+    return false;
+  }
+  // the header is written again by stop(), with the source mask and record count
+  struct REPLAY_FILE_HEADER header = {REPLAY_FILE_MAGIC, REPLAY_VERSION, 0, (uint32_t)millis(), 0};
+  if(replayFile.write((const uint8_t *)&header, sizeof(header)) != sizeof(header))
+  {
+    CETALIB_LOG_ERROR("replay: cannot write \"%s\"", fileName);
+    replayFile.close();
+    return false;
+  }
+  memset(&replayStats, 0, sizeof(replayStats));
+  replayStats.bytes = sizeof(header);
+  replaySourceMask = 0;
+  replayLength[0] = 0;
+  replayLength[1] = 0;
+  replayPending[0] = false;
+  replayPending[1] = false;
+  replayFillIndex = 0;
+  replayWriteIndex = 0;
+  replayMode = REPLAY_RECORDING;
+  CETALIB_LOG_INFO("replay: recording to \"%s\"", fileName);
+  return true;
+}
+
+bool replay_play(const char *fileName)
+{
+  if((replayMode != REPLAY_OFF) || !LittleFS.begin())
+  {
+    return false;
+  }
+  replayFile = LittleFS.open(fileName, "r");
+  if(!replayFile)
+  {
+    CETALIB_LOG_ERROR("replay: cannot open \"%s\"", fileName);
+    return false;
+  }
+  struct REPLAY_FILE_HEADER header;
+  if((replayFile.read((uint8_t *)&header, sizeof(header)) != sizeof(header)) ||
+     (header.magic != REPLAY_FILE_MAGIC) || (header.version != REPLAY_VERSION))
+  {
+    CETALIB_LOG_ERROR("replay: \"%s\" is not a trace file", fileName);
+    replayFile.close();
+    return false;
+  }
+  memset(&replayStats, 0, sizeof(replayStats));
+  memset(replayQueueCount, 0, sizeof(replayQueueCount));
+  replaySourceMask = header.sourceMask;
+  replayReadMask = 0;
+  replayReadPos = 0;
+  replayReadEnd = 0;
+  replayEndOfFile = false;
+  replayReadFile();
+
+  // the replay clock starts at the first recorded input
+  const struct REPLAY_RECORD_HEADER *record = replayPeek();
+  replayClock = record ? record->time : 0;
+  replayClockTime = micros();
+  replayMode = REPLAY_PLAYING;
+  CETALIB_LOG_INFO("replay: playing \"%s\" (%lu inputs)", fileName, (unsigned long)header.records);
+  return true;
+}
+
+void replay_stop(void)
+{
+  if(replayMode == REPLAY_RECORDING)
+  {
+    replayMode = REPLAY_OFF;
+    if(!replayPending[replayFillIndex] && (replayLength[replayFillIndex] > 0))
+    {
+      replayPending[replayFillIndex] = true;
+    }
+    while(replayPending[replayWriteIndex])
+    {
+      replayWriteBuffer();
+    }
+    struct REPLAY_FILE_HEADER header = {REPLAY_FILE_MAGIC, REPLAY_VERSION, replaySourceMask, 0, (uint32_t)replayStats.records};
+    replayFile.seek(offsetof(struct REPLAY_FILE_HEADER, sourceMask));
+    replayFile.write((const uint8_t *)&header.sourceMask, sizeof(header.sourceMask));
+    replayFile.seek(offsetof(struct REPLAY_FILE_HEADER, records));
+    replayFile.write((const uint8_t *)&header.records, sizeof(header.records));
+    replayFile.close();
+    CETALIB_LOG_INFO("replay: recorded %lu inputs (%lu dropped), %lu bytes",
+                     replayStats.records, replayStats.recordsDropped, replayStats.bytes);
+  }
+  else if(replayMode == REPLAY_PLAYING)
+  {
+    replayMode = REPLAY_OFF;
+    replayFile.close();
+    CETALIB_LOG_INFO("replay: replayed %lu inputs (%lu skipped)", replayStats.records, replayStats.recordsSkipped);
+  }
+}
+
+void replay_tasks(void)
+{
+  if(replayMode == REPLAY_OFF)
+  {
+    return;
+  }
+  CETALIB_TRACE_BEGIN("replay", "tasks", replayMode);
+  if(replayMode == REPLAY_RECORDING)
+  {
+    // one buffer per call, so the other background tasks are not held up
+    if(replayPending[replayWriteIndex])
+    {
+      replayWriteBuffer();
+    }
+  }
+  else if(replayMode == REPLAY_PLAYING)
+  {
+    // read ahead, so replay_read() rarely waits for the flash
+    if(!replayEndOfFile && ((replayReadEnd - replayReadPos) < REPLAY_BUFFER_SIZE))
+    {
+      replayReadFile();
+    }
+  }
+  CETALIB_TRACE_END("replay", "tasks", 0);
+}
+
+enum REPLAY_MODE replay_get_mode(void)
+{
+  return replayMode;
+}
+
+bool replay_is_finished(void)
+{
+  if((replayMode != REPLAY_PLAYING) || (replayPeek() != NULL))
+  {
+    return false;
+  }
+  // wait for the sketch to read the values that are still queued
+  for(int source = 0; source < REPLAY_NUM_SOURCES; source++)
+  {
+    if((replayReadMask & (1 << source)) && (replayQueueCount[source] > 0))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+REPLAY_STATS* replay_get_stats(void)
+{
+  return &replayStats;
+}
+
+bool replay_is_playing(void)
+{
+  return (replayMode == REPLAY_PLAYING);
+}
+
+void replay_input(enum REPLAY_SOURCE source, const void *value, int size)
+{
+  if(replayMode != REPLAY_RECORDING)
+  {
+    return;
+  }
+  if(size > REPLAY_MAX_VALUE_SIZE)
+  {
+    // a truncated value would not replay bit-exactly, drop it instead
+    CETALIB_LOG_ERROR("replay: input %d too large (%d bytes), dropped", (int)source, size);
+    replayStats.recordsDropped++;
+    return;
+  }
+  int recordSize = sizeof(struct REPLAY_RECORD_HEADER) + size;
+  if(!replayPending[replayFillIndex] && ((replayLength[replayFillIndex] + recordSize) > REPLAY_BUFFER_SIZE))
+  {
+    replayPending[replayFillIndex] = true;
+  }
+  if(replayPending[replayFillIndex])
+  {
+    // the fill buffer is full, switch to the other one once it is written
+    if(replayPending[replayFillIndex ^ 1])
+    {
+      replayStats.recordsDropped++;
+      return;
+    }
+    replayFillIndex ^= 1;
+    replayLength[replayFillIndex] = 0;
+  }
+  struct REPLAY_RECORD_HEADER header = {(uint8_t)source, (uint8_t)size, (uint32_t)micros()};
+  uint8_t *buffer = &replayBuffer[replayFillIndex][replayLength[replayFillIndex]];
+  memcpy(buffer, &header, sizeof(header));
+  memcpy(buffer + sizeof(header), value, size);
+  replayLength[replayFillIndex] += recordSize;
+  replaySourceMask |= (1 << source);
+  replayStats.records++;
+  replayStats.bytes += recordSize;
+}
+
+int replay_read(enum REPLAY_SOURCE source, void *value, int size)
+{
+  if((replayMode != REPLAY_PLAYING) || !(replaySourceMask & (1 << source)))
+  {
+    return 0;
+  }
+  replayReadMask |= (1 << source);
+  if((1 << source) & REPLAY_ARRIVAL_MASK)
+  {
+    // deliver the values recorded before the current replay time (the time of
+    // the latest replayed value, plus the time elapsed since it was read), but
+    // never read past the next value of a sensor the sketch reads itself, or
+    // past a value that would not fit its queue (it is delivered later instead)
+    uint32_t now = replayClock + (micros() - replayClockTime);
+    const struct REPLAY_RECORD_HEADER *record;
+    while(((record = replayPeek()) != NULL) && ((int32_t)(record->time - now) <= 0) &&
+          !((replayReadMask & ~REPLAY_ARRIVAL_MASK) & (1 << record->source)) &&
+          (replayQueueCount[record->source] < REPLAY_QUEUE_SIZE))
+    {
+      replayQueueNext();
+    }
+  }
+  else
+  {
+    // the next value of this source is further in the trace, read up to it,
+    // but wait for the sketch to take the queued values it has not read yet
+    // (gyro samples, joystick packets)
+    const struct REPLAY_RECORD_HEADER *record;
+    while((replayQueueCount[source] == 0) && ((record = replayPeek()) != NULL) &&
+          !((replayReadMask & REPLAY_ARRIVAL_MASK & (1 << record->source)) &&
+            (replayQueueCount[record->source] == REPLAY_QUEUE_SIZE)))
+    {
+      replayQueueNext();
+    }
+  }
+  return replayDequeue(source, value, size);
+}
+
+/*** Private Function Definitions *********************************************/
+
+static void replayWriteBuffer(void)
+{
+  unsigned long startTime = micros();
+  int length = replayLength[replayWriteIndex];
+  CETALIB_TRACE_BEGIN("replay", "flashWrite", length);
+  bool written = (replayFile.write(replayBuffer[replayWriteIndex], length) == (size_t)length);
+  CETALIB_TRACE_END("replay", "flashWrite", written);
+  unsigned long writeTime = micros() - startTime;
+
+  replayStats.lastWriteTime = writeTime;
+  if(writeTime > replayStats.maxWriteTime)
+  {
+    replayStats.maxWriteTime = writeTime;
+  }
+  if(!written)
+  {
+    CETALIB_LOG_ERROR("replay: flash write failed (flash file system full?)");
+  }
+  replayLength[replayWriteIndex] = 0;
+  replayPending[replayWriteIndex] = false;
+  replayWriteIndex ^= 1;
+}
+
+static void replayReadFile(void)
+{
+  uint8_t *buffer = replayBuffer[0];
+  int unread = replayReadEnd - replayReadPos;
+  memmove(buffer, buffer + replayReadPos, unread);
+  replayReadPos = 0;
+  replayReadEnd = unread;
+
+  unsigned long startTime = micros();
+  CETALIB_TRACE_BEGIN("replay", "flashRead", sizeof(replayBuffer) - replayReadEnd);
+  int count = replayFile.read(buffer + replayReadEnd, sizeof(replayBuffer) - replayReadEnd);
+  CETALIB_TRACE_END("replay", "flashRead", count);
+  unsigned long readTime = micros() - startTime;
+
+  replayStats.lastReadTime = readTime;
+  if(readTime > replayStats.maxReadTime)
+  {
+    replayStats.maxReadTime = readTime;
+  }
+  if(count > 0)
+  {
+    replayReadEnd += count;
+    replayStats.bytes += count;
+  }
+  else
+  {
+    replayEndOfFile = true;
+  }
+}
+
+static const struct REPLAY_RECORD_HEADER* replayPeek(void)
+{
+  const struct REPLAY_RECORD_HEADER *record = (const struct REPLAY_RECORD_HEADER *)(replayBuffer[0] + replayReadPos);
+  int unread = replayReadEnd - replayReadPos;
+  if(((unread < (int)sizeof(*record)) || (unread < (int)(sizeof(*record) + record->size))) && !replayEndOfFile)
+  {
+    replayReadFile();
+    record = (const struct REPLAY_RECORD_HEADER *)replayBuffer[0];
+    unread = replayReadEnd;
+  }
+  if((unread < (int)sizeof(*record)) || (unread < (int)(sizeof(*record) + record->size)) ||
+     (record->source >= REPLAY_NUM_SOURCES) || (record->size > REPLAY_MAX_VALUE_SIZE))
+  {
+    // end of the trace (or a record cut short when recording stopped)
+    return NULL;
+  }
+  return record;
+}
+
+static void replayQueueNext(void)
+{
+  const struct REPLAY_RECORD_HEADER *record = (const struct REPLAY_RECORD_HEADER *)(replayBuffer[0] + replayReadPos);
+  int source = record->source;
+  if(replayQueueCount[source] == REPLAY_QUEUE_SIZE)
+  {
+    // the sketch reads this source less often than when recording, drop the oldest value
+    replayQueueHead[source] = (replayQueueHead[source] + 1) % REPLAY_QUEUE_SIZE;
+    replayQueueCount[source]--;
+    replayStats.recordsSkipped++;
+  }
+  struct REPLAY_QUEUE_ENTRY *entry = &replayQueue[source][(replayQueueHead[source] + replayQueueCount[source]) % REPLAY_QUEUE_SIZE];
+  entry->time = record->time;
+  entry->size = record->size;
+  memcpy(entry->value, (const uint8_t *)record + sizeof(*record), record->size);
+  replayQueueCount[source]++;
+  replayReadPos += sizeof(*record) + record->size;
+}
+
+static int replayDequeue(enum REPLAY_SOURCE source, void *value, int size)
+{
+  if(replayQueueCount[source] == 0)
+  {
+    return 0;
+  }
+  struct REPLAY_QUEUE_ENTRY *entry = &replayQueue[source][replayQueueHead[source]];
+  replayQueueHead[source] = (replayQueueHead[source] + 1) % REPLAY_QUEUE_SIZE;
+  replayQueueCount[source]--;
+  if(size > entry->size)
+  {
+    size = entry->size;
+  }
+  memcpy(value, entry->value, size);
+  if((int32_t)(entry->time - replayClock) > 0)
+  {
+    replayClock = entry->time;
+    replayClockTime = micros();
+  }
+  replayStats.records++;
+  return size;
+}
@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2026 dBm Signal Dynamics Inc.
+ *
+ * File:            replay.h
+ * Project:
+ * Date:            Oct 19, 2026
+ * Framework:       Arduino w. Arduino-Pico Core Pkge by Earl Philhower
+ *                  (https://github.com/earlephilhower/arduino-pico)
+ *
+ * cetalib "replay" sensor input record/replay
+ *
+ * Hardware Configurations Supported:
+ *
+ * CETA IoT Robot (Schematic #14-00069A/B), based on RPI-Pico-WH
+ * (Select "Board = Raspberry Pi Pico W")
+ *
+ * Sparkfun XRP Robot Platform (#KIT-27644), based on the RPI RP2350B MCU
+ * (Select "Board = SparkFun XRP Controller")
+ *
+ * Sparkfun XRP (Beta) Robot Platform (#KIT-22230), based on the RPI Pico W
+ * (Select "Board = SparkFun XRP Controller (Beta)")
+ *
+ */
+
+#ifndef REPLAY_H_
+#define REPLAY_H_
+
+/*** Include Files ************************************************************/
+#include <Arduino.h>
+#include "replay_interface.h"
+
+/*** Macros *******************************************************************/
+#define REPLAY_BUFFER_SIZE          512         // Size of each RAM buffer (in bytes)
+#define REPLAY_MAX_VALUE_SIZE       42          // Largest recorded input (a joystick v2 packet with 3 redundant reports)
+#define REPLAY_QUEUE_SIZE           4           // Replayed inputs read ahead per source
+#define REPLAY_FILE_MAGIC           0x4C505243  // "CRPL"
+#define REPLAY_VERSION              1           // File format version, change when the format or sources change
+
+/*** Custom Data Types ********************************************************/
+
+// Sensor inputs, do not renumber (recorded in the trace files)
+enum REPLAY_SOURCE
+{
+  REPLAY_SOURCE_IMU_GYRO = 0,       // float x, y, z (dps)
+  REPLAY_SOURCE_IMU_TEMPERATURE,    // float (degrees C)
+  REPLAY_SOURCE_REFLECTANCE_LEFT,   // int ADC reading
+  REPLAY_SOURCE_REFLECTANCE_MIDDLE, // int ADC reading
+  REPLAY_SOURCE_REFLECTANCE_RIGHT,  // int ADC reading
+  REPLAY_SOURCE_RANGEFINDER_ECHO,   // unsigned long echo pulse width (uS)
+  REPLAY_SOURCE_ENCODER_LEFT,       // int count
+  REPLAY_SOURCE_ENCODER_RIGHT,      // int count
+  REPLAY_SOURCE_JOYSTICK_PACKET,    // UDP datagram
+  REPLAY_NUM_SOURCES
+};
+
+// Start of the trace file
+struct REPLAY_FILE_HEADER
+{
+  uint32_t magic;                   // REPLAY_FILE_MAGIC
+  uint16_t version;                 // REPLAY_VERSION
+  uint16_t sourceMask;              // sources present in the trace (bit n = source n)
+  uint32_t startTime;               // time recording started (in mS since reset)
+  uint32_t records;                 // number of inputs in the trace
+};
+
+// Start of each recorded input, followed by "size" bytes
+struct REPLAY_RECORD_HEADER
+{
+  uint8_t source;                   // enum REPLAY_SOURCE
+  uint8_t size;                     // size of the value (in bytes)
+  uint32_t time;                    // time of the hardware read (micros())
+} __attribute__((packed));
+
+struct REPLAY_QUEUE_ENTRY
+{
+  uint32_t time;                    // recorded time of the input
+  uint8_t size;                     // size of the value (in bytes)
+  uint8_t value[REPLAY_MAX_VALUE_SIZE];
+};
+
+/*** Public Function Prototypes ***********************************************/
+bool replay_record(const char *fileName);                   // Start recording the sensor inputs to a trace file
+bool replay_play(const char *fileName);                     // Start replaying a trace file instead of reading the sensors
+void replay_stop(void);                                     // Stop recording or replaying
+void replay_tasks(void);                                    // Write or read the trace file
+enum REPLAY_MODE replay_get_mode(void);                     // Returns REPLAY_OFF, REPLAY_RECORDING or REPLAY_PLAYING
+bool replay_is_finished(void);                              // Returns true when all the recorded inputs were replayed
+REPLAY_STATS* replay_get_stats(void);                       // Returns a pointer to the record/replay counters
+
+// Used by the sensor modules
+bool replay_is_playing(void);                               // Returns true if the sensor reads must use replay_read()
+void replay_input(enum REPLAY_SOURCE source, const void *value, int size);  // Record a value read from the hardware
+int replay_read(enum REPLAY_SOURCE source, void *value, int size);          // Get the next replayed value, returns its size (0 = none)
+
+#endif /* REPLAY_H_ */
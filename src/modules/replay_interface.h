@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2026 dBm Signal Dynamics Inc.
+ *
+ * File:            replay_interface.h
+ * Project:
+ * Date:            Oct 19, 2026
+ * Framework:       Arduino w. Arduino-Pico Core Pkge by Earl Philhower
+ *                  (https://github.com/earlephilhower/arduino-pico)
+ *
+ * "replay" driver interface file - defines "REPLAY_INTERFACE" structure
+ *
+ * Hardware Configurations Supported:
+ *
+ * CETA IoT Robot (Schematic #14-00069A/B), based on RPI-Pico-WH
+ * (Select "Board = Raspberry Pi Pico W")
+ *
+ * Sparkfun XRP Robot Platform (#KIT-27644), based on the RPI RP2350B MCU
+ * (Select "Board = SparkFun XRP Controller")
+ *
+ * Sparkfun XRP (Beta) Robot Platform (#KIT-22230), based on the RPI Pico W
+ * (Select "Board = SparkFun XRP Controller (Beta)")
+ *
+ */
+
+#ifndef REPLAY_INTERFACE_H_
+#define REPLAY_INTERFACE_H_
+
+/*** Include Files ************************************************************/
+#include <Arduino.h>
+
+/*** Macros *******************************************************************/
+
+/*** Custom Data Types ********************************************************/
+
+enum REPLAY_MODE {REPLAY_OFF = 0, REPLAY_RECORDING, REPLAY_PLAYING};
+
+typedef struct
+{
+  unsigned long records;            // number of sensor inputs recorded or replayed
+  unsigned long recordsDropped;     // recording: inputs dropped (both RAM buffers waiting to be written, or too large)
+  unsigned long recordsSkipped;     // playing: inputs discarded because the sketch did not read them
+  unsigned long bytes;              // size of the trace (in bytes)
+  unsigned long lastWriteTime;      // recording: duration of the most recent buffer write (in uS)
+  unsigned long maxWriteTime;       // recording: longest buffer write (in uS)
+  unsigned long lastReadTime;       // playing: duration of the most recent buffer read-ahead (in uS)
+  unsigned long maxReadTime;        // playing: longest buffer read-ahead (in uS)
+} REPLAY_STATS;
+
+struct REPLAY_INTERFACE
+{
+  bool (*record)(const char *fileName);                     // Start recording the sensor inputs to a trace file
+  bool (*play)(const char *fileName);                       // Start replaying a trace file instead of reading the sensors
+  void (*stop)(void);                                       // Stop recording or replaying
+  void (*tasks)(void);                                      // Write or read the trace file (called by board tasks())
+  enum REPLAY_MODE (*get_mode)(void);                       // Returns REPLAY_OFF, REPLAY_RECORDING or REPLAY_PLAYING
+  bool (*is_finished)(void);                                // Returns true when all the recorded inputs were replayed
+  REPLAY_STATS* (*get_stats)(void);                         // Returns a pointer to the record/replay counters
+};
+
+/*** Public Function Prototypes ***********************************************/
+
+
+#endif /* REPLAY_INTERFACE_H_ */
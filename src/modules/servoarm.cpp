@@ -36,10 +36,12 @@
 
 /** Include Files *************************************************************/
 #include <Arduino.h>                // Required for Arduino functions
-#include <EEPROM.h>                 // Required for EEPROM emulation functions
+#include "calstore.h"               // "calstore" functions
 #include <Servo.h>                  // Required for the Servo library
 #include "servoarm.h"               // "servoarm" API declarations
+#include "trace.h"                  // "trace" event macros
 #include "board.h"                  // "board" functions
+#include "logger.h"                 // "logger" functions
 
 /*** Symbolic Constants used in this module ***********************************/
 #define SERIAL_PORT Serial  // Default to Serial
@@ -58,7 +60,13 @@ extern const struct SERVOARM_INTERFACE SERVOARM = {
     .home                   = &servoarm_home,
     .lift                   = &servoarm_lift,
     .drop                   = &servoarm_drop,
-    .clear_calibration      = &servoarm_clear_calibration
+    .clear_calibration      = &servoarm_clear_calibration,
+    .tasks                  = &servoarm_tasks,
+    .start_calibration      = &servoarm_start_calibration,
+    .is_calibrating         = &servoarm_is_calibrating,
+    .calibration_next       = &servoarm_calibration_next,
+    .calibration_adjust     = &servoarm_calibration_adjust,
+    .cancel_calibration     = &servoarm_cancel_calibration
 };
 
 // calibration objects with default values assigned
@@ -70,127 +78,27 @@ static struct SERVOARM_CAL servoarmCal = {
 
 static enum SERVOARM_CALIBRATION_STATE servoarmCalState = SERVOARM_CAL_IDLE;
 
-/*** Private Function Prototypes **********************************************/
-
-/*** Public Function Definitions **********************************************/
-
+// calibration routine variables
+static struct SERVOARM_CAL servoarmNewCal;          // positions accepted so far
+static int calAngle;                                // arm angle being set
+static bool servoarmCalNextRequest = false;         // calibration_next() called
 #if defined(ARDUINO_RASPBERRY_PI_PICO_W)
-void servoarm_init(void)
-{
-    // calibration variables
-    int calAngle = 0;
-
-    // Initiallize Servo1 using min/max pulses experimentally confirming 0-180 deg rotation
-    Servo1.attach(SERVOARM_PIN, SERVOARM_MIN_PULSE_WIDTH, SERVOARM_MAX_PULSE_WIDTH);
-
-    // Initiallize a default (safe) home position for the servo
-    setAngle = servoarmCal.home_angle;
-    servoarm_set_angle(setAngle);
+static int calPotAngle;                             // POT angle when the arm was last moved by the POT
+#endif
 
-    // set ADC resolution to 12-bit
-    analogReadResolution(12);
+/*** Private Function Prototypes **********************************************/
+static void servoarmPrintCalibration(void);         // Print the arm positions
+static void servoarmCalPrompt(const char *position);    // Print the instructions to set a position
+static void servoarmCalInput(void);                 // Move the arm from the POT or serial port
+static void servoarmCalMove(int angle);             // Move the arm to a calibration angle
+#if defined(ARDUINO_RASPBERRY_PI_PICO_W)
+static int servoarmCalPotAngle(void);               // Arm angle selected by the POT
+#endif
 
-    // Perform servoarm position calibration if EEPROM calibration memory is blank
-    EEPROM.begin(1024);
-    uint32_t testRead = 0;
-    if(EEPROM.get(SERVOARM_CAL_EEPROM_ADDRESS_START, testRead) == 0xFFFFFFFF)
-    {
-        SERIAL_PORT.println("ServoArm Calibration Routine Triggered. Press button to begin.");
-        // EEPROM is blank, perform calibration procedure
-        servoarmCalState = SERVOARM_CAL_WAIT_BEGIN;
-        board_led_pattern(5);
-        while (servoarmCalState != SERVOARM_CAL_IDLE)
-        {
-            board_tasks();
-            switch(servoarmCalState)
-            {
-                case SERVOARM_CAL_WAIT_BEGIN:
-                    if(board_is_button_pressed())
-                    {
-                        board_led_pattern(1);                   // indicate "SERVOARM_CAL_HOME" state
-                        servoarmCalState = SERVOARM_CAL_HOME;   // set the "home" angle
-                        SERIAL_PORT.println("Rotate POT to set HOME position. Press button when done.");
-                    }
-                    break;
-                case SERVOARM_CAL_HOME:
-                    if(board_is_button_pressed())
-                    {
-                        servoarmCal.home_angle = calAngle;      // save current setting as "HOME"
-                        board_led_pattern(2);                   // indicate "SERVOARM_CAL_LIFT" state
-                        servoarmCalState = SERVOARM_CAL_LIFT;   // set the "lift" angle
-                        SERIAL_PORT.println("Rotate POT to set LIFT position. Press button when done.");
-                    }
-                    else
-                    {
-                        calAngle = (int)map(analogRead(POT_PIN), 0, 4096, 0, 180);
-                        Servo1.write(calAngle);
-                    }
-                    break;
-                case SERVOARM_CAL_LIFT:
-                    if(board_is_button_pressed())
-                    {
-                        servoarmCal.lift_angle = calAngle;      // save current setting as "LIFT"
-                        board_led_pattern(3);                   // indicate "SERVOARM_CAL_DROP" state
-                        servoarmCalState = SERVOARM_CAL_DROP;   // set the "drop" angle
-                        SERIAL_PORT.println("Rotate POT to set DROP position. Press button when done.");
-                    }
-                    else
-                    {
-                        calAngle = (int)map(analogRead(POT_PIN), 0, 4096, 0, 180);
-                        Servo1.write(calAngle);
-                    }
-                    break;
-                case SERVOARM_CAL_DROP:
-                    if(board_is_button_pressed())
-                    {
-                        servoarmCal.drop_angle = calAngle;      // save current setting as "DROP"
-                        board_led_off();                        // turn off the led
-                        servoarmCalState = SERVOARM_CAL_IDLE;   // terminate calibration
-                        SERIAL_PORT.println("ServoArm Calibration Routine Completed.");
-                    }
-                    else
-                    {
-                        calAngle = (int)map(analogRead(POT_PIN), 0, 4096, 0, 180);
-                        Servo1.write(calAngle);
-                    }
-                    break;    
-                default:
-                    servoarmCalState = SERVOARM_CAL_IDLE;
-                    board_led_off();
-                    break;
-            }
-        }
-        // Save calibration values to EEPROM memory
-        EEPROM.put(SERVOARM_CAL_EEPROM_ADDRESS_START, servoarmCal);
-        SERIAL_PORT.print("ServoArm Home Position (angle): ");
-        SERIAL_PORT.print(servoarmCal.home_angle);
-        SERIAL_PORT.print(" ServoArm Lift Position (angle): ");
-        SERIAL_PORT.print(servoarmCal.lift_angle);
-        SERIAL_PORT.print(" ServoArm Drop Position (angle): ");
-        SERIAL_PORT.println(servoarmCal.drop_angle);
-    }
-    else
-    {
-        // EEPROM is programmed with calibration values, so use them
-        EEPROM.get(SERVOARM_CAL_EEPROM_ADDRESS_START, servoarmCal);
-        SERIAL_PORT.print("ServoArm Home Position (angle): ");
-        SERIAL_PORT.print(servoarmCal.home_angle);
-        SERIAL_PORT.print(" ServoArm Lift Position (angle): ");
-        SERIAL_PORT.print(servoarmCal.lift_angle);
-        SERIAL_PORT.print(" ServoArm Drop Position (angle): ");
-        SERIAL_PORT.println(servoarmCal.drop_angle);
-    }
-    // Write any changes to EEPROM and close interface.
-    EEPROM.end();
-}
+/*** Public Function Definitions **********************************************/
 
-#elif defined(ARDUINO_SPARKFUN_XRP_CONTROLLER) || defined(ARDUINO_SPARKFUN_XRP_CONTROLLER_BETA)
 void servoarm_init(void)
 {
-    // calibration variables
-    int calAngle = 90;
-    char c;
-
     // Initiallize Servo1 using min/max pulses experimentally confirming 0-180 deg rotation
     Servo1.attach(SERVOARM_PIN, SERVOARM_MIN_PULSE_WIDTH, SERVOARM_MAX_PULSE_WIDTH);
 
@@ -198,186 +106,23 @@ void servoarm_init(void)
     setAngle = servoarmCal.home_angle;
     servoarm_set_angle(setAngle);
 
-    // Perform servoarm position calibration if EEPROM calibration memory is blank
-    EEPROM.begin(1024);
-    uint32_t testRead = 0;
-    if(EEPROM.get(SERVOARM_CAL_EEPROM_ADDRESS_START, testRead) == 0xFFFFFFFF)
+    // Perform servoarm position calibration if there is no valid calibration record
+    if(!calstore_read(CALSTORE_RECORD_SERVOARM, &servoarmCal, sizeof(servoarmCal)))
     {
-        SERIAL_PORT.println("ServoArm Calibration Routine Triggered. Press button to begin.");
-        // EEPROM is blank, perform calibration procedure
-        servoarmCalState = SERVOARM_CAL_WAIT_BEGIN;
-        board_led_pattern(5);
-        while (servoarmCalState != SERVOARM_CAL_IDLE)
+        // No calibration record, run the calibration routine until it is complete
+        servoarm_start_calibration();
+        while (servoarm_is_calibrating())
         {
             board_tasks();
-            switch(servoarmCalState)
-            {
-                case SERVOARM_CAL_WAIT_BEGIN:
-                    if(board_is_button_pressed())
-                    {
-                        board_led_pattern(1);                   // indicate "SERVOARM_CAL_HOME" state
-                        servoarmCalState = SERVOARM_CAL_HOME;   // set the "home" angle
-                        SERIAL_PORT.println("Enter '+' or '-' to set HOME position. Press button when done.");
-                    }
-                    break;
-                case SERVOARM_CAL_HOME:
-                    if(board_is_button_pressed())
-                    {
-                        servoarmCal.home_angle = calAngle;      // save current setting as "HOME"
-                        board_led_pattern(2);                   // indicate "SERVOARM_CAL_LIFT" state
-                        servoarmCalState = SERVOARM_CAL_LIFT;   // set the "lift" angle
-                        SERIAL_PORT.println("Enter '+' or '-' to set LIFT position. Press button when done.");
-                    }
-                    else
-                    {
-                        if(SERIAL_PORT.available() > 0)
-                        {
-                            c = SERIAL_PORT.read();
-                            switch(c)
-                            {
-                                case '+':
-                                    if(calAngle >= 180)
-                                    {
-                                        Servo1.write(180);
-                                    }
-                                    else
-                                    {
-                                        Servo1.write(calAngle++);
-                                    }
-                                    break;
-                                case '-':
-                                    if(calAngle <= 0)
-                                    {
-                                        Servo1.write(0);
-                                    }
-                                    else
-                                    {
-                                        Servo1.write(calAngle--);
-                                    }
-                                    break;
-                                default:
-                                    break;
-                                }
-                        SERIAL_PORT.println(calAngle);
-                        }
-                    }
-                    break;
-                case SERVOARM_CAL_LIFT:
-                    if(board_is_button_pressed())
-                    {
-                        servoarmCal.lift_angle = calAngle;      // save current setting as "LIFT"
-                        board_led_pattern(3);                   // indicate "SERVOARM_CAL_DROP" state
-                        servoarmCalState = SERVOARM_CAL_DROP;   // set the "drop" angle
-                        SERIAL_PORT.println("Enter '+' or '-' to set DROP position. Press button when done.");
-                    }
-                    else
-                    {
-                        if(SERIAL_PORT.available() > 0)
-                        {
-                            c = SERIAL_PORT.read();
-                            switch(c)
-                            {
-                                case '+':
-                                    if(calAngle >= 180)
-                                    {
-                                        Servo1.write(180);
-                                    }
-                                    else
-                                    {
-                                        Servo1.write(calAngle++);
-                                    }
-                                    break;
-                                case '-':
-                                    if(calAngle <= 0)
-                                    {
-                                        Servo1.write(0);
-                                    }
-                                    else
-                                    {
-                                        Servo1.write(calAngle--);
-                                    }
-                                    break;
-                                default:
-                                    break;
-                                }
-                        SERIAL_PORT.println(calAngle);
-                        }
-                    }
-                    break;
-                case SERVOARM_CAL_DROP:
-                    if(board_is_button_pressed())
-                    {
-                        servoarmCal.drop_angle = calAngle;      // save current setting as "DROP"
-                        board_led_off();                        // turn off the led
-                        servoarmCalState = SERVOARM_CAL_IDLE;   // terminate calibration
-                        SERIAL_PORT.println("ServoArm Calibration Routine Completed.");
-                    }
-                    else
-                    {
-                        if(SERIAL_PORT.available() > 0)
-                        {
-                            c = SERIAL_PORT.read();
-                            switch(c)
-                            {
-                                case '+':
-                                    if(calAngle >= 180)
-                                    {
-                                        Servo1.write(180);
-                                    }
-                                    else
-                                    {
-                                        Servo1.write(calAngle++);
-                                    }
-                                    break;
-                                case '-':
-                                    if(calAngle <= 0)
-                                    {
-                                        Servo1.write(0);
-                                    }
-                                    else
-                                    {
-                                        Servo1.write(calAngle--);
-                                    }
-                                    break;
-                                default:
-                                    break;
-                                }
-                        SERIAL_PORT.println(calAngle);
-                        }
-                    }
-                    break;    
-                default:
-                    servoarmCalState = SERVOARM_CAL_IDLE;
-                    board_led_off();
-                    break;
-            }
+            servoarm_tasks();   // runs the calibration routine
         }
-        // Save calibration values to EEPROM memory
-        EEPROM.put(SERVOARM_CAL_EEPROM_ADDRESS_START, servoarmCal);
-        SERIAL_PORT.print("ServoArm Home Position (angle): ");
-        SERIAL_PORT.print(servoarmCal.home_angle);
-        SERIAL_PORT.print(" ServoArm Lift Position (angle): ");
-        SERIAL_PORT.print(servoarmCal.lift_angle);
-        SERIAL_PORT.print(" ServoArm Drop Position (angle): ");
-        SERIAL_PORT.println(servoarmCal.drop_angle);
     }
     else
     {
-        // EEPROM is programmed with calibration values, so use them
-        EEPROM.get(SERVOARM_CAL_EEPROM_ADDRESS_START, servoarmCal);
-        SERIAL_PORT.print("ServoArm Home Position (angle): ");
-        SERIAL_PORT.print(servoarmCal.home_angle);
-        SERIAL_PORT.print(" ServoArm Lift Position (angle): ");
-        SERIAL_PORT.print(servoarmCal.lift_angle);
-        SERIAL_PORT.print(" ServoArm Drop Position (angle): ");
-        SERIAL_PORT.println(servoarmCal.drop_angle);
+        // Calibration record is valid, so use it
+        servoarmPrintCalibration();
     }
-    // Write any changes to EEPROM and close interface.
-    EEPROM.end();
 }
-#else
-  #error Unsupported board selection
-#endif
 
 void servoarm_set_angle(int desiredAngle)
 {
@@ -397,6 +142,8 @@ void servoarm_set_angle(int desiredAngle)
 
     else
     {
+        // the arm moves 1 degree every 20 mS, the caller waits until it is done
+        CETALIB_TRACE_BEGIN("servoarm", "move", desiredAngle);
         if(desiredAngle > setAngle)
         {
             for(i=setAngle; i< desiredAngle; i++)
@@ -420,6 +167,7 @@ void servoarm_set_angle(int desiredAngle)
             Servo1.write(desiredAngle);
             setAngle = desiredAngle;      
         }
+        CETALIB_TRACE_END("servoarm", "move", setAngle);
     } 
 }
 
@@ -443,13 +191,202 @@ void servoarm_drop(void)
     servoarm_set_angle(servoarmCal.drop_angle);
 }
 
+/*******************************************************************************
+ * Function:        void servoarm_tasks(void)
+ *
+ * Description:     Advance the calibration routine (call from the sketch loop)
+ *
+ * Overview:        The arm is moved to each position (HOME, LIFT, DROP) with
+ *                  the POT (CETA IoT Robot), '+' and '-' on the serial port
+ *                  (XRP Robots) or "calibration_adjust()", then the USER
+ *                  switch (or "calibration_next()") accepts it.
+ *
+ *                  The previous positions are used until the routine
+ *                  completes, then the new ones are saved with one commit.
+ ******************************************************************************/
+
+void servoarm_tasks(void)
+{
+    if(servoarmCalState == SERVOARM_CAL_IDLE)
+    {
+        return;
+    }
+    bool next = board_is_button_pressed() || servoarmCalNextRequest;
+    servoarmCalNextRequest = false;
+
+    if(servoarmCalState == SERVOARM_CAL_WAIT_BEGIN)
+    {
+        if(next)
+        {
+            board_led_pattern(1);                   // indicate "SERVOARM_CAL_HOME" state
+            servoarmCalState = SERVOARM_CAL_HOME;   // set the "home" angle
+            servoarmCalPrompt("HOME");
+        }
+        return;
+    }
+
+    if(!next)
+    {
+        servoarmCalInput();
+        return;
+    }
+
+    // the USER switch accepts the current angle
+    switch(servoarmCalState)
+    {
+        case SERVOARM_CAL_HOME:
+            servoarmNewCal.home_angle = calAngle;   // save current setting as "HOME"
+            board_led_pattern(2);                   // indicate "SERVOARM_CAL_LIFT" state
+            servoarmCalState = SERVOARM_CAL_LIFT;   // set the "lift" angle
+            servoarmCalPrompt("LIFT");
+            break;
+        case SERVOARM_CAL_LIFT:
+            servoarmNewCal.lift_angle = calAngle;   // save current setting as "LIFT"
+            board_led_pattern(3);                   // indicate "SERVOARM_CAL_DROP" state
+            servoarmCalState = SERVOARM_CAL_DROP;   // set the "drop" angle
+            servoarmCalPrompt("DROP");
+            break;
+        case SERVOARM_CAL_DROP:
+            servoarmNewCal.drop_angle = calAngle;   // save current setting as "DROP"
+            board_led_off();                        // turn off the led
+            servoarmCalState = SERVOARM_CAL_IDLE;   // terminate calibration
+            setAngle = calAngle;
+            SERIAL_PORT.println("ServoArm Calibration Routine Completed.");
+            // Save calibration values to flash memory (the whole record, in one commit)
+            servoarmCal = servoarmNewCal;
+            calstore_write(CALSTORE_RECORD_SERVOARM, &servoarmCal, sizeof(servoarmCal));
+            calstore_commit();
+            servoarmPrintCalibration();
+            break;
+        default:
+            servoarmCalState = SERVOARM_CAL_IDLE;
+            board_led_off();
+            break;
+    }
+}
+
+bool servoarm_start_calibration(void)
+{
+    if(servoarmCalState != SERVOARM_CAL_IDLE)
+    {
+        CETALIB_LOG_ERROR("servoarm: calibration already running");
+        return false;
+    }
+    #if defined(ARDUINO_RASPBERRY_PI_PICO_W)
+    // set ADC resolution to 12-bit
+    analogReadResolution(12);
+    calPotAngle = servoarmCalPotAngle();
+    #endif
+    servoarmNewCal = servoarmCal;
+    calAngle = setAngle;                        // start from the current arm position
+    servoarmCalNextRequest = false;
+    SERIAL_PORT.println("ServoArm Calibration Routine Triggered. Press button to begin.");
+    servoarmCalState = SERVOARM_CAL_WAIT_BEGIN;
+    board_led_pattern(5);
+    return true;
+}
+
+bool servoarm_is_calibrating(void)
+{
+    return (servoarmCalState != SERVOARM_CAL_IDLE);
+}
+
+void servoarm_calibration_next(void)
+{
+    servoarmCalNextRequest = true;
+}
+
+void servoarm_calibration_adjust(int degrees)
+{
+    if((servoarmCalState == SERVOARM_CAL_IDLE) || (servoarmCalState == SERVOARM_CAL_WAIT_BEGIN))
+    {
+        return;
+    }
+    servoarmCalMove(calAngle + degrees);
+}
+
+void servoarm_cancel_calibration(void)
+{
+    if(servoarmCalState == SERVOARM_CAL_IDLE)
+    {
+        return;
+    }
+    servoarmCalState = SERVOARM_CAL_IDLE;
+    setAngle = calAngle;                        // the arm stays where it is
+    board_led_off();
+    CETALIB_LOG_WARN("servoarm: calibration cancelled, previous positions kept");
+}
+
 void servoarm_clear_calibration(void)
 {
-    EEPROM.begin(1024);
-    // Erase EEPROM memory to trigger calibration routines during initialization
-    for (int i = SERVOARM_CAL_EEPROM_ADDRESS_START; i <= SERVOARM_CAL_EEPROM_ADDRESS_END; i++) {
-      EEPROM.write(i, 255);
+    // Delete the calibration record to trigger calibration routines during initialization
+    // (saved when the module is re-calibrated, or by the board "tasks()" function)
+    calstore_clear(CALSTORE_RECORD_SERVOARM);
+}
+
+/*** Private Function Definitions *********************************************/
+
+static void servoarmPrintCalibration(void)
+{
+    SERIAL_PORT.print("ServoArm Home Position (angle): ");
+    SERIAL_PORT.print(servoarmCal.home_angle);
+    SERIAL_PORT.print(" ServoArm Lift Position (angle): ");
+    SERIAL_PORT.print(servoarmCal.lift_angle);
+    SERIAL_PORT.print(" ServoArm Drop Position (angle): ");
+    SERIAL_PORT.println(servoarmCal.drop_angle);
+}
+
+static void servoarmCalPrompt(const char *position)
+{
+    #if defined(ARDUINO_RASPBERRY_PI_PICO_W)
+    SERIAL_PORT.printf("Rotate POT to set %s position. Press button when done.\r\n", position);
+    #else
+    SERIAL_PORT.printf("Enter '+' or '-' to set %s position. Press button when done.\r\n", position);
+    #endif
+}
+
+#if defined(ARDUINO_RASPBERRY_PI_PICO_W)
+static void servoarmCalInput(void)
+{
+    // the POT moves the arm only when it is turned, so it does not undo "calibration_adjust()"
+    int potAngle = servoarmCalPotAngle();
+    if(abs(potAngle - calPotAngle) >= SERVOARM_CAL_POT_HYSTERESIS)
+    {
+        calPotAngle = potAngle;
+        servoarmCalMove(potAngle);
     }
-    EEPROM.end();
 }
 
+static int servoarmCalPotAngle(void)
+{
+    return (int)map(analogRead(POT_PIN), 0, 4096, 0, 180);
+}
+
+#elif defined(ARDUINO_SPARKFUN_XRP_CONTROLLER) || defined(ARDUINO_SPARKFUN_XRP_CONTROLLER_BETA)
+static void servoarmCalInput(void)
+{
+    if(SERIAL_PORT.available() > 0)
+    {
+        switch(SERIAL_PORT.read())
+        {
+            case '+':
+                servoarmCalMove(calAngle + 1);
+                break;
+            case '-':
+                servoarmCalMove(calAngle - 1);
+                break;
+            default:
+                break;
+        }
+    }
+}
+#else
+  #error Unsupported board selection
+#endif
+
+static void servoarmCalMove(int angle)
+{
+    calAngle = constrain(angle, 0, 180);
+    Servo1.write(calAngle);
+    SERIAL_PORT.println(calAngle);
+}
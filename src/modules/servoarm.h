@@ -59,8 +59,7 @@
 #define HOME_POSITION_DEFAULT_ANGLE       102   // Default "home" position servo angle
 #define LIFT_POSITION_DEFAULT_ANGLE       115   // Default "lift" position servo angle
 #define DROP_POSITION_DEFAULT_ANGLE       98    // Default "drop" position servo angle
-#define SERVOARM_CAL_EEPROM_ADDRESS_START 128   // EEPROM Start address for calibration data
-#define SERVOARM_CAL_EEPROM_ADDRESS_END   255   // EEPROM End address for calibration data
+#define SERVOARM_CAL_POT_HYSTERESIS       2     // Calibration: POT change that moves the arm (in degrees)
 
 /*** Custom Data Types ********************************************************/
 
@@ -81,5 +80,11 @@ void servoarm_home(void);
 void servoarm_lift(void);
 void servoarm_drop(void);
 void servoarm_clear_calibration(void);
+void servoarm_tasks(void);
+bool servoarm_start_calibration(void);
+bool servoarm_is_calibrating(void);
+void servoarm_calibration_next(void);
+void servoarm_calibration_adjust(int degrees);
+void servoarm_cancel_calibration(void);
 
 #endif /* SERVOARM_H_ */
\ No newline at end of file
@@ -40,6 +40,12 @@ struct SERVOARM_INTERFACE
   void (*lift)(void);                   // Set servo to "lift" position (requires calibration)
   void (*drop)(void);                   // Set servo to "drop" position (requires calibration)
   void (*clear_calibration)(void);      // Delete calibration data
+  void (*tasks)(void);                  // Run the calibration routine (call from the sketch loop)
+  bool (*start_calibration)(void);      // Start the calibration routine (does not wait)
+  bool (*is_calibrating)(void);         // true while the calibration routine runs
+  void (*calibration_next)(void);       // Accept the current position (same as pressing the USER switch)
+  void (*calibration_adjust)(int degrees);  // Move the arm while calibrating (same as '+'/'-' or the POT)
+  void (*cancel_calibration)(void);     // Stop the calibration routine, keep the previous positions
 };
 
 /*** Public Function Prototypes ***********************************************/
@@ -0,0 +1,223 @@
+/*
+ * Copyright (C) 2026 dBm Signal Dynamics Inc.
+ *
+ * File:            telemetry.cpp
+ * Project:
+ * Date:            Oct 19, 2026
+ * Framework:       Arduino w. Arduino-Pico Core Pkge by Earl Philhower
+ *                  (https://github.com/earlephilhower/arduino-pico)
+ *
+ * cetalib "telemetry" publish-on-change filter for mqttc sensor streams
+ *
+ * Each channel maps one sensor value (heading, temperature, distance, line
+ * status, encoder counts...) to an MQTT topic. Samples passed to update() are
+ * optionally smoothed (exponential moving average), and tasks() publishes a
+ * channel only when:
+ *
+ *  - the value has moved by at least "deadband" since it was last published,
+ *    and at least "minInterval" mS have elapsed (rate limit), or
+ *  - "maxInterval" mS have elapsed since it was last published (heartbeat).
+ *
+ * Hardware Configurations Supported:
+ *
+ * CETA IoT Robot (Schematic #14-00069A/B), based on RPI-Pico-WH
+ * (Select "Board = Raspberry Pi Pico W")
+ *
+ * Sparkfun XRP Robot Platform (#KIT-27644), based on the RPI RP2350B MCU
+ * (Select "Board = SparkFun XRP Controller")
+ *
+ * Sparkfun XRP (Beta) Robot Platform (#KIT-22230), based on the RPI Pico W
+ * (Select "Board = SparkFun XRP Controller (Beta)")
+ *
+ */
+
+/** Include Files *************************************************************/
+#include <Arduino.h>                // Required for Arduino functions
+#include <stdio.h>                  // needed for "snprintf()" function
+#include <string.h>                 // needed for "strncpy()" function
+#include <math.h>                   // needed for "fabsf()" function
+#include "mqttc.h"                  // "mqttc" functions
+#include "logger.h"                 // "logger" functions
+#include "telemetry.h"              // "telemetry" API declarations
+#include "trace.h"                  // "trace" event macros
+
+/*** Symbolic Constants used in this module ***********************************/
+#define SERIAL_PORT Serial  // Default to Serial
+#if defined(NO_USB)
+    #undef SERIAL_PORT
+    #define SERIAL_PORT Serial1     // Use Serial1 if USB is disabled
+#endif
+
+/*** Global Variable Declarations *********************************************/
+
+// define the function interface
+extern const struct TELEMETRY_INTERFACE TELEMETRY = {
+    .add_channel            = &telemetry_add_channel,
+    .update                 = &telemetry_update,
+    .tasks                  = &telemetry_tasks,
+    .get_value              = &telemetry_get_value,
+    .get_stats              = &telemetry_get_stats,
+    .clear_channels         = &telemetry_clear_channels
+};
+
+static struct TELEMETRY_CHANNEL telemetryChannels[TELEMETRY_MAX_CHANNELS];
+static int telemetryNumChannels = 0;
+
+/*** Type Declarations ********************************************************/
+
+/*** Private Function Prototypes **********************************************/
+static void telemetryPublish(struct TELEMETRY_CHANNEL *ch, unsigned long now); // Publish the channel value
+static bool telemetryIsSignificant(struct TELEMETRY_CHANNEL *ch);             // Check the channel value against its deadband
+
+/*** Public Function Definitions **********************************************/
+
+int telemetry_add_channel(const char *pubTopic, float deadband, unsigned long minInterval, unsigned long maxInterval, float smoothing)
+{
+  if(telemetryNumChannels >= TELEMETRY_MAX_CHANNELS)
+  {
+    CETALIB_LOG_ERROR("telemetry: too many channels");
+    return -1;
+  }
+  struct TELEMETRY_CHANNEL *ch = &telemetryChannels[telemetryNumChannels];
+  memset(ch, 0, sizeof(struct TELEMETRY_CHANNEL));
+  strncpy(ch->pubTopic, pubTopic, TELEMETRY_MAX_TOPIC_SIZE - 1);
+  ch->deadband = fabsf(deadband);
+  ch->minInterval = minInterval;
+  ch->maxInterval = maxInterval;
+  // smoothing 0.0 = none, approaching 1.0 = heavy (EMA weight of the previous value)
+  ch->alpha = 1.0f - constrain(smoothing, 0.0f, 0.99f);
+  // publish with a resolution matching the deadband
+  if(ch->deadband >= 1.0f)
+  {
+    ch->decimals = 0;
+  }
+  else if(ch->deadband >= 0.1f)
+  {
+    ch->decimals = 1;
+  }
+  else if(ch->deadband >= 0.01f)
+  {
+    ch->decimals = 2;
+  }
+  else
+  {
+    ch->decimals = 3;
+  }
+  return telemetryNumChannels++;
+}
+
+void telemetry_update(int channel, float value)
+{
+  if((channel < 0) || (channel >= telemetryNumChannels))
+  {
+    return;
+  }
+  struct TELEMETRY_CHANNEL *ch = &telemetryChannels[channel];
+  ch->stats.samplesIn++;
+  if(ch->pending)
+  {
+    ch->stats.samplesSuppressed++;  // previous sample was never published
+  }
+  if(ch->hasValue)
+  {
+    ch->value += ch->alpha * (value - ch->value);
+  }
+  else
+  {
+    ch->value = value;
+    ch->hasValue = true;
+  }
+  ch->pending = true;
+}
+
+void telemetry_tasks(void)
+{
+  unsigned long now = millis();
+  CETALIB_TRACE_BEGIN("telemetry", "tasks", telemetryNumChannels);
+  if(!mqttc_is_connected())
+  {
+    // nothing can be published: keep the samples pending (and not counted as sent) until the connection is up
+    CETALIB_TRACE_END("telemetry", "tasks", 0);
+    return;
+  }
+  for(int i = 0; i < telemetryNumChannels; i++)
+  {
+    struct TELEMETRY_CHANNEL *ch = &telemetryChannels[i];
+    if(!ch->hasValue)
+    {
+      continue;
+    }
+    unsigned long elapsed = now - ch->sentTime;
+    if(!ch->hasSent)
+    {
+      telemetryPublish(ch, now);
+    }
+    else if(ch->pending && telemetryIsSignificant(ch))
+    {
+      // significant change, publish once the rate limit allows (the sample stays pending until then)
+      if(elapsed >= ch->minInterval)
+      {
+        telemetryPublish(ch, now);
+      }
+    }
+    else if(ch->maxInterval && (elapsed >= ch->maxInterval))
+    {
+      ch->stats.heartbeatsSent++;
+      telemetryPublish(ch, now);
+    }
+    else if(ch->pending)
+    {
+      ch->stats.samplesSuppressed++;  // inside the deadband
+      ch->pending = false;
+    }
+  }
+  CETALIB_TRACE_END("telemetry", "tasks", 0);
+}
+
+float telemetry_get_value(int channel)
+{
+  if((channel < 0) || (channel >= telemetryNumChannels))
+  {
+    return 0.0f;
+  }
+  return telemetryChannels[channel].value;
+}
+
+TELEMETRY_STATS* telemetry_get_stats(int channel)
+{
+  if((channel < 0) || (channel >= telemetryNumChannels))
+  {
+    return NULL;
+  }
+  return &telemetryChannels[channel].stats;
+}
+
+void telemetry_clear_channels(void)
+{
+  memset(telemetryChannels, 0, sizeof(telemetryChannels));
+  telemetryNumChannels = 0;
+}
+
+/*** Private Function Definitions *********************************************/
+
+static void telemetryPublish(struct TELEMETRY_CHANNEL *ch, unsigned long now)
+{
+  char payload[24];
+  snprintf(payload, sizeof(payload), "%.*f", ch->decimals, ch->value);
+  mqttc_send_message(ch->pubTopic, payload);
+  ch->sentValue = ch->value;
+  ch->sentTime = now;
+  ch->hasSent = true;
+  ch->pending = false;
+  ch->stats.samplesSent++;
+}
+
+static bool telemetryIsSignificant(struct TELEMETRY_CHANNEL *ch)
+{
+  float change = fabsf(ch->value - ch->sentValue);
+  if(ch->deadband > 0.0f)
+  {
+    return (change >= ch->deadband);
+  }
+  return (change > 0.0f);     // no deadband: publish any change
+}
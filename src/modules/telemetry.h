@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2026 dBm Signal Dynamics Inc.
+ *
+ * File:            telemetry.h
+ * Project:
+ * Date:            Oct 19, 2026
+ * Framework:       Arduino w. Arduino-Pico Core Pkge by Earl Philhower
+ *                  (https://github.com/earlephilhower/arduino-pico)
+ *
+ * cetalib "telemetry" publish-on-change filter for mqttc sensor streams
+ *
+ * Each channel maps one sensor value (heading, temperature, distance, line
+ * status, encoder counts...) to an MQTT topic. Samples passed to update() are
+ * optionally smoothed (exponential moving average), and tasks() publishes a
+ * channel only when:
+ *
+ *  - the value has moved by at least "deadband" since it was last published,
+ *    and at least "minInterval" mS have elapsed (rate limit), or
+ *  - "maxInterval" mS have elapsed since it was last published (heartbeat).
+ *
+ * Hardware Configurations Supported:
+ *
+ * CETA IoT Robot (Schematic #14-00069A/B), based on RPI-Pico-WH
+ * (Select "Board = Raspberry Pi Pico W")
+ *
+ * Sparkfun XRP Robot Platform (#KIT-27644), based on the RPI RP2350B MCU
+ * (Select "Board = SparkFun XRP Controller")
+ *
+ * Sparkfun XRP (Beta) Robot Platform (#KIT-22230), based on the RPI Pico W
+ * (Select "Board = SparkFun XRP Controller (Beta)")
+ *
+ */
+
+#ifndef TELEMETRY_H_
+#define TELEMETRY_H_
+
+/*** Include Files ************************************************************/
+#include <Arduino.h>
+#include "telemetry_interface.h"
+
+/*** Macros *******************************************************************/
+#define TELEMETRY_MAX_CHANNELS      8       // Max number of channels
+#define TELEMETRY_MAX_TOPIC_SIZE    64      // Max length of a channel topic (including '\0')
+
+/*** Custom Data Types ********************************************************/
+
+struct TELEMETRY_CHANNEL
+{
+  char pubTopic[TELEMETRY_MAX_TOPIC_SIZE];  // topic the channel value is published to
+  float deadband;                           // minimum change that is published
+  unsigned long minInterval;                // minimum time between published changes (in mS)
+  unsigned long maxInterval;                // heartbeat interval, 0 = no heartbeat (in mS)
+  float alpha;                              // smoothing factor (1.0 = no smoothing)
+  int decimals;                             // decimal places in the published payload
+  float value;                              // current (smoothed) value
+  float sentValue;                          // most recently published value
+  unsigned long sentTime;                   // time of the most recent publish (in mS)
+  bool hasValue;                            // at least one sample has been received
+  bool hasSent;                             // at least one value has been published
+  bool pending;                             // a sample has been received since the last publish/decision
+  TELEMETRY_STATS stats;                    // sent/suppressed counters
+};
+
+/*** Public Function Prototypes ***********************************************/
+int telemetry_add_channel(const char *pubTopic, float deadband, unsigned long minInterval, unsigned long maxInterval, float smoothing); // Define a channel
+void telemetry_update(int channel, float value);              // Pass a new sample to a channel
+void telemetry_tasks(void);                                   // Publish significant changes and heartbeats
+float telemetry_get_value(int channel);                       // Returns the (smoothed) channel value
+TELEMETRY_STATS* telemetry_get_stats(int channel);            // Returns a pointer to the channel counters
+void telemetry_clear_channels(void);                          // Remove all channels
+
+#endif /* TELEMETRY_H_ */
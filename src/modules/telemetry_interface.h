@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) 2026 dBm Signal Dynamics Inc.
+ *
+ * File:            telemetry_interface.h
+ * Project:
+ * Date:            Oct 19, 2026
+ * Framework:       Arduino w. Arduino-Pico Core Pkge by Earl Philhower
+ *                  (https://github.com/earlephilhower/arduino-pico)
+ *
+ * "telemetry" driver interface file - defines "TELEMETRY_INTERFACE" structure
+ *
+ * Hardware Configurations Supported:
+ *
+ * CETA IoT Robot (Schematic #14-00069A/B), based on RPI-Pico-WH
+ * (Select "Board = Raspberry Pi Pico W")
+ *
+ * Sparkfun XRP Robot Platform (#KIT-27644), based on the RPI RP2350B MCU
+ * (Select "Board = SparkFun XRP Controller")
+ *
+ * Sparkfun XRP (Beta) Robot Platform (#KIT-22230), based on the RPI Pico W
+ * (Select "Board = SparkFun XRP Controller (Beta)")
+ *
+ */
+
+#ifndef TELEMETRY_INTERFACE_H_
+#define TELEMETRY_INTERFACE_H_
+
+/*** Include Files ************************************************************/
+#include <Arduino.h>
+
+/*** Macros *******************************************************************/
+
+/*** Custom Data Types ********************************************************/
+
+typedef struct
+{
+  unsigned long samplesIn;          // number of samples passed to update()
+  unsigned long samplesSent;        // number of values published (changes + heartbeats)
+  unsigned long samplesSuppressed;  // number of samples discarded (inside deadband, or replaced before publishing)
+  unsigned long heartbeatsSent;     // number of values published because maxInterval expired
+} TELEMETRY_STATS;
+
+struct TELEMETRY_INTERFACE
+{
+  int (*add_channel)(const char *pubTopic, float deadband, unsigned long minInterval, unsigned long maxInterval, float smoothing); // Define a channel, returns channel number (-1 if full)
+  void (*update)(int channel, float value);                 // Pass a new sample to a channel
+  void (*tasks)(void);                                      // Publish channels that changed significantly or reached their heartbeat timeout
+  float (*get_value)(int channel);                          // Returns the (smoothed) channel value
+  TELEMETRY_STATS* (*get_stats)(int channel);               // Returns a pointer to the channel sent/suppressed counters
+  void (*clear_channels)(void);                             // Remove all channels
+};
+
+/*** Public Function Prototypes ***********************************************/
+
+
+#endif /* TELEMETRY_INTERFACE_H_ */
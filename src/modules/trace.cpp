@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2026 dBm Signal Dynamics Inc.
+ *
+ * File:            trace.cpp
+ * Project:
+ * Date:            Oct 19, 2026
+ * Framework:       Arduino w. Arduino-Pico Core Pkge by Earl Philhower
+ *                  (https://github.com/earlephilhower/arduino-pico)
+ *
+ * cetalib "trace" event tracer
+ *
+ * Library modules (and sketches) mark the start and end of the code they run
+ * with the CETALIB_TRACE_BEGIN/END() macros: every tasks() function, every
+ * blocking wait (rangefinder echo, I2C transfers, flash writes, socket writes,
+ * connection retries) and every MQTT/joystick packet. Each event (type,
+ * module, function, argument) is stored with a microsecond time stamp in the
+ * event buffer of the core that ran it. A core only writes its own buffer, so
+ * recording never waits for the other core. When a buffer is full, the oldest
+ * events are overwritten: stop() (or dump()) keeps the events that led up to
+ * a problem.
+ *
+ * dump() sends the events as text lines, converted by "cetalib-trace-export.py"
+ * to a Chrome trace file, to view the timeline of both cores in Perfetto.
+ *
+ * Tracing is built in only when CETALIB_TRACE is 1 (see "trace_interface.h").
+ *
+ * Hardware Configurations Supported:
+ *
+ * CETA IoT Robot (Schematic #14-00069A/B), based on RPI-Pico-WH
+ * (Select "Board = Raspberry Pi Pico W")
+ *
+ * Sparkfun XRP Robot Platform (#KIT-27644), based on the RPI RP2350B MCU
+ * (Select "Board = SparkFun XRP Controller")
+ *
+ * Sparkfun XRP (Beta) Robot Platform (#KIT-22230), based on the RPI Pico W
+ * (Select "Board = SparkFun XRP Controller (Beta)")
+ *
+ */
+
+/** Include Files *************************************************************/
+#include <Arduino.h>                // Required for Arduino functions
+#include <stdio.h>                  // needed for "snprintf()" function
+#include <string.h>                 // needed for "strlen()" function
+#include <hardware/sync.h>          // needed for get_core_num(), save_and_disable_interrupts() and memory barriers
+#include "logger.h"                 // "logger" functions
+#include "trace.h"                  // "trace" API declarations
+
+/*** Symbolic Constants used in this module ***********************************/
+#define SERIAL_PORT Serial  // Default to Serial
+#if defined(NO_USB)
+    #undef SERIAL_PORT
+    #define SERIAL_PORT Serial1     // Use Serial1 if USB is disabled
+#endif
+
+/*** Global Variable Declarations *********************************************/
+
+// define the function interface
+extern const struct TRACE_INTERFACE TRACE = {
+    .start                  = &trace_start,
+    .stop                   = &trace_stop,
+    .is_running             = &trace_is_running,
+    .get_stats              = &trace_get_stats,
+    .dump                   = &trace_dump
+};
+
+static struct TRACE_EVENT traceRing[TRACE_NUM_CORES][TRACE_RING_SIZE];
+static volatile uint32_t traceHead[TRACE_NUM_CORES];   // total events recorded on each core
+static volatile bool traceRunning = false;
+static TRACE_STATS traceStats;
+
+/*** Type Declarations ********************************************************/
+
+/*** Private Function Prototypes **********************************************/
+
+/*** Public Function Definitions **********************************************/
+
+void trace_event(char type, const char *name, long arg)
+{
+  if(!traceRunning)
+  {
+    return;
+  }
+  // only interrupt handlers of the same core can interleave with this event
+  uint32_t core = get_core_num();
+  uint32_t irqState = save_and_disable_interrupts();
+  struct TRACE_EVENT *event = &traceRing[core][traceHead[core] & (TRACE_RING_SIZE - 1)];
+  event->time = micros();
+  event->name = name;
+  event->arg = arg;
+  event->type = type;
+  traceHead[core]++;
+  restore_interrupts(irqState);
+}
+
+bool trace_start(void)
+{
+  #if CETALIB_TRACE
+  traceRunning = false;
+  __dmb();
+  for(int core = 0; core < TRACE_NUM_CORES; core++)
+  {
+    traceHead[core] = 0;
+  }
+  __dmb();
+  traceRunning = true;
+  return true;
+  #else
+  CETALIB_LOG_ERROR("trace: not built in (build with CETALIB_TRACE=1)");
+  return false;
+  #endif
+}
+
+void trace_stop(void)
+{
+  traceRunning = false;
+  __dmb();                          // the buffers must not change while they are read
+}
+
+bool trace_is_running(void)
+{
+  return traceRunning;
+}
+
+TRACE_STATS* trace_get_stats(void)
+{
+  for(int core = 0; core < TRACE_NUM_CORES; core++)
+  {
+    uint32_t head = traceHead[core];
+    traceStats.events[core] = head;
+    traceStats.overwritten[core] = (head > TRACE_RING_SIZE) ? (head - TRACE_RING_SIZE) : 0;
+  }
+  return &traceStats;
+}
+
+void trace_dump(void)
+{
+  trace_stop();
+  // text survives any serial terminal, "cetalib-trace-export.py" reads the
+  // lines between the BEGIN and END markers. The BEGIN line holds the current
+  // time, used to place each event before the dump (the uS counter wraps)
+  char line[TRACE_DUMP_LINE_SIZE];
+  snprintf(line, sizeof(line), "TRACE BEGIN %lu", (unsigned long)micros());
+  SERIAL_PORT.println(line);
+  for(int core = 0; core < TRACE_NUM_CORES; core++)
+  {
+    uint32_t head = traceHead[core];
+    uint32_t first = (head > TRACE_RING_SIZE) ? (head - TRACE_RING_SIZE) : 0;
+    for(uint32_t i = first; i < head; i++)
+    {
+      struct TRACE_EVENT *event = &traceRing[core][i & (TRACE_RING_SIZE - 1)];
+      const char *function = event->name + strlen(event->name) + 1;
+      snprintf(line, sizeof(line), "%d %lu %c %s %s %ld", core, (unsigned long)event->time,
+               event->type, event->name, function, event->arg);
+      SERIAL_PORT.println(line);
+    }
+  }
+  SERIAL_PORT.println("TRACE END");
+}
+
+/*** Private Function Definitions *********************************************/
@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) 2026 dBm Signal Dynamics Inc.
+ *
+ * File:            trace.h
+ * Project:
+ * Date:            Oct 19, 2026
+ * Framework:       Arduino w. Arduino-Pico Core Pkge by Earl Philhower
+ *                  (https://github.com/earlephilhower/arduino-pico)
+ *
+ * cetalib "trace" event tracer
+ *
+ * Hardware Configurations Supported:
+ *
+ * CETA IoT Robot (Schematic #14-00069A/B), based on RPI-Pico-WH
+ * (Select "Board = Raspberry Pi Pico W")
+ *
+ * Sparkfun XRP Robot Platform (#KIT-27644), based on the RPI RP2350B MCU
+ * (Select "Board = SparkFun XRP Controller")
+ *
+ * Sparkfun XRP (Beta) Robot Platform (#KIT-22230), based on the RPI Pico W
+ * (Select "Board = SparkFun XRP Controller (Beta)")
+ *
+ */
+
+#ifndef TRACE_H_
+#define TRACE_H_
+
+/*** Include Files ************************************************************/
+#include <Arduino.h>
+#include "trace_interface.h"
+
+/*** Macros *******************************************************************/
+#define TRACE_NUM_CORES             2           // One event buffer per core
+#if CETALIB_TRACE
+#define TRACE_RING_SIZE             512         // Events kept per core (must be a power of 2)
+#else
+#define TRACE_RING_SIZE             1           // Tracing not built in: no event buffers
+#endif
+#define TRACE_DUMP_LINE_SIZE        80          // Max length of a line sent by dump()
+
+/*** Custom Data Types ********************************************************/
+
+struct TRACE_EVENT
+{
+  uint32_t time;                    // time of the event (in uS since reset)
+  const char *name;                 // "module\0function" string literal
+  long arg;                         // event argument (size, pin, result...)
+  char type;                        // CETALIB_TRACE_TYPE_xxx
+};
+
+/*** Public Function Prototypes ***********************************************/
+bool trace_start(void);                                     // Clear the event buffers and start recording
+void trace_stop(void);                                      // Stop recording
+bool trace_is_running(void);                                // Returns true while recording
+TRACE_STATS* trace_get_stats(void);                         // Returns a pointer to the event counters
+void trace_dump(void);                                      // Stop recording and send the events to the serial terminal
+
+#endif /* TRACE_H_ */
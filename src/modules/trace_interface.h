@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2026 dBm Signal Dynamics Inc.
+ *
+ * File:            trace_interface.h
+ * Project:
+ * Date:            Oct 19, 2026
+ * Framework:       Arduino w. Arduino-Pico Core Pkge by Earl Philhower
+ *                  (https://github.com/earlephilhower/arduino-pico)
+ *
+ * "trace" driver interface file - defines "TRACE_INTERFACE" structure
+ * and the CETALIB_TRACE_xxx() event macros
+ *
+ * Hardware Configurations Supported:
+ *
+ * CETA IoT Robot (Schematic #14-00069A/B), based on RPI-Pico-WH
+ * (Select "Board = Raspberry Pi Pico W")
+ *
+ * Sparkfun XRP Robot Platform (#KIT-27644), based on the RPI RP2350B MCU
+ * (Select "Board = SparkFun XRP Controller")
+ *
+ * Sparkfun XRP (Beta) Robot Platform (#KIT-22230), based on the RPI Pico W
+ * (Select "Board = SparkFun XRP Controller (Beta)")
+ *
+ */
+
+#ifndef TRACE_INTERFACE_H_
+#define TRACE_INTERFACE_H_
+
+/*** Include Files ************************************************************/
+#include <Arduino.h>
+
+/*** Macros *******************************************************************/
+
+// Compile-time tracing switch. When 0 the CETALIB_TRACE_xxx() macros are removed
+// by the pre-processor (no code, arguments not evaluated) and the event buffers
+// are not allocated. The library modules must be built with the same setting:
+// add "-DCETALIB_TRACE=1" to a "build_opt.h" file in the sketch folder, or edit
+// the default below
+#ifndef CETALIB_TRACE
+#define CETALIB_TRACE               0
+#endif
+
+// Event types
+#define CETALIB_TRACE_TYPE_BEGIN    'B'
+#define CETALIB_TRACE_TYPE_END      'E'
+#define CETALIB_TRACE_TYPE_INSTANT  'I'
+
+// "module" and "function" must be string literals (only a pointer is recorded)
+#if CETALIB_TRACE
+#define CETALIB_TRACE_BEGIN(module, function, arg)      trace_event(CETALIB_TRACE_TYPE_BEGIN, module "\0" function, (long)(arg))
+#define CETALIB_TRACE_END(module, function, arg)        trace_event(CETALIB_TRACE_TYPE_END, module "\0" function, (long)(arg))
+#define CETALIB_TRACE_INSTANT(module, function, arg)    trace_event(CETALIB_TRACE_TYPE_INSTANT, module "\0" function, (long)(arg))
+#else
+#define CETALIB_TRACE_BEGIN(module, function, arg)      do {} while(0)
+#define CETALIB_TRACE_END(module, function, arg)        do {} while(0)
+#define CETALIB_TRACE_INSTANT(module, function, arg)    do {} while(0)
+#endif
+
+/*** Custom Data Types ********************************************************/
+
+typedef struct
+{
+  unsigned long events[2];          // number of events recorded on each core since start()
+  unsigned long overwritten[2];     // number of oldest events overwritten on each core (buffer full)
+} TRACE_STATS;
+
+struct TRACE_INTERFACE
+{
+  bool (*start)(void);                      // Clear the event buffers and start recording, returns false if tracing is not built in
+  void (*stop)(void);                       // Stop recording (the event buffers are kept for dump())
+  bool (*is_running)(void);                 // Returns true while recording
+  TRACE_STATS* (*get_stats)(void);          // Returns a pointer to the event counters
+  void (*dump)(void);                       // Stop recording and send the events to the serial terminal (as text)
+};
+
+/*** Public Function Prototypes ***********************************************/
+
+// Record an event (used by the CETALIB_TRACE_xxx() macros)
+void trace_event(char type, const char *name, long arg);
+
+#endif /* TRACE_INTERFACE_H_ */
@@ -0,0 +1,243 @@
+#
+# Copyright (C) 2026 dBm Signal Dynamics Inc
+#
+# File:     cetalib-datalog-decode.py
+# Version:  0.0.1
+# Date:     October 19, 2026
+#
+# Description:
+#
+# Decodes the binary log files recorded by the CETALIB "datalog" module and
+# exports them to CSV (or Parquet, if pandas and pyarrow are installed).
+#
+# The input is either the binary log file, or a text capture of the datalog
+# "dump()" output (the hex lines between "DATALOG BEGIN" and "DATALOG END").
+# With "--serial", the dump is captured directly from the robot's serial port
+# (requires pyserial).
+#
+# Log file layout (all values little-endian):
+#
+#   block 0:    file header - magic "CDLG", version, number of channels,
+#               block size, number of blocks, start time (mS), then a
+#               12 byte name and a float scale for each channel
+#   block 1..N: data blocks (circular, the oldest block is overwritten) -
+#               magic 0xB10C, length, sequence number, rows, then the rows
+#
+# Each row is a list of variable-length integers (7 bits per byte, least
+# significant first): the time since the previous row (in uS), then the
+# zigzag-encoded change of each channel since the previous row. The first row
+# of each block holds absolute values. A channel value is the recorded integer
+# divided by the channel scale.
+#
+
+import argparse
+import csv
+import os
+import struct
+import sys
+import time
+
+FILE_MAGIC = 0x474C4443
+BLOCK_MAGIC = 0xB10C
+FILE_HEADER = struct.Struct('<IBBHHHI')
+CHANNEL = struct.Struct('<12sf')
+BLOCK_HEADER = struct.Struct('<HHIHH')
+
+
+def read_varint(data, pos):
+    value = 0
+    shift = 0
+    while True:
+        byte = data[pos]
+        pos += 1
+        value |= (byte & 0x7F) << shift
+        if byte < 0x80:
+            return value, pos
+        shift += 7
+
+
+def from_hex_dump(text):
+    # keep the last complete dump in the capture
+    lines = None
+    dump = None
+    for line in text.splitlines():
+        line = line.strip()
+        if line.startswith("DATALOG BEGIN"):
+            lines = []
+        elif line == "DATALOG END" and lines is not None:
+            dump = lines
+            lines = None
+        elif lines is not None and line:
+            lines.append(line)
+    if dump is None:
+        raise ValueError("no complete \"DATALOG BEGIN\" ... \"DATALOG END\" dump found")
+    return bytes.fromhex(''.join(dump))
+
+
+def capture_serial(port, baud, fileName):
+    try:
+        import serial
+    except ImportError:
+        sys.exit("[!] --serial requires pyserial (pip install pyserial)")
+    print(f"[*] Waiting for a datalog dump on {port} (call datalog->dump(\"{fileName}\") on the robot)...")
+    text = []
+    with serial.Serial(port, baud, timeout=1) as ser:
+        started = False
+        while True:
+            line = ser.readline().decode('ascii', errors='replace').strip()
+            if line.startswith("DATALOG BEGIN"):
+                started = True
+                text = []
+                print(f"[*] Receiving {line[14:]} bytes")
+            if started:
+                text.append(line)
+                if line == "DATALOG END":
+                    return from_hex_dump('\n'.join(text))
+
+
+def decode(data):
+    if len(data) < FILE_HEADER.size:
+        raise ValueError("file is too short")
+    magic, version, num_channels, block_size, max_blocks, _, start_time = FILE_HEADER.unpack_from(data, 0)
+    if magic != FILE_MAGIC:
+        raise ValueError("not a datalog file")
+    if version != 1:
+        raise ValueError(f"unsupported datalog version {version}")
+    names = []
+    scales = []
+    for i in range(num_channels):
+        name, scale = CHANNEL.unpack_from(data, FILE_HEADER.size + i * CHANNEL.size)
+        names.append(name.split(b'\0', 1)[0].decode('ascii', errors='replace'))
+        scales.append(scale)
+
+    # collect the valid blocks, the circular log is put back in order by sequence number
+    blocks = []
+    for index in range(max_blocks):
+        offset = (index + 1) * block_size
+        if offset + BLOCK_HEADER.size > len(data):
+            break
+        magic, length, sequence, rows, _ = BLOCK_HEADER.unpack_from(data, offset)
+        if magic != BLOCK_MAGIC or length > block_size or offset + length > len(data):
+            continue
+        blocks.append((sequence, rows, data[offset + BLOCK_HEADER.size:offset + length]))
+    blocks.sort(key=lambda block: block[0])
+
+    samples = []
+    gaps = 0
+    previous_sequence = None
+    clock = None                        # unwrapped micros()
+    for sequence, rows, payload in blocks:
+        if previous_sequence is not None and sequence != previous_sequence + 1:
+            gaps += 1
+        previous_sequence = sequence
+        pos = 0
+        values = [0] * num_channels
+        for row in range(rows):
+            delta_time, pos = read_varint(payload, pos)
+            if row == 0:
+                # absolute 32-bit micros(), unwrapped against the previous block
+                if clock is None:
+                    clock = delta_time
+                else:
+                    clock += (delta_time - clock) & 0xFFFFFFFF
+            else:
+                clock += delta_time
+            for i in range(num_channels):
+                zigzag, pos = read_varint(payload, pos)
+                delta = (zigzag >> 1) ^ -(zigzag & 1)
+                values[i] = ((values[i] + delta + 0x80000000) & 0xFFFFFFFF) - 0x80000000
+            samples.append((clock, [values[i] / scales[i] for i in range(num_channels)]))
+
+    info = {
+        'start_time': start_time,
+        'blocks': len(blocks),
+        'gaps': gaps,
+        'wrapped': bool(blocks) and blocks[0][0] > 0,
+        'payload_bytes': sum(len(block[2]) for block in blocks),
+    }
+    return names, samples, info
+
+
+def write_csv(path, names, samples):
+    first = samples[0][0] if samples else 0
+    with open(path, 'w', newline='') as f:
+        writer = csv.writer(f)
+        writer.writerow(['time_s'] + names)
+        for clock, values in samples:
+            writer.writerow([f"{(clock - first) / 1e6:.6f}"] + [f"{value:.6g}" for value in values])
+
+
+def write_parquet(path, names, samples):
+    try:
+        import pandas
+    except ImportError:
+        sys.exit("[!] Parquet output requires pandas and pyarrow (pip install -r requirements.txt)")
+    first = samples[0][0] if samples else 0
+    columns = {'time_s': [(clock - first) / 1e6 for clock, _ in samples]}
+    for i, name in enumerate(names):
+        columns[name] = [values[i] for _, values in samples]
+    pandas.DataFrame(columns).to_parquet(path, index=False)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="CETALIB datalog decoder")
+    parser.add_argument('input', nargs='?', help="log file, or a text capture of datalog dump()")
+    parser.add_argument('-o', '--output', help="output file (default: input name with .csv or .parquet)")
+    parser.add_argument('--format', choices=['csv', 'parquet'], help="output format (default: from the output file name, else csv)")
+    parser.add_argument('--serial', metavar='PORT', help="capture a dump from the robot's serial port instead of reading a file")
+    parser.add_argument('--baud', type=int, default=115200, help="serial baud rate (default: 115200)")
+    parser.add_argument('--file', default="/datalog.bin", help="file name shown in the --serial prompt (default: /datalog.bin)")
+    args = parser.parse_args()
+
+    if args.serial:
+        data = capture_serial(args.serial, args.baud, args.file)
+        base = args.output or time.strftime("datalog-%Y%m%d-%H%M%S")
+        with open(os.path.splitext(base)[0] + '.bin', 'wb') as f:
+            f.write(data)
+    elif args.input:
+        with open(args.input, 'rb') as f:
+            data = f.read()
+        if not data.startswith(struct.pack('<I', FILE_MAGIC)):
+            data = from_hex_dump(data.decode('ascii', errors='replace'))
+        base = args.input
+    else:
+        parser.error("give an input file or --serial PORT")
+
+    output_format = args.format
+    if output_format is None:
+        output_format = 'parquet' if args.output and args.output.endswith('.parquet') else 'csv'
+    output = args.output
+    if output is None or os.path.splitext(output)[1] == '':
+        output = os.path.splitext(output or base)[0] + '.' + output_format
+
+    try:
+        names, samples, info = decode(data)
+    except ValueError as error:
+        sys.exit(f"[!] {error}")
+
+    if output_format == 'parquet':
+        write_parquet(output, names, samples)
+    else:
+        write_csv(output, names, samples)
+
+    duration = (samples[-1][0] - samples[0][0]) / 1e6 if len(samples) > 1 else 0.0
+    print(f"--- CETALIB datalog: {len(names)} channels ({', '.join(names)}) ---")
+    print(f"{len(samples)} samples in {info['blocks']} blocks, {duration:.3f} s", end='')
+    if duration > 0:
+        print(f" ({(len(samples) - 1) / duration:.1f} samples/s)", end='')
+    print()
+    if samples:
+        print(f"{info['payload_bytes'] / len(samples):.1f} bytes/sample "
+              f"({4 * (len(names) + 1)} bytes/sample unencoded)")
+    if info['wrapped']:
+        print("log wrapped: the oldest samples were overwritten")
+    if info['gaps']:
+        print(f"[!] {info['gaps']} gaps (missing blocks, e.g. a reset before the file was closed)")
+    print(f"[*] Written {output}")
+
+
+if __name__ == '__main__':
+    try:
+        main()
+    except KeyboardInterrupt:
+        print("\n[!] Exiting...")
@@ -2,8 +2,8 @@
 # Copyright (C) 2026 dBm Signal Dynamics Inc
 #
 # File:     cetalib-joystick-client.py
-# Version:  0.0.1
-# Date:     March 30, 2026
+# Version:  0.0.4
+# Date:     October 19, 2026
 #
 # Description:
 #
@@ -12,18 +12,57 @@
 # the CETALIB "joystick" library using the default IP:Port 192.168.42.1:8888.
 # The F310 must be set to "D" mode.
 #
+# Packet formats (select with --protocol):
+#
+#   1: the raw 8-byte HID report
+#   2: 'C', 'J', version (2), robot ID (0 = any), sequence (uint16 LE),
+#      sender timestamp in mS (uint32 LE), 8-byte HID report (18 bytes),
+#      followed by 0-3 redundant older reports (sequence - 1, - 2, ...)
+#
+# Protocol 2 lets the robot discard stale/duplicate packets and report packet
+# loss, reordering and latency statistics. It is opt-in: a robot running an
+# older cetalib reads the 'C', 'J' header bytes as stick values and drives
+# off, so protocol 1 is used unless --protocol 2, --fleet or --redundancy is
+# given.
+#
+# Fleet mode (--fleet) drives several robots that have joined one shared WiFi
+# network (joystick "initialize_fleet()"). Each connected F310 is assigned to a
+# robot ID, in the order the gamepads are found. Packets for a robot are sent
+# to its IP address (ID@IP), or to the fleet multicast group when no IP is
+# given; every robot ignores packets carrying another robot's ID (and ID 0).
+#
+# Reports are sent as soon as the gamepad state changes. While nothing
+# changes, the last state is repeated every --keepalive mS so the robot's
+# link-loss failsafe stays armed but idle. With --redundancy N, protocol 2
+# packets also carry the N previous reports, so the robot can recover a
+# button press or release whose packet was lost.
+#
+# --bench replays a synthetic gamepad trace to a local UDP receiver stand-in
+# (no gamepad or robot needed) and compares the latency and bandwidth of the
+# fixed 10 mS polling sender with the send-on-change sender.
+#
 
-import hid
-import time
+import argparse
+import collections
+import random
 import socket
 import signal
+import struct
 import sys
+import threading
+import time
 
 # Logitech F310 IDs
 LOGITECH_VID = 0x046d
 PID_MODE_D = 0xc216  
 PID_MODE_X = 0xc21d
 
+# Fleet mode multicast group (must match the robot "joystick" module)
+FLEET_GROUP = "239.42.0.1"
+
+# Most redundant reports a robot accepts in one protocol 2 packet
+MAX_REDUNDANCY = 3
+
 def exit_gracefully(signum, frame):
     print("\n[!] Exiting...")
     sys.exit(0)
@@ -31,53 +70,310 @@ def exit_gracefully(signum, frame):
 # Handle Ctrl+C (works on Windows and macOS)
 signal.signal(signal.SIGINT, exit_gracefully)
 
-def find_f310():
+def find_f310s():
+    import hid
+    paths = []
     for device in hid.enumerate(LOGITECH_VID):
         if device['product_id'] in [PID_MODE_D, PID_MODE_X]:
-            return device['path']
-    return None
+            paths.append(device['path'])
+    return paths
 
-def main():
-    print("--- CETALIB Joystick UDP Publisher v0.0.1 ---")
-    ip = "192.168.42.1"
-    port = 8888
+def parse_fleet(entries, group, port):
+    # "ID" -> (ID, multicast group), "ID@IP" -> (ID, robot IP)
+    targets = []
+    for entry in entries:
+        robot_id, _, ip = entry.partition('@')
+        robot_id = int(robot_id)
+        if not 1 <= robot_id <= 255:
+            raise ValueError(f"robot ID {robot_id} must be 1-255")
+        targets.append((robot_id, (ip or group, port)))
+    return targets
 
-    udp_socket = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
-    server_address = (ip, port)
+def build_packet(protocol, robot_id, sequence, report, history=()):
+    if protocol == 1:
+        return report
+    timestamp = int(time.monotonic() * 1000) & 0xFFFFFFFF
+    return struct.pack('<2sBBHI', b'CJ', 2, robot_id, sequence, timestamp) + report + b''.join(history)
 
-    path = find_f310()
-    if not path:
-        print("F310 not found."); return
+class PadSender:
+    """Sends one gamepad's reports to one robot: on change, plus a keepalive."""
 
-    try:
-        device = hid.device()
-        device.open_path(path)
-        device.set_nonblocking(True)
-        
-        print(f"Streaming raw bytes to {ip}:{port}...")
+    def __init__(self, sock, protocol, robot_id, address, keepalive, redundancy):
+        self.sock = sock
+        self.protocol = protocol
+        self.robot_id = robot_id
+        self.address = address
+        self.keepalive = keepalive / 1000.0
+        self.history = collections.deque(maxlen=redundancy)
+        self.sequence = 0
+        self.last_report = None
+        self.last_send_time = 0.0
+        self.packets = 0
+        self.bytes = 0
+
+    def send(self, report, now):
+        packet = build_packet(self.protocol, self.robot_id, self.sequence, report, self.history)
+        self.sock.sendto(packet, self.address)
+        self.sequence = (self.sequence + 1) & 0xFFFF
+        self.history.appendleft(report)
+        self.last_report = report
+        self.last_send_time = now
+        self.packets += 1
+        self.bytes += len(packet)
+
+    def on_report(self, report, now):
+        if report != self.last_report:
+            self.send(report, now)
+
+    def on_idle(self, now):
+        if self.last_report is not None and self.keepalive and now - self.last_send_time >= self.keepalive:
+            self.send(self.last_report, now)
+
+    def next_deadline(self):
+        if self.last_report is None or not self.keepalive:
+            return None
+        return self.last_send_time + self.keepalive
+
+def run_senders(pads, clock=time.monotonic, show=None):
+    """pads: list of (device, PadSender). Runs until interrupted (or the devices run out)."""
+    while True:
+        now = clock()
+        received = False
+        for device, sender in pads:
+            # a single gamepad can block until a report arrives or the keepalive is due
+            timeout_ms = 0
+            if len(pads) == 1:
+                deadline = sender.next_deadline()
+                timeout_ms = 100 if deadline is None else max(1, int((deadline - now) * 1000))
+            report = device.read(8, timeout_ms)
+            if report is None:
+                return
+            while report:
+                received = True
+                raw_payload = bytes(report)
+                sender.on_report(raw_payload, clock())
+                if show:
+                    show(raw_payload)
+                report = device.read(8)         # drain anything else already queued
+        now = clock()
+        for device, sender in pads:
+            sender.on_idle(now)
+        if len(pads) > 1 and not received:
+            time.sleep(0.001)
+
+#
+# Benchmark: synthetic gamepad, legacy and send-on-change senders, receiver stand-in
+#
+
+class SyntheticGamepad:
+    """Replays (time, report) events with the hid.device read() semantics. Every report
+    is unique (bytes 6-7 hold the event number) so the receiver can time each change."""
+
+    def __init__(self, events, start):
+        self.events = events
+        self.start = start
+        self.next_event = 0
+
+    def read(self, max_length, timeout_ms=0):
+        if self.next_event >= len(self.events):
+            return None                         # end of trace
+        due = self.start + self.events[self.next_event][0]
+        now = time.perf_counter()
+        if due > now:
+            if timeout_ms <= 0:
+                return []
+            wait = min(due - now, timeout_ms / 1000.0)
+            time.sleep(wait)
+            if time.perf_counter() < due:
+                return []
+        report = self.events[self.next_event][1]
+        self.next_event += 1
+        return list(report)
+
+def make_trace(duration, seed):
+    # idle periods, stick sweeps (a report every 8 mS, the F310 USB interval) and button taps
+    rng = random.Random(seed)
+    events, t, state = [], 0.5, [128, 128, 128, 128, 8, 0]
+    def emit(when):
+        index = len(events)
+        events.append((when, bytes(state) + struct.pack('<H', index)))
+    while t < duration:
+        kind = rng.random()
+        if kind < 0.4:
+            axis = rng.randrange(4)
+            target = rng.choice([0, 64, 192, 255])
+            steps = rng.randint(10, 60)
+            start = state[axis]
+            for i in range(1, steps + 1):
+                state[axis] = int(start + (target - start) * i / steps)
+                emit(t)
+                t += 0.008
+            state[axis] = 128
+            emit(t)
+        elif kind < 0.7:
+            bit = rng.choice([0x10, 0x20, 0x40, 0x80])
+            state[4] |= bit
+            emit(t)
+            t += rng.uniform(0.05, 0.15)
+            state[4] &= ~bit
+            emit(t)
+        t += rng.uniform(0.2, 1.5)
+    return events
+
+class ReceiverStandIn(threading.Thread):
+    """Decodes packets like the robot (sequence tracking, redundant report recovery)
+    and records when each gamepad state first arrived. Drops packets at 'loss' rate."""
 
+    def __init__(self, port, loss, seed):
+        super().__init__(daemon=True)
+        self.sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        self.sock.bind(('127.0.0.1', port))
+        self.sock.settimeout(0.05)
+        self.loss = loss
+        self.rng = random.Random(seed)
+        self.arrivals = {}
+        self.last_sequence = None
+        self.running = True
+
+    def deliver(self, report, now):
+        index = struct.unpack_from('<H', report, 6)[0]
+        self.arrivals.setdefault(index, now)
+
+    def run(self):
+        while self.running:
+            try:
+                packet = self.sock.recv(256)
+            except socket.timeout:
+                continue
+            now = time.perf_counter()
+            if self.rng.random() < self.loss:
+                continue
+            if len(packet) == 8:
+                self.deliver(packet, now)
+                continue
+            sequence = struct.unpack_from('<H', packet, 4)[0]
+            reports = [packet[i:i + 8] for i in range(10, len(packet), 8)]
+            if self.last_sequence is not None:
+                gap = (sequence - self.last_sequence) & 0xFFFF
+                for k in range(min(gap - 1, len(reports) - 1), 0, -1):
+                    self.deliver(reports[k], now)           # recovered, oldest first
+            self.last_sequence = sequence
+            self.deliver(reports[0], now)
+
+def run_bench_case(name, events, args, legacy, redundancy):
+    port = args.port
+    receiver = ReceiverStandIn(port, args.bench_loss / 100.0, args.bench_seed)
+    receiver.start()
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sender = PadSender(sock, args.protocol, 0, ('127.0.0.1', port), args.keepalive, redundancy)
+    start = time.perf_counter()
+    device = SyntheticGamepad(events, start)
+    if legacy:
+        # v0.0.3 loop: read one report, send it, sleep 10 mS
         while True:
-            # Read 8 bytes (Standard F310 Report size in Mode D)
             report = device.read(8)
-            
+            if report is None:
+                break
             if report:
-                # 1. Convert to immutable 'bytes' type for the socket
-                raw_payload = bytes(report)
-                
-                # 2. Send over UDP
-                udp_socket.sendto(raw_payload, server_address)
+                sender.send(bytes(report), time.perf_counter())
+            time.sleep(0.01)
+    else:
+        run_senders([(device, sender)], clock=time.perf_counter)
+    elapsed = time.perf_counter() - start
+    time.sleep(0.2)
+    receiver.running = False
+    receiver.join()
+    sock.close()
+    receiver.sock.close()
+
+    latencies = sorted(receiver.arrivals[i] - (start + events[i][0]) for i in receiver.arrivals)
+    missed = 100.0 * (len(events) - len(latencies)) / len(events)
+    pct = lambda f: latencies[min(len(latencies) - 1, int(len(latencies) * f))] * 1000 if latencies else float('nan')
+    print(f"{name:<24} {sender.packets / elapsed:7.1f} {sender.bytes / elapsed:8.0f} "
+          f"{pct(0.5):7.2f} {pct(0.99):7.2f} {(latencies[-1] * 1000 if latencies else float('nan')):7.2f} {missed:8.2f}")
 
-                # 3. Output to terminal for verification
-                # Shows: [128, 128, 128, 128, 8, 0, 0, 0]
-                print(f"Raw: {list(raw_payload)}", end='\r')
+def run_bench(args):
+    events = make_trace(args.bench_duration, args.bench_seed)
+    print(f"Synthetic trace: {len(events)} gamepad changes in {events[-1][0]:.1f} s, "
+          f"simulated loss {args.bench_loss:.1f} %, keepalive {args.keepalive} mS")
+    print(f"{'sender':<24} {'pkt/s':>7} {'B/s':>8} {'p50 mS':>7} {'p99 mS':>7} {'max mS':>7} {'missed %':>8}")
+    run_bench_case("fixed 10 mS polling", events, args, True, 0)
+    run_bench_case("on change", events, args, False, 0)
+    if args.protocol == 2 and args.redundancy:
+        run_bench_case(f"on change, redundancy {args.redundancy}", events, args, False, args.redundancy)
+
+def main():
+    parser = argparse.ArgumentParser(description="CETALIB Joystick UDP Publisher")
+    parser.add_argument('--ip', default="192.168.42.1", help="robot IP address (default: 192.168.42.1)")
+    parser.add_argument('--port', type=int, default=8888, help="robot UDP port (default: 8888)")
+    parser.add_argument('--protocol', type=int, choices=[1, 2], default=None,
+                        help="packet format (default: 1, or 2 with --fleet or --redundancy)")
+    parser.add_argument('--robot-id', type=int, default=0, help="protocol 2 robot ID (default: 0 = any)")
+    parser.add_argument('--fleet', nargs='+', metavar='ID[@IP]',
+                        help="fleet mode: robot ID (and optional IP) for each gamepad, in order")
+    parser.add_argument('--group', default=FLEET_GROUP, help=f"fleet multicast group (default: {FLEET_GROUP})")
+    parser.add_argument('--keepalive', type=int, default=100,
+                        help="repeat an unchanged state every N mS (default: 100, 0 = never)")
+    parser.add_argument('--redundancy', type=int, default=0, choices=range(MAX_REDUNDANCY + 1),
+                        help="protocol 2: previous reports repeated in each packet (default: 0)")
+    parser.add_argument('--bench', action='store_true', help="benchmark against a local receiver stand-in")
+    parser.add_argument('--bench-duration', type=float, default=20.0, help="benchmark trace length in seconds (default: 20)")
+    parser.add_argument('--bench-loss', type=float, default=0.0, help="benchmark packet loss in percent (default: 0)")
+    parser.add_argument('--bench-seed', type=int, default=1, help="benchmark trace/loss random seed (default: 1)")
+    args = parser.parse_args()
+
+    print("--- CETALIB Joystick UDP Publisher v0.0.5 ---")
+
+    if args.bench and args.redundancy == 0:
+        args.redundancy = 2
+    if args.protocol is None:
+        # protocol 2 only when a protocol 2 feature is asked for (older robots need protocol 1)
+        args.protocol = 2 if (args.fleet or args.redundancy) else 1
+    if args.bench:
+        run_bench(args)
+        return
+
+    if args.redundancy and args.protocol != 2:
+        print("Redundancy requires protocol 2."); return
+    if args.fleet:
+        if args.protocol != 2:
+            print("Fleet mode requires protocol 2."); return
+        targets = parse_fleet(args.fleet, args.group, args.port)
+    else:
+        targets = [(args.robot_id, (args.ip, args.port))]
+
+    udp_socket = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    udp_socket.setsockopt(socket.IPPROTO_IP, socket.IP_MULTICAST_TTL, 1)   # keep multicast on the local network
+
+    paths = find_f310s()
+    if not paths:
+        print("F310 not found."); return
+    if len(paths) < len(targets):
+        print(f"Found {len(paths)} F310(s), only the first {len(paths)} robot(s) will be driven.")
+        targets = targets[:len(paths)]
+
+    import hid
+    pads = []
+    try:
+        # one gamepad per robot
+        for path, (robot_id, address) in zip(paths, targets):
+            device = hid.device()
+            device.open_path(path)
+            device.set_nonblocking(True)
+            pads.append((device, PadSender(udp_socket, args.protocol, robot_id, address, args.keepalive, args.redundancy)))
+            print(f"Streaming protocol {args.protocol} packets to robot ID {robot_id} at {address[0]}:{address[1]}...")
 
-            time.sleep(0.01) # 100Hz
+        # Output to terminal for verification
+        # Shows: [128, 128, 128, 128, 8, 0, 0, 0]
+        show = (lambda raw_payload: print(f"Raw: {list(raw_payload)}", end='\r')) if len(pads) == 1 else None
+        run_senders(pads, show=show)
 
     except Exception as e:
         print(f"\nError: {e}")
     finally:
-        device.close()
+        for device, sender in pads:
+            device.close()
         udp_socket.close()
 
 if __name__ == "__main__":
-    main()
\ No newline at end of file
+    main()
@@ -0,0 +1,188 @@
+#
+# Copyright (C) 2026 dBm Signal Dynamics Inc
+#
+# File:     cetalib-joystick-fleet-loadtest.py
+# Version:  0.0.1
+# Date:     October 19, 2026
+#
+# Description:
+#
+# Host-side load test for the CETALIB joystick fleet mode. No gamepads or
+# robots are needed: each simulated robot is a UDP socket that filters
+# protocol 2 packets by robot ID, exactly like the "joystick" module, and a
+# simulated client streams gamepad packets to every robot at the gamepad rate.
+#
+# The fleet grows step by step (e.g. 1, 2, 4 ... 32 robots), and for each
+# step the script reports the per-robot one-way latency (p50/p99/max), packet
+# loss, and the number of packets each robot had to receive and discard
+# because they were addressed to another robot.
+#
+#   unicast:   one packet per robot, sent to that robot's address
+#   multicast: one packet per robot, sent to the fleet group; every robot
+#              receives (and filters) the packets of the whole fleet
+#
+# Run it on a PC on the classroom network with "--interface" set to that PC's
+# address to include the WiFi hops in multicast mode, or on loopback (default)
+# to measure the client and receive-side cost alone.
+#
+
+import argparse
+import selectors
+import socket
+import struct
+import threading
+import time
+
+FLEET_GROUP = "239.42.0.1"
+NEUTRAL_REPORT = bytes([128, 128, 128, 128, 8, 0, 0, 0])
+
+
+def build_packet(robot_id, sequence):
+    timestamp = int(time.monotonic() * 1000) & 0xFFFFFFFF
+    return struct.pack('<2sBBHI', b'CJ', 2, robot_id, sequence, timestamp) + NEUTRAL_REPORT
+
+
+class SimulatedRobot:
+    def __init__(self, robot_id, mode, group, port, interface):
+        self.robot_id = robot_id
+        self.sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        self.sock.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+        if mode == 'multicast':
+            # every robot listens on the same group and port
+            if hasattr(socket, 'SO_REUSEPORT'):
+                self.sock.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEPORT, 1)
+            self.sock.bind(('', port))
+            membership = socket.inet_aton(group) + socket.inet_aton(interface)
+            self.sock.setsockopt(socket.IPPROTO_IP, socket.IP_ADD_MEMBERSHIP, membership)
+            self.address = (group, port)
+        else:
+            # each robot has its own address (a port per robot on the test PC)
+            self.sock.bind((interface, port + robot_id))
+            self.address = (interface, port + robot_id)
+        self.sock.setblocking(False)
+        self.received = 0
+        self.filtered = 0
+        self.latencies = []
+
+    def receive(self, send_times):
+        now = time.perf_counter()
+        while True:
+            try:
+                packet = self.sock.recv(64)
+            except BlockingIOError:
+                return
+            if len(packet) != 18 or packet[0:2] != b'CJ' or packet[2] != 2:
+                continue
+            robot_id = packet[3]
+            if robot_id != self.robot_id:        # fleet robots also ignore robot ID 0
+                self.filtered += 1
+                continue
+            sequence = struct.unpack_from('<H', packet, 4)[0]
+            sent = send_times.get((robot_id, sequence))
+            if sent is not None:
+                self.received += 1
+                self.latencies.append(now - sent)
+
+    def close(self):
+        self.sock.close()
+
+
+def percentile(samples, fraction):
+    if not samples:
+        return float('nan')
+    return samples[min(len(samples) - 1, int(len(samples) * fraction))]
+
+
+def run_step(num_robots, args):
+    robots = [SimulatedRobot(i + 1, args.mode, args.group, args.port, args.interface) for i in range(num_robots)]
+    send_times = {}
+    running = True
+
+    selector = selectors.DefaultSelector()
+    for robot in robots:
+        selector.register(robot.sock, selectors.EVENT_READ, robot)
+
+    def receiver():
+        while running:
+            for key, _ in selector.select(timeout=0.05):
+                key.data.receive(send_times)
+
+    thread = threading.Thread(target=receiver, daemon=True)
+    thread.start()
+
+    sender = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sender.setsockopt(socket.IPPROTO_IP, socket.IP_MULTICAST_TTL, 1)
+    sender.setsockopt(socket.IPPROTO_IP, socket.IP_MULTICAST_LOOP, 1)
+    sender.setsockopt(socket.IPPROTO_IP, socket.IP_MULTICAST_IF, socket.inet_aton(args.interface))
+
+    # one gamepad per robot, each sending at the gamepad rate, spread evenly over the period
+    period = 1.0 / args.rate
+    sent = 0
+    sequence = 0
+    start = time.perf_counter()
+    next_time = start
+    while next_time - start < args.duration:
+        for robot in robots:
+            packet = build_packet(robot.robot_id, sequence)
+            send_times[(robot.robot_id, sequence)] = time.perf_counter()
+            sender.sendto(packet, robot.address)
+            sent += 1
+        sequence = (sequence + 1) & 0xFFFF
+        next_time += period
+        delay = next_time - time.perf_counter()
+        if delay > 0:
+            time.sleep(delay)
+
+    time.sleep(0.2)                 # let the last packets arrive
+    running = False
+    thread.join()
+    sender.close()
+
+    expected = sent // num_robots
+    per_robot = []
+    for robot in robots:
+        robot.latencies.sort()
+        per_robot.append((robot.robot_id, robot.received, expected,
+                          percentile(robot.latencies, 0.50), percentile(robot.latencies, 0.99),
+                          robot.latencies[-1] if robot.latencies else float('nan'), robot.filtered))
+        selector.unregister(robot.sock)
+        robot.close()
+    selector.close()
+    return sent / args.duration, per_robot
+
+
+def main():
+    parser = argparse.ArgumentParser(description="CETALIB Joystick fleet mode load test")
+    parser.add_argument('--mode', choices=['unicast', 'multicast'], default='unicast', help="addressing mode (default: unicast)")
+    parser.add_argument('--robots', default="1,2,4,8,16,32", help="fleet sizes to test (default: 1,2,4,8,16,32)")
+    parser.add_argument('--rate', type=float, default=100.0, help="packets per second per gamepad (default: 100)")
+    parser.add_argument('--duration', type=float, default=5.0, help="seconds per fleet size (default: 5)")
+    parser.add_argument('--port', type=int, default=8888, help="robot UDP port (unicast: first port - 1, default: 8888)")
+    parser.add_argument('--group', default=FLEET_GROUP, help=f"multicast group (default: {FLEET_GROUP})")
+    parser.add_argument('--interface', default="127.0.0.1", help="local address to use (default: 127.0.0.1)")
+    parser.add_argument('--verbose', action='store_true', help="print every robot, not only the fleet summary")
+    args = parser.parse_args()
+
+    print(f"--- CETALIB Joystick fleet load test ({args.mode}, {args.rate:.0f} pkt/s per gamepad) ---")
+    print(f"{'robots':>6} {'pkt/s':>8} {'loss %':>7} {'p50 mS':>8} {'p99 mS':>8} {'worst p99':>10} {'max mS':>8} {'filtered/s':>11}")
+    for num_robots in [int(n) for n in args.robots.split(',')]:
+        rate, per_robot = run_step(num_robots, args)
+        received = sum(r[1] for r in per_robot)
+        expected = sum(r[2] for r in per_robot)
+        loss = 100.0 * (expected - received) / expected if expected else 0.0
+        p50s = sorted(r[3] for r in per_robot)
+        p99s = [r[4] for r in per_robot]
+        print(f"{num_robots:6d} {rate:8.0f} {loss:7.2f} {percentile(p50s, 0.5) * 1000:8.3f} "
+              f"{percentile(sorted(p99s), 0.5) * 1000:8.3f} {max(p99s) * 1000:10.3f} "
+              f"{max(r[5] for r in per_robot) * 1000:8.3f} {sum(r[6] for r in per_robot) / num_robots / args.duration:11.0f}")
+        if args.verbose:
+            for robot_id, rx, exp, p50, p99, worst, filtered in per_robot:
+                print(f"    robot {robot_id:3d}: rx {rx}/{exp}  p50 {p50 * 1000:.3f} mS  p99 {p99 * 1000:.3f} mS  "
+                      f"max {worst * 1000:.3f} mS  filtered {filtered}")
+
+
+if __name__ == '__main__':
+    try:
+        main()
+    except KeyboardInterrupt:
+        print("\n[!] Exiting...")
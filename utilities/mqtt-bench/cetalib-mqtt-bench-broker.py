@@ -0,0 +1,217 @@
+#
+# Copyright (C) 2026 dBm Signal Dynamics Inc
+#
+# File:     cetalib-mqtt-bench-broker.py
+# Version:  0.0.1
+# Date:     October 19, 2026
+#
+# Description:
+#
+# A minimal MQTT 3.1.1 broker stand-in for benchmarking the CETALIB "mqttc"
+# module on a local network (no cloud broker, no internet round trip).
+#
+# Supports CONNECT, SUBSCRIBE/UNSUBSCRIBE (with "+" and "#" wildcards),
+# PUBLISH at QoS 0 and 1, PINGREQ and DISCONNECT over plain TCP (port 1883)
+# and optionally TLS (port 8883) using a certificate signed by a test CA.
+# Retained messages, QoS 2, sessions and authentication are not implemented;
+# any username/password is accepted.
+#
+# Per-client message and byte rates are printed every few seconds, so that
+# the broker side can be compared with the "mqttc_benchmark" example report.
+#
+
+import argparse
+import asyncio
+import ssl
+import struct
+import time
+
+# MQTT control packet types
+CONNECT, CONNACK, PUBLISH, PUBACK = 1, 2, 3, 4
+SUBSCRIBE, SUBACK, UNSUBSCRIBE, UNSUBACK = 8, 9, 10, 11
+PINGREQ, PINGRESP, DISCONNECT = 12, 13, 14
+
+
+def encode_length(length):
+    out = bytearray()
+    while True:
+        byte = length % 128
+        length //= 128
+        if length:
+            byte |= 0x80
+        out.append(byte)
+        if not length:
+            return bytes(out)
+
+
+def topic_matches(pattern, topic):
+    p_levels = pattern.split('/')
+    t_levels = topic.split('/')
+    for i, p in enumerate(p_levels):
+        if p == '#':
+            return True
+        if i >= len(t_levels):
+            return False
+        if p != '+' and p != t_levels[i]:
+            return False
+    return len(p_levels) == len(t_levels)
+
+
+class Client:
+    def __init__(self, reader, writer):
+        self.reader = reader
+        self.writer = writer
+        self.client_id = '?'
+        self.subscriptions = {}         # topic filter -> granted QoS
+        self.next_packet_id = 1
+        self.msgs_in = self.bytes_in = 0
+        self.msgs_out = self.bytes_out = 0
+
+    def send(self, packet_type, flags, body):
+        self.writer.write(bytes([(packet_type << 4) | flags]) + encode_length(len(body)) + body)
+
+    def publish(self, topic, payload, qos):
+        body = struct.pack('>H', len(topic)) + topic
+        if qos:
+            body += struct.pack('>H', self.next_packet_id)
+            self.next_packet_id = self.next_packet_id % 0xFFFF + 1
+        self.send(PUBLISH, qos << 1, body + payload)
+        self.msgs_out += 1
+        self.bytes_out += len(payload)
+
+
+class Broker:
+    def __init__(self, verbose):
+        self.clients = set()
+        self.verbose = verbose
+
+    async def read_packet(self, reader):
+        header = await reader.readexactly(1)
+        length, multiplier = 0, 1
+        while True:
+            byte = (await reader.readexactly(1))[0]
+            length += (byte & 0x7F) * multiplier
+            if not byte & 0x80:
+                break
+            multiplier *= 128
+        body = await reader.readexactly(length) if length else b''
+        return header[0] >> 4, header[0] & 0x0F, body
+
+    async def handle(self, reader, writer):
+        client = Client(reader, writer)
+        self.clients.add(client)
+        peer = writer.get_extra_info('peername')
+        try:
+            while True:
+                packet_type, flags, body = await self.read_packet(reader)
+                if packet_type == CONNECT:
+                    # skip protocol name, level, flags and keep-alive to reach the client id
+                    name_len = struct.unpack_from('>H', body, 0)[0]
+                    offset = 2 + name_len + 4
+                    id_len = struct.unpack_from('>H', body, offset)[0]
+                    client.client_id = body[offset + 2:offset + 2 + id_len].decode(errors='replace')
+                    client.send(CONNACK, 0, b'\x00\x00')
+                    print(f"[+] {client.client_id} connected from {peer[0]}:{peer[1]}")
+                elif packet_type == PUBLISH:
+                    qos = (flags >> 1) & 0x03
+                    topic_len = struct.unpack_from('>H', body, 0)[0]
+                    topic = body[2:2 + topic_len]
+                    offset = 2 + topic_len
+                    if qos:
+                        packet_id = body[offset:offset + 2]
+                        offset += 2
+                        client.send(PUBACK, 0, packet_id)
+                    payload = body[offset:]
+                    client.msgs_in += 1
+                    client.bytes_in += len(payload)
+                    self.route(topic, payload, qos)
+                elif packet_type == SUBSCRIBE:
+                    packet_id = body[0:2]
+                    offset, granted = 2, bytearray()
+                    while offset < len(body):
+                        filter_len = struct.unpack_from('>H', body, offset)[0]
+                        topic_filter = body[offset + 2:offset + 2 + filter_len].decode()
+                        qos = min(body[offset + 2 + filter_len] & 0x03, 1)
+                        client.subscriptions[topic_filter] = qos
+                        granted.append(qos)
+                        offset += 3 + filter_len
+                        if self.verbose:
+                            print(f"    {client.client_id} subscribed to {topic_filter} (QoS {qos})")
+                    client.send(SUBACK, 0, packet_id + bytes(granted))
+                elif packet_type == UNSUBSCRIBE:
+                    packet_id = body[0:2]
+                    offset = 2
+                    while offset < len(body):
+                        filter_len = struct.unpack_from('>H', body, offset)[0]
+                        client.subscriptions.pop(body[offset + 2:offset + 2 + filter_len].decode(), None)
+                        offset += 2 + filter_len
+                    client.send(UNSUBACK, 0, packet_id)
+                elif packet_type == PINGREQ:
+                    client.send(PINGRESP, 0, b'')
+                elif packet_type == DISCONNECT:
+                    break
+                # PUBACKs from clients (for QoS 1 deliveries) need no action
+                await writer.drain()
+        except (asyncio.IncompleteReadError, ConnectionError, ssl.SSLError):
+            pass
+        finally:
+            self.clients.discard(client)
+            print(f"[-] {client.client_id} disconnected "
+                  f"(in: {client.msgs_in} msgs/{client.bytes_in} B, out: {client.msgs_out} msgs/{client.bytes_out} B)")
+            writer.close()
+
+    def route(self, topic, payload, qos):
+        topic_str = topic.decode(errors='replace')
+        for client in list(self.clients):
+            for topic_filter, sub_qos in client.subscriptions.items():
+                if topic_matches(topic_filter, topic_str):
+                    client.publish(topic, payload, min(qos, sub_qos))
+                    break
+
+    async def report(self, interval):
+        last = {}
+        while True:
+            await asyncio.sleep(interval)
+            for client in list(self.clients):
+                prev = last.get(client, (0, 0, 0, 0))
+                now = (client.msgs_in, client.bytes_in, client.msgs_out, client.bytes_out)
+                if now != prev:
+                    print(f"    {client.client_id}: "
+                          f"in {(now[0] - prev[0]) / interval:7.1f} msg/s {(now[1] - prev[1]) / interval:9.1f} B/s | "
+                          f"out {(now[2] - prev[2]) / interval:7.1f} msg/s {(now[3] - prev[3]) / interval:9.1f} B/s")
+                last[client] = now
+
+
+async def main():
+    parser = argparse.ArgumentParser(description="CETALIB MQTT benchmark broker stand-in")
+    parser.add_argument('--host', default='0.0.0.0', help="interface to listen on (default: all)")
+    parser.add_argument('--port', type=int, default=1883, help="plain TCP port (default: 1883)")
+    parser.add_argument('--tls-port', type=int, default=8883, help="TLS port (default: 8883)")
+    parser.add_argument('--cert', help="broker certificate (PEM), enables the TLS listener")
+    parser.add_argument('--key', help="broker private key (PEM)")
+    parser.add_argument('--interval', type=float, default=5.0, help="rate report interval in seconds")
+    parser.add_argument('--verbose', action='store_true', help="print subscriptions")
+    args = parser.parse_args()
+
+    broker = Broker(args.verbose)
+    servers = [await asyncio.start_server(broker.handle, args.host, args.port)]
+    print(f"[*] Listening on {args.host}:{args.port} (TCP)")
+    if args.cert:
+        context = ssl.create_default_context(ssl.Purpose.CLIENT_AUTH)
+        context.load_cert_chain(args.cert, args.key)
+        servers.append(await asyncio.start_server(broker.handle, args.host, args.tls_port, ssl=context))
+        print(f"[*] Listening on {args.host}:{args.tls_port} (TLS)")
+
+    asyncio.create_task(broker.report(args.interval))
+    start = time.monotonic()
+    try:
+        await asyncio.gather(*(server.serve_forever() for server in servers))
+    finally:
+        print(f"[!] Broker ran for {time.monotonic() - start:.0f} s")
+
+
+if __name__ == '__main__':
+    try:
+        asyncio.run(main())
+    except KeyboardInterrupt:
+        print("\n[!] Exiting...")
@@ -0,0 +1,286 @@
+#
+# Copyright (C) 2026 dBm Signal Dynamics Inc
+#
+# File:     cetalib-pathfollow-sim.py
+# Version:  0.0.1
+# Date:     October 19, 2026
+#
+# Description:
+#
+# Simulates the CETALIB "pathFollow" module (pure pursuit on wheel odometry)
+# on an XRP robot, to compare the tracking accuracy of paths, speeds and
+# lookahead distances on a PC.
+#
+# The controller is a line-by-line copy of "src/modules/pathFollow.cpp", with
+# the constants of "src/modules/pathFollow.h". The robot model adds what the
+# controller sees on the real robot:
+#
+#   - motor lag: each wheel speed follows its effort with a first-order lag
+#   - motor mismatch: the right wheel is slower than the left at equal effort
+#   - encoder quantization: the odometry uses whole encoder counts
+#   - loop jitter: tasks() is called every 1-3 mS (random)
+#
+# The tracking error is measured from the true robot position, so it includes
+# the odometry error. The final error is the distance from the true end
+# position to the last point of the path.
+#
+
+import argparse
+import math
+import random
+
+# --- src/modules/pathFollow.h ---
+WHEEL_DIAMETER = 6.0            # cm
+TRACK_WIDTH = 15.5              # cm
+COUNTS_PER_REV = 585
+INTERVAL = 20                   # mS
+LOOKAHEAD_DEFAULT = 12.0        # cm
+LOOKAHEAD_MIN = 3.0             # cm
+MAX_LATERAL_ACCEL = 40.0        # cm/s^2
+MAX_DECEL = 40.0                # cm/s^2
+MIN_SPEED = 4.0                 # cm/s
+GOAL_TOLERANCE = 1.5            # cm
+MAX_WHEEL_SPEED = 50.0          # cm/s
+SPEED_KP = 0.01
+SPEED_KI = 0.05
+SPEED_I_LIMIT = 0.3
+SPLINE_STEPS = 8
+
+CM_PER_COUNT = math.pi * WHEEL_DIAMETER / COUNTS_PER_REV
+
+PATHS = {
+    'square': ('waypoints', [(0, 0), (50, 0), (50, 50), (0, 50), (0, 0)]),
+    's-curve': ('spline', [(0, 0), (30, 15), (60, -15), (90, 0), (60, 40), (0, 20), (0, 0)]),
+    'figure-8': ('spline', [(0, 0), (30, 25), (60, 0), (30, -25), (0, 0), (-30, 25), (-60, 0), (-30, -25), (0, 0)]),
+}
+
+
+def clamp(value, low, high):
+    return max(low, min(high, value))
+
+
+def wrap_angle(angle):
+    while angle >= math.pi:
+        angle -= 2.0 * math.pi
+    while angle < -math.pi:
+        angle += 2.0 * math.pi
+    return angle
+
+
+def spline(points):
+    """Uniform Catmull-Rom samples through the points (pathFollow_set_spline())."""
+    samples = []
+    count = len(points)
+    for i in range(count - 1):
+        p0 = points[max(i - 1, 0)]
+        p1 = points[i]
+        p2 = points[i + 1]
+        p3 = points[min(i + 2, count - 1)]
+        for step in range(SPLINE_STEPS):
+            t = step / SPLINE_STEPS
+            samples.append(tuple(
+                0.5 * ((2 * p1[k]) + (p2[k] - p0[k]) * t + (2 * p0[k] - 5 * p1[k] + 4 * p2[k] - p3[k]) * t * t
+                       + (3 * p1[k] - p0[k] - 3 * p2[k] + p3[k]) * t * t * t) for k in (0, 1)))
+    samples.append(points[-1])
+    return samples
+
+
+class PathFollower:
+    """pathFollow.cpp controller state and update."""
+
+    def __init__(self, points, speed, lookahead):
+        self.points = []
+        self.distance = []
+        for point in points:
+            length = 0.0
+            if self.points:
+                length = math.hypot(point[0] - self.points[-1][0], point[1] - self.points[-1][1])
+                if length < 0.01:
+                    continue
+                length += self.distance[-1]
+            self.points.append(point)
+            self.distance.append(length)
+        self.speed = speed
+        self.lookahead = max(lookahead, LOOKAHEAD_MIN)
+        self.segment = 0
+        self.along = 0.0
+        self.cross_track = 0.0
+        self.integrals = [0.0, 0.0]
+        self.x = self.y = self.heading = 0.0
+        self.complete = False
+
+    def odometry(self, left_counts, right_counts, dt):
+        left = left_counts * CM_PER_COUNT
+        right = right_counts * CM_PER_COUNT
+        distance = 0.5 * (left + right)
+        turn = (right - left) / TRACK_WIDTH
+        mid_heading = self.heading + 0.5 * turn
+        self.x += distance * math.cos(mid_heading)
+        self.y += distance * math.sin(mid_heading)
+        self.heading = wrap_angle(self.heading + turn)
+        return left / dt, right / dt
+
+    def closest(self):
+        best = -1.0
+        count = len(self.points)
+        for i in range(self.segment, count - 1):
+            if i > self.segment and self.distance[i] > self.along + 2.0 * self.lookahead:
+                break
+            a, b = self.points[i], self.points[i + 1]
+            length = self.distance[i + 1] - self.distance[i]
+            ux, uy = (b[0] - a[0]) / length, (b[1] - a[1]) / length
+            along = (self.x - a[0]) * ux + (self.y - a[1]) * uy
+            side = (self.y - a[1]) * ux - (self.x - a[0]) * uy
+            clamped = clamp(along, 0.0, length)
+            distance = math.hypot(along - clamped, side)
+            if best < 0.0 or distance < best:
+                best = distance
+                self.segment = i
+                self.along = self.distance[i] + (along if i == count - 2 else clamped)
+                self.cross_track = -distance if side < 0.0 else distance
+
+    def lookahead_point(self):
+        target = self.along + self.lookahead
+        i = self.segment
+        while i < len(self.points) - 2 and self.distance[i + 1] < target:
+            i += 1
+        a, b = self.points[i], self.points[i + 1]
+        fraction = (target - self.distance[i]) / (self.distance[i + 1] - self.distance[i])
+        return a[0] + (b[0] - a[0]) * fraction, a[1] + (b[1] - a[1]) * fraction
+
+    def wheel_effort(self, wheel, target, measured, dt):
+        error = target - measured
+        self.integrals[wheel] = clamp(self.integrals[wheel] + SPEED_KI * error * dt, -SPEED_I_LIMIT, SPEED_I_LIMIT)
+        return clamp(target / MAX_WHEEL_SPEED + SPEED_KP * error + self.integrals[wheel], -1.0, 1.0)
+
+    def control(self, left_speed, right_speed, dt):
+        """Returns the wheel efforts, None at the end of the path."""
+        self.closest()
+        last = self.points[-1]
+        remaining = self.distance[-1] - self.along
+        if (remaining < self.lookahead and math.hypot(last[0] - self.x, last[1] - self.y) < GOAL_TOLERANCE) or remaining <= 0.0:
+            self.complete = True
+            return None
+        tx, ty = self.lookahead_point()
+        dx, dy = tx - self.x, ty - self.y
+        local_y = math.cos(self.heading) * dy - math.sin(self.heading) * dx
+        distance_squared = dx * dx + dy * dy
+        curvature = 2.0 * local_y / distance_squared if distance_squared > 0.01 else 0.0
+        speed = self.speed
+        if abs(curvature) > 0.0001:
+            speed = min(speed, math.sqrt(MAX_LATERAL_ACCEL / abs(curvature)))
+        speed = min(speed, math.sqrt(2.0 * MAX_DECEL * remaining))
+        speed = max(speed, min(MIN_SPEED, self.speed))
+        left_target = speed * (1.0 - 0.5 * curvature * TRACK_WIDTH)
+        right_target = speed * (1.0 + 0.5 * curvature * TRACK_WIDTH)
+        return (self.wheel_effort(0, left_target, left_speed, dt),
+                self.wheel_effort(1, right_target, right_speed, dt))
+
+
+def true_cross_track(points, x, y):
+    """Distance from the true robot position to the whole path."""
+    best = float('inf')
+    for a, b in zip(points, points[1:]):
+        length = math.hypot(b[0] - a[0], b[1] - a[1])
+        if length < 0.01:
+            continue
+        t = clamp(((x - a[0]) * (b[0] - a[0]) + (y - a[1]) * (b[1] - a[1])) / (length * length), 0.0, 1.0)
+        best = min(best, math.hypot(x - a[0] - t * (b[0] - a[0]), y - a[1] - t * (b[1] - a[1])))
+    return best
+
+
+def simulate(points, speed, lookahead, args, rng):
+    """Returns (RMS error, max error, time, final error, completed)."""
+    follower = PathFollower(points, speed, lookahead)
+    x = y = heading = 0.0                       # true pose
+    wheel_speed = [0.0, 0.0]                    # cm/s
+    wheel_travel = [0.0, 0.0]                   # cm
+    prev_counts = [0, 0]
+    efforts = [0.0, 0.0]
+    gains = [1.0, 1.0 - args.mismatch]
+    time_ms = 0.0
+    next_update = 0.0
+    prev_update = 0.0
+    squares = 0.0
+    max_error = 0.0
+    updates = 0
+    step = 0.0005                               # physics time step (s)
+    next_call = 0.0
+    while time_ms < args.timeout * 1000.0:
+        # robot physics
+        for wheel in (0, 1):
+            target = efforts[wheel] * MAX_WHEEL_SPEED * gains[wheel]
+            wheel_speed[wheel] += (target - wheel_speed[wheel]) * step / args.motor_lag
+            wheel_travel[wheel] += wheel_speed[wheel] * step
+        distance = 0.5 * (wheel_speed[0] + wheel_speed[1]) * step
+        heading += (wheel_speed[1] - wheel_speed[0]) / TRACK_WIDTH * step
+        x += distance * math.cos(heading)
+        y += distance * math.sin(heading)
+        time_ms += step * 1000.0
+
+        # sketch loop: tasks() is called every 1-3 mS, runs every INTERVAL mS
+        if time_ms < next_call:
+            continue
+        next_call = time_ms + rng.uniform(1.0, args.jitter)
+        if time_ms < next_update:
+            continue
+        if time_ms - next_update >= INTERVAL:
+            next_update = time_ms
+        next_update += INTERVAL
+        dt = (time_ms - prev_update) / 1000.0
+        prev_update = time_ms
+        counts = [int(wheel_travel[wheel] / CM_PER_COUNT) for wheel in (0, 1)]
+        measured = follower.odometry(counts[0] - prev_counts[0], counts[1] - prev_counts[1], dt)
+        prev_counts = counts
+        result = follower.control(measured[0], measured[1], dt)
+        error = true_cross_track(follower.points, x, y)
+        updates += 1
+        squares += error * error
+        max_error = max(max_error, error)
+        if result is None:
+            efforts = [0.0, 0.0]
+            break
+        efforts = list(result)
+
+    last = follower.points[-1]
+    rms = math.sqrt(squares / updates) if updates else 0.0
+    return rms, max_error, time_ms / 1000.0, math.hypot(x - last[0], y - last[1]), follower.complete
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Simulate the CETALIB pathFollow controller: tracking error versus speed")
+    parser.add_argument('--path', choices=list(PATHS) + ['all'], default='all', help="path to follow (default: all)")
+    parser.add_argument('--speeds', default='10,20,30,40', help="cruise speeds in cm/s (default: 10,20,30,40)")
+    parser.add_argument('--lookahead', type=float, default=LOOKAHEAD_DEFAULT, help=f"lookahead distance in cm (default: {LOOKAHEAD_DEFAULT})")
+    parser.add_argument('--motor-lag', type=float, default=0.08, help="motor time constant in seconds (default: 0.08)")
+    parser.add_argument('--mismatch', type=float, default=0.05, help="right motor speed deficit, 0.05 = 5%% slower (default: 0.05)")
+    parser.add_argument('--jitter', type=float, default=3.0, help="longest time between tasks() calls in mS (default: 3)")
+    parser.add_argument('--timeout', type=float, default=60.0, help="simulation time limit per run in seconds (default: 60)")
+    parser.add_argument('--seed', type=int, default=1, help="random seed for the loop jitter (default: 1)")
+    args = parser.parse_args()
+
+    try:
+        speeds = [float(speed) for speed in args.speeds.split(',')]
+    except ValueError:
+        parser.error("--speeds must be a comma separated list of numbers")
+    names = list(PATHS) if args.path == 'all' else [args.path]
+
+    print(f"--- CETALIB pathFollow simulation: lookahead {args.lookahead:.1f} cm, motor lag {args.motor_lag * 1000:.0f} mS, "
+          f"mismatch {args.mismatch * 100:.0f}% ---")
+    print(f"{'path':<10} {'speed':>6} {'RMS cm':>7} {'max cm':>7} {'time s':>7} {'final cm':>9}")
+    for name in names:
+        kind, points = PATHS[name]
+        if kind == 'spline':
+            points = spline(points)
+        for speed in speeds:
+            rng = random.Random(args.seed)
+            rms, max_error, duration, final, complete = simulate(points, speed, args.lookahead, args, rng)
+            note = '' if complete else '  (timeout)'
+            print(f"{name:<10} {speed:6.1f} {rms:7.2f} {max_error:7.2f} {duration:7.2f} {final:9.2f}{note}")
+
+
+if __name__ == '__main__':
+    try:
+        main()
+    except KeyboardInterrupt:
+        print("\n[!] Exiting...")
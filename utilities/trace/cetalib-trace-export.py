@@ -0,0 +1,183 @@
+#
+# Copyright (C) 2026 dBm Signal Dynamics Inc
+#
+# File:     cetalib-trace-export.py
+# Version:  0.0.1
+# Date:     October 19, 2026
+#
+# Description:
+#
+# Converts the events recorded by the CETALIB "trace" module to a Chrome trace
+# file (JSON), to view the timeline of both cores in Perfetto
+# (https://ui.perfetto.dev) or chrome://tracing.
+#
+# The input is a text capture of the trace "dump()" output (the lines between
+# "TRACE BEGIN" and "TRACE END"). With "--serial", the dump is captured
+# directly from the robot's serial port (requires pyserial).
+#
+# Dump layout (one event per line, oldest first, core 0 then core 1):
+#
+#   TRACE BEGIN <time of the dump (uS)>
+#   <core> <time (uS)> <B|E|I> <module> <function> <argument>
+#   TRACE END
+#
+# The uS times are 32-bit and wrap every 71 minutes: each event is placed
+# before the time of the dump. Begin/end pairs become complete ("X") events
+# with the begin and end arguments. An end without its begin (overwritten
+# when the event buffer was full) is discarded, a begin without its end is
+# closed at the last event of its core.
+#
+
+import argparse
+import json
+import os
+import sys
+import time
+
+
+def from_dump(text):
+    # keep the last complete dump in the capture
+    lines = None
+    dump = None
+    for line in text.splitlines():
+        line = line.strip()
+        if line.startswith("TRACE BEGIN"):
+            lines = [line]
+        elif line == "TRACE END" and lines is not None:
+            dump = lines
+            lines = None
+        elif lines is not None and line:
+            lines.append(line)
+    if dump is None:
+        raise ValueError("no complete \"TRACE BEGIN\" ... \"TRACE END\" dump found")
+    return dump
+
+
+def capture_serial(port, baud):
+    try:
+        import serial
+    except ImportError:
+        sys.exit("[!] --serial requires pyserial (pip install pyserial)")
+    print(f"[*] Waiting for a trace dump on {port} (call trace->dump() on the robot)...")
+    text = []
+    with serial.Serial(port, baud, timeout=1) as ser:
+        started = False
+        while True:
+            line = ser.readline().decode('ascii', errors='replace').strip()
+            if line.startswith("TRACE BEGIN"):
+                started = True
+                text = []
+            if started:
+                text.append(line)
+                if line == "TRACE END":
+                    return '\n'.join(text)
+
+
+def parse(dump):
+    dump_time = int(dump[0].split()[2])
+    events = []
+    for line in dump[1:]:
+        fields = line.split()
+        if len(fields) != 6 or fields[2] not in ('B', 'E', 'I'):
+            continue                    # e.g. a log message sent by the other core
+        core, raw_time, kind, module, function, arg = fields
+        # place the wrapped 32-bit time before the dump
+        clock = dump_time - ((dump_time - int(raw_time)) & 0xFFFFFFFF)
+        events.append((int(core), clock, kind, module, function, int(arg)))
+    return events
+
+
+def convert(events):
+    first = min((event[1] for event in events), default=0)
+    trace = []
+    stats = {}
+    discarded = 0
+    unfinished = 0
+    for core in sorted(set(event[0] for event in events)):
+        trace.append({'name': 'thread_name', 'ph': 'M', 'pid': 1, 'tid': core, 'args': {'name': f"core {core}"}})
+        stack = []
+        last = first
+        for _, clock, kind, module, function, arg in (event for event in events if event[0] == core):
+            last = max(last, clock)
+            if kind == 'I':
+                trace.append({'name': function, 'cat': module, 'ph': 'i', 's': 't', 'ts': clock - first,
+                              'pid': 1, 'tid': core, 'args': {'arg': arg}})
+            elif kind == 'B':
+                stack.append((clock, module, function, arg))
+            else:
+                # close the matching begin, and any begin left open inside it
+                match = next((i for i in range(len(stack) - 1, -1, -1) if stack[i][1:3] == (module, function)), None)
+                if match is None:
+                    discarded += 1
+                    continue
+                while len(stack) > match:
+                    begin, begin_module, begin_function, begin_arg = stack.pop()
+                    closed = len(stack) == match
+                    args = {'begin': begin_arg}
+                    if closed:
+                        args['end'] = arg
+                    else:
+                        unfinished += 1
+                        args['unfinished'] = True
+                    trace.append({'name': begin_function, 'cat': begin_module, 'ph': 'X', 'ts': begin - first,
+                                  'dur': clock - begin, 'pid': 1, 'tid': core, 'args': args})
+                    if closed:
+                        span = stats.setdefault(f"{begin_module}.{begin_function}", [0, 0, 0])
+                        span[0] += 1
+                        span[1] += clock - begin
+                        span[2] = max(span[2], clock - begin)
+        for begin, module, function, arg in stack:
+            unfinished += 1
+            trace.append({'name': function, 'cat': module, 'ph': 'X', 'ts': begin - first, 'dur': last - begin,
+                          'pid': 1, 'tid': core, 'args': {'begin': arg, 'unfinished': True}})
+    trace.append({'name': 'process_name', 'ph': 'M', 'pid': 1, 'args': {'name': 'cetalib robot'}})
+    return trace, stats, discarded, unfinished
+
+
+def main():
+    parser = argparse.ArgumentParser(description="CETALIB trace to Chrome/Perfetto trace converter")
+    parser.add_argument('input', nargs='?', help="text capture of trace dump()")
+    parser.add_argument('-o', '--output', help="output file (default: input name with .json)")
+    parser.add_argument('--serial', metavar='PORT', help="capture a dump from the robot's serial port instead of reading a file")
+    parser.add_argument('--baud', type=int, default=115200, help="serial baud rate (default: 115200)")
+    parser.add_argument('--top', type=int, default=10, help="number of spans listed in the summary (default: 10)")
+    args = parser.parse_args()
+
+    if args.serial:
+        text = capture_serial(args.serial, args.baud)
+        base = args.output or time.strftime("trace-%Y%m%d-%H%M%S")
+        with open(os.path.splitext(base)[0] + '.txt', 'w') as f:
+            f.write(text + '\n')
+    elif args.input:
+        with open(args.input, 'r', errors='replace') as f:
+            text = f.read()
+        base = args.input
+    else:
+        parser.error("give an input file or --serial PORT")
+    output = args.output or os.path.splitext(base)[0] + '.json'
+
+    try:
+        events = parse(from_dump(text))
+    except ValueError as error:
+        sys.exit(f"[!] {error}")
+    trace, stats, discarded, unfinished = convert(events)
+    with open(output, 'w') as f:
+        json.dump({'traceEvents': trace, 'displayTimeUnit': 'ms'}, f)
+
+    duration = (max(event[1] for event in events) - min(event[1] for event in events)) if events else 0
+    print(f"--- CETALIB trace: {len(events)} events, {duration / 1000:.3f} mS ---")
+    print(f"{'span':<28} {'count':>6} {'total mS':>9} {'avg uS':>8} {'max uS':>8}")
+    for name, (count, total, longest) in sorted(stats.items(), key=lambda item: -item[1][1])[:args.top]:
+        print(f"{name:<28} {count:6d} {total / 1000:9.3f} {total / count:8.1f} {longest:8d}")
+    if discarded:
+        print(f"{discarded} end events without their begin discarded (overwritten when the buffer was full)")
+    if unfinished:
+        print(f"{unfinished} spans without their end (marked \"unfinished\")")
+    print(f"[*] Written {output} (open it in https://ui.perfetto.dev)")
+
+
+if __name__ == '__main__':
+    try:
+        main()
+    except KeyboardInterrupt:
+        print("\n[!] Exiting...")